@@ -9,9 +9,12 @@
  */
 
 #include "ToolZ/DistanceService.h"
+#include "ToolZ/MappedIndexMatrix.h"
 
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind/bind.hpp>
 #include <algorithm>
 #include <vector>
 
@@ -20,23 +23,53 @@ using namespace indexmatrix;
 //=================== CLASS DistanceService ===========
 
 DistanceService::DistanceService(
-  const PositionServiceConstPtr& posService) 
+  const PositionServiceConstPtr& posService,
+  const bool persistCache) 
 : hasher_(posService->GetHashService()),
   posService_(posService),
+  persistCache_(persistCache),
   hashedDist_(hasher_->HashSize())
 {};
 
-void DistanceService::HashAllDistances() const {
-  for (unsigned int i=0; i<hasher_->HashSize(); i++) {
-    for (unsigned int j=0; j<hasher_->HashSize() && j<=i; j++) {
-      const I3Position pos_i = posService_->GetPosition(i);
-      const I3Position pos_j = posService_->GetPosition(j);
-      const double dist = (pos_i-pos_j).Magnitude() +0.5; //+0.5 for rounding
-      hashedDist_.Set(i,j,dist);
+void DistanceService::HashDistanceRowBlocks(
+  const unsigned firstBlock,
+  const unsigned blockStride) const
+{
+  const unsigned n = hasher_->HashSize();
+  const double* x = posService_->GetX().data();
+  const double* y = posService_->GetY().data();
+  const double* z = posService_->GetZ().data();
+  std::vector<double> dist(n);
+  std::vector<uint16_t> row(n);
+  
+  for (unsigned block=firstBlock; block*hashall_block_rows_<n; block+=blockStride) {
+    const unsigned row_end = std::min(n, (block+1)*hashall_block_rows_);
+    for (unsigned i=block*hashall_block_rows_; i<row_end; i++) {
+      //row i holds the distances to all DOMs j<=i
+      PositionService::DistancesFrom(I3Position(x[i], y[i], z[i]), x, y, z, i+1, &dist[0]);
+      for (unsigned j=0; j<=i; j++)
+        row[j] = dist[j] +0.5; //+0.5 for rounding
+      hashedDist_.SetRow(i, row.begin());
     }
   }
 };
 
+void DistanceService::HashAllDistances(const unsigned nThreads) const {
+  const unsigned nBlocks = (hasher_->HashSize()+hashall_block_rows_-1)/hashall_block_rows_;
+  unsigned nWorkers = nThreads ? nThreads : boost::thread::hardware_concurrency();
+  nWorkers = std::max(1u, std::min(nWorkers, nBlocks));
+  
+  if (nWorkers==1) {
+    HashDistanceRowBlocks(0, 1);
+    return;
+  }
+  //rows grow in length, so blocks are dealt round-robin to balance the load
+  boost::thread_group workers;
+  for (unsigned t=0; t<nWorkers; t++)
+    workers.create_thread(boost::bind(&DistanceService::HashDistanceRowBlocks, this, t, nWorkers));
+  workers.join_all();
+};
+
 double DistanceService::GetDistance(
   const CompactHash a,
   const CompactHash b) const 
@@ -46,19 +79,82 @@ double DistanceService::GetDistance(
   uint16_t dist = hashedDist_.Get(a,b);
   if (dist) //if this entry is different from 0. thus has been set
     return double(dist);
-  const I3Position pos_a = posService_->GetPosition(a);
-  const I3Position pos_b = posService_->GetPosition(b);
-  dist = (pos_a-pos_b).Magnitude() + 0.5; //+0.5 for rounding
+  dist = posService_->GetDistance(a,b) + 0.5; //+0.5 for rounding
   hashedDist_.Set(a,b,dist);
   return dist;
 };  
 
+uint64_t DistanceService::GetNCached() const {
+  const RelaxedAtomicVector<uint16_t>& fields = hashedDist_.GetInternal();
+  uint64_t nCached = 0;
+  for (size_t index=0; index<fields.size(); index++)
+    nCached += (fields[index]!=0);
+  return nCached;
+};
+
+void DistanceService::EncodeCache(
+  std::vector<uint64_t>& runs,
+  std::vector<uint8_t>& values) const
+{
+  const RelaxedAtomicVector<uint16_t>& fields = hashedDist_.GetInternal();
+  runs.clear();
+  values.clear();
+  size_t index = 0;
+  while (index<fields.size()) {
+    const size_t empty_begin = index;
+    while (index<fields.size() && fields[index]==0)
+      index++;
+    const size_t filled_begin = index;
+    //read each field once, as other threads may be filling the cache concurrently
+    uint16_t value;
+    while (index<fields.size() && (value = fields[index])!=0) {
+      values.push_back(value & 0xff);
+      values.push_back(value >> 8);
+      index++;
+    }
+    runs.push_back(filled_begin-empty_begin);
+    runs.push_back(index-filled_begin);
+  }
+};
+
+void DistanceService::DecodeCache(
+  const std::vector<uint64_t>& runs,
+  const std::vector<uint8_t>& values) const
+{
+  //the cache is mutable; GetInternal only hands out read access
+  RelaxedAtomicVector<uint16_t>& fields = const_cast<RelaxedAtomicVector<uint16_t>&>(hashedDist_.GetInternal());
+  //the runs come in pairs of empty and filled fields, and every filled field takes two bytes
+  if (runs.size()%2)
+    log_fatal("the persisted distance cache is corrupt");
+  size_t index = 0;
+  size_t byte = 0;
+  for (size_t run=0; run<runs.size(); run+=2) {
+    //compare against the remaining space, as the sums of corrupt runs may overflow
+    if (runs[run]>fields.size()-index
+      || runs[run+1]>fields.size()-index-runs[run]
+      || runs[run+1]>(values.size()-byte)/2)
+      log_fatal("the persisted distance cache does not fit this geometry");
+    index += runs[run];
+    for (uint64_t k=0; k<runs[run+1]; k++, index++, byte+=2)
+      fields[index] = uint16_t(values[byte] | (values[byte+1] << 8));
+  }
+  if (byte!=values.size())
+    log_fatal("the persisted distance cache is corrupt");
+};
+
 bool DistanceService::VerifyAgainst(
   const I3OMGeoMap& omgeo) const 
 {
   return posService_->VerifyAgainst(omgeo);
 }
 
+void DistanceService::WriteMapped(
+  const std::string& path) const
+{
+  HashAllDistances();
+  indexmatrix::WriteMapped(path, hashedDist_, posService_->GetChecksum());
+};
+
 #if SERIALIZATION_ENABLED
   I3_SERIALIZABLE(DistanceService);
 #endif
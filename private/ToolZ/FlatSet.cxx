@@ -0,0 +1,11 @@
+/**
+ * \file FlatSet.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * An ordered set stored as a sorted vector
+ */
+
+#include "ToolZ/FlatSet.h"
@@ -12,27 +12,33 @@
  */
 
 #include "ToolZ/HashedGeometry.h"
+#include "ToolZ/HashedGeometryRegistry.h"
 
-HashedGeometry::HashedGeometry(const I3OMGeoMap& omgeo) 
-: hashService_(boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(omgeo))),
+HashedGeometry::HashedGeometry(
+  const I3OMGeoMap& omgeo,
+  const bool persistDistances) 
+: hashService_(HashedGeometryRegistry::GetHashService(ExtractOMKeys(omgeo))),
   posService_(boost::make_shared<const PositionService>(omgeo, hashService_)),
-  distService_(boost::make_shared<const DistanceService>(posService_))
+  distService_(boost::make_shared<const DistanceService>(posService_, persistDistances))
 {};
 
 HashedGeometry::HashedGeometry(
   const I3OMGeoMap& omgeo,
-  const std::set<OMKey> omkeys)
-: hashService_(boost::make_shared<const CompactOMKeyHashService>(omkeys)),
+  const std::set<OMKey> omkeys,
+  const bool persistDistances)
+: hashService_(HashedGeometryRegistry::GetHashService(omkeys)),
   posService_(boost::make_shared<const PositionService>(omgeo, hashService_)),
-  distService_(boost::make_shared<const DistanceService>(posService_))
+  distService_(boost::make_shared<const DistanceService>(posService_, persistDistances))
 {};
 
 
 #if SERIALIZATION_ENABLED
-HashedGeometry::HashedGeometry (const PositionServiceConstPtr& posService) 
+HashedGeometry::HashedGeometry (
+  const PositionServiceConstPtr& posService,
+  const bool persistDistances) 
 : hashService_(posService->GetHashService()),
   posService_(posService),
-  distService_(boost::make_shared<const DistanceService>(posService_))
+  distService_(boost::make_shared<const DistanceService>(posService_, persistDistances))
 {};
 #endif //SERIALIZATION_ENABLED
 
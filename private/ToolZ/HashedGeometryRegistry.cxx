@@ -0,0 +1,214 @@
+/**
+ * \file HashedGeometryRegistry.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A process-wide registry of hashers and HashedGeometries, so that identical geometries are only hashed once
+ */
+
+#include "ToolZ/HashedGeometryRegistry.h"
+#include "ToolZ/FNV1a.h"
+
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+namespace {
+  ///purge expired entries only once the registers have grown this large
+  const size_t min_purge_size = 16;
+
+  ///does this hasher encode exactly these OMKeys; guards against fingerprint collisions
+  bool Encodes(
+    const CompactOMKeyHashService& hasher,
+    const std::set<OMKey>& omkeys)
+  {
+    if (hasher.HashSize()!=omkeys.size())
+      return false;
+    CompactHash hash = 0;
+    BOOST_FOREACH(const OMKey& omkey, omkeys) {
+      if (hasher.OMKeyFromHash(hash++)!=omkey)
+        return false;
+    }
+    return true;
+  };
+
+  ///does this HashedGeometry encode exactly these OMKeys at their positions in omgeo
+  bool Encodes(
+    const HashedGeometry& hashedGeo,
+    const I3OMGeoMap& omgeo,
+    const std::set<OMKey>& omkeys)
+  {
+    if (!Encodes(*hashedGeo.GetHashService(), omkeys))
+      return false;
+    const PositionServiceConstPtr posService = hashedGeo.GetPosService();
+    CompactHash hash = 0;
+    BOOST_FOREACH(const OMKey& omkey, omkeys) {
+      if (posService->GetPosition(hash++)!=omgeo.at(omkey).position)
+        return false;
+    }
+    return true;
+  };
+}
+
+//============ CLASS HashedGeometryRegistry ============
+
+HashedGeometryRegistry::Registers::Registers()
+: hits_(0),
+  misses_(0),
+  purgeSize_(min_purge_size)
+{};
+
+HashedGeometryRegistry::Registers& HashedGeometryRegistry::GetRegisters() {
+  static Registers regs;
+  return regs;
+};
+
+uint64_t HashedGeometryRegistry::Fingerprint(const std::set<OMKey>& omkeys) {
+  uint64_t fingerprint = fnv1a::offset_basis;
+  BOOST_FOREACH(const OMKey& omkey, omkeys)
+    fnv1a::FoldIn(fingerprint, omkey);
+  return fingerprint;
+};
+
+uint64_t HashedGeometryRegistry::Fingerprint(const I3OMGeoMap& omgeo) {
+  uint64_t fingerprint = fnv1a::offset_basis;
+  BOOST_FOREACH(const I3OMGeoMap::value_type& omkey_omgeo, omgeo) {
+    fnv1a::FoldIn(fingerprint, omkey_omgeo.first);
+    fnv1a::FoldIn(fingerprint, omkey_omgeo.second.position);
+  }
+  return fingerprint;
+};
+
+uint64_t HashedGeometryRegistry::Fingerprint(
+  const I3OMGeoMap& omgeo,
+  const std::set<OMKey>& omkeys)
+{
+  uint64_t fingerprint = fnv1a::offset_basis;
+  BOOST_FOREACH(const OMKey& omkey, omkeys) {
+    fnv1a::FoldIn(fingerprint, omkey);
+    fnv1a::FoldIn(fingerprint, omgeo.at(omkey).position);
+  }
+  return fingerprint;
+};
+
+void HashedGeometryRegistry::Purge(Registers& regs) {
+  for (HasherRegister::iterator it=regs.hashers_.begin(); it!=regs.hashers_.end();) {
+    if (it->second.expired())
+      regs.hashers_.erase(it++);
+    else
+      ++it;
+  }
+  for (GeometryRegister::iterator it=regs.geometries_.begin(); it!=regs.geometries_.end();) {
+    if (it->second.expired())
+      regs.geometries_.erase(it++);
+    else
+      ++it;
+  }
+  regs.purgeSize_ = std::max(min_purge_size, 2*(regs.hashers_.size()+regs.geometries_.size()));
+};
+
+void HashedGeometryRegistry::PurgeIfGrown(Registers& regs) {
+  if (regs.hashers_.size()+regs.geometries_.size() >= regs.purgeSize_)
+    Purge(regs);
+};
+
+CompactOMKeyHashServiceConstPtr
+HashedGeometryRegistry::GetHashService(const std::set<OMKey>& omkeys) {
+  const uint64_t fingerprint = Fingerprint(omkeys);
+  Registers& regs = GetRegisters();
+  {
+    boost::lock_guard<boost::mutex> lock(regs.mutex_);
+    const HasherRegister::const_iterator it = regs.hashers_.find(fingerprint);
+    if (it!=regs.hashers_.end()) {
+      const CompactOMKeyHashServiceConstPtr hasher = it->second.lock();
+      if (hasher && Encodes(*hasher, omkeys)) {
+        regs.hits_++;
+        return hasher;
+      }
+    }
+  }
+
+  //build outside the lock; another thread might be quicker, in which case its object is taken
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(omkeys);
+
+  boost::lock_guard<boost::mutex> lock(regs.mutex_);
+  regs.misses_++;
+  PurgeIfGrown(regs);
+  boost::weak_ptr<const CompactOMKeyHashService>& entry = regs.hashers_[fingerprint];
+  const CompactOMKeyHashServiceConstPtr registered = entry.lock();
+  if (registered && Encodes(*registered, omkeys))
+    return registered;
+  entry = hasher;
+  return hasher;
+};
+
+HashedGeometryConstPtr
+HashedGeometryRegistry::GetHashedGeometry(const I3OMGeoMap& omgeo) {
+  return GetHashedGeometry(omgeo, ExtractOMKeys(omgeo));
+};
+
+HashedGeometryConstPtr
+HashedGeometryRegistry::GetHashedGeometry(
+  const I3OMGeoMap& omgeo,
+  const std::set<OMKey>& omkeys)
+{
+  const uint64_t fingerprint = Fingerprint(omgeo, omkeys);
+  Registers& regs = GetRegisters();
+  {
+    boost::lock_guard<boost::mutex> lock(regs.mutex_);
+    const GeometryRegister::const_iterator it = regs.geometries_.find(fingerprint);
+    if (it!=regs.geometries_.end()) {
+      const HashedGeometryConstPtr hashedGeo = it->second.lock();
+      if (hashedGeo && Encodes(*hashedGeo, omgeo, omkeys)) {
+        regs.hits_++;
+        return hashedGeo;
+      }
+    }
+  }
+
+  //build outside the lock, as the construction itself requests the hasher from the registry
+  const HashedGeometryConstPtr hashedGeo = boost::make_shared<const HashedGeometry>(omgeo, omkeys);
+
+  boost::lock_guard<boost::mutex> lock(regs.mutex_);
+  regs.misses_++;
+  PurgeIfGrown(regs);
+  boost::weak_ptr<const HashedGeometry>& entry = regs.geometries_[fingerprint];
+  const HashedGeometryConstPtr registered = entry.lock();
+  if (registered && Encodes(*registered, omgeo, omkeys))
+    return registered;
+  entry = hashedGeo;
+  return hashedGeo;
+};
+
+uint64_t HashedGeometryRegistry::GetCacheHits() {
+  Registers& regs = GetRegisters();
+  boost::lock_guard<boost::mutex> lock(regs.mutex_);
+  return regs.hits_;
+};
+
+uint64_t HashedGeometryRegistry::GetCacheMisses() {
+  Registers& regs = GetRegisters();
+  boost::lock_guard<boost::mutex> lock(regs.mutex_);
+  return regs.misses_;
+};
+
+size_t HashedGeometryRegistry::GetSize() {
+  Registers& regs = GetRegisters();
+  boost::lock_guard<boost::mutex> lock(regs.mutex_);
+  Purge(regs);
+  return regs.hashers_.size() + regs.geometries_.size();
+};
+
+void HashedGeometryRegistry::Clear() {
+  Registers& regs = GetRegisters();
+  boost::lock_guard<boost::mutex> lock(regs.mutex_);
+  regs.hashers_.clear();
+  regs.geometries_.clear();
+  regs.hits_ = 0;
+  regs.misses_ = 0;
+  regs.purgeSize_ = min_purge_size;
+};
@@ -0,0 +1,138 @@
+/**
+ * \file HashedOMKeySet.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A set of OMKeys represented by a bitset over their compact hashes
+ */
+
+#include "ToolZ/HashedOMKeySet.h"
+
+#include <boost/foreach.hpp>
+
+//============ CLASS HashedOMKeySet ============
+
+HashedOMKeySet::HashedOMKeySet()
+{};
+
+HashedOMKeySet::HashedOMKeySet(const CompactOMKeyHashServiceConstPtr& hasher)
+: hasher_(hasher),
+  bits_(hasher->HashSize())
+{};
+
+HashedOMKeySet::HashedOMKeySet(
+  const CompactOMKeyHashServiceConstPtr& hasher,
+  const std::set<OMKey>& omkeys)
+: hasher_(hasher),
+  bits_(hasher->HashSize())
+{
+  //the set is sorted, so all hashes are resolved in a single pass
+  BOOST_FOREACH(const CompactHash hash, hasher_->HashFromOMKeys(omkeys.begin(), omkeys.end()))
+    bits_.set(hash);
+};
+
+HashedOMKeySet::HashedOMKeySet(
+  const CompactOMKeyHashServiceConstPtr& hasher,
+  const std::vector<CompactHash>& hashes)
+: hasher_(hasher),
+  bits_(hasher->HashSize())
+{
+  BOOST_FOREACH(const CompactHash hash, hashes) {
+    AssertInRange(hash);
+    bits_.set(hash);
+  }
+};
+
+HashedOMKeySet HashedOMKeySet::Full(const CompactOMKeyHashServiceConstPtr& hasher) {
+  HashedOMKeySet full(hasher);
+  full.bits_.set();
+  return full;
+};
+
+void HashedOMKeySet::AssertCompatible(const HashedOMKeySet& rhs) const {
+  if (hasher_!=rhs.hasher_)
+    log_fatal("HashedOMKeySets are defined over different hashers");
+};
+
+HashedOMKeySet& HashedOMKeySet::operator|=(const HashedOMKeySet& rhs) {
+  AssertCompatible(rhs);
+  bits_ |= rhs.bits_;
+  return *this;
+};
+
+HashedOMKeySet& HashedOMKeySet::operator&=(const HashedOMKeySet& rhs) {
+  AssertCompatible(rhs);
+  bits_ &= rhs.bits_;
+  return *this;
+};
+
+HashedOMKeySet& HashedOMKeySet::operator-=(const HashedOMKeySet& rhs) {
+  AssertCompatible(rhs);
+  bits_ -= rhs.bits_;
+  return *this;
+};
+
+HashedOMKeySet& HashedOMKeySet::operator^=(const HashedOMKeySet& rhs) {
+  AssertCompatible(rhs);
+  bits_ ^= rhs.bits_;
+  return *this;
+};
+
+HashedOMKeySet HashedOMKeySet::operator~() const {
+  HashedOMKeySet complement(*this);
+  complement.bits_.flip();
+  return complement;
+};
+
+bool HashedOMKeySet::IsSubsetOf(const HashedOMKeySet& rhs) const {
+  AssertCompatible(rhs);
+  return bits_.is_subset_of(rhs.bits_);
+};
+
+bool HashedOMKeySet::Intersects(const HashedOMKeySet& rhs) const {
+  AssertCompatible(rhs);
+  return bits_.intersects(rhs.bits_);
+};
+
+size_t HashedOMKeySet::IntersectionCount(const HashedOMKeySet& rhs) const {
+  AssertCompatible(rhs);
+  return (bits_ & rhs.bits_).count();
+};
+
+bool HashedOMKeySet::operator==(const HashedOMKeySet& rhs) const {
+  return hasher_==rhs.hasher_ && bits_==rhs.bits_;
+};
+
+bool HashedOMKeySet::operator!=(const HashedOMKeySet& rhs) const {
+  return !(*this==rhs);
+};
+
+std::set<OMKey> HashedOMKeySet::GetOMKeys() const {
+  std::set<OMKey> omkeys;
+  //hashes are ordered like their OMKeys, so every insert goes to the end
+  for (const_iterator it=begin(); it!=end(); ++it)
+    omkeys.insert(omkeys.end(), hasher_->OMKeyFromHash(*it));
+  return omkeys;
+};
+
+std::vector<CompactHash> HashedOMKeySet::GetHashes() const {
+  std::vector<CompactHash> hashes;
+  hashes.reserve(Count());
+  for (const_iterator it=begin(); it!=end(); ++it)
+    hashes.push_back(*it);
+  return hashes;
+};
+
+HashedOMKeySet operator|(HashedOMKeySet lhs, const HashedOMKeySet& rhs)
+  {return lhs |= rhs;};
+
+HashedOMKeySet operator&(HashedOMKeySet lhs, const HashedOMKeySet& rhs)
+  {return lhs &= rhs;};
+
+HashedOMKeySet operator-(HashedOMKeySet lhs, const HashedOMKeySet& rhs)
+  {return lhs -= rhs;};
+
+HashedOMKeySet operator^(HashedOMKeySet lhs, const HashedOMKeySet& rhs)
+  {return lhs ^= rhs;};
@@ -0,0 +1,99 @@
+/**
+ * \file HitBatch.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A time-ordered batch of hits stored as structure-of-arrays
+ */
+
+#include "ToolZ/HitBatch.h"
+
+namespace {
+  ///the sort key of a hit, with its position in the unsorted columns
+  struct SortEntry {
+    double time;
+    CompactHash domIndex;
+    uint32_t tieBreak;
+    uint32_t position;
+
+    bool operator<(const SortEntry& rhs) const {
+      if (time!=rhs.time)
+        return time<rhs.time;
+      if (domIndex!=rhs.domIndex)
+        return domIndex<rhs.domIndex;
+      return tieBreak<rhs.tieBreak;
+    };
+  };
+
+  ///reorder a column into the order of 'entries'
+  template <typename T>
+  void Gather(std::vector<T>& column, const std::vector<SortEntry>& entries) {
+    if (column.empty())
+      return;
+    std::vector<T> sorted;
+    sorted.reserve(column.size());
+    BOOST_FOREACH(const SortEntry& e, entries)
+      sorted.push_back(column[e.position]);
+    column.swap(sorted);
+  };
+};
+
+//================ CLASS HitBatch =======================
+
+HitBatch::HitBatch() {};
+
+HitBatch::HitBatch(
+  std::vector<CompactHash>& domIndex,
+  std::vector<double>& time,
+  std::vector<double>& charge,
+  std::vector<uint32_t>& origin)
+{
+  if (domIndex.size()!=time.size()
+    || (!charge.empty() && charge.size()!=time.size())
+    || (!origin.empty() && origin.size()!=time.size()))
+    log_fatal("the columns of a HitBatch must be of the same length");
+  domIndex_.swap(domIndex);
+  time_.swap(time);
+  charge_.swap(charge);
+  origin_.swap(origin);
+  Sort();
+};
+
+void HitBatch::Sort() {
+  //extracted hits are often in order already, like those from an AbsHitSet
+  bool sorted = true;
+  for (size_t i=1; i<time_.size() && sorted; i++) {
+    if (time_[i-1]!=time_[i])
+      sorted = time_[i-1]<time_[i];
+    else if (domIndex_[i-1]!=domIndex_[i])
+      sorted = domIndex_[i-1]<domIndex_[i];
+    else
+      sorted = origin_.empty() || origin_[i-1]<=origin_[i];
+  }
+  if (sorted)
+    return;
+
+  //sort the compact keys, then gather each column once
+  std::vector<SortEntry> entries(time_.size());
+  for (size_t i=0; i<time_.size(); i++) {
+    const SortEntry e = {time_[i], domIndex_[i], origin_.empty() ? uint32_t(i) : origin_[i], uint32_t(i)};
+    entries[i] = e;
+  }
+  std::sort(entries.begin(), entries.end());
+  for (size_t i=0; i<entries.size(); i++) {
+    time_[i] = entries[i].time;
+    domIndex_[i] = entries[i].domIndex;
+  }
+  Gather(charge_, entries);
+  Gather(origin_, entries);
+};
+
+std::ostream& operator<<(std::ostream& oss, const HitBatch& b) {
+  oss << "HitBatch(" <<
+  " size : " << b.size() <<
+  ", charge : " << (b.HasCharge() ? "yes" : "no") <<
+  ", origin : " << (b.HasOrigin() ? "yes" : "no") << " )";
+  return oss;
+};
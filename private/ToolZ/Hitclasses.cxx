@@ -45,6 +45,51 @@ std::ostream& operator<< (std::ostream& oss, const AbsDAQHit& h){
 };
 
 
+//================== class CompactHit =====================
+
+const double CompactHit::losslessRange = 1048576.; //beyond 2^20 ns the spacing of floats exceeds the DAQ tick of 0.1ns
+
+CompactHit::CompactHit(
+  const CompactHash di,
+  const double time,
+  const double timeBase) :
+  domIndex_(di),
+  relTime_(time-timeBase)
+{
+  if (!InLosslessRange(time-timeBase))
+    log_fatal_stream("time "<<time<<" is beyond the lossless range of a CompactHit around the time base "<<timeBase);
+};
+
+CompactHit::CompactHit(
+  const AbsHit& h,
+  const double timeBase) :
+  CompactHit(h.GetDOMIndex(), h.GetTime(), timeBase)
+{};
+
+CompactHit::CompactHit(
+  const AbsDAQHit& h,
+  const double timeBase) :
+  CompactHit(h.GetDOMIndex(), h.GetDAQTicks()/10., timeBase)
+{};
+
+std::ostream& operator<< (std::ostream& oss, const CompactHit& h){
+  oss << "CompactHit(" <<
+  " domIndex : " << h.GetDOMIndex() <<
+  ", relTime : " << h.GetRelativeTime() << " )";
+  return oss;
+};
+
+
+//================ CLASS HitHandle ===================
+
+std::ostream& operator<<(std::ostream& oss, const HitHandle& h) {
+  oss << "HitHandle(" <<
+  " domIndex : " << h.GetDOMIndex() <<
+  ", responseIndex : " << h.GetResponseIndex() << " )";
+  return oss;
+};
+
+
 //================ CLASS Hit ===================
 
 std::ostream& operator<<(std::ostream& oss, const Hit& h) {
@@ -71,3 +116,20 @@ double GetInferredTime<I3MCHit>(const I3MCHit &r)
 template <>
 double GetInferredTime<I3MCPulse>(const I3MCPulse &r)
   {return r.time;};
+
+//specialize the GetCharge() to the ResponseObject
+template <>
+double GetInferredCharge<I3RecoPulse>(const I3RecoPulse &r)
+  {return r.GetCharge();};
+
+template <>
+double GetInferredCharge<I3DOMLaunch>(const I3DOMLaunch &)
+  {log_fatal("I3DOMLaunch carries no charge; the waveforms need to be unfolded first");};
+
+template <>
+double GetInferredCharge<I3MCHit>(const I3MCHit &r)
+  {return r.GetNPE();};
+
+template <>
+double GetInferredCharge<I3MCPulse>(const I3MCPulse &r)
+  {return r.charge;};
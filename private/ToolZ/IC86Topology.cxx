@@ -14,6 +14,14 @@
 
 #include "ToolZ/IC86Topology.h"
 
+#include <boost/make_shared.hpp>
+
+//definitions of the in-class initialized constants, as they might be bound to references
+const unsigned int IC86Topology::N_ICETOP_STRINGS;
+const unsigned int IC86Topology::N_DOMS_ICETOP_STRING;
+const unsigned int IC86Topology::N_DOMS_INICE_STRING;
+const unsigned int IC86Topology::N_DOMS;
+
 bool IC86Topology::IsIceTop(const OMKey& omkey) {
   const unsigned int str = omkey.GetString();
   const unsigned int om = omkey.GetOM();
@@ -69,6 +77,169 @@ bool IC86Topology::IsDeepCoreDense(const OMKey& omkey) {
 }
 
 
+//============ IC86 string and DOM positions ====================
+
+namespace {
+  const double Xic = 125.0; //characteristic inter-string spacing
+  const double Yic = Xic*sqrt(3./4.);
+  const double Xip = Xic/3.; //spacing of the DeepCore infill
+  const double Yip = Yic/3.;
+  
+  const double vspacing_ic = 17.; // 17m OM spacing on regular IC strings
+  const double vspacing_dc_top = 10.; // 10m OM spacing on DC-strings in the top 10 DOMS
+  const double vspacing_dc_bottom = 7.; // 10m OM spacing on DC-strings in the bottom 50 DOMs
+  const double Zsurface = 1948.; //distance from the zero-point to the surface
+  
+  const double OM_zero = 30.; // OM30 lies at z=0
+  
+  const double dc_veto = 190.; //depth of OM1 on DC-strings
+  const double dc_infill = -160.; //depth of OM11 on DC-strings
+  
+  /// XY-position of each string in units of the grid spacing (Xic, Yic) or, for DeepCore strings 79-86, the infill spacing (Xip, Yip)
+  const double string_grid[86][2] = {
+    {  -3.,  -4.}, //1
+    {  -2.,  -4.}, //2
+    {  -1.,  -4.}, //3
+    {   0.,  -4.}, //4
+    {   1.,  -4.}, //5
+    {   2.,  -4.}, //6
+    { -3.5,  -3.}, //7
+    { -2.5,  -3.}, //8
+    { -1.5,  -3.}, //9
+    { -0.5,  -3.}, //10
+    {  0.5,  -3.}, //11
+    {  1.5,  -3.}, //12
+    {  2.5,  -3.}, //13
+    {  -4.,  -2.}, //14
+    {  -3.,  -2.}, //15
+    {  -2.,  -2.}, //16
+    {  -1.,  -2.}, //17
+    {   0.,  -2.}, //18
+    {   1.,  -2.}, //19
+    {   2.,  -2.}, //20
+    {   3.,  -2.}, //21
+    { -4.5,  -1.}, //22
+    { -3.5,  -1.}, //23
+    { -2.5,  -1.}, //24
+    { -1.5,  -1.}, //25
+    { -0.5,  -1.}, //26
+    {  0.5,  -1.}, //27
+    {  1.5,  -1.}, //28
+    {  2.5,  -1.}, //29
+    {  3.5,  -1.}, //30
+    {  -5.,   0.}, //31
+    {  -4.,   0.}, //32
+    {  -3.,   0.}, //33
+    {  -2.,   0.}, //34
+    {  -1.,   0.}, //35
+    {   0.,   0.}, //36
+    {   1.,   0.}, //37
+    {   2.,   0.}, //38
+    {   3.,   0.}, //39
+    {   4.,   0.}, //40
+    { -4.5,   1.}, //41
+    { -3.5,   1.}, //42
+    { -2.5,   1.}, //43
+    { -1.5,   1.}, //44
+    { -0.5,   1.}, //45
+    {  0.5,   1.}, //46
+    {  1.5,   1.}, //47
+    {  2.5,   1.}, //48
+    {  3.5,   1.}, //49
+    {  4.5,   1.}, //50
+    {  -4.,   2.}, //51
+    {  -3.,   2.}, //52
+    {  -2.,   2.}, //53
+    {  -1.,   2.}, //54
+    {   0.,   2.}, //55
+    {   1.,   2.}, //56
+    {   2.,   2.}, //57
+    {   3.,   2.}, //58
+    {   4.,   2.}, //59
+    { -3.5,   3.}, //60
+    { -2.5,   3.}, //61
+    { -1.5,   3.}, //62
+    { -0.5,   3.}, //63
+    {  0.5,   3.}, //64
+    {  1.5,   3.}, //65
+    {  2.5,   3.}, //66
+    {  3.5,   3.}, //67
+    {  -3.,   4.}, //68
+    {  -2.,   4.}, //69
+    {  -1.,   4.}, //70
+    {   0.,   4.}, //71
+    {   1.,   4.}, //72
+    {   2.,   4.}, //73
+    {   3.,   4.}, //74
+    { -2.5,   5.}, //75
+    { -1.5,   5.}, //76
+    { -0.5,   5.}, //77
+    {  0.5,   5.}, //78
+    { -0.5,  -1.}, //79
+    {  0.5,  -1.}, //80
+    {   0.,   2.}, //81
+    {  1.5,   1.}, //82
+    {  1.5,  -1.}, //83
+    {   0.,  -2.}, //84
+    { -1.5,  -1.}, //85
+    { -1.5,   1.}, //86
+  };
+}
+
+I3Position IC86Topology::GetStringPosition(const unsigned int str) {
+  const double* grid = string_grid[str-1];
+  if (str<=78)
+    return I3Position(grid[0]*Xic, grid[1]*Yic, 0.);
+  return I3Position(grid[0]*Xip, grid[1]*Yip, 0.);
+};
+
+I3Position IC86Topology::GetPosition(const OMKey& omkey) {
+  const unsigned int str = omkey.GetString();
+  const unsigned int om = omkey.GetOM();
+  const I3Position pos = GetStringPosition(str);
+  double z;
+  if (om>60) //IceTop tanks rest exactly on top of the strings at the surface
+    z = Zsurface;
+  else if (str<=78)
+    z = (OM_zero-om)*vspacing_ic;
+  else if (om<=10) //its infill DC
+    z = dc_veto-(om*vspacing_dc_top);
+  else
+    z = dc_infill-((om-11)*vspacing_dc_bottom);
+  return I3Position(pos.GetX(), pos.GetY(), z);
+};
+
+namespace {
+  ///all OMKeys of IC86 from the closed-form hashes
+  std::set<OMKey> IC86_OMKeys() {
+    std::set<OMKey> omkeys;
+    for (CompactHash hash=0; hash<IC86Topology::N_DOMS; hash++)
+      omkeys.insert(omkeys.end(), IC86Topology::OMKeyFromHash(hash));
+    return omkeys;
+  };
+  
+  ///all positions of IC86 in the order of the closed-form hashes
+  std::vector<I3Position> IC86_HashedPositions() {
+    std::vector<I3Position> positions;
+    positions.reserve(IC86Topology::N_DOMS);
+    for (CompactHash hash=0; hash<IC86Topology::N_DOMS; hash++)
+      positions.push_back(IC86Topology::GetPosition(IC86Topology::OMKeyFromHash(hash)));
+    return positions;
+  };
+}
+
+CompactOMKeyHashServiceConstPtr IC86Topology::GetHashService() {
+  //NOTE initialization of function-local statics is thread-safe
+  static const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(IC86_OMKeys());
+  return hasher;
+};
+
+PositionServiceConstPtr IC86Topology::GetPositionService() {
+  static const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(GetHashService(), IC86_HashedPositions());
+  return posService;
+};
+
+
 //============ FUNCTION BUILD_IC86_Geometry ====================
 
 I3Geometry IC86Topology::Build_IC86_Geometry () {
@@ -83,166 +254,20 @@ I3Geometry IC86Topology::Build_IC86_Geometry () {
   7. DOMs are spaced 17m in IC, 10/7m in DC
   8. IceTop tanks are located exactly on top of the strings at the surface
   */
-  std::map<unsigned int, I3Position> string_position_map;
-  
-  const double Xic = 125.0;
-  const double Yic = Xic*sqrt(3./4.);
-  const double Xip = Xic/3.;
-  const double Yip = Yic/3.; 
-  
-  string_position_map[ 1]=I3Position(  -3*Xic,-4*Yic, 0.);
-  string_position_map[ 2]=I3Position(  -2*Xic,-4*Yic, 0.);
-  string_position_map[ 3]=I3Position(  -1*Xic,-4*Yic, 0.);
-  string_position_map[ 4]=I3Position(       0,-4*Yic, 0.);
-  string_position_map[ 5]=I3Position(   1*Xic,-4*Yic, 0.);
-  string_position_map[ 6]=I3Position(   2*Xic,-4*Yic, 0.);
-  string_position_map[ 7]=I3Position(-3.5*Xic,-3*Yic, 0.);
-  string_position_map[ 8]=I3Position(-2.5*Xic,-3*Yic, 0.);
-  string_position_map[ 9]=I3Position(-1.5*Xic,-3*Yic, 0.);
-  string_position_map[10]=I3Position(-0.5*Xic,-3*Yic, 0.);
-  string_position_map[11]=I3Position( 0.5*Xic,-3*Yic, 0.);
-  string_position_map[12]=I3Position( 1.5*Xic,-3*Yic, 0.);
-  string_position_map[13]=I3Position( 2.5*Xic,-3*Yic, 0.);
-  string_position_map[14]=I3Position(  -4*Xic,-2*Yic, 0.);
-  string_position_map[15]=I3Position(  -3*Xic,-2*Yic, 0.);
-  string_position_map[16]=I3Position(  -2*Xic,-2*Yic, 0.);
-  string_position_map[17]=I3Position(  -1*Xic,-2*Yic, 0.);
-  string_position_map[18]=I3Position(       0,-2*Yic, 0.);
-  string_position_map[19]=I3Position(   1*Xic,-2*Yic, 0.);
-  string_position_map[20]=I3Position(   2*Xic,-2*Yic, 0.);
-  string_position_map[21]=I3Position(   3*Xic,-2*Yic, 0.);
-  string_position_map[22]=I3Position(-4.5*Xic,-1*Yic, 0.);
-  string_position_map[23]=I3Position(-3.5*Xic,-1*Yic, 0.);
-  string_position_map[24]=I3Position(-2.5*Xic,-1*Yic, 0.);
-  string_position_map[25]=I3Position(-1.5*Xic,-1*Yic, 0.);
-  string_position_map[26]=I3Position(-0.5*Xic,-1*Yic, 0.);
-  string_position_map[27]=I3Position( 0.5*Xic,-1*Yic, 0.);
-  string_position_map[28]=I3Position( 1.5*Xic,-1*Yic, 0.);
-  string_position_map[29]=I3Position( 2.5*Xic,-1*Yic, 0.);
-  string_position_map[30]=I3Position( 3.5*Xic,-1*Yic, 0.);
-  string_position_map[31]=I3Position(  -5*Xic,     0, 0.);
-  string_position_map[32]=I3Position(  -4*Xic,     0, 0.);
-  string_position_map[33]=I3Position(  -3*Xic,     0, 0.);
-  string_position_map[34]=I3Position(  -2*Xic,     0, 0.);
-  string_position_map[35]=I3Position(  -1*Xic,     0, 0.);
-  string_position_map[36]=I3Position(       0,     0, 0.); //center
-  string_position_map[37]=I3Position(   1*Xic,     0, 0.);
-  string_position_map[38]=I3Position(   2*Xic,     0, 0.);
-  string_position_map[39]=I3Position(   3*Xic,     0, 0.);
-  string_position_map[40]=I3Position(   4*Xic,     0, 0.);
-  string_position_map[41]=I3Position(-4.5*Xic, 1*Yic, 0.);
-  string_position_map[42]=I3Position(-3.5*Xic, 1*Yic, 0.);
-  string_position_map[43]=I3Position(-2.5*Xic, 1*Yic, 0.);
-  string_position_map[44]=I3Position(-1.5*Xic, 1*Yic, 0.);
-  string_position_map[45]=I3Position(-0.5*Xic, 1*Yic, 0.);
-  string_position_map[46]=I3Position( 0.5*Xic, 1*Yic, 0.);
-  string_position_map[47]=I3Position( 1.5*Xic, 1*Yic, 0.);
-  string_position_map[48]=I3Position( 2.5*Xic, 1*Yic, 0.);
-  string_position_map[49]=I3Position( 3.5*Xic, 1*Yic, 0.);
-  string_position_map[50]=I3Position( 4.5*Xic, 1*Yic, 0.);
-  string_position_map[51]=I3Position(  -4*Xic, 2*Yic, 0.);
-  string_position_map[52]=I3Position(  -3*Xic, 2*Yic, 0.);
-  string_position_map[53]=I3Position(  -2*Xic, 2*Yic, 0.);
-  string_position_map[54]=I3Position(  -1*Xic, 2*Yic, 0.);
-  string_position_map[55]=I3Position(       0, 2*Yic, 0.);
-  string_position_map[56]=I3Position(   1*Xic, 2*Yic, 0.);
-  string_position_map[57]=I3Position(   2*Xic, 2*Yic, 0.);
-  string_position_map[58]=I3Position(   3*Xic, 2*Yic, 0.);
-  string_position_map[59]=I3Position(   4*Xic, 2*Yic, 0.);
-  string_position_map[60]=I3Position(-3.5*Xic, 3*Yic, 0.);
-  string_position_map[61]=I3Position(-2.5*Xic, 3*Yic, 0.);
-  string_position_map[62]=I3Position(-1.5*Xic, 3*Yic, 0.);
-  string_position_map[63]=I3Position(-0.5*Xic, 3*Yic, 0.);
-  string_position_map[64]=I3Position( 0.5*Xic, 3*Yic, 0.);
-  string_position_map[65]=I3Position( 1.5*Xic, 3*Yic, 0.);
-  string_position_map[66]=I3Position( 2.5*Xic, 3*Yic, 0.);
-  string_position_map[67]=I3Position( 3.5*Xic, 3*Yic, 0.);
-  string_position_map[68]=I3Position(  -3*Xic, 4*Yic, 0.);
-  string_position_map[69]=I3Position(  -2*Xic, 4*Yic, 0.);
-  string_position_map[70]=I3Position(  -1*Xic, 4*Yic, 0.);
-  string_position_map[71]=I3Position(       0, 4*Yic, 0.);
-  string_position_map[72]=I3Position(   1*Xic, 4*Yic, 0.);
-  string_position_map[73]=I3Position(   2*Xic, 4*Yic, 0.);
-  string_position_map[74]=I3Position(   3*Xic, 4*Yic, 0.);
-  string_position_map[75]=I3Position(-2.5*Xic, 5*Yic, 0.);
-  string_position_map[76]=I3Position(-1.5*Xic, 5*Yic, 0.);
-  string_position_map[77]=I3Position(-0.5*Xic, 5*Yic, 0.);
-  string_position_map[78]=I3Position( 0.5*Xic, 5*Yic, 0.);
-  string_position_map[79]=I3Position(-0.5*Xip,-1*Yip, 0.);
-  string_position_map[80]=I3Position( 0.5*Xip,-1*Yip, 0.);
-  string_position_map[81]=I3Position(       0, 2*Yip, 0.);
-  string_position_map[82]=I3Position( 1.5*Xip, 1*Yip, 0.);
-  string_position_map[83]=I3Position( 1.5*Xip,-1*Yip, 0.);
-  string_position_map[84]=I3Position(       0,-2*Yip, 0.);
-  string_position_map[85]=I3Position(-1.5*Xip,-1*Yip, 0.);
-  string_position_map[86]=I3Position(-1.5*Xip, 1*Yip, 0.);
- 
-
-  const double vspacing_ic = 17.; // 17m OM spacing on regular IC strings
-  const double vspacing_dc_top = 10.; // 10m OM spacing on DC-strings in the top 10 DOMS
-  const double vspacing_dc_bottom = 7.; // 10m OM spacing on DC-strings in the bottom 50 DOMs
-  const double Zsurface = 1948.; //distance from the zero-point to the surface
-  
-  const double OM_zero = 30.; // OM30 lies at z=0
-  
-  const double dc_veto = 190.; //depth of OM1 on DC-strings
-  const double dc_infill = -160.; //depth of OM11 on DC-strings
-  //All definitions are done; now work it!
-  
   I3Geometry geometry;
 
   geometry.startTime = I3Time(0,0);
   geometry.endTime = I3Time(0,0);
   I3OMGeoMap &omgeomap = geometry.omgeo;
   
-  for (std::map<unsigned int, I3Position>::const_iterator str_pos_pair = string_position_map.begin(); str_pos_pair!= string_position_map.end(); ++str_pos_pair) {
-    const unsigned int& str = str_pos_pair->first;
-    const I3Position& pos = str_pos_pair->second;
-    if ( 1 <= str && str <= 78) {
-      for (uint om=1; om<=60; ++om) {
-        I3OMGeo omgeo;
-        omgeo.omtype = I3OMGeo::IceCube;
-        omgeo.position = I3Position(pos.GetX(), pos.GetY(), (OM_zero-om)*vspacing_ic);
-        omgeo.orientation = I3Orientation(I3Direction(0, 0),I3Direction(M_PI, 0)); //straight_down
-        omgeo.area = 0.0443999990821;
-        omgeomap[OMKey(str, om)] = omgeo;
-      }
-    }
-    else if ( 79 <= str && str <= 86) { //its infill DC
-      for (unsigned int om=1; om<=10; ++om) {
-        I3OMGeo omgeo;
-        omgeo.omtype = I3OMGeo::IceCube;
-        omgeo.position = I3Position(pos.GetX(), pos.GetY(), dc_veto-(om*vspacing_dc_top));
-        omgeo.orientation = I3Orientation(I3Direction(0, 0),I3Direction(M_PI, 0)); //straight_down
-        omgeo.area = 0.0443999990821;
-        omgeomap[OMKey(str, om)] = omgeo;
-      }
-      
-      for (unsigned int om=11; om<=60; ++om) {
-        I3OMGeo omgeo;
-        omgeo.omtype = I3OMGeo::IceCube;
-        omgeo.position = I3Position(pos.GetX(), pos.GetY(), dc_infill-((om-11)*vspacing_dc_bottom));
-        omgeo.orientation = I3Orientation(I3Direction(0, 0),I3Direction(M_PI, 0)); //straight_down
-        omgeo.area = 0.0443999990821;
-        omgeomap[OMKey(str, om)] = omgeo;
-      }
-    }
-  }
-  
-  //ICETOP
-  for (unsigned int str=1; str<=81; ++str) {
-    const I3Position& pos = string_position_map[str];
-    for (unsigned int om=61; om<=64; om++) {
-      const OMKey omkey(str, om);
-      const I3Position dom_pos(pos.GetX(), pos.GetY(), Zsurface);
-      
-      I3OMGeo omgeo;
-      omgeo.omtype = I3OMGeo::IceTop;
-      omgeo.position = I3Position(dom_pos);
-      omgeo.orientation = I3Orientation(I3Direction(0, 0),I3Direction(M_PI, 0)); //straight_down
-      omgeo.area = 0.0443999990821;
-      omgeomap[OMKey(str, om)] = omgeo;
-    }
+  for (CompactHash hash=0; hash<N_DOMS; hash++) {
+    const OMKey omkey = OMKeyFromHash(hash);
+    I3OMGeo omgeo;
+    omgeo.omtype = IsIceTop(omkey) ? I3OMGeo::IceTop : I3OMGeo::IceCube;
+    omgeo.position = GetPosition(omkey);
+    omgeo.orientation = I3Orientation(I3Direction(0, 0),I3Direction(M_PI, 0)); //straight_down
+    omgeo.area = 0.0443999990821;
+    omgeomap.insert(omgeomap.end(), std::make_pair(omkey, omgeo));
   }
   return geometry;
 };
@@ -17,6 +17,10 @@
 //   I3_SPLIT_SERIALIZABLE(DynamicBitSet);
 // #endif //SERIALIZATION_ENABLED
 
+//================== Layouts ==================
+
+const uint32_t indexmatrix::RowMajorLayout::tag;
+
 //================== CLASS  (A)SymmetricIndexMatrix_Double ==================
 
 indexmatrix::AsymmetricIndexMatrix_Double::AsymmetricIndexMatrix_Double (const unsigned biSize) :
@@ -34,6 +38,369 @@ indexmatrix::SymmetricIndexMatrix_Double::SymmetricIndexMatrix_Double (const uns
 };
 
 
+//================== block access ==================
+
+#if INDEXMATRIX_BITSET_BLOCKS
+namespace {
+  ///receives the address of the blocks of a bitset from boost::to_block_range, instead of a copy of them
+  struct BlockAddress {
+    const boost::dynamic_bitset<>::block_type** address_;
+  };
+}
+
+namespace boost {
+  /**
+   * to_block_range is a friend of dynamic_bitset, which otherwise does not expose its blocks;
+   * this specialization for BlockAddress hands out their address.
+   * NOTE kept in this translation unit, so that it can not interfere with any other use of dynamic_bitset
+   */
+  template <>
+  inline void to_block_range(const dynamic_bitset<>& b, BlockAddress result)
+    {*result.address_ = b.m_bits.empty() ? 0 : &b.m_bits[0];};
+}
+
+const boost::dynamic_bitset<>::block_type* indexmatrix::BitsetBlocks(const boost::dynamic_bitset<>& bits) {
+  const boost::dynamic_bitset<>::block_type* blocks = 0;
+  const BlockAddress result = {&blocks};
+  boost::to_block_range(bits, result);
+  return blocks;
+};
+
+boost::dynamic_bitset<>::block_type* indexmatrix::BitsetBlocks(boost::dynamic_bitset<>& bits) {
+  //the bitset itself is not const, so its blocks may be written
+  return const_cast<boost::dynamic_bitset<>::block_type*>(BitsetBlocks(static_cast<const boost::dynamic_bitset<>&>(bits)));
+};
+#endif //INDEXMATRIX_BITSET_BLOCKS
+
+namespace {
+  typedef boost::dynamic_bitset<>::block_type Block;
+  const size_t bitsPerBlock = boost::dynamic_bitset<>::bits_per_block;
+
+#if INDEXMATRIX_BITSET_BLOCKS
+  ///the value of the bit at this position
+  inline bool TestBit(const Block* blocks, const size_t pos)
+    {return (blocks[pos/bitsPerBlock]>>(pos%bitsPerBlock)) & 1;};
+
+  ///the number of true bits in [pos, pos+length); the partial head and tail blocks are masked
+  size_t CountBits(const Block* blocks, const size_t pos, const size_t length) {
+    if (!length)
+      return 0;
+    const size_t first = pos/bitsPerBlock;
+    const size_t last = (pos+length-1)/bitsPerBlock;
+    const Block head = ~Block(0) << (pos%bitsPerBlock);
+    const Block tail = ~Block(0) >> (bitsPerBlock-1-(pos+length-1)%bitsPerBlock);
+    if (first==last)
+      return __builtin_popcountl(blocks[first] & head & tail);
+    size_t count = __builtin_popcountl(blocks[first] & head);
+    for (size_t b=first+1; b<last; b++)
+      count += __builtin_popcountl(blocks[b]);
+    return count + __builtin_popcountl(blocks[last] & tail);
+  };
+#endif //INDEXMATRIX_BITSET_BLOCKS
+}
+
+//================== CLASS  BitLine ==================
+
+const size_t indexmatrix::BitLine::npos;
+
+indexmatrix::BitLine::BitLine(
+  const BitSet& bits,
+  const size_t biSize,
+  const size_t offset,
+  const size_t contiguous,
+  const size_t fixed,
+  const bool triangular)
+: bits_(&bits),
+  biSize_(biSize),
+  offset_(offset),
+  contiguous_(std::min(contiguous, biSize)),
+  fixed_(fixed),
+  triangular_(triangular)
+{};
+
+size_t indexmatrix::BitLine::FindNext(const size_t index) const {
+  size_t next = index+1;
+  if (next<contiguous_) {
+    //scan the contiguous segment a block at a time
+    const size_t pos = bits_->find_next(offset_+index);
+    if (pos<offset_+contiguous_)
+      return pos-offset_;
+    next = contiguous_;
+  }
+#if INDEXMATRIX_BITSET_BLOCKS
+  const Block* blocks = BitsetBlocks(*bits_);
+  for (; next<biSize_; next++) {
+    if (TestBit(blocks, StridedPosition(next)))
+      return next;
+  }
+#else
+  for (; next<biSize_; next++) {
+    if (bits_->test(StridedPosition(next)))
+      return next;
+  }
+#endif
+  return npos;
+};
+
+size_t indexmatrix::BitLine::Count() const {
+#if INDEXMATRIX_BITSET_BLOCKS
+  const Block* blocks = BitsetBlocks(*bits_);
+  //the contiguous segment a block at a time, the strided segment field by field, stepping from one field to the next
+  size_t count = CountBits(blocks, offset_, contiguous_);
+  size_t pos = StridedPosition(contiguous_);
+  for (size_t index=contiguous_; index<biSize_; index++) {
+    count += TestBit(blocks, pos);
+    pos += triangular_ ? index+1 : biSize_;
+  }
+#else
+  //the true fields of the contiguous segment by scanning, the strided segment field by field
+  size_t count = 0;
+  if (contiguous_) {
+    for (size_t pos=bits_->test(offset_) ? offset_ : bits_->find_next(offset_); pos<offset_+contiguous_; pos=bits_->find_next(pos))
+      count++;
+  }
+  size_t pos = StridedPosition(contiguous_);
+  for (size_t index=contiguous_; index<biSize_; index++) {
+    count += bits_->test(pos);
+    pos += triangular_ ? index+1 : biSize_;
+  }
+#endif
+  return count;
+};
+
+bool indexmatrix::BitLine::Any() const
+  {return FindFirst()!=npos;};
+
+
+//================== boolean matrix algebra ==================
+
+namespace {
+  ///the lhs columns of a block are tabulated in groups of this many bits
+  const size_t tableBits = 8;
+  
+  ///the index of the lowest true bit of a non-zero block
+  inline unsigned LowestBit(const Block block)
+    {return __builtin_ctzl(block);};
+  
+  /**
+   * a square bool matrix stored as full rows, each starting at a block boundary,
+   * so that rows can be combined a block at a time
+   */
+  class RowBits {
+    ///the number of rows and columns
+    size_t n_;
+    ///the number of blocks per row
+    size_t nBlocks_;
+    ///the blocks of all rows
+    std::vector<Block> blocks_;
+  public:
+    RowBits(const size_t n) :
+      n_(n),
+      nBlocks_((n+bitsPerBlock-1)/bitsPerBlock),
+      blocks_(n*nBlocks_, Block(0))
+    {};
+    size_t Size() const {return n_;};
+    size_t NBlocks() const {return nBlocks_;};
+    Block* Row(const size_t a) {return &blocks_[a*nBlocks_];};
+    const Block* Row(const size_t a) const {return &blocks_[a*nBlocks_];};
+    void Set(const size_t a, const size_t b) {Row(a)[b/bitsPerBlock] |= Block(1)<<(b%bitsPerBlock);};
+    bool operator==(const RowBits& rhs) const {return blocks_==rhs.blocks_;};
+    RowBits& operator|=(const RowBits& rhs) {
+      for (size_t i=0; i<blocks_.size(); i++)
+        blocks_[i] |= rhs.blocks_[i];
+      return *this;
+    };
+  };
+  
+  ///copy the bits [pos, pos+length) of a bitset to the start of dest
+  void ReadBits(const std::vector<Block>& src, const size_t pos, const size_t length, Block* dest) {
+    for (size_t w=0; w*bitsPerBlock<length; w++) {
+      const size_t q = (pos+w*bitsPerBlock)/bitsPerBlock;
+      const size_t r = (pos+w*bitsPerBlock)%bitsPerBlock;
+      Block block = src[q]>>r;
+      if (r && q+1<src.size())
+        block |= src[q+1]<<(bitsPerBlock-r);
+      const size_t rest = length-w*bitsPerBlock;
+      if (rest<bitsPerBlock)
+        block &= (Block(1)<<rest)-1;
+      dest[w] = block;
+    }
+  };
+  
+  ///or the first length bits of src into the bits [pos, pos+length) of a bitset
+  void OrBits(const Block* src, const size_t length, std::vector<Block>& dest, const size_t pos) {
+    for (size_t w=0; w*bitsPerBlock<length; w++) {
+      Block block = src[w];
+      const size_t rest = length-w*bitsPerBlock;
+      if (rest<bitsPerBlock)
+        block &= (Block(1)<<rest)-1;
+      const size_t q = (pos+w*bitsPerBlock)/bitsPerBlock;
+      const size_t r = (pos+w*bitsPerBlock)%bitsPerBlock;
+      dest[q] |= block<<r;
+      if (r && q+1<dest.size())
+        dest[q+1] |= block>>(bitsPerBlock-r);
+    }
+  };
+  
+  std::vector<Block> ToBlocks(const boost::dynamic_bitset<>& bits) {
+    std::vector<Block> blocks;
+    blocks.reserve(bits.num_blocks());
+    boost::to_block_range(bits, std::back_inserter(blocks));
+    return blocks;
+  };
+  
+  ///replace the content of a bitset by blocks, keeping its size
+  void AssignBlocks(boost::dynamic_bitset<>& bits, const std::vector<Block>& blocks) {
+    const size_t size = bits.size();
+    bits.clear();
+    bits.append(blocks.begin(), blocks.end());
+    bits.resize(size);
+  };
+  
+  ///expand the packed lower triangle of a symmetric matrix to full rows
+  RowBits FromTriangle(const boost::dynamic_bitset<>& bits, const size_t n) {
+    const std::vector<Block> blocks = ToBlocks(bits);
+    RowBits rows(n);
+    for (size_t a=0; a<n; a++)
+      ReadBits(blocks, (a*a+a)/2, a+1, rows.Row(a));
+    //mirror the lower triangle into the upper triangle
+    for (size_t a=0; a<n; a++) {
+      for (size_t w=0; w*bitsPerBlock<a; w++) {
+        for (Block block=rows.Row(a)[w]; block; block&=block-1) {
+          const size_t b = w*bitsPerBlock+LowestBit(block);
+          if (b<a)
+            rows.Set(b, a);
+        }
+      }
+    }
+    return rows;
+  };
+  
+  ///pack the lower triangle of full rows
+  std::vector<Block> ToTriangle(const RowBits& rows, const size_t nBlocks) {
+    std::vector<Block> blocks(nBlocks, Block(0));
+    for (size_t a=0; a<rows.Size(); a++)
+      OrBits(rows.Row(a), a+1, blocks, (a*a+a)/2);
+    return blocks;
+  };
+  
+  RowBits FromSquare(const boost::dynamic_bitset<>& bits, const size_t n) {
+    const std::vector<Block> blocks = ToBlocks(bits);
+    RowBits rows(n);
+    for (size_t a=0; a<n; a++)
+      ReadBits(blocks, a*n, n, rows.Row(a));
+    return rows;
+  };
+  
+  std::vector<Block> ToSquare(const RowBits& rows, const size_t nBlocks) {
+    std::vector<Block> blocks(nBlocks, Block(0));
+    for (size_t a=0; a<rows.Size(); a++)
+      OrBits(rows.Row(a), rows.Size(), blocks, a*rows.Size());
+    return blocks;
+  };
+  
+  /**
+   * the product of the rows [firstRow, lastRow) by the method of the four Russians:
+   * for each block of lhs-columns, the ors of all combinations of each tableBits rows of rhs are tabulated,
+   * so that a row of the product needs one row-or per non-zero tableBits of lhs, instead of one per true field
+   */
+  void MultiplyRows(const RowBits* lhs, const RowBits* rhs, RowBits* product, const size_t firstRow, const size_t lastRow) {
+    const size_t nBlocks = rhs->NBlocks();
+    const size_t nTables = bitsPerBlock/tableBits;
+    const size_t tableSize = size_t(1)<<tableBits;
+    std::vector<Block> tables(nTables*tableSize*nBlocks, Block(0));
+    
+    for (size_t w=0; w<nBlocks; w++) {
+      bool used = false;
+      for (size_t a=firstRow; a<lastRow && !used; a++)
+        used = lhs->Row(a)[w];
+      if (!used)
+        continue;
+      
+      for (size_t t=0; t<nTables; t++) {
+        Block* table = &tables[t*tableSize*nBlocks];
+        //each combination is the combination without its lowest bit, or'ed with the row of that bit
+        for (size_t v=1; v<tableSize; v++) {
+          const Block* without = table+(v&(v-1))*nBlocks;
+          Block* entry = table+v*nBlocks;
+          const size_t c = w*bitsPerBlock+t*tableBits+LowestBit(v);
+          if (c<rhs->Size()) {
+            const Block* row = rhs->Row(c);
+            for (size_t j=0; j<nBlocks; j++)
+              entry[j] = without[j] | row[j];
+          }
+          else
+            std::copy(without, without+nBlocks, entry);
+        }
+      }
+      
+      for (size_t a=firstRow; a<lastRow; a++) {
+        const Block block = lhs->Row(a)[w];
+        if (!block)
+          continue;
+        Block* out = product->Row(a);
+        for (size_t t=0; t<nTables; t++) {
+          const size_t v = (block>>(t*tableBits)) & (tableSize-1);
+          if (!v)
+            continue;
+          const Block* entry = &tables[(t*tableSize+v)*nBlocks];
+          for (size_t j=0; j<nBlocks; j++)
+            out[j] |= entry[j];
+        }
+      }
+    }
+  };
+  
+  ///the boolean product lhs*rhs, with the rows distributed in contiguous ranges to the threads
+  RowBits Multiply(const RowBits& lhs, const RowBits& rhs, const unsigned nThreads) {
+    const size_t n = lhs.Size();
+    RowBits product(n);
+    size_t nWorkers = nThreads ? nThreads : boost::thread::hardware_concurrency();
+    nWorkers = std::max(size_t(1), std::min(nWorkers, n));
+    
+    if (nWorkers==1)
+      MultiplyRows(&lhs, &rhs, &product, 0, n);
+    else {
+      //each thread writes its own rows
+      boost::thread_group workers;
+      for (size_t t=0; t<nWorkers; t++)
+        workers.create_thread(boost::bind(&MultiplyRows, &lhs, &rhs, &product, n*t/nWorkers, n*(t+1)/nWorkers));
+      workers.join_all();
+    }
+    return product;
+  };
+  
+  ///fields connected by a path of 1 to nSteps true fields, by exponentiation of (matrix or identity) by squaring
+  RowBits ReachableWithin(const RowBits& matrix, const unsigned nSteps, const unsigned nThreads) {
+    if (!nSteps)
+      return RowBits(matrix.Size());
+    //base holds the paths of 0 to 1 steps; its powers the paths of 0 to power steps
+    RowBits base(matrix);
+    for (size_t a=0; a<matrix.Size(); a++)
+      base.Set(a, a);
+    
+    RowBits power(matrix.Size());
+    bool havePower = false;
+    for (unsigned exponent=nSteps-1; exponent; exponent>>=1) {
+      if (exponent&1) {
+        power = havePower ? Multiply(power, base, nThreads) : base;
+        havePower = true;
+      }
+      if (exponent>1) {
+        RowBits square = Multiply(base, base, nThreads);
+        if (square==base) { //saturated: all higher powers are identical
+          power = havePower ? Multiply(power, base, nThreads) : base;
+          havePower = true;
+          break;
+        }
+        base = square;
+      }
+    }
+    return havePower ? Multiply(power, matrix, nThreads) : matrix;
+  };
+}
+
+
 //================== CLASS  (A)SymmetricIndexMatrix_Bool ==================
 
 indexmatrix::SymmetricIndexMatrix_Bool::SymmetricIndexMatrix_Bool (
@@ -48,18 +415,6 @@ indexmatrix::SymmetricIndexMatrix_Bool::SymmetricIndexMatrix_Bool (
   }
 };
 
-indexmatrix::SymmetricIndexMatrix_Bool::SymmetricIndexMatrix_Bool (
-  const unsigned biSize,
-  const boost::function<bool (const uint64_t, const uint64_t)> predicate)
-: SymmetricIndexMatrix<bool, boost::dynamic_bitset<> >(biSize)
-{
-  for (boost::dynamic_bitset<>::size_type index=0; index<internal_.size(); ++index) {
-    std::pair<unsigned, unsigned> one_two = UniIndex_To_BiIndex(index); 
-    //log_debug_stream("EVAL "<<index<<" with "<<one_two.first<<","<<one_two.second<<" as "<<predicate(one_two.first, one_two.second));
-    internal_[index] = predicate(one_two.first, one_two.second);
-  }
-};
-
 indexmatrix::SymmetricIndexMatrix_Bool&
 indexmatrix::SymmetricIndexMatrix_Bool::operator|= (const SymmetricIndexMatrix_Bool& rhs) {
   assert (rhs.biSize_ == biSize_);
@@ -74,6 +429,86 @@ indexmatrix::SymmetricIndexMatrix_Bool::operator&= (const SymmetricIndexMatrix_B
   return *this;
 }
 
+indexmatrix::BitLine
+indexmatrix::SymmetricIndexMatrix_Bool::GetRow(const unsigned indexA) const {
+  //fields (indexA, 0..indexA) are the stored row, fields (indexA+1.., indexA) the stored column
+  return BitLine(internal_, biSize_, (size_t(indexA)*indexA+indexA)/2, size_t(indexA)+1, indexA, true);
+}
+
+indexmatrix::BitLine
+indexmatrix::SymmetricIndexMatrix_Bool::GetColumn(const unsigned indexB) const
+  {return GetRow(indexB);}
+
+indexmatrix::AsymmetricIndexMatrix_Bool
+indexmatrix::SymmetricIndexMatrix_Bool::Multiply(
+  const SymmetricIndexMatrix_Bool& rhs,
+  const unsigned nThreads) const
+{
+  assert (rhs.biSize_ == biSize_);
+  const RowBits product = ::Multiply(FromTriangle(internal_, biSize_), FromTriangle(rhs.internal_, biSize_), nThreads);
+  AsymmetricIndexMatrix_Bool result(biSize_);
+  AssignBlocks(result.internal_, ToSquare(product, result.internal_.num_blocks()));
+  return result;
+}
+
+indexmatrix::SymmetricIndexMatrix_Bool
+indexmatrix::SymmetricIndexMatrix_Bool::ReachableWithin(
+  const unsigned nSteps,
+  const unsigned nThreads) const
+{
+  //all powers of a symmetric matrix are symmetric
+  const RowBits reachable = ::ReachableWithin(FromTriangle(internal_, biSize_), nSteps, nThreads);
+  SymmetricIndexMatrix_Bool result(biSize_);
+  AssignBlocks(result.internal_, ToTriangle(reachable, result.internal_.num_blocks()));
+  return result;
+}
+
+indexmatrix::SymmetricIndexMatrix_Bool
+indexmatrix::SymmetricIndexMatrix_Bool::TransitiveClosure() const {
+  //union-find the clusters over all true fields, which are visited in storage order
+  std::vector<unsigned> parent(biSize_);
+  for (unsigned a=0; a<biSize_; a++)
+    parent[a] = a;
+  std::vector<bool> linked(biSize_, false);
+  
+  size_t indexA = 0;
+  size_t rowStart = 0;
+  for (size_t pos=internal_.find_first(); pos!=boost::dynamic_bitset<>::npos; pos=internal_.find_next(pos)) {
+    while (pos>rowStart+indexA) {
+      rowStart += indexA+1;
+      indexA++;
+    }
+    const size_t indexB = pos-rowStart;
+    linked[indexA] = linked[indexB] = true;
+    
+    unsigned rootA = indexA, rootB = indexB;
+    while (parent[rootA]!=rootA)
+      rootA = parent[rootA] = parent[parent[rootA]];
+    while (parent[rootB]!=rootB)
+      rootB = parent[rootB] = parent[parent[rootB]];
+    parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+  }
+  
+  //the row of every linked member is the set of all members of its cluster
+  RowBits clusters(biSize_);
+  for (unsigned a=0; a<biSize_; a++) {
+    unsigned root = a;
+    while (parent[root]!=root)
+      root = parent[root];
+    parent[a] = root;
+    if (linked[a])
+      clusters.Set(root, a);
+  }
+  SymmetricIndexMatrix_Bool result(biSize_);
+  std::vector<Block> blocks(result.internal_.num_blocks(), Block(0));
+  for (size_t a=0; a<biSize_; a++) {
+    if (linked[a])
+      OrBits(clusters.Row(parent[a]), a+1, blocks, (a*a+a)/2);
+  }
+  AssignBlocks(result.internal_, blocks);
+  return result;
+}
+
 indexmatrix::AsymmetricIndexMatrix_Bool::AsymmetricIndexMatrix_Bool (
   const unsigned biSize,
   const bool setall) 
@@ -85,18 +520,6 @@ indexmatrix::AsymmetricIndexMatrix_Bool::AsymmetricIndexMatrix_Bool (
   }
 };
 
-indexmatrix::AsymmetricIndexMatrix_Bool::AsymmetricIndexMatrix_Bool (
-  const unsigned biSize,
-  const boost::function<bool (const uint64_t, const uint64_t)> predicate)
-: AsymmetricIndexMatrix<bool, boost::dynamic_bitset<> >(biSize)
-{
-  for (boost::dynamic_bitset<>::size_type index=0; index<internal_.size(); ++index) {
-    std::pair<uint64_t, uint64_t> one_two = UniIndex_To_BiIndex(index);
-    //log_debug_stream("EVAL "<<index<<" with "<<one_two.first<<","<<one_two.second<<" as "<<predicate(one_two.first, one_two.second));
-    internal_[index] = predicate(one_two.first, one_two.second);
-  }
-};
-
 indexmatrix::AsymmetricIndexMatrix_Bool&
 indexmatrix::AsymmetricIndexMatrix_Bool::operator|= (const AsymmetricIndexMatrix_Bool& rhs) {
   assert (rhs.biSize_ == biSize_);
@@ -111,6 +534,53 @@ indexmatrix::AsymmetricIndexMatrix_Bool::operator&= (const AsymmetricIndexMatrix
   return *this;
 }    
 
+indexmatrix::BitLine
+indexmatrix::AsymmetricIndexMatrix_Bool::GetRow(const unsigned indexA) const
+  {return BitLine(internal_, biSize_, size_t(indexA)*biSize_, biSize_, 0, false);}
+
+indexmatrix::BitLine
+indexmatrix::AsymmetricIndexMatrix_Bool::GetColumn(const unsigned indexB) const
+  {return BitLine(internal_, biSize_, 0, 0, indexB, false);}
+
+indexmatrix::AsymmetricIndexMatrix_Bool
+indexmatrix::AsymmetricIndexMatrix_Bool::Multiply(
+  const AsymmetricIndexMatrix_Bool& rhs,
+  const unsigned nThreads) const
+{
+  assert (rhs.biSize_ == biSize_);
+  const RowBits product = ::Multiply(FromSquare(internal_, biSize_), FromSquare(rhs.internal_, biSize_), nThreads);
+  AsymmetricIndexMatrix_Bool result(biSize_);
+  AssignBlocks(result.internal_, ToSquare(product, internal_.num_blocks()));
+  return result;
+}
+
+indexmatrix::AsymmetricIndexMatrix_Bool
+indexmatrix::AsymmetricIndexMatrix_Bool::ReachableWithin(
+  const unsigned nSteps,
+  const unsigned nThreads) const
+{
+  const RowBits reachable = ::ReachableWithin(FromSquare(internal_, biSize_), nSteps, nThreads);
+  AsymmetricIndexMatrix_Bool result(biSize_);
+  AssignBlocks(result.internal_, ToSquare(reachable, internal_.num_blocks()));
+  return result;
+}
+
+indexmatrix::AsymmetricIndexMatrix_Bool
+indexmatrix::AsymmetricIndexMatrix_Bool::TransitiveClosure(const unsigned nThreads) const {
+  //each squaring doubles the length of the paths covered
+  RowBits closure = FromSquare(internal_, biSize_);
+  while (true) {
+    RowBits extended = ::Multiply(closure, closure, nThreads);
+    extended |= closure;
+    if (extended==closure)
+      break;
+    closure = extended;
+  }
+  AsymmetricIndexMatrix_Bool result(biSize_);
+  AssignBlocks(result.internal_, ToSquare(closure, internal_.num_blocks()));
+  return result;
+}
+
 #if SERIALIZATION_ENABLED
   I3_SERIALIZABLE(indexmatrix::AsymmetricIndexMatrix_Double);
   I3_SERIALIZABLE(indexmatrix::SymmetricIndexMatrix_Double);
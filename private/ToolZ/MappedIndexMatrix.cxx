@@ -0,0 +1,135 @@
+/**
+ * \file MappedIndexMatrix.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Read-only IndexMatrix storage backed by a memory-mapped file
+ */
+
+#include "ToolZ/MappedIndexMatrix.h"
+
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace indexmatrix;
+
+//=================== CLASS MappedFile ===========
+
+MappedFile::MappedFile(const std::string& path) :
+  address_(MAP_FAILED),
+  length_(0)
+{
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd<0)
+    log_fatal_stream("can not open "<<path);
+  struct stat st;
+  if (fstat(fd, &st) || size_t(st.st_size)<sizeof(MappedFileHeader)) {
+    close(fd);
+    log_fatal_stream(path<<" is no mapped matrix file");
+  }
+  length_ = st.st_size;
+  address_ = mmap(NULL, length_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); //the mapping holds its own reference to the file
+  if (address_==MAP_FAILED)
+    log_fatal_stream("can not map "<<path);
+
+  const MappedFileHeader& header = GetHeader();
+  const MappedFileHeader reference = MappedFileHeader::Create<char>(false, 0, 0, 0, 0);
+  const char* error = NULL;
+  if (std::memcmp(header.magic, reference.magic, sizeof(header.magic)))
+    error = " is no mapped matrix file";
+  else if (header.byteOrder!=reference.byteOrder)
+    error = " was written with another byte-order";
+  else if (header.version!=mappedindexmatrix_version_)
+    error = " has an unsupported version";
+  else if (header.dataOffset<sizeof(MappedFileHeader) || header.dataOffset>length_
+    || header.nFields>(length_-header.dataOffset)/std::max(header.fieldSize, uint32_t(1)))
+    error = " is truncated";
+  if (error) {
+    munmap(address_, length_);
+    log_fatal_stream(path<<error);
+  }
+};
+
+MappedFile::~MappedFile()
+  {munmap(address_, length_);};
+
+const MappedFileHeader& MappedFile::GetHeader() const
+  {return *static_cast<const MappedFileHeader*>(address_);};
+
+const void* MappedFile::GetFields() const
+  {return static_cast<const char*>(address_)+GetHeader().dataOffset;};
+
+
+//=================== CLASS MappedFileWriter ===========
+
+MappedFileWriter::MappedFileWriter(const std::string& path) :
+  path_(path),
+  tmpPath_(path+".XXXXXX"),
+  fd_(-1)
+{
+  //a unique name in the same directory, so that concurrent writers do not share it, and the rename stays on the filesystem
+  std::vector<char> name(tmpPath_.begin(), tmpPath_.end());
+  name.push_back('\0');
+  fd_ = mkstemp(&name[0]);
+  if (fd_<0)
+    log_fatal_stream("can not write "<<path_);
+  tmpPath_ = &name[0];
+  //mkstemp creates the file private to the user; the matrix is to be mapped by other processes as well
+  fchmod(fd_, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+};
+
+MappedFileWriter::~MappedFileWriter() {
+  if (fd_>=0) {
+    close(fd_);
+    unlink(tmpPath_.c_str());
+  }
+};
+
+void MappedFileWriter::Write(const void* data, const size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  size_t written = 0;
+  while (written<size) {
+    const ssize_t n = write(fd_, bytes+written, size-written);
+    if (n<0 && errno==EINTR)
+      continue;
+    if (n<=0)
+      log_fatal_stream("can not write "<<tmpPath_);
+    written += n;
+  }
+};
+
+void MappedFileWriter::Commit() {
+  const int fd = fd_;
+  fd_ = -1;
+  if (close(fd) || std::rename(tmpPath_.c_str(), path_.c_str())) {
+    unlink(tmpPath_.c_str());
+    log_fatal_stream("can not write "<<path_);
+  }
+};
+
+
+//=================== free functions ===========
+
+void indexmatrix::VerifyMappedFile(
+  const std::string& path,
+  const MappedFileHeader& found,
+  const MappedFileHeader& expected)
+{
+  if (found.fieldSize!=expected.fieldSize || found.fieldKind!=expected.fieldKind)
+    log_fatal_stream(path<<" holds fields of another type");
+  if (found.symmetric!=expected.symmetric || found.layout!=expected.layout)
+    log_fatal_stream(path<<" holds a matrix of another symmetry or layout");
+  if (found.nFields!=expected.nFields)
+    log_fatal_stream(path<<" holds "<<found.nFields<<" fields instead of "<<expected.nFields);
+  if (found.checksum!=expected.checksum)
+    log_fatal_stream(path<<" was built from another geometry");
+};
@@ -0,0 +1,100 @@
+/**
+ * \file NeighbourIndex.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Lists for each hashed DOM all DOMs within a fixed radius, ordered by distance
+ */
+
+#include "ToolZ/NeighbourIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+//=================== CLASS NeighbourIndex ===========
+
+NeighbourIndex::NeighbourIndex(
+  const HashedGeometryConstPtr& hashedGeo,
+  const double radius,
+  const Constraint constraint)
+: hasher_(hashedGeo->GetHashService()),
+  radius_(radius),
+  constraint_(constraint)
+{
+  Build(*hashedGeo->GetPosService());
+};
+
+NeighbourIndex::NeighbourIndex(
+  const PositionServiceConstPtr& posService,
+  const double radius,
+  const Constraint constraint)
+: hasher_(posService->GetHashService()),
+  radius_(radius),
+  constraint_(constraint)
+{
+  Build(*posService);
+};
+
+void NeighbourIndex::Build(const PositionService& posService) {
+  if (radius_<0.)
+    log_fatal("The radius of a NeighbourIndex must not be negative");
+
+  const CompactHash n = hasher_->HashSize();
+  const PositionService::CoordinateVector& z = posService.GetZ();
+
+  std::vector<int> strings;
+  if (constraint_==StringOnly) {
+    strings.reserve(n);
+    for (CompactHash j=0; j<n; j++)
+      strings.push_back(hasher_->OMKeyFromHash(j).GetString());
+  }
+
+  offsets_.reserve(n+1);
+  offsets_.push_back(0);
+
+  std::vector<double> dist(n);
+  std::vector<std::pair<double, CompactHash> > row;
+  for (CompactHash a=0; a<n; a++) {
+    row.clear();
+    if (constraint_==ZOnly) {
+      for (CompactHash j=0; j<n; j++) {
+        const double dz = std::fabs(z[j]-z[a]);
+        if (dz<=radius_ && j!=a)
+          row.push_back(std::make_pair(dz, j));
+      }
+    }
+    else {
+      posService.DistancesFrom(posService.GetPosition(a), &dist[0]);
+      for (CompactHash j=0; j<n; j++) {
+        if (dist[j]<=radius_ && j!=a && (constraint_!=StringOnly || strings[j]==strings[a]))
+          row.push_back(std::make_pair(dist[j], j));
+      }
+    }
+    //order by distance, ties by hash
+    std::sort(row.begin(), row.end());
+
+    for (std::vector<std::pair<double, CompactHash> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+      distances_.push_back(it->first);
+      neighbours_.push_back(it->second);
+    }
+    offsets_.push_back(neighbours_.size());
+  }
+  neighbours_.shrink_to_fit();
+  distances_.shrink_to_fit();
+};
+
+NeighbourIndex::NeighbourRange
+NeighbourIndex::GetNeighboursWithin(
+  const CompactHash a,
+  const double radius) const
+{
+  if (radius>radius_)
+    log_fatal("Can not query neighbours within a larger radius than the radius of the NeighbourIndex");
+
+  const DistanceRange distances = GetDistances(a);
+  const double* last = std::upper_bound(distances.begin(), distances.end(), radius);
+  const CompactHash* first = neighbours_.data()+offsets_[a];
+  return NeighbourRange(first, first+(last-distances.begin()));
+};
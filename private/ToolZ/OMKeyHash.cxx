@@ -11,6 +11,9 @@
  */
 
 #include "ToolZ/OMKeyHash.h"
+#include "ToolZ/HashedOMKeySet.h"
+
+#include <algorithm>
 
 #include <boost/foreach.hpp>
 
@@ -31,9 +34,14 @@ ExtractOMKeys(
 
 CompactOMKeyHashService::CompactOMKeyHashService() {};
 
+CompactOMKeyHashService::LookupTable::LookupTable()
+: minString_(0), minOM_(0), minPMT_(0),
+  nStrings_(0), nOMs_(0), nPMTs_(0)
+{};
+
 bool CompactOMKeyHashService::VerifyAgainst(const std::set<OMKey>& omkeys) const {
   BOOST_FOREACH(const OMKey& omkey, omkeys) {
-    if (! hashmap_.count(omkey)) {
+    if (! HoldsOMKey(omkey)) {
       log_error("Provided OMKey set contains more DOMs than this hasher is currently encoding"); 
       return false;
     }
@@ -41,15 +49,90 @@ bool CompactOMKeyHashService::VerifyAgainst(const std::set<OMKey>& omkeys) const
   log_debug_stream("sets are congruent");
   return true;
 };
+
+bool CompactOMKeyHashService::VerifyAgainst(const HashedOMKeySet& omkeys) const {
+  const CompactOMKeyHashServiceConstPtr other = omkeys.GetHasher();
+  if (other.get()==this) //everything in the set is hashed by construction
+    return true;
+  
+  //mark all hashes of the other hasher which are also held here by merge-walking the sorted omkeyvecs
+  HashedOMKeySet::BitSet held(other->HashSize());
+  std::vector<OMKey>::const_iterator this_iter = omkeyvec_.begin();
+  for (CompactHash hash=0; hash<other->omkeyvec_.size() && this_iter!=omkeyvec_.end(); hash++) {
+    const OMKey& omkey = other->omkeyvec_[hash];
+    while (this_iter!=omkeyvec_.end() && *this_iter<omkey)
+      ++this_iter;
+    if (this_iter!=omkeyvec_.end() && !(omkey<*this_iter))
+      held.set(hash);
+  }
+  
+  if (! omkeys.GetBits().is_subset_of(held)) {
+    log_error("Provided OMKey set contains more DOMs than this hasher is currently encoding"); 
+    return false;
+  }
+  log_debug_stream("sets are congruent");
+  return true;
+};
   
 CompactOMKeyHashService::CompactOMKeyHashService(const std::set<OMKey> omkeys)
 : omkeyvec_(omkeys.begin(), omkeys.end()),
-  hashmap_(HashMap_From_OMKeyVec(omkeyvec_))
+  lookup_(LookupTable_From_OMKeyVec(omkeyvec_)),
+  hashmap_(HashMap_From_OMKeyVec(omkeyvec_, lookup_))
 {};
 
+CompactOMKeyHashService::LookupTable
+CompactOMKeyHashService::LookupTable_From_OMKeyVec(const std::vector<OMKey>& omkeyvec) {
+  LookupTable lookup;
+  if (omkeyvec.empty())
+    return lookup;
+  
+  //find the bounding box
+  int minString = omkeyvec.front().GetString(), maxString = minString;
+  unsigned int minOM = omkeyvec.front().GetOM(), maxOM = minOM;
+  unsigned int minPMT = omkeyvec.front().GetPMT(), maxPMT = minPMT;
+  BOOST_FOREACH(const OMKey &omkey, omkeyvec) {
+    minString = std::min(minString, omkey.GetString());
+    maxString = std::max(maxString, omkey.GetString());
+    minOM = std::min(minOM, omkey.GetOM());
+    maxOM = std::max(maxOM, omkey.GetOM());
+    minPMT = std::min(minPMT, (unsigned int)omkey.GetPMT());
+    maxPMT = std::max(maxPMT, (unsigned int)omkey.GetPMT());
+  }
+  
+  const uint64_t nStrings = uint64_t(int64_t(maxString)-minString)+1;
+  const uint64_t nOMs = uint64_t(maxOM-minOM)+1;
+  const uint64_t nPMTs = uint64_t(maxPMT-minPMT)+1;
+  const uint64_t tableSize = nStrings*nOMs*nPMTs;
+  //do not tabulate very sparse keyspaces; leave the table empty and fall back to the hashmap
+  if (tableSize > uint64_t(lookup_max_sparsity_)*omkeyvec.size() + 1024) {
+    log_debug_stream("OMKey space too sparse for a dense lookup table; falling back to map");
+    return lookup;
+  }
+  
+  lookup.minString_ = minString;
+  lookup.minOM_ = minOM;
+  lookup.minPMT_ = minPMT;
+  lookup.nStrings_ = nStrings;
+  lookup.nOMs_ = nOMs;
+  lookup.nPMTs_ = nPMTs;
+  lookup.table_.assign(tableSize, INVALID_HASH);
+  CompactHash hash_iter = 0;
+  BOOST_FOREACH(const OMKey &omkey, omkeyvec) {
+    const uint64_t index = (uint64_t(omkey.GetString()-minString)*nOMs + (omkey.GetOM()-minOM))*nPMTs + (omkey.GetPMT()-minPMT);
+    lookup.table_[index] = hash_iter;
+    hash_iter++;
+  }
+  return lookup;
+};
+
 std::map<OMKey, CompactHash>
-CompactOMKeyHashService::HashMap_From_OMKeyVec(const std::vector<OMKey>& omkeyvec) {
+CompactOMKeyHashService::HashMap_From_OMKeyVec(
+  const std::vector<OMKey>& omkeyvec,
+  const LookupTable& lookup) 
+{
   std::map<OMKey, CompactHash> hashmap;
+  if (!lookup.Empty()) //no need for the map, table is in use
+    return hashmap;
   CompactHash hash_iter = 0;
   BOOST_FOREACH(const OMKey &omkey, omkeyvec) {
     hashmap.insert(std::make_pair(omkeyvec.at(hash_iter), hash_iter));
@@ -9,4 +9,32 @@
  * \author mzoll <marcel.zoll@fysik.su.se>
  */
 
-#include "ToolZ/PartialCOG.h"
\ No newline at end of file
+#include "ToolZ/PartialCOG.h"
+
+
+//_____________________________________________________________________________
+I3PosTime ComputeCOG(
+  const PositionServiceConstPtr& posService,
+  const HitSpan& hits,
+  const bool useCharge)
+{
+  if (useCharge && hits.size && !hits.charge)
+    log_fatal("the HitSpan holds no charges");
+  
+  const double* x = &posService->GetX()[0];
+  const double* y = &posService->GetY()[0];
+  const double* z = &posService->GetZ()[0];
+  
+  double sum_weight(0.), sum_time(0.), sum_x(0.), sum_y(0.), sum_z(0.);
+  for (size_t i=0; i<hits.size; i++) {
+    const double weight = useCharge ? hits.charge[i] : 1.;
+    const CompactHash dom = hits.domIndex[i];
+    sum_weight += weight;
+    sum_time += hits.time[i]*weight;
+    sum_x += x[dom]*weight;
+    sum_y += y[dom]*weight;
+    sum_z += z[dom]*weight;
+  }
+  
+  return std::make_pair(I3Position(sum_x/sum_weight, sum_y/sum_weight, sum_z/sum_weight), sum_time/sum_weight);
+};
@@ -9,20 +9,28 @@
  */
 
 #include "ToolZ/PositionService.h"
+#include "ToolZ/HashedGeometryRegistry.h"
+#include "ToolZ/FNV1a.h"
 
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 #include <algorithm>
+#include <cassert>
 #include <vector>
 
+#if defined(__AVX__) || defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
 //=================== CLASS PositionService ===========
 
 PositionService::PositionService(
   const I3OMGeoMap& omgeo,
   CompactOMKeyHashServiceConstPtr& hasher)
-: hasher_(hasher ? hasher : boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(omgeo))),
-  hashedPosition_(ConstructHashedPositions(omgeo))
+: hasher_(hasher ? hasher : HashedGeometryRegistry::GetHashService(ExtractOMKeys(omgeo))),
+  x_(), y_(), z_()
 {
+  SetHashedPositions(ConstructHashedPositions(omgeo));
   if (!hasher)
     hasher = hasher_;
 };
@@ -31,17 +39,20 @@ PositionService::PositionService(
   const I3OMGeoMap& omgeo,
   const CompactOMKeyHashServiceConstPtr& hasher)
 : hasher_(hasher),
-  hashedPosition_(ConstructHashedPositions(omgeo))
-{};
+  x_(), y_(), z_()
+{
+  SetHashedPositions(ConstructHashedPositions(omgeo));
+};
 
-#if SERIALIZATION_ENABLED
-  PositionService::PositionService(
-    const CompactOMKeyHashServiceConstPtr& hasher,
-    const std::vector<I3Position>& hashedPosition)
-  : hasher_(hasher),
-    hashedPosition_(hashedPosition)
-  {};
-#endif //SERIALIZATION_ENABLED
+PositionService::PositionService(
+  const CompactOMKeyHashServiceConstPtr& hasher,
+  const std::vector<I3Position>& hashedPosition)
+: hasher_(hasher),
+  x_(), y_(), z_()
+{
+  assert(hashedPosition.size()==hasher_->HashSize());
+  SetHashedPositions(hashedPosition);
+};
     
 std::vector<I3Position> PositionService::ConstructHashedPositions (
   const I3OMGeoMap& omgeo) const 
@@ -53,17 +64,36 @@ std::vector<I3Position> PositionService::ConstructHashedPositions (
   return hashedPosition;
 };
 
+void PositionService::SetHashedPositions(const std::vector<I3Position>& hashedPosition) {
+  x_.resize(hashedPosition.size());
+  y_.resize(hashedPosition.size());
+  z_.resize(hashedPosition.size());
+  for (size_t i=0; i<hashedPosition.size(); i++) {
+    x_[i] = hashedPosition[i].GetX();
+    y_[i] = hashedPosition[i].GetY();
+    z_[i] = hashedPosition[i].GetZ();
+  }
+};
+
+std::vector<I3Position> PositionService::GetHashedPositions() const {
+  std::vector<I3Position> hashedPosition;
+  hashedPosition.reserve(x_.size());
+  for (size_t i=0; i<x_.size(); i++)
+    hashedPosition.push_back(I3Position(x_[i], y_[i], z_[i]));
+  return hashedPosition;
+};
+
 bool PositionService::VerifyAgainst(
   const I3OMGeoMap& omgeo) const 
 {
-  for (uint64_t i=0; i<hashedPosition_.size(); i++) {
+  for (uint64_t i=0; i<x_.size(); i++) {
     const OMKey omkey = hasher_->OMKeyFromHash(i);
     const I3OMGeoMap::const_iterator geo_entry = omgeo.find(omkey);
     if (geo_entry == omgeo.end()) {
       log_error("Do not verify against each other");
       return false;
     }
-    if (hashedPosition_.at(i) != omgeo.at(omkey).position) {
+    if (GetPosition(i) != geo_entry->second.position) {
       log_error("Do not verify against each other");
       return false;
     }
@@ -71,6 +101,68 @@ bool PositionService::VerifyAgainst(
   return true;
 }
 
+uint64_t PositionService::GetChecksum() const {
+  uint64_t hash = fnv1a::offset_basis;
+  for (CompactHash i=0; i<x_.size(); i++) {
+    fnv1a::FoldIn(hash, hasher_->OMKeyFromHash(i));
+    fnv1a::FoldIn(hash, x_[i]);
+    fnv1a::FoldIn(hash, y_[i]);
+    fnv1a::FoldIn(hash, z_[i]);
+  }
+  return hash;
+};
+
+void PositionService::DistancesFrom(
+  const I3Position& pos,
+  double* dist) const
+{
+  DistancesFrom(pos, x_.data(), y_.data(), z_.data(), x_.size(), dist);
+};
+
+void PositionService::DistancesFrom(
+  const I3Position& pos,
+  const double* x,
+  const double* y,
+  const double* z,
+  const size_t n,
+  double* dist)
+{
+  const double px = pos.GetX();
+  const double py = pos.GetY();
+  const double pz = pos.GetZ();
+  size_t i = 0;
+#if defined(__AVX__)
+  const __m256d vpx = _mm256_set1_pd(px);
+  const __m256d vpy = _mm256_set1_pd(py);
+  const __m256d vpz = _mm256_set1_pd(pz);
+  for (; i+4<=n; i+=4) {
+    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x+i), vpx);
+    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y+i), vpy);
+    const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z+i), vpz);
+    const __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx,dx), _mm256_mul_pd(dy,dy)), _mm256_mul_pd(dz,dz));
+    _mm256_storeu_pd(dist+i, _mm256_sqrt_pd(d2));
+  }
+#elif defined(__SSE2__)
+  const __m128d vpx = _mm_set1_pd(px);
+  const __m128d vpy = _mm_set1_pd(py);
+  const __m128d vpz = _mm_set1_pd(pz);
+  for (; i+2<=n; i+=2) {
+    const __m128d dx = _mm_sub_pd(_mm_loadu_pd(x+i), vpx);
+    const __m128d dy = _mm_sub_pd(_mm_loadu_pd(y+i), vpy);
+    const __m128d dz = _mm_sub_pd(_mm_loadu_pd(z+i), vpz);
+    const __m128d d2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx,dx), _mm_mul_pd(dy,dy)), _mm_mul_pd(dz,dz));
+    _mm_storeu_pd(dist+i, _mm_sqrt_pd(d2));
+  }
+#endif
+  //remainder, or everything on platforms without SIMD support
+  for (; i<n; i++) {
+    const double dx = x[i]-px;
+    const double dy = y[i]-py;
+    const double dz = z[i]-pz;
+    dist[i] = std::sqrt(dx*dx+dy*dy+dz*dz);
+  }
+};
+
 #if SERIALIZATION_ENABLED
   I3_SERIALIZABLE(PositionService);
 #endif
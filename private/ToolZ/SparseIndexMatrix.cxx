@@ -0,0 +1,18 @@
+/**
+ * \file SparseIndexMatrix.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Two dimensional matrices, which store only the fields differing from a default value
+ */
+
+#include "ToolZ/SparseIndexMatrix.h"
+
+#if SERIALIZATION_ENABLED
+  I3_SERIALIZABLE(indexmatrix::SparseSymmetricIndexMatrix_Double);
+  I3_SERIALIZABLE(indexmatrix::SparseAsymmetricIndexMatrix_Double);
+  I3_SERIALIZABLE(indexmatrix::SparseSymmetricIndexMatrix_Bool);
+  I3_SERIALIZABLE(indexmatrix::SparseAsymmetricIndexMatrix_Bool);
+#endif
@@ -0,0 +1,120 @@
+/**
+ * \file StringDistanceService.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Computes distances between hashed DOMs from a compact string-factored representation
+ */
+
+#include "ToolZ/StringDistanceService.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#if defined(__AVX__) || defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+//=================== CLASS StringDistanceService ===========
+
+StringDistanceService::StringDistanceService(
+  const PositionServiceConstPtr& posService,
+  const double tolerance)
+: hasher_(posService->GetHashService()),
+  posService_(posService),
+  tolerance_(tolerance),
+  nColumns_(0),
+  maxOffset_(0.),
+  column_(hasher_->HashSize())
+{
+  const PositionService::CoordinateVector& x = posService_->GetX();
+  const PositionService::CoordinateVector& y = posService_->GetY();
+
+  //group the DOMs of each string into columns; a DOM joins the first column of its string,
+  //whose first DOM is within the tolerance, otherwise it starts a new column
+  std::map<int, std::vector<unsigned> > stringColumns;
+  std::vector<double> firstX, firstY, sumDX, sumDY;
+  std::vector<unsigned> nMembers;
+  for (CompactHash i=0; i<hasher_->HashSize(); i++) {
+    std::vector<unsigned>& columns = stringColumns[hasher_->OMKeyFromHash(i).GetString()];
+    std::vector<unsigned>::const_iterator column = columns.begin();
+    while (column!=columns.end() && std::hypot(x[i]-firstX[*column], y[i]-firstY[*column])>tolerance_)
+      ++column;
+    if (column!=columns.end())
+      column_[i] = *column;
+    else {
+      if (nColumns_>std::numeric_limits<uint16_t>::max())
+        log_fatal("Too many columns; the DOMs do not sit on strings");
+      column_[i] = nColumns_;
+      columns.push_back(nColumns_);
+      firstX.push_back(x[i]);
+      firstY.push_back(y[i]);
+      sumDX.push_back(0.);
+      sumDY.push_back(0.);
+      nMembers.push_back(0);
+      nColumns_++;
+    }
+    sumDX[column_[i]] += x[i]-firstX[column_[i]];
+    sumDY[column_[i]] += y[i]-firstY[column_[i]];
+    nMembers[column_[i]]++;
+  }
+
+  //every column sits at the mean position of its DOMs; averaged as offsets to the first DOM, so that ideal strings are exact
+  std::vector<double> columnX(nColumns_), columnY(nColumns_);
+  for (unsigned c=0; c<nColumns_; c++) {
+    columnX[c] = firstX[c]+sumDX[c]/nMembers[c];
+    columnY[c] = firstY[c]+sumDY[c]/nMembers[c];
+  }
+  for (CompactHash i=0; i<hasher_->HashSize(); i++)
+    maxOffset_ = std::max(maxOffset_, std::hypot(x[i]-columnX[column_[i]], y[i]-columnY[column_[i]]));
+
+  horizontalDist2_.resize(nColumns_*nColumns_);
+  for (unsigned c=0; c<nColumns_; c++) {
+    for (unsigned d=0; d<nColumns_; d++) {
+      const double dx = columnX[c]-columnX[d];
+      const double dy = columnY[c]-columnY[d];
+      horizontalDist2_[c*nColumns_+d] = float(dx*dx+dy*dy);
+    }
+  }
+};
+
+void StringDistanceService::DistancesFrom(
+  const CompactHash a,
+  double* dist) const
+{
+  const size_t n = column_.size();
+  const double* z = posService_->GetZ().data();
+  const double za = z[a];
+  const float* row = &horizontalDist2_[column_[a]*nColumns_];
+
+  //squared distances; the row of horizontal distances is gathered by column
+  for (size_t j=0; j<n; j++) {
+    const double dz = z[j]-za;
+    dist[j] = row[column_[j]] + dz*dz;
+  }
+
+  size_t j = 0;
+#if defined(__AVX__)
+  for (; j+4<=n; j+=4)
+    _mm256_storeu_pd(dist+j, _mm256_sqrt_pd(_mm256_loadu_pd(dist+j)));
+#elif defined(__SSE2__)
+  for (; j+2<=n; j+=2)
+    _mm_storeu_pd(dist+j, _mm_sqrt_pd(_mm_loadu_pd(dist+j)));
+#endif
+  //remainder, or everything on platforms without SIMD support
+  for (; j<n; j++)
+    dist[j] = std::sqrt(dist[j]);
+};
+
+bool StringDistanceService::VerifyAgainst(
+  const I3OMGeoMap& omgeo) const
+{
+  return posService_->VerifyAgainst(omgeo);
+};
+
+#if SERIALIZATION_ENABLED
+  I3_SERIALIZABLE(StringDistanceService);
+#endif
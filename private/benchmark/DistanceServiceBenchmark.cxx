@@ -0,0 +1,99 @@
+/**
+ * \file DistanceServiceBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the precomputation of the DistanceService; not part of the unit tests
+ */
+#include <I3Test.h>
+
+#include "ToolZ/DistanceService.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+TEST_GROUP(DistanceServiceBenchmark)
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+static PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo,hasher); 
+
+///time the precomputation of all distances
+static void BenchmarkHashAllDistances(const PositionServiceConstPtr& ps, const std::string& name) {
+  const unsigned nThreads = boost::thread::hardware_concurrency();
+  
+  const DistanceServiceConstPtr ds_single = boost::make_shared<const DistanceService>(ps);
+  I3RUsageTimer timer_single;
+  timer_single.Start();
+  ds_single->HashAllDistances(1);
+  timer_single.Stop();
+  
+  const DistanceServiceConstPtr ds_multi = boost::make_shared<const DistanceService>(ps);
+  I3RUsageTimer timer_multi;
+  timer_multi.Start();
+  ds_multi->HashAllDistances();
+  timer_multi.Stop();
+  
+  ENSURE_EQUAL(ds_single->GetDistance(0, ps->GetHashService()->HashSize()-1), ds_multi->GetDistance(0, ps->GetHashService()->HashSize()-1));
+  
+  log_info_stream("HashAllDistances on "<<name<<" ("<<ps->GetHashService()->HashSize()<<" DOMs):"
+    <<" 1 thread "<<timer_single.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" "<<nThreads<<" threads "<<timer_multi.GetTotalRUsage()->wallclocktime/1E6<<" ms");
+};
+
+TEST(Benchmark_HashAllDistances) {
+  BenchmarkHashAllDistances(posService, "IC86");
+  
+  //a synthetic Gen2-like geometry of 10k DOMs
+  std::set<OMKey> omkeys;
+  std::vector<I3Position> positions;
+  for (unsigned i=1; i<=125; i++) {
+    for (unsigned j=1; j<=80; j++) {
+      omkeys.insert(omkeys.end(), OMKey(i,j));
+      positions.push_back(I3Position(240.*(i%12), 240.*(i/12), -17.*j));
+    }
+  }
+  const CompactOMKeyHashServiceConstPtr synth_hasher = boost::make_shared<const CompactOMKeyHashService>(omkeys);
+  BenchmarkHashAllDistances(boost::make_shared<const PositionService>(synth_hasher, positions), "synthetic 10k");
+}
+
+#if SERIALIZATION_ENABLED
+TEST(Benchmark_Serialize_cache){
+  const uint64_t n = hasher->HashSize();
+  I3RUsageTimer timer_compute;
+  timer_compute.Start();
+  const DistanceServicePtr ds_save = boost::make_shared<DistanceService>(posService, true);
+  ds_save->HashAllDistances(1);
+  timer_compute.Stop();
+  
+  I3RUsageTimer timer_save;
+  timer_save.Start();
+  std::stringstream ss;
+  {
+    SERIALIZATION_NS_BASE::archive::portable_binary_oarchive oa(ss);
+    const DistanceServiceConstPtr ds = ds_save;
+    oa << ds;
+  }
+  timer_save.Stop();
+  
+  I3RUsageTimer timer_load;
+  timer_load.Start();
+  DistanceServiceConstPtr ds_load;
+  {
+    SERIALIZATION_NS_BASE::archive::portable_binary_iarchive ia(ss);
+    ia >> ds_load;
+  }
+  timer_load.Stop();
+  ENSURE_EQUAL(ds_load->GetNCached(), ds_save->GetNCached());
+  
+  log_info_stream("persisted distance cache of IC86 ("<<n<<" DOMs): archive "<<ss.str().size()/1E6<<" MB,"
+    <<" recompute "<<timer_compute.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" save "<<timer_save.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" load "<<timer_load.GetTotalRUsage()->wallclocktime/1E6<<" ms");
+};
+#endif //SERIALIZATION_ENABLED
@@ -0,0 +1,96 @@
+/**
+ * \file FlatSetBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the sorted-vector FlatSet against std::set in the hit kernels and set-algorithms; not part of the unit tests
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/FlatSet.h"
+#include "ToolZ/SetHelpers.h"
+#include "ToolZ/HitFacility.h"
+#include "ToolZ/PartialCOG.h"
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <boost/make_shared.hpp>
+
+#include "test/TestHelpers.h"
+
+TEST_GROUP(FlatSetBenchmark);
+
+typedef FlatSet<int> IntFlatSet;
+typedef std::set<int> IntSet;
+
+///n pseudo-random numbers in [0, range), unsorted and with repetitions
+static std::vector<int> RandomInts(const unsigned n, const unsigned range, const uint64_t seed) {
+  TestRandom random(seed);
+  std::vector<int> ints;
+  for (unsigned i=0; i<n; i++)
+    ints.push_back(random.Uniform(range));
+  return ints;
+};
+
+TEST (Benchmark) {
+  const I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+  const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo, hasher);
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(GenerateTestRecoPulses()));
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  const unsigned n_rounds = 5;
+
+  //extraction and a COG over all hits
+  double sum_set(0.), sum_flat(0.);
+  I3RUsageTimer timer_set, timer_flat;
+  timer_set.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    sum_set += ComputeCOG(posService, hf.GetAbsHits<AbsHitSet>()).second;
+  timer_set.Stop();
+  timer_flat.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    sum_flat += ComputeCOG(posService, hf.GetAbsHits<AbsHitFlatSet>()).second;
+  timer_flat.Stop();
+  ENSURE_DISTANCE(sum_flat, sum_set, 1E-9*sum_set);
+
+  //intersection of a few hits with many, balanced and unbalanced
+  const std::vector<int> many = RandomInts(100000, 1000000, 7);
+  const std::vector<int> few = RandomInts(100, 1000000, 8);
+  const std::vector<int> other = RandomInts(100000, 1000000, 9);
+  const IntSet set_many(many.begin(), many.end()), set_few(few.begin(), few.end()), set_other(other.begin(), other.end());
+  const IntFlatSet flat_many(many.begin(), many.end()), flat_few(few.begin(), few.end()), flat_other(other.begin(), other.end());
+  const unsigned n_isect = 20;
+  unsigned count_set(0), count_flat(0);
+  I3RUsageTimer timer_isect_set, timer_isect_flat, timer_gallop_set, timer_gallop_flat;
+  timer_isect_set.Start();
+  for (unsigned r=0; r<n_isect; r++)
+    count_set += SetsIntersectionCount(set_many, set_other);
+  timer_isect_set.Stop();
+  timer_isect_flat.Start();
+  for (unsigned r=0; r<n_isect; r++)
+    count_flat += SetsIntersectionCount(flat_many, flat_other);
+  timer_isect_flat.Stop();
+  timer_gallop_set.Start();
+  for (unsigned r=0; r<n_isect; r++)
+    count_set += SetsIntersectionCount(set_few, set_many);
+  timer_gallop_set.Stop();
+  timer_gallop_flat.Start();
+  for (unsigned r=0; r<n_isect; r++)
+    count_flat += SetsIntersectionCount(flat_few, flat_many);
+  timer_gallop_flat.Stop();
+  ENSURE_EQUAL(count_flat, count_set);
+
+  log_info_stream("extract and COG of "<<hf.GetAbsHits<AbsHitSet>().size()<<" hits: "
+    <<" AbsHitSet "<<timer_set.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms,"
+    <<" AbsHitFlatSet "<<timer_flat.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms;"
+    <<" intersection count "<<set_many.size()<<" x "<<set_other.size()<<":"
+    <<" std::set "<<timer_isect_set.GetTotalRUsage()->wallclocktime/1E6/n_isect<<" ms,"
+    <<" FlatSet "<<timer_isect_flat.GetTotalRUsage()->wallclocktime/1E6/n_isect<<" ms;"
+    <<" "<<set_few.size()<<" x "<<set_many.size()<<":"
+    <<" std::set "<<timer_gallop_set.GetTotalRUsage()->wallclocktime/1E6/n_isect<<" ms,"
+    <<" FlatSet (galloping) "<<timer_gallop_flat.GetTotalRUsage()->wallclocktime/1E6/n_isect<<" ms");
+};
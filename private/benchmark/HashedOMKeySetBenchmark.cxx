@@ -0,0 +1,67 @@
+/**
+ * \file HashedOMKeySetBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the set-algebra of the bitset-backed OMKey sets against their std::set<OMKey> equivalents; not part of the unit tests
+ */
+
+#include "ToolZ/HashedOMKeySet.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+#include "ToolZ/SetHelpers.h"
+
+#include <I3Test.h>
+#include <boost/make_shared.hpp>
+#include <boost/foreach.hpp>
+
+TEST_GROUP(HashedOMKeySetBenchmark);
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+
+///every n-th OMKey of the geometry, starting at offset
+static std::set<OMKey> EveryNth(const unsigned n, const unsigned offset) {
+  std::set<OMKey> omkeys;
+  unsigned i=0;
+  BOOST_FOREACH(const I3OMGeoMap::value_type& omkey_omgeo, geo->omgeo) {
+    if (i++%n==offset)
+      omkeys.insert(omkeys.end(), omkey_omgeo.first);
+  }
+  return omkeys;
+};
+
+TEST(Benchmark_SetAlgebra) {
+  const unsigned n_rounds = 1000;
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+  const std::set<OMKey> a_omkeys = EveryNth(2, 0);
+  const std::set<OMKey> b_omkeys = EveryNth(3, 0);
+  const HashedOMKeySet a(hasher, a_omkeys);
+  const HashedOMKeySet b(hasher, b_omkeys);
+
+  size_t count_set = 0;
+  I3RUsageTimer timer_set;
+  timer_set.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    count_set += UniteSets(a_omkeys, b_omkeys).size();
+    count_set += SetsIntersectionCount(a_omkeys, b_omkeys);
+  }
+  timer_set.Stop();
+
+  size_t count_bits = 0;
+  I3RUsageTimer timer_bits;
+  timer_bits.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    count_bits += (a|b).Count();
+    count_bits += a.IntersectionCount(b);
+  }
+  timer_bits.Stop();
+
+  ENSURE_EQUAL(count_set, count_bits, "both methods compute identical");
+
+  log_info_stream("union+intersection on IC86 ("<<a.Count()<<" and "<<b.Count()<<" DOMs): "
+    <<" std::set<OMKey> "<<timer_set.GetTotalRUsage()->wallclocktime/n_rounds<<" ns,"
+    <<" HashedOMKeySet "<<timer_bits.GetTotalRUsage()->wallclocktime/n_rounds<<" ns");
+};
@@ -0,0 +1,102 @@
+/**
+ * \file HitBatchBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the HitBatch against the set-based hit containers it replaces in the kernels; not part of the unit tests
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/HitBatch.h"
+#include "ToolZ/HitFacility.h"
+#include "ToolZ/PartialCOG.h"
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <boost/make_shared.hpp>
+
+#include "test/TestHelpers.h"
+
+TEST_GROUP(HitBatchBenchmark);
+
+static const I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+static const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo, hasher);
+
+///a pulse map with 'nPerDOM' pulses of random time and charge on every in-ice DOM, time-ordered per DOM
+static I3RecoPulseSeriesMap RandomPulses(const unsigned nPerDOM) {
+  TestRandom random(42);
+  I3RecoPulseSeriesMap pulseMap;
+  for (unsigned str=1; str<=86; str++) {
+    for (unsigned om=1; om<=60; om++) {
+      std::vector<double> times;
+      for (unsigned k=0; k<nPerDOM; k++) {
+        times.push_back(double(random.Next()>>38)/64.); //multiples of 1/64 ns, so that some times coincide
+      }
+      std::sort(times.begin(), times.end());
+      BOOST_FOREACH(const double t, times)
+        pulseMap[OMKey(str,om)].push_back(MakeRecoPulse(t, 0.25+double(uint64_t(t)%16)/4.));
+    }
+  }
+  return pulseMap;
+};
+
+///a facility over 'pulseMap', hashed by the IC86 geometry
+static I3RecoPulseSeriesMap_HitFacility MakeFacility(const I3RecoPulseSeriesMap& pulseMap) {
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(pulseMap));
+  const CompactOMKeyHashServiceConstPtr& constHasher = hasher;
+  return I3RecoPulseSeriesMap_HitFacility(frame, "KEY", constHasher);
+};
+
+TEST (Benchmark) {
+  const I3RecoPulseSeriesMap pulseMap = RandomPulses(20);
+  const I3RecoPulseSeriesMap_HitFacility hf = MakeFacility(pulseMap);
+  const unsigned n_rounds = 10;
+
+  //extraction from the map
+  I3RUsageTimer timer_extract_set, timer_extract_batch;
+  timer_extract_set.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    hf.GetAbsHits<AbsHitSet>();
+  timer_extract_set.Stop();
+  timer_extract_batch.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    hf.GetHitBatch();
+  timer_extract_batch.Stop();
+
+  const AbsHitSet set = hf.GetAbsHits<AbsHitSet>();
+  const HitBatch batch = hf.GetHitBatch();
+
+  //the COG of every time window of 1 us
+  double sum_set(0.), sum_batch(0.);
+  I3RUsageTimer timer_cog_set, timer_cog_batch;
+  timer_cog_set.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    for (double begin=0.; begin<1E6; begin+=1E3) {
+      AbsHitSet window(set.lower_bound(AbsHit(0, begin)), set.lower_bound(AbsHit(0, begin+1E3)));
+      if (!window.empty())
+        sum_set += ComputeCOG(posService, window).first.GetZ();
+    }
+  }
+  timer_cog_set.Stop();
+  timer_cog_batch.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    for (double begin=0.; begin<1E6; begin+=1E3) {
+      const HitSpan window = batch.GetSpan().TimeWindow(begin, begin+1E3);
+      if (window.size)
+        sum_batch += ComputeCOG(posService, window).first.GetZ();
+    }
+  }
+  timer_cog_batch.Stop();
+  ENSURE_DISTANCE(sum_batch, sum_set, 1E-6*std::abs(sum_set));
+
+  log_info_stream(batch.size()<<" hits, per round:"
+    <<" extract AbsHitSet "<<timer_extract_set.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms,"
+    <<" HitBatch "<<timer_extract_batch.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms;"
+    <<" COG of 1000 time windows over AbsHitSet "<<timer_cog_set.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms,"
+    <<" over HitSpan "<<timer_cog_batch.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms");
+};
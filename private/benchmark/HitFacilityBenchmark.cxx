@@ -0,0 +1,86 @@
+/**
+ * \file HitFacilityBenchmark.cxx
+ *
+ * (c) 2013 the IceCube Collaboration
+ *
+ * \author mzoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the extraction and back-conversion of hits by a HitFacility; not part of the unit tests
+ */
+
+#include "ToolZ/HitFacility.h"
+#include "ToolZ/I3RUsageTimer.h"
+#include "test/TestHelpers.h"
+
+#include <I3Test.h>
+
+#include <boost/make_shared.hpp>
+
+using namespace HitSorting;
+
+TEST_GROUP(HitFacilityBenchmark);
+
+///Time the back-conversion of hits with handles against the former retrieval-ordered set
+TEST(Benchmark) {
+  const I3RecoPulseSeriesMap recoMap= GenerateTestRecoPulses();
+
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(recoMap));
+  
+  CompactOMKeyHashServiceConstPtr hasher;
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  const HitSet hits = hf.GetHits<HitSet>();
+  const unsigned n_rounds = 10;
+  
+  I3RUsageTimer timer_ro, timer_handles;
+  size_t n_ro(0), n_handles(0);
+  timer_ro.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    I3RecoPulseSeriesMap responseMap;
+    const HitSetRO ro_hits(hits.begin(), hits.end());
+    BOOST_FOREACH(const Hit& h, ro_hits) {
+      const I3RecoPulse_HitObject& ho = h.GetAssociatedHitObject<I3RecoPulse>();
+      responseMap[ho.GetOMKey()].push_back(ho.GetResponseObj());
+    }
+    n_ro += responseMap.size();
+  }
+  timer_ro.Stop();
+  timer_handles.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    n_handles += hf.MapFromHits(hits).size();
+  timer_handles.Stop();
+  ENSURE_EQUAL(n_handles, n_ro);
+  
+  log_info_stream(hits.size()<<" hits, MapFromHits per round:"
+    <<" by retrieval-ordered set "<<timer_ro.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms,"
+    <<" by handles "<<timer_handles.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms");
+};
+
+///Time the extraction of CompactHits against AbsHits
+TEST(Benchmark_CompactHits) {
+  const I3RecoPulseSeriesMap recoMap= GenerateTestRecoPulses();
+
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(recoMap));
+  
+  CompactOMKeyHashServiceConstPtr hasher;
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  const double timeBase = hf.GetTimeBase();
+  const unsigned n_rounds = 10;
+  
+  I3RUsageTimer timer_abs, timer_compact;
+  size_t n_abs(0), n_compact(0);
+  timer_abs.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    n_abs += hf.GetAbsHits<AbsHitFlatSet>().size();
+  timer_abs.Stop();
+  timer_compact.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    n_compact += hf.GetCompactHits<CompactHitFlatSet>(timeBase).size();
+  timer_compact.Stop();
+  ENSURE_EQUAL(n_compact, n_abs);
+  
+  log_info_stream(n_abs/n_rounds<<" hits, extraction into a sorted vector per round:"
+    <<" AbsHit "<<timer_abs.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms, "<<n_abs/n_rounds*sizeof(AbsHit)/1E6<<" MB;"
+    <<" CompactHit "<<timer_compact.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms, "<<n_compact/n_rounds*sizeof(CompactHit)/1E6<<" MB");
+};
@@ -0,0 +1,56 @@
+/**
+ * \file HitSortingBenchmark.cxx
+ *
+ * (c) 2013 the IceCube Collaboration
+ *
+ * \author mzoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the conversion of HitObjects back into an OMKeyMap; not part of the unit tests
+ */
+
+#include "ToolZ/HitSorting.h"
+#include "ToolZ/I3RUsageTimer.h"
+#include "test/TestHelpers.h"
+
+#include <I3Test.h>
+
+#include <boost/make_shared.hpp>
+
+using namespace HitSorting;
+
+TEST_GROUP(HitSortingBenchmark);
+
+///Time the in-place sort of HitObjects into retrieval order against the insertion into a set
+TEST(Benchmark) {
+  typedef std::vector<HitObject<I3RecoPulse> > HitObjectSeries;
+  typedef std::set<HitObject<I3RecoPulse>, HitObject<I3RecoPulse>::RetrievalOrdered> HitObjectSetRO;
+  
+  const I3RecoPulseSeriesMap pulseMap = GenerateTestRecoPulses();
+  HitObjectSeries hitObjs = OMKeyMap_To_HitObjects<I3RecoPulse, HitObjectSeries>(pulseMap);
+  //shuffle; the HitObjects can be swapped in place
+  TestRandom random(1);
+  for (size_t i=hitObjs.size()-1; i>0; i--)
+    std::swap(hitObjs[i], hitObjs[random.Uniform(i+1)]);
+  const unsigned n_rounds = 10;
+  
+  I3RUsageTimer timer_set, timer_sort;
+  I3RecoPulseSeriesMap map_set, map_sort;
+  timer_set.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    map_set.clear();
+    const HitObjectSetRO ro_ho(hitObjs.begin(), hitObjs.end());
+    BOOST_FOREACH(const HitObject<I3RecoPulse>& ho, ro_ho)
+      map_set[ho.GetOMKey()].push_back(ho.GetResponseObj());
+  }
+  timer_set.Stop();
+  timer_sort.Start();
+  for (unsigned r=0; r<n_rounds; r++)
+    map_sort = HitObjects_To_OMKeyMap<I3RecoPulse>(hitObjs);
+  timer_sort.Stop();
+  ENSURE(map_sort==map_set);
+  ENSURE(map_sort==pulseMap);
+  
+  log_info_stream(hitObjs.size()<<" HitObjects, HitObjects_To_OMKeyMap per round:"
+    <<" by set insertion "<<timer_set.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms,"
+    <<" by in-place sort "<<timer_sort.GetTotalRUsage()->wallclocktime/1E6/n_rounds<<" ms");
+};
@@ -0,0 +1,520 @@
+/**
+ * \file IndexMatrixBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the two dimensional matrices; not part of the unit tests
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/IndexMatrix.h"
+#include "ToolZ/TiledLayout.h"
+#include "ToolZ/I3RUsageTimer.h"
+#include "test/TestHelpers.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <malloc.h>
+
+using namespace indexmatrix;
+using namespace std;
+
+TEST_GROUP(IndexMatrixBenchmark);
+
+///the former design of the matrices, kept as reference for the benchmark:
+///the index conversion is a virtual call, where the symmetric one recurses once to order the indices
+class VirtualIndexMatrix {
+protected:
+  const unsigned biSize_;
+  std::vector<uint16_t> internal_;
+  virtual unsigned BiIndex_To_UniIndex(const unsigned indexA, const unsigned indexB) const = 0;
+public:
+  VirtualIndexMatrix(const unsigned biSize, const unsigned mapSize) : biSize_(biSize), internal_(mapSize) {};
+  virtual ~VirtualIndexMatrix() {};
+  uint16_t Get(const unsigned indexA, const unsigned indexB) const
+    {return internal_[BiIndex_To_UniIndex(indexA, indexB)];};
+  void Set(const unsigned indexA, const unsigned indexB, const uint16_t value)
+    {internal_[BiIndex_To_UniIndex(indexA, indexB)] = value;};
+};
+
+class VirtualSymmetricIndexMatrix : public VirtualIndexMatrix {
+  unsigned BiIndex_To_UniIndex(const unsigned indexA, const unsigned indexB) const {
+    if (indexB > indexA)
+      return BiIndex_To_UniIndex(indexB, indexA);
+    return (indexA*indexA+indexA)/2+indexB;
+  };
+public:
+  VirtualSymmetricIndexMatrix(const unsigned biSize) : VirtualIndexMatrix(biSize, (biSize*biSize+biSize)/2) {};
+};
+
+///time Get at pseudo-random pairs, the lookup pattern of the DistanceService, for both designs
+static void BenchmarkGet(const unsigned biSize) {
+  const unsigned n_queries = 4000000;
+  
+  const boost::shared_ptr<VirtualIndexMatrix> virtual_matrix = boost::make_shared<VirtualSymmetricIndexMatrix>(biSize);
+  SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > static_matrix(biSize);
+  
+  std::vector<std::pair<unsigned, unsigned> > pairs;
+  TestRandom random(1);
+  for (unsigned q=0; q<4096; q++) {
+    const uint64_t state = random.Next();
+    pairs.push_back(std::make_pair((state>>33)%biSize, (state>>13)%biSize));
+    static_matrix.Set(pairs.back().first, pairs.back().second, q%100);
+    virtual_matrix->Set(pairs.back().first, pairs.back().second, q%100);
+  }
+  
+  size_t sum_virtual = 0;
+  I3RUsageTimer timer_virtual;
+  timer_virtual.Start();
+  for (unsigned q=0; q<n_queries; q++)
+    sum_virtual += virtual_matrix->Get(pairs[q%4096].first, pairs[q%4096].second);
+  timer_virtual.Stop();
+  
+  size_t sum_static = 0;
+  I3RUsageTimer timer_static;
+  timer_static.Start();
+  for (unsigned q=0; q<n_queries; q++)
+    sum_static += static_matrix.Get(pairs[q%4096].first, pairs[q%4096].second);
+  timer_static.Stop();
+  
+  ENSURE_EQUAL(sum_virtual, sum_static, "both designs access identical fields");
+  
+  log_info_stream("SymmetricIndexMatrix<uint16_t>::Get on "<<biSize<<"x"<<biSize<<":"
+    <<" virtual dispatch "<<timer_virtual.GetTotalRUsage()->wallclocktime/n_queries<<" ns/access,"
+    <<" static dispatch "<<timer_static.GetTotalRUsage()->wallclocktime/n_queries<<" ns/access");
+};
+
+TEST (Benchmark_Get) {
+  BenchmarkGet(5484); //all DOMs of IC86; the matrix exceeds the caches
+  BenchmarkGet(128); //a matrix that stays in cache, where the access overhead dominates
+};
+
+///a predicate which is true for a pseudo-random half of the pairs, symmetric in its arguments
+struct HashPredicate {
+  bool operator() (const uint64_t index_A, const uint64_t index_B) const {
+    const uint64_t low = std::min(index_A, index_B);
+    const uint64_t high = std::max(index_A, index_B);
+    return ((high*2654435761ULL) ^ (low*40503ULL)) & 0x10;
+  };
+};
+
+///find the row of a linear index of the symmetric layout by a linear search, as formerly done
+static std::pair<unsigned, unsigned> LinearSearch_UniIndex_To_BiIndex(const uint64_t index) {
+  uint64_t indexA=0;
+  while ((indexA*indexA+indexA)/2 <= index)
+    indexA++;
+  indexA--;
+  return std::make_pair(indexA, index-(indexA*indexA+indexA)/2);
+};
+
+TEST (Benchmark_Bool_Predicate) {
+  const HashPredicate hp;
+  
+  //former construction: invert every linear index by a linear search; O(n^3)
+  const unsigned small_size = 1000;
+  SymmetricIndexMatrix_Bool simb_former(small_size);
+  I3RUsageTimer timer_former;
+  timer_former.Start();
+  for (uint64_t index=0; index<(small_size*small_size+small_size)/2; index++) {
+    const std::pair<unsigned, unsigned> AB = LinearSearch_UniIndex_To_BiIndex(index);
+    simb_former.Set(AB.first, AB.second, hp(AB.first, AB.second));
+  }
+  timer_former.Stop();
+  
+  I3RUsageTimer timer_small;
+  timer_small.Start();
+  const SymmetricIndexMatrix_Bool simb_small(small_size, hp);
+  timer_small.Stop();
+  
+  for (unsigned index_A=0; index_A<small_size; index_A+=7) {
+    for (unsigned index_B=0; index_B<small_size; index_B++)
+      ENSURE_EQUAL(simb_former.Get(index_A, index_B), simb_small.Get(index_A, index_B));
+  }
+  
+  //all DOMs of IC86
+  const unsigned large_size = 5484;
+  const unsigned nThreads = boost::thread::hardware_concurrency();
+  I3RUsageTimer timer_single;
+  timer_single.Start();
+  const SymmetricIndexMatrix_Bool simb_single(large_size, hp, 1);
+  timer_single.Stop();
+  
+  I3RUsageTimer timer_multi;
+  timer_multi.Start();
+  const SymmetricIndexMatrix_Bool simb_multi(large_size, hp, 0);
+  timer_multi.Stop();
+  
+  ENSURE_EQUAL(simb_single.Get(large_size-1, 17), simb_multi.Get(large_size-1, 17));
+  
+  log_info_stream("SymmetricIndexMatrix_Bool from predicate:"
+    <<" "<<small_size<<" per-element inversion "<<timer_former.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" row-wise "<<timer_small.GetTotalRUsage()->wallclocktime/1E6<<" ms;"
+    <<" "<<large_size<<" row-wise 1 thread "<<timer_single.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" "<<nThreads<<" threads "<<timer_multi.GetTotalRUsage()->wallclocktime/1E6<<" ms");
+};
+
+///the true fields are a band of width 2*40 around the diagonal
+struct BandPredicate {
+  bool operator() (const uint64_t index_A, const uint64_t index_B) const 
+    {return (index_A>index_B ? index_A-index_B : index_B-index_A)<=40;};
+};
+
+///time enumerating the true fields of all rows element-wise and by BitLine
+template <class Matrix>
+static void BenchmarkRowEnumeration(const Matrix& m, const std::string& name) {
+  const unsigned biSize = m.GetBiSize();
+  
+  size_t count_get = 0;
+  I3RUsageTimer timer_get;
+  timer_get.Start();
+  for (unsigned index_A=0; index_A<biSize; index_A++) {
+    for (unsigned index_B=0; index_B<biSize; index_B++)
+      count_get += m.Get(index_A, index_B);
+  }
+  timer_get.Stop();
+  
+  size_t count_line = 0;
+  I3RUsageTimer timer_line;
+  timer_line.Start();
+  for (unsigned index_A=0; index_A<biSize; index_A++) {
+    const BitLine row = m.GetRow(index_A);
+    for (BitLine::const_iterator it=row.begin(); it!=row.end(); ++it)
+      count_line++;
+  }
+  timer_line.Stop();
+  
+  size_t count_count = 0;
+  I3RUsageTimer timer_count;
+  timer_count.Start();
+  for (unsigned index_A=0; index_A<biSize; index_A++)
+    count_count += m.GetRow(index_A).Count();
+  timer_count.Stop();
+  
+  ENSURE_EQUAL(count_get, count_line, "both methods enumerate identical");
+  ENSURE_EQUAL(count_get, count_count, "both methods count identical");
+  
+  log_info_stream("enumerate the true fields of all rows of a "<<biSize<<"x"<<biSize<<" "<<name<<" ("<<count_line/biSize<<" per row):"
+    <<" element-wise Get "<<timer_get.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" BitLine "<<timer_line.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" BitLine::Count "<<timer_count.GetTotalRUsage()->wallclocktime/1E6<<" ms");
+};
+
+TEST (Benchmark_RowEnumeration) {
+  //sparse neighbourhood-like matrices over all DOMs of IC86
+  BenchmarkRowEnumeration(SymmetricIndexMatrix_Bool(5484, BandPredicate()), "SymmetricIndexMatrix_Bool");
+  BenchmarkRowEnumeration(AsymmetricIndexMatrix_Bool(5484, BandPredicate()), "AsymmetricIndexMatrix_Bool");
+};
+
+///sum the fields of a matrix in three access patterns
+template <class Matrix>
+static std::vector<double> BenchmarkAccessPatterns(const unsigned biSize, std::vector<size_t>& sums) {
+  const unsigned tile = 64;
+  Matrix m(biSize);
+  for (unsigned a=0; a<biSize; a++) {
+    for (unsigned b=0; b<=a; b++)
+      m.Set(a, b, (a+b)%100);
+  }
+  std::vector<double> times;
+  
+  //random pairs all over the matrix, as from hits of an unordered event
+  const size_t n_random = 4000000;
+  size_t sum = 0;
+  TestRandom random(1);
+  I3RUsageTimer timer_random;
+  timer_random.Start();
+  for (size_t q=0; q<n_random; q++) {
+    const uint64_t state = random.Next();
+    sum += m.Get((state>>33)%biSize, (state>>13)%biSize);
+  }
+  timer_random.Stop();
+  sums.push_back(sum);
+  times.push_back(timer_random.GetTotalRUsage()->wallclocktime/n_random);
+  
+  //the whole triangle row after row
+  const size_t n_fields = size_t(biSize)*(biSize+1)/2;
+  sum = 0;
+  I3RUsageTimer timer_rows;
+  timer_rows.Start();
+  for (unsigned a=0; a<biSize; a++) {
+    for (unsigned b=0; b<=a; b++)
+      sum += m.Get(a, b);
+  }
+  timer_rows.Stop();
+  sums.push_back(sum);
+  times.push_back(timer_rows.GetTotalRUsage()->wallclocktime/n_fields);
+  
+  //the whole triangle in blocks of nearby indices, as pairs of hits clustered in time and space
+  sum = 0;
+  I3RUsageTimer timer_blocks;
+  timer_blocks.Start();
+  for (unsigned tileA=0; tileA<biSize; tileA+=tile) {
+    for (unsigned tileB=0; tileB<=tileA; tileB+=tile) {
+      for (unsigned a=tileA; a<std::min(tileA+tile, biSize); a++) {
+        for (unsigned b=tileB; b<std::min(tileB+tile, a+1); b++)
+          sum += m.Get(a, b);
+      }
+    }
+  }
+  timer_blocks.Stop();
+  sums.push_back(sum);
+  times.push_back(timer_blocks.GetTotalRUsage()->wallclocktime/n_fields);
+  return times;
+};
+
+TEST (Benchmark_TiledLayout) {
+  const unsigned biSize = 5484; //all DOMs of IC86; the matrix exceeds the caches
+  std::vector<size_t> sums_flat, sums_tiled;
+  const std::vector<double> flat =
+    BenchmarkAccessPatterns<SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > >(biSize, sums_flat);
+  const std::vector<double> tiled =
+    BenchmarkAccessPatterns<TiledSymmetricIndexMatrix<uint16_t, std::vector<uint16_t> >::type>(biSize, sums_tiled);
+  ENSURE(sums_flat==sums_tiled, "both layouts hold identical fields");
+  
+  log_info_stream("SymmetricIndexMatrix<uint16_t>::Get on "<<biSize<<"x"<<biSize<<", RowMajorLayout vs TiledLayout<64>:"
+    <<" random "<<flat[0]<<" vs "<<tiled[0]<<" ns/access,"
+    <<" row-major sweep "<<flat[1]<<" vs "<<tiled[1]<<" ns/access,"
+    <<" block-ordered sweep "<<flat[2]<<" vs "<<tiled[2]<<" ns/access");
+};
+
+///the product by the definition, element by element
+template <class Lhs, class Rhs>
+static std::vector<std::vector<bool> > NaiveProduct(const Lhs& lhs, const Rhs& rhs, const unsigned size) {
+  std::vector<std::vector<bool> > product(size, std::vector<bool>(size, false));
+  for (unsigned index_A=0; index_A<size; index_A++) {
+    for (unsigned index_B=0; index_B<size; index_B++) {
+      for (unsigned index_C=0; index_C<size && !product[index_A][index_B]; index_C++)
+        product[index_A][index_B] = lhs.Get(index_A, index_C) && rhs.Get(index_C, index_B);
+    }
+  }
+  return product;
+};
+
+template <class Matrix>
+static void CheckEqual(const Matrix& m, const std::vector<std::vector<bool> >& reference) {
+  for (unsigned index_A=0; index_A<reference.size(); index_A++) {
+    for (unsigned index_B=0; index_B<reference.size(); index_B++)
+      ENSURE_EQUAL(m.Get(index_A, index_B), bool(reference[index_A][index_B]));
+  }
+};
+
+TEST (Benchmark_Bool_Product) {
+  const unsigned small_size = 500;
+  const SymmetricIndexMatrix_Bool small_band(small_size, BandPredicate());
+  
+  I3RUsageTimer timer_naive;
+  timer_naive.Start();
+  const std::vector<std::vector<bool> > naive = NaiveProduct(small_band, small_band, small_size);
+  timer_naive.Stop();
+  
+  I3RUsageTimer timer_small;
+  timer_small.Start();
+  const AsymmetricIndexMatrix_Bool small_product = small_band.Multiply(small_band);
+  timer_small.Stop();
+  CheckEqual(small_product, naive);
+  
+  const unsigned large_size = 5484; //all DOMs of IC86
+  const SymmetricIndexMatrix_Bool band(large_size, BandPredicate());
+  
+  I3RUsageTimer timer_single;
+  timer_single.Start();
+  const AsymmetricIndexMatrix_Bool product_single = band.Multiply(band, 1);
+  timer_single.Stop();
+  
+  I3RUsageTimer timer_multi;
+  timer_multi.Start();
+  const AsymmetricIndexMatrix_Bool product_multi = band.Multiply(band, 0);
+  timer_multi.Stop();
+  ENSURE(product_single.GetRow(2000).Count()==161 && product_multi.GetRow(2000).Count()==161, "the band widens to 2*80");
+  
+  I3RUsageTimer timer_reach;
+  timer_reach.Start();
+  const SymmetricIndexMatrix_Bool reach = band.ReachableWithin(4);
+  timer_reach.Stop();
+  ENSURE_EQUAL(reach.GetRow(2000).Count(), 321u);
+  
+  I3RUsageTimer timer_closure;
+  timer_closure.Start();
+  const SymmetricIndexMatrix_Bool closure = band.TransitiveClosure();
+  timer_closure.Stop();
+  ENSURE_EQUAL(closure.GetRow(0).Count(), size_t(large_size));
+  
+  log_info_stream("boolean product of a band matrix: "<<small_size<<" element loop "<<timer_naive.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" word-parallel "<<timer_small.GetTotalRUsage()->wallclocktime/1E6<<" ms; "
+    <<large_size<<" word-parallel 1 thread "<<timer_single.GetTotalRUsage()->wallclocktime/1E6<<" ms, "
+    <<boost::thread::hardware_concurrency()<<" threads "<<timer_multi.GetTotalRUsage()->wallclocktime/1E6<<" ms;"
+    <<" reachable within 4 steps "<<timer_reach.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" transitive closure "<<timer_closure.GetTotalRUsage()->wallclocktime/1E6<<" ms");
+};
+
+TEST (Benchmark_PackedIntVector) {
+  const size_t size = (5484*5485)/2; //the triangle of all DOMs of IC86
+  PackedIntVector<12> packed(size);
+  std::vector<uint16_t> plain(size);
+  for (size_t i=0; i<size; i++) {
+    plain[i] = (i*2654435761ULL>>20)%4096;
+    packed[i] = plain[i];
+  }
+  
+  //sum all fields element-wise and in bulk chunks
+  uint64_t sum_plain = 0;
+  I3RUsageTimer timer_plain;
+  timer_plain.Start();
+  for (size_t i=0; i<size; i++)
+    sum_plain += plain[i];
+  timer_plain.Stop();
+  
+  uint64_t sum_element = 0;
+  I3RUsageTimer timer_element;
+  timer_element.Start();
+  for (size_t i=0; i<size; i++)
+    sum_element += packed[i];
+  timer_element.Stop();
+  
+  uint64_t sum_bulk = 0;
+  std::vector<uint32_t> chunk(4096);
+  I3RUsageTimer timer_bulk;
+  timer_bulk.Start();
+  for (size_t first=0; first<size; first+=chunk.size()) {
+    const size_t count = std::min(chunk.size(), size-first);
+    packed.Unpack(first, count, &chunk[0]);
+    for (size_t i=0; i<count; i++)
+      sum_bulk += chunk[i];
+  }
+  timer_bulk.Stop();
+  
+  ENSURE_EQUAL(sum_plain, sum_element);
+  ENSURE_EQUAL(sum_plain, sum_bulk);
+  
+  log_info_stream("sweep of "<<size<<" 12-bit fields:"
+    <<" uint16_t "<<plain.size()*sizeof(uint16_t)/1E6<<" MB "<<timer_plain.GetTotalRUsage()->wallclocktime/size<<" ns/field,"
+    <<" PackedIntVector<12> "<<packed.GetNBytes()/1E6<<" MB element-wise "<<timer_element.GetTotalRUsage()->wallclocktime/size<<" ns/field,"
+    <<" bulk Unpack "<<timer_bulk.GetTotalRUsage()->wallclocktime/size<<" ns/field");
+};
+
+#if SERIALIZATION_ENABLED
+///a bitset of n pseudo-random bits
+static boost::dynamic_bitset<> RandomBitset(const size_t n) {
+  std::vector<boost::dynamic_bitset<>::block_type> blocks((n+boost::dynamic_bitset<>::bits_per_block-1)/boost::dynamic_bitset<>::bits_per_block);
+  TestRandom random(n);
+  for (size_t b=0; b<blocks.size(); b++)
+    blocks[b] = random.Next();
+  boost::dynamic_bitset<> bits(blocks.begin(), blocks.end());
+  bits.resize(n);
+  return bits;
+};
+
+///serialize a bitset as it was done before, in the format of version 0
+template <class Archive>
+static void CopyingSave(Archive& ar, const boost::dynamic_bitset<>& bits) {
+  size_t num_bits = bits.size();
+  std::vector<boost::dynamic_bitset<>::block_type> blocks(bits.num_blocks());
+  to_block_range(bits, blocks.begin());
+  ar << SERIALIZATION_NS::make_nvp("num_bits", num_bits);
+  ar << SERIALIZATION_NS::make_nvp("blocks", blocks);
+};
+
+///deserialize a bitset as it was done before, resizing the bitset twice
+template <class Archive>
+static void CopyingLoad(Archive& ar, boost::dynamic_bitset<>& bits) {
+  size_t num_bits;
+  std::vector<boost::dynamic_bitset<>::block_type> blocks;
+  ar >> SERIALIZATION_NS::make_nvp("num_bits", num_bits);
+  ar >> SERIALIZATION_NS::make_nvp("blocks", blocks);
+  bits.resize(num_bits);
+  from_block_range(blocks.begin(), blocks.end(), bits);
+  bits.resize(num_bits);
+};
+
+///save a bitset into a binary archive file, as it was done before or as it is done now
+struct SaveBitset {
+  const boost::dynamic_bitset<>& bits_;
+  const std::string& path_;
+  const bool former_;
+  SaveBitset(const boost::dynamic_bitset<>& bits, const std::string& path, const bool former) : bits_(bits), path_(path), former_(former) {};
+  void operator()() const {
+    std::ofstream ofs(path_.c_str(), std::ios::binary);
+    SERIALIZATION_NS_BASE::archive::portable_binary_oarchive oa(ofs);
+    if (former_)
+      CopyingSave(oa, bits_);
+    else
+      oa << bits_;
+  };
+};
+
+///load a bitset from a binary archive file, as it was done before or as it is done now
+struct LoadBitset {
+  const boost::dynamic_bitset<>& expected_;
+  const std::string& path_;
+  const bool former_;
+  LoadBitset(const boost::dynamic_bitset<>& expected, const std::string& path, const bool former) : expected_(expected), path_(path), former_(former) {};
+  void operator()() const {
+    boost::dynamic_bitset<> bits;
+    {
+      std::ifstream ifs(path_.c_str(), std::ios::binary);
+      SERIALIZATION_NS_BASE::archive::portable_binary_iarchive ia(ifs);
+      if (former_)
+        CopyingLoad(ia, bits);
+      else
+        ia >> bits;
+    }
+    if (bits!=expected_)
+      log_fatal("the loaded bitset differs");
+  };
+};
+
+///the peak resident memory of this process in MB since the last reset; NAN where /proc is not available
+static double PeakMemory() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:")==0)
+      return atof(line.c_str()+6)/1E3;
+  }
+  return NAN;
+};
+
+/** run a function, and measure its peak memory against the resident memory before
+ * @return the growth of the peak resident memory in MB and the wall time in ms
+ */
+template <class Function>
+static std::pair<double, double> PeakGrowthAndTime(const Function& function) {
+  {
+    //return the free heap to the system, so that its reuse shows, and reset the peak to the present resident memory
+    malloc_trim(0);
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+  }
+  const double before = PeakMemory();
+  I3RUsageTimer timer;
+  timer.Start();
+  function();
+  timer.Stop();
+  return std::make_pair(PeakMemory()-before, timer.GetTotalRUsage()->wallclocktime/1E6);
+};
+
+TEST(Benchmark_DynamicBitSet_Serialize){
+  const std::string path = "IndexMatrixBenchmark.bitset";
+  const size_t sizes[] = {10000000, 100000000};
+  BOOST_FOREACH(const size_t n, sizes) {
+    const boost::dynamic_bitset<> bits = RandomBitset(n);
+    std::pair<double, double> save[2], load[2];
+    for (int former=1; former>=0; former--) {
+      save[former] = PeakGrowthAndTime(SaveBitset(bits, path, former));
+      load[former] = PeakGrowthAndTime(LoadBitset(bits, path, former));
+    }
+    std::remove(path.c_str());
+    
+    log_info_stream("binary archive file of "<<n<<" bits ("<<bits.num_blocks()*sizeof(boost::dynamic_bitset<>::block_type)/1E6<<" MB),"
+      <<" peak memory growth and time:"
+      <<" save former "<<save[1].first<<" MB "<<save[1].second<<" ms, current "<<save[0].first<<" MB "<<save[0].second<<" ms;"
+      <<" load former "<<load[1].first<<" MB "<<load[1].second<<" ms, current "<<load[0].first<<" MB "<<load[0].second<<" ms");
+  }
+};
+#endif //SERIALIZATION_ENABLED
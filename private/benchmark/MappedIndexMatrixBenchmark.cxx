@@ -0,0 +1,79 @@
+/**
+ * \file MappedIndexMatrixBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time mapping a matrix file against reading a private copy; not part of the unit tests
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/MappedIndexMatrix.h"
+#include "ToolZ/DistanceService.h"
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <boost/make_shared.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace indexmatrix;
+
+TEST_GROUP(MappedIndexMatrixBenchmark);
+
+///the file the benchmark writes to
+static const std::string path = "MappedIndexMatrixBenchmark.idx";
+
+TEST (Benchmark_Load) {
+  const I3Geometry geo = IC86Topology::Build_IC86_Geometry();
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo.omgeo));
+  const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo.omgeo, hasher);
+  const DistanceService distService(posService);
+  const unsigned n = hasher->HashSize();
+
+  I3RUsageTimer timer_compute;
+  timer_compute.Start();
+  distService.HashAllDistances(1);
+  timer_compute.Stop();
+  distService.WriteMapped(path);
+
+  //map the file, and touch every page once
+  I3RUsageTimer timer_map;
+  timer_map.Start();
+  const MappedSymmetricIndexMatrix<uint16_t>::type mapped = MappedSymmetricIndexMatrix<uint16_t>::Open(path, posService->GetChecksum());
+  timer_map.Stop();
+  uint64_t sum_mapped = 0;
+  I3RUsageTimer timer_touch;
+  timer_touch.Start();
+  for (size_t index=0; index<mapped.GetInternal().size(); index+=2048)
+    sum_mapped += mapped.GetInternal()[index];
+  timer_touch.Stop();
+
+  //read a private copy of the same fields into a dense matrix
+  I3RUsageTimer timer_read;
+  timer_read.Start();
+  std::vector<uint16_t> fields(RowMajorLayout::SymmetricSize(n));
+  {
+    std::ifstream ifs(path.c_str(), std::ios::binary);
+    MappedFileHeader header;
+    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    ifs.seekg(header.dataOffset);
+    ifs.read(reinterpret_cast<char*>(&fields[0]), fields.size()*sizeof(uint16_t));
+  }
+  const SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > copied(n, fields);
+  timer_read.Stop();
+  uint64_t sum_copied = 0;
+  for (size_t index=0; index<copied.GetInternal().size(); index+=2048)
+    sum_copied += copied.GetInternal()[index];
+  ENSURE_EQUAL(sum_mapped, sum_copied);
+
+  log_info_stream("distance matrix of IC86 ("<<n<<" DOMs, "<<fields.size()*sizeof(uint16_t)/1E6<<" MB):"
+    <<" compute "<<timer_compute.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" read private copy "<<timer_read.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" map "<<timer_map.GetTotalRUsage()->wallclocktime/1E6<<" ms"
+    <<" + first touch of all pages "<<timer_touch.GetTotalRUsage()->wallclocktime/1E6<<" ms (shared in the page cache)");
+  std::remove(path.c_str());
+};
@@ -0,0 +1,63 @@
+/**
+ * \file NeighbourIndexBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the neighbour lists against a scan of the distance matrix; not part of the unit tests
+ */
+#include <I3Test.h>
+
+#include "ToolZ/NeighbourIndex.h"
+#include "ToolZ/DistanceService.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(NeighbourIndexBenchmark)
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static HashedGeometryConstPtr hashedGeo = boost::make_shared<const HashedGeometry>(geo->omgeo);
+
+TEST(Benchmark_RangeQuery) {
+  const double radius = 150.;
+  const CompactHash n = hashedGeo->GetHashService()->HashSize();
+  const DistanceServiceConstPtr distService = hashedGeo->GetDistService();
+  distService->HashAllDistances();
+
+  I3RUsageTimer timer_build;
+  timer_build.Start();
+  const NeighbourIndex index(hashedGeo, radius);
+  timer_build.Stop();
+
+  //scan a whole row of the symmetric distance matrix for every DOM
+  size_t count_scan = 0;
+  I3RUsageTimer timer_scan;
+  timer_scan.Start();
+  for (CompactHash i=0; i<n; i++) {
+    for (CompactHash j=0; j<n; j++)
+      count_scan += (j!=i && distService->GetDistance(i, j)<=radius);
+  }
+  timer_scan.Stop();
+
+  size_t count_index = 0;
+  I3RUsageTimer timer_index;
+  timer_index.Start();
+  for (CompactHash i=0; i<n; i++) {
+    const NeighbourIndex::NeighbourRange neighbours = index.GetNeighbours(i);
+    for (const CompactHash* it=neighbours.begin(); it!=neighbours.end(); ++it)
+      count_index += (*it!=n); //touch every neighbour
+  }
+  timer_index.Stop();
+
+  //the distance matrix is rounded to meters, so the counts may deviate slightly at the boundary
+  ENSURE_DISTANCE(double(count_scan), double(count_index), 0.01*count_index);
+
+  log_info_stream("range query R="<<radius<<"m on IC86 ("<<count_index/double(n)<<" neighbours per DOM):"
+    <<" build "<<timer_build.GetTotalRUsage()->wallclocktime/1E6<<" ms,"
+    <<" matrix row scan "<<timer_scan.GetTotalRUsage()->wallclocktime/n<<" ns/DOM,"
+    <<" NeighbourIndex "<<timer_index.GetTotalRUsage()->wallclocktime/n<<" ns/DOM");
+}
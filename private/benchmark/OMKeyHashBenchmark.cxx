@@ -0,0 +1,76 @@
+/**
+ * \file OMKeyHashBenchmark.cxx
+ *
+ * (c) 2013 the IceCube Collaboration
+ *
+ * \author mzoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the forward hashing of OMKeys; not part of the unit tests
+ */
+
+#include "ToolZ/OMKeyHash.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <I3Test.h>
+#include <boost/make_shared.hpp>
+#include <boost/foreach.hpp>
+
+TEST_GROUP(OMKeyHashBenchmark);
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+
+///time forward hashing through the lookup table against the plain std::map it replaces
+static void BenchmarkHashing(const std::set<OMKey>& omkey_set, const std::string& name) {
+  const unsigned n_rounds = 200;
+  
+  CompactOMKeyHashService hasher(omkey_set);
+  std::map<OMKey, CompactHash> hashmap;
+  CompactHash hash_iter = 0;
+  BOOST_FOREACH(const OMKey& omkey, omkey_set)
+    hashmap.insert(hashmap.end(), std::make_pair(omkey, hash_iter++));
+  
+  //shuffle the access order so that we are not just streaming through
+  std::vector<OMKey> queries(omkey_set.begin(), omkey_set.end());
+  for (size_t i=queries.size()-1; i>0; i--)
+    std::swap(queries[i], queries[(i*7919)%(i+1)]);
+  
+  uint64_t sum_map = 0;
+  I3RUsageTimer timer_map;
+  timer_map.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    BOOST_FOREACH(const OMKey& omkey, queries)
+      sum_map += hashmap.find(omkey)->second;
+  }
+  timer_map.Stop();
+  
+  uint64_t sum_dense = 0;
+  I3RUsageTimer timer_dense;
+  timer_dense.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    BOOST_FOREACH(const OMKey& omkey, queries)
+      sum_dense += hasher.HashFromOMKey(omkey);
+  }
+  timer_dense.Stop();
+  
+  ENSURE_EQUAL(sum_map, sum_dense, "both methods hash identical");
+  
+  const double n_lookups = double(n_rounds)*queries.size();
+  log_info_stream("HashFromOMKey on "<<name<<" ("<<queries.size()<<" DOMs, dense="<<hasher.IsDense()<<"): "
+    <<" std::map "<<timer_map.GetTotalRUsage()->wallclocktime/n_lookups<<" ns/lookup,"
+    <<" lookup table "<<timer_dense.GetTotalRUsage()->wallclocktime/n_lookups<<" ns/lookup");
+};
+
+TEST(Benchmark_DenseVsMap) {
+  BenchmarkHashing(ExtractOMKeys(geo), "IC86");
+  
+  //a synthetic Gen2-like geometry of 10k DOMs
+  std::set<OMKey> omkey_set;
+  for (unsigned i=1; i<=125; i++) {
+    for (unsigned j=1; j<=80; j++) {
+      omkey_set.insert(omkey_set.end(),OMKey(i,j));
+    }
+  }
+  BenchmarkHashing(omkey_set, "synthetic 10k");
+};
@@ -0,0 +1,55 @@
+/**
+ * \file PositionServiceBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the batch distance kernels of the PositionService; not part of the unit tests
+ */
+#include <I3Test.h>
+
+#include "ToolZ/PositionService.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(PositionServiceBenchmark)
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+static PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo,hasher); 
+
+TEST(Benchmark_DistancesFrom) {
+  const unsigned n_rounds = 1000;
+  const I3Position pos(12., -34., 56.);
+  std::vector<double> dist(hasher->HashSize());
+  
+  double sum_single = 0.;
+  I3RUsageTimer timer_single;
+  timer_single.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    for (CompactHash i=0; i<hasher->HashSize(); i++)
+      dist[i] = (posService->GetPosition(i)-pos).Magnitude();
+    sum_single += dist[r%dist.size()];
+  }
+  timer_single.Stop();
+  
+  double sum_batch = 0.;
+  I3RUsageTimer timer_batch;
+  timer_batch.Start();
+  for (unsigned r=0; r<n_rounds; r++) {
+    posService->DistancesFrom(pos, dist.data());
+    sum_batch += dist[r%dist.size()];
+  }
+  timer_batch.Stop();
+  
+  ENSURE_DISTANCE(sum_single, sum_batch, 1E-6, "both methods compute identical");
+  
+  const double n_distances = double(n_rounds)*hasher->HashSize();
+  log_info_stream("distance from a point to all "<<hasher->HashSize()<<" DOMs:"
+    <<" per DOM "<<timer_single.GetTotalRUsage()->wallclocktime/n_distances<<" ns/DOM,"
+    <<" batch "<<timer_batch.GetTotalRUsage()->wallclocktime/n_distances<<" ns/DOM");
+}
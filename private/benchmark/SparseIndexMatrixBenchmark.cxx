@@ -0,0 +1,94 @@
+/**
+ * \file SparseIndexMatrixBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the sparse matrices against the dense matrices; not part of the unit tests
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/SparseIndexMatrix.h"
+#include "ToolZ/IndexMatrix.h"
+#include "ToolZ/I3RUsageTimer.h"
+#include "test/TestHelpers.h"
+
+using namespace indexmatrix;
+
+TEST_GROUP(SparseIndexMatrixBenchmark);
+
+///a distance-like value within a band of width 2*40 around the diagonal, and 0 beyond
+struct BandFunction {
+  double operator() (const uint64_t index_A, const uint64_t index_B) const {
+    const uint64_t distance = index_A>index_B ? index_A-index_B : index_B-index_A;
+    return distance<=40 ? 1.+distance : 0.;
+  };
+};
+
+TEST (Benchmark_Sparse) {
+  const BandFunction band;
+  const unsigned n_queries = 4000000;
+
+  //all DOMs of IC86, with pairs relevant within a band of 2*40, as within a causality radius
+  const unsigned size = 5484;
+  SymmetricIndexMatrix<double, std::vector<double> > dense(size);
+  for (unsigned index_A=0; index_A<size; index_A++) {
+    for (unsigned index_B=0; index_B<=index_A; index_B++)
+      dense.Set(index_A, index_B, band(index_A, index_B));
+  }
+  I3RUsageTimer timer_build;
+  timer_build.Start();
+  const SparseSymmetricIndexMatrix_Double sparse(size, band);
+  timer_build.Stop();
+
+  //query pairs of which most are relevant
+  std::vector<std::pair<unsigned, unsigned> > pairs;
+  TestRandom random(1);
+  for (unsigned q=0; q<4096; q++) {
+    const uint64_t state = random.Next();
+    const unsigned index_A = (state>>33)%size;
+    pairs.push_back(std::make_pair(index_A, std::min(size-1, index_A+unsigned((state>>13)%50))));
+  }
+
+  double sum_dense = 0.;
+  I3RUsageTimer timer_dense;
+  timer_dense.Start();
+  for (unsigned q=0; q<n_queries; q++)
+    sum_dense += dense.Get(pairs[q%4096].first, pairs[q%4096].second);
+  timer_dense.Stop();
+
+  double sum_sparse = 0.;
+  I3RUsageTimer timer_sparse;
+  timer_sparse.Start();
+  for (unsigned q=0; q<n_queries; q++)
+    sum_sparse += sparse.Get(pairs[q%4096].first, pairs[q%4096].second);
+  timer_sparse.Stop();
+  ENSURE_EQUAL(sum_dense, sum_sparse, "both hold identical fields");
+
+  //a Gen2-scale range, built row by row from lists of neighbours
+  const unsigned gen2_size = 100000;
+  I3RUsageTimer timer_gen2;
+  timer_gen2.Start();
+  SparseSymmetricIndexMatrix_Double gen2(gen2_size);
+  std::vector<SparseSymmetricIndexMatrix_Double::Entry> row;
+  for (unsigned index_A=0; index_A<gen2_size; index_A++) {
+    row.clear();
+    for (unsigned index_B=(index_A>40 ? index_A-40 : 0); index_B<=index_A; index_B++)
+      row.push_back(SparseSymmetricIndexMatrix_Double::Entry(index_B, band(index_A, index_B)));
+    //rows are set in ascending order with their lower part only, so that no row is replaced which holds mirrored fields
+    gen2.SetRow(index_A, row.begin(), row.end());
+  }
+  timer_gen2.Stop();
+  ENSURE_EQUAL(gen2.GetRow(50000).size(), 81u);
+
+  const size_t dense_bytes = (size_t(size)*size+size)/2*sizeof(double);
+  const size_t sparse_bytes = sparse.GetNEntries()*sizeof(SparseSymmetricIndexMatrix_Double::Entry);
+  log_info_stream("band of 2*40 on "<<size<<"x"<<size<<": dense "<<dense_bytes/1E6<<" MB,"
+    <<" sparse "<<sparse_bytes/1E6<<" MB built in "<<timer_build.GetTotalRUsage()->wallclocktime/1E6<<" ms;"
+    <<" Get dense "<<timer_dense.GetTotalRUsage()->wallclocktime/n_queries<<" ns/access,"
+    <<" sparse "<<timer_sparse.GetTotalRUsage()->wallclocktime/n_queries<<" ns/access;"
+    <<" "<<gen2_size<<"x"<<gen2_size<<" sparse built row-wise in "<<timer_gen2.GetTotalRUsage()->wallclocktime/1E6<<" ms, "
+    <<gen2.GetNEntries()*sizeof(SparseSymmetricIndexMatrix_Double::Entry)/1E6<<" MB");
+};
@@ -0,0 +1,62 @@
+/**
+ * \file StringDistanceServiceBenchmark.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Time the string-factored distance computation against the full distance matrix; not part of the unit tests
+ */
+#include <I3Test.h>
+
+#include "ToolZ/StringDistanceService.h"
+#include "ToolZ/DistanceService.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/I3RUsageTimer.h"
+#include "test/TestHelpers.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(StringDistanceServiceBenchmark)
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+static PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo,hasher);
+
+static StringDistanceServiceConstPtr strDistService = boost::make_shared<const StringDistanceService>(posService);
+
+TEST(Benchmark_GetDistance) {
+  const DistanceServiceConstPtr distService = boost::make_shared<const DistanceService>(posService);
+  distService->HashAllDistances();
+  const CompactHash n = hasher->HashSize();
+  const unsigned n_queries = 4000000;
+
+  //pseudo-random pairs, as they come from hits
+  std::vector<std::pair<CompactHash, CompactHash> > pairs;
+  TestRandom random(1);
+  for (unsigned q=0; q<4096; q++) {
+    const uint64_t state = random.Next();
+    pairs.push_back(std::make_pair((state>>33)%n, (state>>13)%n));
+  }
+
+  double sum_matrix = 0.;
+  I3RUsageTimer timer_matrix;
+  timer_matrix.Start();
+  for (unsigned q=0; q<n_queries; q++)
+    sum_matrix += distService->GetDistance(pairs[q%4096].first, pairs[q%4096].second);
+  timer_matrix.Stop();
+
+  double sum_string = 0.;
+  I3RUsageTimer timer_string;
+  timer_string.Start();
+  for (unsigned q=0; q<n_queries; q++)
+    sum_string += strDistService->GetDistance(pairs[q%4096].first, pairs[q%4096].second);
+  timer_string.Stop();
+
+  ENSURE_DISTANCE(sum_matrix/n_queries, sum_string/n_queries, 0.5, "both methods compute identical within rounding");
+
+  log_info_stream("GetDistance on IC86:"
+    <<" full matrix "<<timer_matrix.GetTotalRUsage()->wallclocktime/n_queries<<" ns/query,"
+    <<" string-factored "<<timer_string.GetTotalRUsage()->wallclocktime/n_queries<<" ns/query");
+}
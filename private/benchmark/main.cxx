@@ -0,0 +1 @@
+#include <I3TestMain.ixx>
\ No newline at end of file
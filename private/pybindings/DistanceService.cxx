@@ -15,6 +15,7 @@
 
 #include "ToolZ/OMKeyHash.h"
 #include "ToolZ/DistanceService.h"
+#include "ToolZ/StringDistanceService.h"
 
 #include <boost/make_shared.hpp>
 
@@ -27,8 +28,8 @@ namespace pyDistanceService {
 //Do the pybindings
 void register_DistanceService() {
   //================= DistanceService ===========================
-  bp::class_<DistanceService>(
-    "DistanceService", bp::init<PositionServiceConstPtr>(bp::args("posService"), "make DistanceService for already hashed Position" ))
+  bp::class_<DistanceService, DistanceServicePtr, boost::noncopyable>(
+    "DistanceService", bp::init<PositionServiceConstPtr, bp::optional<bool> >(bp::args("posService", "persistCache"), "make DistanceService for already hashed Position; optionally serialize the filled distances along" ))
     .def("GetDistance",
       (double (DistanceService::*)(const CompactHash, const CompactHash) const)&DistanceService::GetDistance,
       bp::args("compacthash", "compacthash"),
@@ -39,7 +40,36 @@ void register_DistanceService() {
       "Get the Distance between these DOMs")
     .def("HashAllDistances",
       &DistanceService::HashAllDistances,
-      "Hash all Distances")
+      (bp::arg("nThreads")=0),
+      "Hash all Distances; use this many threads, 0 for all hardware threads")
+    .def("GetPersistCache",
+      &DistanceService::GetPersistCache,
+      "Are the filled distances serialized along")
+    .def("GetNCached",
+      &DistanceService::GetNCached,
+      "Number of distances which are computed and cached")
+    ;
+  
+  //================= StringDistanceService ===========================
+  bp::class_<StringDistanceService, StringDistanceServicePtr>(
+    "StringDistanceService", bp::init<PositionServiceConstPtr, bp::optional<double> >(bp::args("posService", "tolerance"), "make StringDistanceService for already hashed Position; group DOMs of a string within the tolerance into columns" ))
+    .def("GetDistance",
+      (double (StringDistanceService::*)(const CompactHash, const CompactHash) const)&StringDistanceService::GetDistance,
+      bp::args("compacthash", "compacthash"),
+      "Get the Distance between these DOMs")
+    .def("GetDistance",
+      (double (StringDistanceService::*)(const OMKey&, const OMKey&) const)&StringDistanceService::GetDistance,
+      bp::args("omkey", "omkey"),
+      "Get the Distance between these DOMs")
+    .def("GetNColumns",
+      &StringDistanceService::GetNColumns,
+      "Number of columns the DOMs are grouped into")
+    .def("GetTolerance",
+      &StringDistanceService::GetTolerance,
+      "Tolerance within which DOMs of the same string are grouped into a column")
+    .def("GetMaxOffset",
+      &StringDistanceService::GetMaxOffset,
+      "Largest horizontal distance of any DOM to its column; distances are accurate to twice this value")
     ;
 };
 
@@ -46,6 +46,7 @@ void register_HashedGeometry()
 {
   //=== class HashedGeometry
   bp::class_<HashedGeometry, HashedGeometryPtr>("HashedGeometry", bp::init<const I3OMGeoMap&>(bp::args("omgeo"), "hash all OMs inthis Geometry"))
+    .def(bp::init<const I3OMGeoMap&, bool>(bp::args("omgeo", "persistDistances"), "hash all OMs in this Geometry; serialize the filled distances along"))
     .def("__init__",
       bp::make_constructor(&pyHashedGeometry::HashedGeometryConstPtr_From_pyOMKeyList) )
     .def_readonly("hashService",
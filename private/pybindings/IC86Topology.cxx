@@ -53,6 +53,14 @@ void register_IC86Topology() {
       &IC86Topology::Build_IC86_OMKeyTopologyMap,
       "Build the OMTopologyMap for IC86 with the most common applications")
     .staticmethod("OMTopologyMap")
+    .def("hash_service",
+      &IC86Topology::GetHashService,
+      "The process-wide hasher of all OMKeys in the IC86 geometry")
+    .staticmethod("hash_service")
+    .def("position_service",
+      &IC86Topology::GetPositionService,
+      "The process-wide PositionService of the IC86 geometry")
+    .staticmethod("position_service")
     ;
 };
 
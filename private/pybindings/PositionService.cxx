@@ -41,13 +41,11 @@ void register_PositionService() {
     .def(bp::init<I3OMGeoMap,CompactOMKeyHashServiceConstPtr>(
       bp::args("geo", "hasher"),"Hashes Positions and Distances; hold external hasher"))
     .def("GetPosition",
-      (const I3Position& (PositionService::*)(const CompactHash) const)&PositionService::GetPosition,
-      bp::return_value_policy<bp::return_by_value>(),
+      (I3Position (PositionService::*)(const CompactHash) const)&PositionService::GetPosition,
       bp::args("compacthash"),
       "Get the Position of this OMKeyHash")
     .def("GetPosition",
-      (const I3Position& (PositionService::*)(const OMKey&) const)&PositionService::GetPosition,
-      bp::return_value_policy<bp::return_by_value>(),
+      (I3Position (PositionService::*)(const OMKey&) const)&PositionService::GetPosition,
       bp::args("compacthash"),
       "Get the Position of this OMKey")
     ;
@@ -19,6 +19,9 @@
 #include "TestHelpers.h"
 
 #include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/ref.hpp>
 
 TEST_GROUP(DistanceService)
 
@@ -35,10 +38,10 @@ TEST(Verify_against) {
 }
   
 TEST(get_distance) {
-  for (int i=0; i<hasher->HashSize(); i++) {
+  for (CompactHash i=0; i<hasher->HashSize(); i++) {
     const OMKey omkey_a = hasher->OMKeyFromHash(i); 
     I3Position pos_a = geo->omgeo.at(omkey_a).position;
-    for (int j=0; j<hasher->HashSize(); j++) {
+    for (CompactHash j=0; j<hasher->HashSize(); j++) {
       const OMKey omkey_b = hasher->OMKeyFromHash(j); 
       I3Position pos_b = geo->omgeo.at(omkey_b).position;
       ENSURE_DISTANCE(distService->GetDistance(omkey_a, omkey_b), (pos_a-pos_b).Magnitude(), 0.5); //exact within 0.5meters
@@ -46,7 +49,102 @@ TEST(get_distance) {
   }
 }
 
+///query distances in a pseudo-random order and count those deviating from the positions
+static void QueryDistances(
+  const DistanceServiceConstPtr& ds,
+  const unsigned seed,
+  const unsigned n_queries,
+  unsigned& n_wrong)
+{
+  const CompactHash n = ds->GetHashService()->HashSize();
+  TestRandom random(seed);
+  n_wrong = 0;
+  for (unsigned q=0; q<n_queries; q++) {
+    //crowd onto few DOMs so that threads collide on the same fields
+    const uint64_t state = random.Next();
+    const CompactHash a = (state>>33)%n;
+    const CompactHash b = (state>>17)%(n/8);
+    const double expected = (ds->GetPosService()->GetPosition(a)-ds->GetPosService()->GetPosition(b)).Magnitude();
+    if (std::fabs(ds->GetDistance(a,b)-expected)>0.5)
+      n_wrong++;
+  }
+};
+
+TEST(concurrent_get_distance) {
+  const unsigned n_threads = 8;
+  const unsigned n_queries = 200000;
+  //a fresh service, so that threads race on filling the cache
+  const DistanceServiceConstPtr sharedDistService = boost::make_shared<const DistanceService>(posService);
+  
+  std::vector<unsigned> n_wrong(n_threads, 0);
+  boost::thread_group threads;
+  for (unsigned t=0; t<n_threads; t++)
+    threads.create_thread(boost::bind(&QueryDistances, sharedDistService, t, n_queries, boost::ref(n_wrong[t])));
+  threads.join_all();
+  
+  for (unsigned t=0; t<n_threads; t++)
+    ENSURE_EQUAL(n_wrong[t], 0, "every thread read correct distances");
+  
+  //the cache was filled correctly
+  unsigned n_wrong_after = 0;
+  QueryDistances(sharedDistService, 0, n_queries, n_wrong_after);
+  ENSURE_EQUAL(n_wrong_after, 0);
+}
+
+TEST(hash_all_distances) {
+  //single threaded and multi-threaded precomputation agree with the lazy computation
+  const DistanceServiceConstPtr lazyDistService = boost::make_shared<const DistanceService>(posService);
+  for (unsigned nThreads=1; nThreads<=3; nThreads++) {
+    const DistanceServiceConstPtr fullDistService = boost::make_shared<const DistanceService>(posService);
+    fullDistService->HashAllDistances(nThreads);
+    for (CompactHash i=0; i<hasher->HashSize(); i+=13) {
+      for (CompactHash j=0; j<hasher->HashSize(); j++)
+        ENSURE_EQUAL(fullDistService->GetDistance(i,j), lazyDistService->GetDistance(i,j));
+    }
+  }
+}
+
+TEST(n_cached) {
+  const DistanceServiceConstPtr ds = boost::make_shared<const DistanceService>(posService);
+  ENSURE_EQUAL(ds->GetNCached(), 0u);
+  ds->GetDistance(3, 7);
+  ds->GetDistance(7, 3);
+  ds->GetDistance(5, 5);
+  ENSURE_EQUAL(ds->GetNCached(), 1u, "symmetric pairs share a field, the diagonal is not cached");
+  ds->HashAllDistances();
+  uint64_t n_nonzero = 0;
+  for (CompactHash i=0; i<hasher->HashSize(); i++) {
+    for (CompactHash j=0; j<i; j++)
+      n_nonzero += (uint16_t(posService->GetDistance(i,j)+0.5)!=0);
+  }
+  ENSURE_EQUAL(ds->GetNCached(), n_nonzero, "all but the distances rounding to 0m");
+}
+
 #if SERIALIZATION_ENABLED
+TEST(Serialize_cache){
+  //a partially filled cache
+  const DistanceServicePtr ds_save = boost::make_shared<DistanceService>(posService, true);
+  unsigned n_wrong;
+  QueryDistances(ds_save, 0, 20000, n_wrong);
+  ENSURE(ds_save->GetNCached()>0);
+  
+  DistanceServicePtr ds_load;
+  serialize_object(ds_save, ds_load);
+  ENSURE(ds_load->GetPersistCache());
+  ENSURE_EQUAL(ds_load->GetNCached(), ds_save->GetNCached());
+  for (CompactHash i=0; i<hasher->HashSize(); i+=3) {
+    for (CompactHash j=0; j<hasher->HashSize(); j+=5)
+      ENSURE_EQUAL(ds_load->GetDistance(i,j), ds_save->GetDistance(i,j));
+  }
+  
+  //without the option the cache starts empty
+  const DistanceServicePtr ds_plain = boost::make_shared<DistanceService>(posService);
+  ds_plain->HashAllDistances();
+  serialize_object(ds_plain, ds_load);
+  ENSURE(!ds_load->GetPersistCache());
+  ENSURE_EQUAL(ds_load->GetNCached(), 0u);
+};
+
 TEST(Serialize_raw_ptr){
   DistanceService* ds_save = new DistanceService(posService);
   DistanceService* ds_load = nullptr;
@@ -0,0 +1,189 @@
+/**
+ * \file FlatSetTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Test the sorted-vector FlatSet against std::set, as container and in the set-algorithms
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/FlatSet.h"
+#include "ToolZ/SetHelpers.h"
+#include "ToolZ/HitFacility.h"
+#include "ToolZ/PartialCOG.h"
+#include "ToolZ/IC86Topology.h"
+
+#include <boost/make_shared.hpp>
+
+#include "TestHelpers.h"
+
+TEST_GROUP(FlatSet);
+
+typedef FlatSet<int> IntFlatSet;
+typedef std::set<int> IntSet;
+
+///n pseudo-random numbers in [0, range), unsorted and with repetitions
+static std::vector<int> RandomInts(const unsigned n, const unsigned range, const uint64_t seed) {
+  TestRandom random(seed);
+  std::vector<int> ints;
+  for (unsigned i=0; i<n; i++)
+    ints.push_back(random.Uniform(range));
+  return ints;
+};
+
+///do the containers hold the same elements in the same order
+template <class Container1, class Container2>
+bool SameElements(const Container1& lhs, const Container2& rhs)
+  {return lhs.size()==rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());};
+
+TEST (Contract) {
+  const std::vector<int> ints = RandomInts(500, 300, 1);
+  IntFlatSet flat(ints.begin(), ints.end());
+  IntSet set(ints.begin(), ints.end());
+  ENSURE(SameElements(flat, set), "construction from an unsorted range");
+
+  TestRandom random(2);
+  for (unsigned i=0; i<2000; i++) {
+    const int key = random.Uniform(400);
+    switch (random.Uniform(5)) {
+      case 0: {
+        const std::pair<IntFlatSet::iterator, bool> f = flat.insert(key);
+        const std::pair<IntSet::iterator, bool> s = set.insert(key);
+        ENSURE_EQUAL(f.second, s.second);
+        ENSURE_EQUAL(*f.first, *s.first);
+        break; }
+      case 1: { //hinted, with correct and wrong hints
+        const IntFlatSet::iterator hint = random.Uniform(2) ? flat.lower_bound(key) : flat.begin();
+        ENSURE_EQUAL(*flat.insert(hint, key), key);
+        set.insert(key);
+        break; }
+      case 2:
+        ENSURE_EQUAL(flat.erase(key), set.erase(key));
+        break;
+      case 3:
+        if (flat.find(key)!=flat.end()) {
+          const size_t index = flat.find(key)-flat.begin();
+          ENSURE(flat.erase(flat.find(key))==flat.begin()+index, "the position after the erased element");
+          set.erase(key);
+        }
+        break;
+      case 4:
+        ENSURE_EQUAL(flat.count(key), set.count(key));
+        ENSURE_EQUAL(flat.lower_bound(key)-flat.begin(), std::distance(set.begin(), set.lower_bound(key)));
+        ENSURE_EQUAL(flat.upper_bound(key)-flat.begin(), std::distance(set.begin(), set.upper_bound(key)));
+        ENSURE(flat.equal_range(key).first==flat.lower_bound(key));
+        ENSURE(flat.equal_range(key).second==flat.upper_bound(key));
+        break;
+    }
+  }
+  ENSURE(SameElements(flat, set), "after random insertions and erasures");
+
+  //range insertion: behind the held elements, and interleaved
+  const std::vector<int> more = RandomInts(200, 800, 3);
+  flat.insert(more.begin(), more.end());
+  set.insert(more.begin(), more.end());
+  ENSURE(SameElements(flat, set));
+  const std::vector<int> behind(1, 10000);
+  flat.insert(behind.begin(), behind.end());
+  set.insert(behind.begin(), behind.end());
+  ENSURE(SameElements(flat, set));
+
+  flat.erase(flat.begin()+10, flat.begin()+20);
+  IntSet::iterator first = set.begin(), last;
+  std::advance(first, 10);
+  last = first;
+  std::advance(last, 10);
+  set.erase(first, last);
+  ENSURE(SameElements(flat, set), "range erasure");
+
+  ENSURE(IntFlatSet(set.begin(), set.end())==flat);
+  ENSURE(IntFlatSet(set.begin(), --set.end())<flat);
+  ENSURE(std::equal(flat.rbegin(), flat.rend(), set.rbegin()));
+  flat.clear();
+  ENSURE(flat.empty());
+  ENSURE(flat.data()==NULL);
+};
+
+TEST (Gallop) {
+  std::vector<int> sorted;
+  for (int i=0; i<1000; i++)
+    sorted.push_back(3*i);
+  const std::less<int> comp;
+  for (int value=-5; value<3010; value+=7) {
+    for (size_t start=0; start<sorted.size(); start+=97) {
+      ENSURE(sethelpers::Gallop(sorted.begin()+start, sorted.end(), value, comp)
+        ==std::lower_bound(sorted.begin()+start, sorted.end(), value));
+    }
+  }
+};
+
+TEST (SetHelpers) {
+  //balanced sizes merge, unbalanced sizes gallop, in both directions
+  const unsigned sizes[][2] = {{1000, 1000}, {10, 5000}, {5000, 10}, {0, 100}, {1, 1}};
+  for (unsigned s=0; s<5; s++) {
+    const std::vector<int> a = RandomInts(sizes[s][0], 20000, 5+s);
+    const std::vector<int> b = RandomInts(sizes[s][1], 20000, 15+s);
+    const IntSet set_a(a.begin(), a.end()), set_b(b.begin(), b.end());
+    const IntFlatSet flat_a(a.begin(), a.end()), flat_b(b.begin(), b.end());
+
+    ENSURE_EQUAL(SetsIntersect(flat_a, flat_b), SetsIntersect(set_a, set_b));
+    ENSURE_EQUAL(SetsIntersectionCount(flat_a, flat_b), SetsIntersectionCount(set_a, set_b));
+    ENSURE(SameElements(SetsIntersection(flat_a, flat_b), SetsIntersection(set_a, set_b)));
+    ENSURE(SameElements(UniteSets(flat_a, flat_b), UniteSets(set_a, set_b)));
+    IntSet expected;
+    std::set_intersection(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::inserter(expected, expected.end()));
+    ENSURE(SameElements(SetsIntersection(flat_a, flat_b), expected));
+    ENSURE(SetsIdentical(flat_a, IntFlatSet(set_a.begin(), set_a.end())));
+  }
+
+  //the order of the containers is used, not operator<
+  AbsHitSeries a, b;
+  TestRandom random(6);
+  for (unsigned i=0; i<400; i++) {
+    a.push_back(AbsHit(random.Uniform(20), random.Uniform(100)));
+    b.push_back(AbsHit(random.Uniform(20), random.Uniform(100)));
+  }
+  const AbsHitSetRO setRO_a(a.begin(), a.end()), setRO_b(b.begin(), b.end());
+  const AbsHitFlatSetRO flatRO_a(a.begin(), a.end()), flatRO_b(b.begin(), b.end());
+  const AbsHitSet set_a(a.begin(), a.end()), set_b(b.begin(), b.end());
+  ENSURE_EQUAL(SetsIntersectionCount(setRO_a, setRO_b), SetsIntersectionCount(set_a, set_b));
+  ENSURE_EQUAL(SetsIntersectionCount(flatRO_a, flatRO_b), SetsIntersectionCount(set_a, set_b));
+  ENSURE(SameElements(UniteSets(flatRO_a, flatRO_b), UniteSets(setRO_a, setRO_b)));
+};
+
+TEST (HitContainers) {
+  const I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+  const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo, hasher);
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(GenerateTestRecoPulses()));
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+
+  //extraction
+  const AbsHitSet set = hf.GetAbsHits<AbsHitSet>();
+  const AbsHitFlatSet flat = hf.GetAbsHits<AbsHitFlatSet>();
+  ENSURE(SameElements(flat, set));
+  const HitSet hits = hf.GetHits<HitSet>();
+  const HitFlatSet flatHits = hf.GetHits<HitFlatSet>();
+  ENSURE(SameElements(flatHits, hits));
+  ENSURE(hf.MapFromHits(flatHits).size()==hf.MapFromHits(hits).size());
+
+  //the fraction and COG kernels
+  for (size_t frac=1; frac<=4; frac++) {
+    ENSURE(SameElements(Fraction_count(flat, 4, frac, frac), Fraction_count(set, 4, frac, frac)));
+    ENSURE(SameElements(Fraction_count(flat, 4, 5-frac, 5-frac, true), Fraction_count(set, 4, 5-frac, 5-frac, true)));
+  }
+  const I3PosTime cog_set = ComputeCOG(posService, set);
+  const I3PosTime cog_flat = ComputeCOG(posService, flat);
+  ENSURE_DISTANCE(cog_flat.first.GetZ(), cog_set.first.GetZ(), 1E-9);
+  ENSURE_DISTANCE(cog_flat.second, cog_set.second, 1E-9);
+
+  //time-ordered sequences of flat sets
+  std::set<AbsHitFlatSet, HitSetTimeOrder> sequence;
+  sequence.insert(Fraction_count(flat, 2, 2, 2));
+  sequence.insert(Fraction_count(flat, 2, 1, 1));
+  ENSURE(sequence.begin()->begin()->GetTime() <= sequence.rbegin()->begin()->GetTime());
+};
@@ -0,0 +1,94 @@
+/**
+ * \file HashedGeometryRegistryTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Unit test to test the sharing of hashers and HashedGeometries through the registry
+ */
+#include <I3Test.h>
+
+#include "ToolZ/HashedGeometryRegistry.h"
+
+#include "ToolZ/IC86Topology.h"
+
+#include "TestHelpers.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(HashedGeometryRegistry)
+
+//create some objects which are used in all the tests
+const I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+
+TEST(Fingerprint) {
+  const std::set<OMKey> omkeys = ExtractOMKeys(geo->omgeo);
+  ENSURE_EQUAL(HashedGeometryRegistry::Fingerprint(omkeys), HashedGeometryRegistry::Fingerprint(omkeys));
+  ENSURE_EQUAL(HashedGeometryRegistry::Fingerprint(geo->omgeo), HashedGeometryRegistry::Fingerprint(geo->omgeo, omkeys));
+
+  //one OMKey less
+  std::set<OMKey> fewer_omkeys = omkeys;
+  fewer_omkeys.erase(OMKey(1,1));
+  ENSURE(HashedGeometryRegistry::Fingerprint(omkeys) != HashedGeometryRegistry::Fingerprint(fewer_omkeys));
+
+  //one OM displaced
+  I3OMGeoMap displaced_omgeo = geo->omgeo;
+  displaced_omgeo[OMKey(1,1)].position.SetZ(displaced_omgeo[OMKey(1,1)].position.GetZ()+1.);
+  ENSURE(HashedGeometryRegistry::Fingerprint(geo->omgeo) != HashedGeometryRegistry::Fingerprint(displaced_omgeo));
+};
+
+TEST(GetHashService) {
+  HashedGeometryRegistry::Clear();
+  const std::set<OMKey> omkeys = ExtractOMKeys(geo->omgeo);
+
+  const CompactOMKeyHashServiceConstPtr hasher1 = HashedGeometryRegistry::GetHashService(omkeys);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheMisses(), 1);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheHits(), 0);
+  ENSURE_EQUAL(hasher1->HashSize(), omkeys.size());
+
+  const CompactOMKeyHashServiceConstPtr hasher2 = HashedGeometryRegistry::GetHashService(omkeys);
+  ENSURE(hasher1 == hasher2);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheMisses(), 1);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheHits(), 1);
+
+  std::set<OMKey> fewer_omkeys = omkeys;
+  fewer_omkeys.erase(OMKey(1,1));
+  const CompactOMKeyHashServiceConstPtr hasher3 = HashedGeometryRegistry::GetHashService(fewer_omkeys);
+  ENSURE(hasher1 != hasher3);
+  ENSURE_EQUAL(hasher3->HashSize(), fewer_omkeys.size());
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheMisses(), 2);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetSize(), 2);
+};
+
+TEST(GetHashedGeometry) {
+  HashedGeometryRegistry::Clear();
+
+  const HashedGeometryConstPtr hashedGeo1 = HashedGeometryRegistry::GetHashedGeometry(geo->omgeo);
+  const HashedGeometryConstPtr hashedGeo2 = HashedGeometryRegistry::GetHashedGeometry(geo->omgeo);
+  ENSURE(hashedGeo1 == hashedGeo2);
+  ENSURE_EQUAL(hashedGeo1->GetHashService()->HashSize(), geo->omgeo.size());
+
+  //a directly constructed HashedGeometry shares the registered hasher
+  const HashedGeometry hashedGeo3(geo->omgeo);
+  ENSURE(hashedGeo1->GetHashService() == hashedGeo3.GetHashService());
+
+  //as does a PositionService constructed without a hasher
+  CompactOMKeyHashServiceConstPtr hasher;
+  const PositionService posService(geo->omgeo, hasher);
+  ENSURE(hashedGeo1->GetHashService() == hasher);
+};
+
+TEST(WeakEntries) {
+  HashedGeometryRegistry::Clear();
+  const std::set<OMKey> omkeys = ExtractOMKeys(geo->omgeo);
+  {
+    const CompactOMKeyHashServiceConstPtr hasher = HashedGeometryRegistry::GetHashService(omkeys);
+    ENSURE_EQUAL(HashedGeometryRegistry::GetSize(), 1);
+  }
+  //nobody holds the hasher anymore, thus it has expired
+  ENSURE_EQUAL(HashedGeometryRegistry::GetSize(), 0);
+  HashedGeometryRegistry::GetHashService(omkeys);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheMisses(), 2);
+  ENSURE_EQUAL(HashedGeometryRegistry::GetCacheHits(), 0);
+};
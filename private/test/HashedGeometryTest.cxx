@@ -60,4 +60,16 @@ TEST(Serialize_boost_shared_ptr){
   
   serialize_object(hg_save, hg_load);
 };
+
+TEST(Serialize_persist_distances){
+  HashedGeometryPtr hg_save = boost::make_shared<HashedGeometry>(geo->omgeo, true);
+  hg_save->GetDistService()->GetDistance(OMKey(36,30), OMKey(21,5));
+  HashedGeometryPtr hg_load;
+  
+  serialize_object(hg_save, hg_load);
+  ENSURE(hg_load->GetDistService()->GetPersistCache());
+  ENSURE_EQUAL(hg_load->GetDistService()->GetNCached(), 1u);
+  ENSURE_EQUAL(hg_load->GetDistService()->GetDistance(OMKey(21,5), OMKey(36,30)),
+               hg_save->GetDistService()->GetDistance(OMKey(36,30), OMKey(21,5)));
+};
 #endif //SERIALIZATION_ENABLED
@@ -0,0 +1,153 @@
+/**
+ * \file HashedOMKeySetTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Unit test to test the bitset-backed OMKey sets against their std::set<OMKey> equivalents
+ */
+
+#include "ToolZ/HashedOMKeySet.h"
+
+#include "ToolZ/IC86Topology.h"
+#include "ToolZ/SetHelpers.h"
+
+#include <I3Test.h>
+#include <boost/make_shared.hpp>
+#include <boost/foreach.hpp>
+
+#include "TestHelpers.h"
+
+TEST_GROUP(HashedOMKeySet);
+
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+
+///every n-th OMKey of the geometry, starting at offset
+static std::set<OMKey> EveryNth(const unsigned n, const unsigned offset) {
+  std::set<OMKey> omkeys;
+  unsigned i=0;
+  BOOST_FOREACH(const I3OMGeoMap::value_type& omkey_omgeo, geo->omgeo) {
+    if (i++%n==offset)
+      omkeys.insert(omkeys.end(), omkey_omgeo.first);
+  }
+  return omkeys;
+};
+
+TEST(Construction) {
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+
+  const HashedOMKeySet empty(hasher);
+  ENSURE(empty.Empty());
+  ENSURE_EQUAL(empty.Count(), 0);
+  ENSURE(empty.begin()==empty.end());
+
+  const HashedOMKeySet full = HashedOMKeySet::Full(hasher);
+  ENSURE_EQUAL(full.Count(), geo->omgeo.size());
+  ENSURE(full.GetOMKeys()==ExtractOMKeys(geo));
+
+  const std::set<OMKey> omkeys = EveryNth(3, 1);
+  const HashedOMKeySet set(hasher, omkeys);
+  ENSURE_EQUAL(set.Count(), omkeys.size());
+  ENSURE(set.GetOMKeys()==omkeys, "round trip through std::set<OMKey>");
+  ENSURE(HashedOMKeySet(hasher, set.GetHashes())==set, "round trip through hashes");
+
+  //iteration is ordered like the OMKeys
+  std::set<OMKey>::const_iterator omkey_iter = omkeys.begin();
+  for (HashedOMKeySet::const_iterator it=set.begin(); it!=set.end(); ++it, ++omkey_iter)
+    ENSURE_EQUAL(hasher->OMKeyFromHash(*it), *omkey_iter);
+  ENSURE(omkey_iter==omkeys.end());
+
+  bool thrown = false;
+  std::set<OMKey> unhashed;
+  unhashed.insert(OMKey(1000,1));
+  try { HashedOMKeySet(hasher, unhashed); }
+  catch (const std::out_of_range&) { thrown = true; }
+  ENSURE(thrown, "not hashed OMKeys throw");
+};
+
+TEST(ElementAccess) {
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+  HashedOMKeySet set(hasher);
+
+  ENSURE(set.Insert(OMKey(1,1)));
+  ENSURE(!set.Insert(OMKey(1,1)), "already contained");
+  ENSURE(set.Contains(OMKey(1,1)));
+  ENSURE(set.Contains(hasher->HashFromOMKey(OMKey(1,1))));
+  ENSURE(!set.Contains(OMKey(1,2)));
+  ENSURE(!set.Contains(OMKey(1000,1)), "not hashed OMKeys are not contained");
+  ENSURE_EQUAL(set.Count(), 1);
+
+  ENSURE(set.Erase(OMKey(1,1)));
+  ENSURE(!set.Erase(OMKey(1,1)), "not contained anymore");
+  ENSURE(!set.Erase(OMKey(1000,1)));
+  ENSURE(set.Empty());
+
+  set.Insert(OMKey(2,2));
+  set.Clear();
+  ENSURE(set.Empty());
+
+  //hashes beyond the hasher
+  const CompactHash beyond = hasher->HashSize();
+  ENSURE(!set.Contains(beyond), "hashes beyond the hasher are not contained");
+  bool thrown = false;
+  try { set.Insert(beyond); }
+  catch (const std::out_of_range&) { thrown = true; }
+  ENSURE(thrown, "inserting a hash beyond the hasher throws");
+  thrown = false;
+  try { set.Erase(beyond); }
+  catch (const std::out_of_range&) { thrown = true; }
+  ENSURE(thrown, "erasing a hash beyond the hasher throws");
+  thrown = false;
+  try { HashedOMKeySet(hasher, std::vector<CompactHash>(1, beyond)); }
+  catch (const std::out_of_range&) { thrown = true; }
+  ENSURE(thrown, "constructing from a hash beyond the hasher throws");
+  ENSURE(set.Empty());
+};
+
+TEST(SetAlgebra) {
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+  const std::set<OMKey> a_omkeys = EveryNth(2, 0);
+  const std::set<OMKey> b_omkeys = EveryNth(3, 0);
+  const HashedOMKeySet a(hasher, a_omkeys);
+  const HashedOMKeySet b(hasher, b_omkeys);
+
+  //compare against the std::set implementations
+  ENSURE((a|b).GetOMKeys()==UniteSets(a_omkeys, b_omkeys));
+  ENSURE((a&b).GetOMKeys()==SetsIntersection(a_omkeys, b_omkeys));
+  ENSURE_EQUAL(a.IntersectionCount(b), SetsIntersectionCount(a_omkeys, b_omkeys));
+  ENSURE(a.Intersects(b));
+
+  std::set<OMKey> difference;
+  std::set_difference(a_omkeys.begin(), a_omkeys.end(), b_omkeys.begin(), b_omkeys.end(), std::inserter(difference, difference.end()));
+  ENSURE((a-b).GetOMKeys()==difference);
+
+  std::set<OMKey> symmetric_difference;
+  std::set_symmetric_difference(a_omkeys.begin(), a_omkeys.end(), b_omkeys.begin(), b_omkeys.end(), std::inserter(symmetric_difference, symmetric_difference.end()));
+  ENSURE((a^b).GetOMKeys()==symmetric_difference);
+
+  ENSURE_EQUAL((~a).Count(), geo->omgeo.size()-a.Count());
+  ENSURE(!(~a).Intersects(a));
+
+  ENSURE((a&b).IsSubsetOf(a));
+  ENSURE((a&b).IsSubsetOf(b));
+  ENSURE(!a.IsSubsetOf(b));
+  ENSURE(a.IsSubsetOf(a|b));
+  ENSURE(a!=b);
+  ENSURE(a==HashedOMKeySet(hasher, a_omkeys));
+};
+
+TEST(VerifyAgainst) {
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+  const CompactOMKeyHashServiceConstPtr sub_hasher = boost::make_shared<const CompactOMKeyHashService>(EveryNth(2, 0));
+
+  //sets over the own hasher are always hashable
+  ENSURE(hasher->VerifyAgainst(HashedOMKeySet::Full(hasher)));
+
+  //sets over a hasher of a subset
+  ENSURE(hasher->VerifyAgainst(HashedOMKeySet::Full(sub_hasher)));
+  ENSURE(sub_hasher->VerifyAgainst(HashedOMKeySet(hasher, EveryNth(4, 0))));
+  ENSURE(!sub_hasher->VerifyAgainst(HashedOMKeySet(hasher, EveryNth(4, 1))));
+  ENSURE(!sub_hasher->VerifyAgainst(HashedOMKeySet::Full(hasher)));
+  ENSURE(sub_hasher->VerifyAgainst(HashedOMKeySet(hasher)), "empty set is always hashable");
+};
@@ -0,0 +1,191 @@
+/**
+ * \file HitBatchTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Test the HitBatch against the set-based hit containers it replaces in the kernels
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/HitBatch.h"
+#include "ToolZ/HitFacility.h"
+#include "ToolZ/PartialCOG.h"
+#include "ToolZ/IC86Topology.h"
+
+#include <boost/make_shared.hpp>
+
+#include "TestHelpers.h"
+
+TEST_GROUP(HitBatch);
+
+static const I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+static const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo, hasher);
+
+///a pulse map with 'nPerDOM' pulses of random time and charge on every in-ice DOM, time-ordered per DOM
+static I3RecoPulseSeriesMap RandomPulses(const unsigned nPerDOM) {
+  TestRandom random(42);
+  I3RecoPulseSeriesMap pulseMap;
+  for (unsigned str=1; str<=86; str++) {
+    for (unsigned om=1; om<=60; om++) {
+      std::vector<double> times;
+      for (unsigned k=0; k<nPerDOM; k++) {
+        times.push_back(double(random.Next()>>38)/64.); //multiples of 1/64 ns, so that some times coincide
+      }
+      std::sort(times.begin(), times.end());
+      BOOST_FOREACH(const double t, times)
+        pulseMap[OMKey(str,om)].push_back(MakeRecoPulse(t, 0.25+double(uint64_t(t)%16)/4.));
+    }
+  }
+  return pulseMap;
+};
+
+///a facility over 'pulseMap', hashed by the IC86 geometry
+static I3RecoPulseSeriesMap_HitFacility MakeFacility(const I3RecoPulseSeriesMap& pulseMap) {
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(pulseMap));
+  const CompactOMKeyHashServiceConstPtr& constHasher = hasher;
+  return I3RecoPulseSeriesMap_HitFacility(frame, "KEY", constHasher);
+};
+
+TEST (FromAbsHits) {
+  //unordered hits, with coinciding times
+  AbsHitSeries series;
+  TestRandom random(1);
+  for (unsigned i=0; i<1000; i++) {
+    const uint64_t state = random.Next();
+    series.push_back(AbsHit(CompactHash(state>>54), double((state>>32)%200)));
+  }
+  const AbsHitSet set(series.begin(), series.end());
+
+  const HitBatch batch(series);
+  ENSURE(!batch.HasCharge());
+  ENSURE(!batch.HasOrigin());
+  //same hits in the order of the AbsHitSet; coinciding hits collapse in the set only
+  ENSURE_EQUAL(batch.size(), series.size());
+  ENSURE(batch.GetAbsHits<AbsHitSet>()==set);
+  for (size_t i=1; i<batch.size(); i++)
+    ENSURE(!(batch.GetAbsHit(i)<batch.GetAbsHit(i-1)), "time-ordered");
+
+  //from the set itself, and from AbsDAQHits
+  const HitBatch setBatch(set);
+  const AbsHitList setOrdered = setBatch.GetAbsHits<AbsHitList>();
+  ENSURE(setOrdered==AbsHitList(set.begin(), set.end()));
+  AbsDAQHitSet daqHits;
+  BOOST_FOREACH(const AbsHit& h, set)
+    daqHits.insert(AbsDAQHit(h.GetDOMIndex(), int64_t(h.GetTime()*10)));
+  const HitBatch daqBatch(daqHits);
+  ENSURE(daqBatch.GetAbsHits<AbsHitList>()==setOrdered);
+
+  ENSURE(HitBatch().empty());
+};
+
+TEST (OMKeyMap_HitFacility) {
+  const I3RecoPulseSeriesMap pulseMap = RandomPulses(8);
+  const I3RecoPulseSeriesMap_HitFacility hf = MakeFacility(pulseMap);
+
+  const HitBatch batch = hf.GetHitBatch(true);
+  ENSURE_EQUAL(batch.size(), 86*60*8);
+  ENSURE(batch.HasCharge());
+  ENSURE(batch.HasOrigin());
+
+  //the same hits in the same order as from the facility's AbsHits
+  const AbsHitList expected = hf.GetAbsHits<AbsHitList>();
+  const AbsHitSet expectedSet(expected.begin(), expected.end());
+  ENSURE(batch.GetAbsHits<AbsHitSet>()==expectedSet);
+  for (size_t i=1; i<batch.size(); i++)
+    ENSURE(!(batch.GetAbsHit(i)<batch.GetAbsHit(i-1)), "time-ordered");
+
+  //the charge and origin trace back to the pulse
+  std::vector<std::pair<OMKey, I3RecoPulse> > flat;
+  BOOST_FOREACH(const I3RecoPulseSeriesMap::value_type& o_rvec, pulseMap)
+    BOOST_FOREACH(const I3RecoPulse& p, o_rvec.second)
+      flat.push_back(std::make_pair(o_rvec.first, p));
+  for (size_t i=0; i<batch.size(); i++) {
+    const std::pair<OMKey, I3RecoPulse>& origin = flat.at(batch.GetOrigin(i));
+    ENSURE(hasher->HashFromOMKey(origin.first)==batch.GetDOMIndex(i));
+    ENSURE_EQUAL(origin.second.GetTime(), batch.GetTime(i));
+    ENSURE_EQUAL(double(origin.second.GetCharge()), batch.GetCharge(i));
+  }
+
+  //without charges
+  ENSURE(!hf.GetHitBatch().HasCharge());
+  ENSURE(hf.GetHitBatch().GetTimes()==batch.GetTimes());
+};
+
+TEST (MapFromHitBatch) {
+  const I3RecoPulseSeriesMap pulseMap = RandomPulses(4);
+  const I3RecoPulseSeriesMap_HitFacility hf = MakeFacility(pulseMap);
+  const HitBatch batch = hf.GetHitBatch();
+
+  ENSURE(hf.MapFromHitBatch(batch)==pulseMap, "full round trip");
+
+  //a time window of the batch reverts to the pulses in that window
+  const double begin = 100000., end = 400000.;
+  I3RecoPulseSeriesMap window;
+  BOOST_FOREACH(const I3RecoPulseSeriesMap::value_type& o_rvec, pulseMap)
+    BOOST_FOREACH(const I3RecoPulse& p, o_rvec.second)
+      if (p.GetTime()>=begin && p.GetTime()<end)
+        window[o_rvec.first].push_back(p);
+  const HitSpan span = batch.GetSpan().TimeWindow(begin, end);
+  std::vector<CompactHash> domIndex(span.domIndex, span.domIndex+span.size);
+  std::vector<double> time(span.time, span.time+span.size);
+  std::vector<double> charge;
+  std::vector<uint32_t> origin(span.origin, span.origin+span.size);
+  const HitBatch sub(domIndex, time, charge, origin);
+  ENSURE(hf.MapFromHitBatch(sub)==window);
+
+  ENSURE(hf.MapFromHitBatch(HitBatch()).empty());
+};
+
+TEST (TimeWindow) {
+  const I3RecoPulseSeriesMap pulseMap = RandomPulses(2);
+  const HitBatch batch = MakeFacility(pulseMap).GetHitBatch();
+  const AbsHitSet set = batch.GetAbsHits<AbsHitSet>();
+  const HitSpan all = batch.GetSpan();
+  ENSURE_EQUAL(all.size, batch.size());
+  ENSURE(all.charge==NULL);
+
+  for (double begin=-1000.; begin<1.1E6; begin+=77777.) {
+    const double end = begin+123456.;
+    const HitSpan window = all.TimeWindow(begin, end);
+    size_t count = 0;
+    BOOST_FOREACH(const AbsHit& h, set)
+      count += (h.GetTime()>=begin && h.GetTime()<end);
+    ENSURE_EQUAL(window.size, count);
+    for (size_t i=0; i<window.size; i++)
+      ENSURE(window.time[i]>=begin && window.time[i]<end);
+  }
+  ENSURE_EQUAL(all.TimeWindow(10., 5.).size, 0u, "empty for reversed bounds");
+  ENSURE_EQUAL(all.SubSpan(10, 5).time, all.time+10);
+};
+
+TEST (ComputeCOG) {
+  const I3RecoPulseSeriesMap pulseMap = RandomPulses(3);
+  const I3RecoPulseSeriesMap_HitFacility hf = MakeFacility(pulseMap);
+  const HitBatch batch = hf.GetHitBatch(true);
+  const AbsHitSet set = hf.GetAbsHits<AbsHitSet>();
+
+  const I3PosTime cog_set = ComputeCOG(posService, set);
+  const I3PosTime cog_span = ComputeCOG(posService, batch.GetSpan());
+  ENSURE_DISTANCE(cog_span.first.GetX(), cog_set.first.GetX(), 1E-6);
+  ENSURE_DISTANCE(cog_span.first.GetY(), cog_set.first.GetY(), 1E-6);
+  ENSURE_DISTANCE(cog_span.first.GetZ(), cog_set.first.GetZ(), 1E-6);
+  ENSURE_DISTANCE(cog_span.second, cog_set.second, 1E-6);
+
+  //charge weighted
+  double sum_charge(0.), sum_z(0.), sum_time(0.);
+  for (size_t i=0; i<batch.size(); i++) {
+    sum_charge += batch.GetCharge(i);
+    sum_z += posService->GetPosition(batch.GetDOMIndex(i)).GetZ()*batch.GetCharge(i);
+    sum_time += batch.GetTime(i)*batch.GetCharge(i);
+  }
+  const I3PosTime cog_charge = ComputeCOG(posService, batch.GetSpan(), true);
+  ENSURE_DISTANCE(cog_charge.first.GetZ(), sum_z/sum_charge, 1E-6);
+  ENSURE_DISTANCE(cog_charge.second, sum_time/sum_charge, 1E-6);
+
+  ENSURE(HitBatch(set).HasCharge()==false);
+};
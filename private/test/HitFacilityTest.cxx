@@ -68,4 +68,158 @@ TEST(I3RecoPulseSeriesMap_HitFacility) {
   ENSURE(appliedMask.size() == recoMap.size());
 };
 
+///does the resolution of the handle raise log_fatal
+static bool IsFatalResolve(const I3RecoPulseSeriesMap_HitFacility& hf, const HitHandle& h) {
+  try { hf.GetResponse(h); }
+  catch (const std::runtime_error&) { return true; }
+  return false;
+};
+
+///Resolve and back-convert HitHandles by a HitFacility
+TEST(HitHandles) {
+  const I3RecoPulseSeriesMap recoMap= GenerateTestRecoPulses();
+
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(recoMap));
+  
+  CompactOMKeyHashServiceConstPtr hasher;
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  
+  const HitHandleSeries handles = hf.GetHitHandles<HitHandleSeries>();
+  ENSURE_EQUAL(handles.size(), 86*60*20, "Expected number of entries for extracted handles");
+  
+  //every handle resolves to the object at its index within the series of its DOM
+  BOOST_FOREACH(const HitHandle& h, handles) {
+    const I3RecoPulse_HitObject ho = hf.GetHitObject(h);
+    ENSURE(ho.GetOMKey()==hasher->OMKeyFromHash(h.GetDOMIndex()));
+    ENSURE(&ho.GetResponseObj()==&hf.GetResponse(h));
+    ENSURE(hf.GetResponse(h)==recoMap.at(ho.GetOMKey())[h.GetResponseIndex()]);
+  }
+  
+  //the handles of hits are those of their response objects
+  const HitSet hits = hf.GetHits<HitSet>();
+  BOOST_FOREACH(const Hit& h, hits) {
+    const HitHandle handle = hf.GetHandle(h);
+    ENSURE_EQUAL(handle.GetDOMIndex(), h.GetDOMIndex());
+    ENSURE(&hf.GetResponse(handle)==&h.GetAssociatedHitObject<I3RecoPulse>().GetResponseObj());
+  }
+  
+  //a subset of handles in any order, copied away from the facility, reverts to the same subset
+  HitHandleSeries subset;
+  for (HitHandleSeries::const_reverse_iterator h_iter=handles.rbegin(); h_iter!=handles.rend(); ++h_iter)
+    if (h_iter->GetResponseIndex()%3==0 && h_iter->GetDOMIndex()%2==0)
+      subset.push_back(*h_iter);
+  const std::vector<HitHandle> copied(subset);
+  
+  const I3RecoPulseSeriesMap subMap = hf.MapFromHandles(copied);
+  ENSURE_EQUAL(subMap.size(), 86*60/2);
+  size_t n_subMap = 0;
+  typedef I3RecoPulseSeriesMap::value_type OMKey_Pulses;
+  BOOST_FOREACH(const OMKey_Pulses& o_pulses, subMap) {
+    ENSURE_EQUAL(o_pulses.second.size(), 7u);
+    for (size_t i=0; i<o_pulses.second.size(); i++)
+      ENSURE(o_pulses.second[i]==recoMap.at(o_pulses.first)[3*i]);
+    n_subMap += o_pulses.second.size();
+  }
+  ENSURE_EQUAL(n_subMap, subset.size());
+  
+  const I3RecoPulseSeriesMapMask subMask = hf.MaskFromHandles(HitHandleSet(subset.begin(), subset.end()));
+  const I3RecoPulseSeriesMap appliedMask = *(subMask.Apply(*frame));
+  ENSURE(appliedMask==subMap);
+  
+  //a handle into a DOM or index not in the map is rejected
+  I3RecoPulseSeriesMap otherMap;
+  otherMap[OMKey(1,1)] = recoMap.at(OMKey(1,1));
+  I3FramePtr otherFrame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  otherFrame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(otherMap));
+  const I3RecoPulseSeriesMap_HitFacility otherHf(otherFrame, "KEY", hasher);
+  ENSURE(IsFatalResolve(otherHf, HitHandle(hasher->HashFromOMKey(OMKey(1,2)), 0)), "a handle into a DOM which is not in the map is rejected");
+  ENSURE(IsFatalResolve(otherHf, HitHandle(hasher->HashFromOMKey(OMKey(1,1)), 20)), "a handle beyond the series of a DOM is rejected");
+};
+
+///the AbsHits extracted from a map, which holds no empty series
+static AbsHitSeries recoMap_HitFacility_AbsHits(const I3RecoPulseSeriesMap& recoMap, const CompactOMKeyHashServiceConstPtr& hasher) {
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(recoMap));
+  return I3RecoPulseSeriesMap_HitFacility(frame, "KEY", hasher).GetAbsHits<AbsHitSeries>();
+};
+
+///Extract CompactHits by a HitFacility
+TEST(CompactHits) {
+  const I3RecoPulseSeriesMap recoMap= GenerateTestRecoPulses();
+
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(recoMap));
+  
+  CompactOMKeyHashServiceConstPtr hasher;
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  
+  const double timeBase = hf.GetTimeBase();
+  ENSURE_EQUAL(timeBase, 0.);
+  
+  const AbsHitSeries abshits = hf.GetAbsHits<AbsHitSeries>();
+  const CompactHitSeries compacthits = hf.GetCompactHits<CompactHitSeries>(timeBase);
+  ENSURE_EQUAL(compacthits.size(), abshits.size());
+  for (size_t i=0; i<abshits.size(); i++)
+    ENSURE(compacthits[i].ToAbsHit(timeBase)==abshits[i]);
+  
+  const CompactHitFlatSet compactset = hf.GetCompactHits<CompactHitFlatSet>(timeBase);
+  const AbsHitSet absset = hf.GetAbsHits<AbsHitSet>();
+  ENSURE_EQUAL(compactset.size(), absset.size());
+  ENSURE(compactset.begin()->ToAbsHit(timeBase)==*absset.begin());
+  
+  //a time base too far away from the hits
+  bool fatal = false;
+  try { hf.GetCompactHits<CompactHitSeries>(timeBase-2*CompactHit::losslessRange); }
+  catch (const std::runtime_error&) { fatal = true; }
+  ENSURE(fatal, "hits beyond the lossless range are rejected");
+};
+
+///Keys of empty series yield no hits, and so need not be held by the hasher
+TEST(UnhashedEmptySeries) {
+  const I3RecoPulseSeriesMap recoMap= GenerateTestRecoPulses();
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(recoMap));
+  
+  //empty series before, amid and after the hashed keys
+  I3RecoPulseSeriesMap extendedMap = recoMap;
+  extendedMap[OMKey(0,1)];
+  extendedMap[OMKey(1,61)];
+  extendedMap[OMKey(99,1)];
+  ENSURE(!hasher->HoldsOMKey(OMKey(1,61)));
+  
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(extendedMap));
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  const size_t nHits = 86*60*20;
+  
+  const HitSeries hits = hf.GetHits<HitSeries>();
+  ENSURE_EQUAL(hits.size(), nHits);
+  ENSURE(hf.MapFromHits(hits)==recoMap);
+  ENSURE(hf.GetAbsHits<AbsHitSeries>()==recoMap_HitFacility_AbsHits(recoMap, hasher));
+  ENSURE_EQUAL(hf.GetAbsDAQHits<AbsDAQHitSeries>().size(), nHits);
+  ENSURE_EQUAL(hf.GetCompactHits<CompactHitSeries>(hf.GetTimeBase()).size(), nHits);
+  ENSURE_EQUAL(hf.GetHitBatch().size(), nHits);
+  ENSURE(hf.MapFromHandles(hf.GetHitHandles<HitHandleSeries>())==recoMap);
+};
 
+#if SERIALIZATION_ENABLED
+///HitHandles survive serialization, and resolve to the same objects afterwards
+TEST(HitHandles_Serialize) {
+  const I3RecoPulseSeriesMap recoMap= GenerateTestRecoPulses();
+
+  I3FramePtr frame = boost::make_shared<I3Frame>(I3Frame::Physics);
+  frame->Put("KEY", boost::make_shared<I3RecoPulseSeriesMap>(recoMap));
+  
+  CompactOMKeyHashServiceConstPtr hasher;
+  const I3RecoPulseSeriesMap_HitFacility hf(frame, "KEY", hasher);
+  
+  const HitHandleSeries* handles_save = new HitHandleSeries(hf.GetHitHandles<HitHandleSeries>());
+  HitHandleSeries* handles_load = nullptr;
+  serialize_object(handles_save, handles_load);
+  
+  ENSURE(*handles_load==*handles_save);
+  ENSURE(hf.MapFromHandles(*handles_load)==recoMap);
+  delete handles_save;
+  delete handles_load;
+};
+#endif //SERIALIZATION_ENABLED
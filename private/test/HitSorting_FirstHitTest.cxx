@@ -77,3 +77,15 @@ TEST (I3RecoPulseSeriesMap_FirstHits_To_AbsHits) {
   ENSURE_EQUAL(abshits.rbegin()->GetDOMIndex(), hashService->HashFromOMKey(OMKey(1,2)));
   ENSURE_EQUAL(abshits.rbegin()->GetTime(), 2.);
 };
+
+TEST (UnhashedEmptySeries) {
+  //the key of an empty series yields no hit, and so need not be held by the hasher
+  I3RecoPulseSeriesMap recoMap = CreateTestMap();
+  recoMap[OMKey(99,1)];
+  ENSURE(!hashService->HoldsOMKey(OMKey(99,1)));
+  
+  const AbsHitSet abshits = OMKeyMap_FirstHits_To_AbsHits<I3RecoPulse,AbsHitSet>(hashService, recoMap);
+  ENSURE_EQUAL(abshits.size(), 2u);
+  const AbsDAQHitSet absdaqhits = OMKeyMap_FirstHits_To_AbsDAQHits<I3RecoPulse,AbsDAQHitSet>(hashService, recoMap);
+  ENSURE_EQUAL(absdaqhits.size(), 2u);
+};
@@ -18,6 +18,9 @@
 
 #include <boost/make_shared.hpp>
 
+#include <cstring>
+#include <algorithm>
+
 //Do testing on the example of an I3RecoPulse
 
 TEST_GROUP(Hitclasses);
@@ -29,3 +32,91 @@ TEST(HitObjects) {
   Hit h(0, GetInferredTime(pulse), ho);
 };
 
+///Hits are values, which can be assigned, sorted in place and copied as memory
+TEST(ValueSemantics) {
+  AbsHitSeries hits;
+  for (unsigned i=0; i<100; i++)
+    hits.push_back(AbsHit((i*37)%11, double((i*53)%17)));
+  
+  const AbsHitSet set(hits.begin(), hits.end());
+  AbsHitSeries sorted(hits);
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  ENSURE(sorted==AbsHitSeries(set.begin(), set.end()));
+  
+  AbsHitSeries copied(hits.size(), AbsHit(0, 0.));
+  std::memcpy(&copied[0], &hits[0], hits.size()*sizeof(AbsHit));
+  ENSURE(copied==hits);
+  
+  AbsDAQHit daqhit(1, 10);
+  daqhit = AbsDAQHit(2, 20);
+  ENSURE(daqhit==AbsDAQHit(2, 20));
+  
+  OMKey omkey(1,1);
+  I3RecoPulse pulse = MakeRecoPulse(0, 1.);
+  HitObject<I3RecoPulse> ho(omkey, pulse);
+  Hit h(0, GetInferredTime(pulse), ho);
+  Hit h_assigned(1, 0., ho);
+  h_assigned = h;
+  ENSURE(h_assigned==h);
+  ENSURE(&h_assigned.GetAssociatedHitObject<I3RecoPulse>()==&ho);
+};
+
+///HitObjectOriginals keep referring to their own copies when being copied and assigned
+TEST(HitObjectOriginal) {
+  const I3RecoPulse_HitObjectOriginal hoo(OMKey(1,1), MakeRecoPulse(0, 1.));
+  I3RecoPulse_HitObjectOriginal hoo_copied(hoo);
+  I3RecoPulse_HitObjectOriginal hoo_assigned(OMKey(2,2), MakeRecoPulse(5, 2.));
+  hoo_assigned = hoo;
+  
+  ENSURE(hoo_copied.GetOMKey()==hoo.GetOMKey());
+  ENSURE(hoo_assigned.GetOMKey()==hoo.GetOMKey());
+  ENSURE(hoo_assigned.GetResponseObj()==hoo.GetResponseObj());
+  ENSURE(&hoo_copied.GetResponseObj()!=&hoo.GetResponseObj());
+  ENSURE(&hoo_assigned.GetResponseObj()!=&hoo.GetResponseObj());
+};
+
+///does the construction of a CompactHit raise log_fatal
+static bool IsFatalCompact(const AbsHit& h, const double timeBase) {
+  try { CompactHit(h, timeBase); }
+  catch (const std::runtime_error&) { return true; }
+  return false;
+};
+
+///CompactHits convert AbsDAQHits exactly and AbsHits to a DAQ tick within the lossless range
+TEST(CompactHit) {
+  ENSURE_EQUAL(sizeof(CompactHit), 8u);
+  
+  const double timeBase = 9876.5;
+  TestRandom random(3);
+  AbsDAQHitSet daqhits;
+  CompactHitSet compacthits;
+  for (unsigned i=0; i<10000; i++) {
+    const uint64_t state = random.Next();
+    //ticks from the time base to the edge of the lossless range
+    const int64_t ticks = int64_t(timeBase*10.)+int64_t((state>>33)%int64_t(CompactHit::losslessRange*10.));
+    const AbsDAQHit daqhit((state>>20)%100, ticks);
+    const CompactHit compacthit(daqhit, timeBase);
+    ENSURE(compacthit.ToAbsDAQHit(timeBase)==daqhit);
+    daqhits.insert(daqhit);
+    compacthits.insert(compacthit);
+    
+    const AbsHit abshit(daqhit.GetDOMIndex(), ticks/10.+0.03);
+    const AbsHit abshit_cycled = CompactHit(abshit, timeBase).ToAbsHit(timeBase);
+    ENSURE_EQUAL(abshit_cycled.GetDOMIndex(), abshit.GetDOMIndex());
+    ENSURE_DISTANCE(abshit_cycled.GetTime(), abshit.GetTime(), 0.05);
+  }
+  
+  //the order of the hits is retained
+  ENSURE_EQUAL(compacthits.size(), daqhits.size());
+  AbsDAQHitSet::const_iterator daq_iter = daqhits.begin();
+  BOOST_FOREACH(const CompactHit& h, compacthits)
+    ENSURE(h.ToAbsDAQHit(timeBase)==*(daq_iter++));
+  
+  //beyond the lossless range
+  ENSURE(CompactHit::InLosslessRange(-CompactHit::losslessRange+1.));
+  ENSURE(!CompactHit::InLosslessRange(CompactHit::losslessRange));
+  ENSURE(!IsFatalCompact(AbsHit(0, timeBase-1000.), timeBase));
+  ENSURE(IsFatalCompact(AbsHit(0, timeBase+CompactHit::losslessRange), timeBase), "beyond the lossless range");
+  ENSURE(IsFatalCompact(AbsHit(0, timeBase-CompactHit::losslessRange-1.), timeBase), "before the lossless range");
+};
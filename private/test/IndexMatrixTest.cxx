@@ -13,8 +13,10 @@
 #include <I3Test.h>
 
 #include "ToolZ/IndexMatrix.h"
+#include "ToolZ/TiledLayout.h"
 
 #include <boost/make_shared.hpp>
+#include <boost/tuple/tuple.hpp>
 
 #include "TestHelpers.h"
 
@@ -91,6 +93,148 @@ TEST (SymmetricIndexMatrix_Bool_Predicate) {
   }
 };
 
+///a predicate which is true for a pseudo-random half of the pairs, symmetric in its arguments
+struct HashPredicate {
+  bool operator() (const uint64_t index_A, const uint64_t index_B) const {
+    const uint64_t low = std::min(index_A, index_B);
+    const uint64_t high = std::max(index_A, index_B);
+    return ((high*2654435761ULL) ^ (low*40503ULL)) & 0x10;
+  };
+};
+
+TEST (Bool_Predicate_LargeAndThreaded) {
+  const HashPredicate hp;
+  //sizes around the boundaries of the blocks of bits
+  const unsigned sizes[] = {1, 11, 64, 65, 181, 1000};
+  BOOST_FOREACH(const unsigned size, sizes) {
+    for (unsigned nThreads=1; nThreads<=3; nThreads++) {
+      const SymmetricIndexMatrix_Bool simb(size, hp, nThreads);
+      const AsymmetricIndexMatrix_Bool aimb(size, hp, nThreads);
+      for (unsigned index_A=0; index_A<size; index_A++) {
+        for (unsigned index_B=0; index_B<size; index_B++) {
+          ENSURE_EQUAL(simb.Get(index_A, index_B), hp(index_A, index_B));
+          ENSURE_EQUAL(aimb.Get(index_A, index_B), hp(index_A, index_B));
+        }
+      }
+    }
+  }
+  
+  //also takes boost::function
+  const boost::function<bool (const uint64_t, const uint64_t)> f = hp;
+  const SymmetricIndexMatrix_Bool simb(100, f);
+  ENSURE_EQUAL(simb.Get(17, 42), hp(17, 42));
+};
+
+///find the row of a linear index of the symmetric layout by a linear search, as formerly done
+static std::pair<unsigned, unsigned> LinearSearch_UniIndex_To_BiIndex(const uint64_t index) {
+  uint64_t indexA=0;
+  while ((indexA*indexA+indexA)/2 <= index)
+    indexA++;
+  indexA--;
+  return std::make_pair(indexA, index-(indexA*indexA+indexA)/2);
+};
+
+///expose the index conversions of the symmetric layout
+struct ExposedSymmetricIndexMatrix : public SymmetricIndexMatrix<bool, boost::dynamic_bitset<> > {
+  ExposedSymmetricIndexMatrix(const unsigned biSize) : SymmetricIndexMatrix<bool, boost::dynamic_bitset<> >(biSize) {};
+  using SymmetricIndexMatrix<bool, boost::dynamic_bitset<> >::BiIndex_To_UniIndex;
+  using SymmetricIndexMatrix<bool, boost::dynamic_bitset<> >::UniIndex_To_BiIndex;
+};
+
+TEST (SymmetricIndexMatrix_ClosedFormInversion) {
+  const ExposedSymmetricIndexMatrix m(3000);
+  for (uint64_t index=0; index<(3000*3000+3000)/2; index+=97)
+    ENSURE(m.UniIndex_To_BiIndex(index)==LinearSearch_UniIndex_To_BiIndex(index));
+  //the first and last fields of each row
+  for (unsigned index_A=0; index_A<3000; index_A++) {
+    ENSURE(m.UniIndex_To_BiIndex(m.BiIndex_To_UniIndex(index_A, 0))==std::make_pair(index_A, 0u));
+    ENSURE(m.UniIndex_To_BiIndex(m.BiIndex_To_UniIndex(index_A, index_A))==std::make_pair(index_A, index_A));
+  }
+};
+
+///expose the conversion of linear indices of a matrix
+template <class Matrix>
+struct ExposedIndexMatrix : public Matrix {
+  ExposedIndexMatrix(const unsigned biSize) : Matrix(biSize) {};
+  using Matrix::UniIndex_To_BiIndex;
+};
+
+///does the conversion of the linear index raise log_fatal
+template <class Matrix>
+static bool IsFatalInversion(const Matrix& m, const size_t index) {
+  try { m.UniIndex_To_BiIndex(index); }
+  catch (const std::runtime_error&) { return true; }
+  return false;
+};
+
+TEST (UniIndex_To_BiIndex_Range) {
+  const ExposedSymmetricIndexMatrix m(100);
+  ENSURE(!IsFatalInversion(m, 100*101/2-1), "the last field is converted");
+  ENSURE(IsFatalInversion(m, 100*101/2), "the position past the last field is rejected");
+  
+  typedef TiledLayout<8> Layout;
+  const ExposedIndexMatrix<TiledSymmetricIndexMatrix<uint32_t, std::vector<uint32_t>, 8>::type> tiled_sym(10);
+  ENSURE(tiled_sym.UniIndex_To_BiIndex(Layout::SymmetricIndex(10, 9, 8))==std::make_pair(9u, 8u));
+  ENSURE(IsFatalInversion(tiled_sym, Layout::SymmetricIndex(10, 0, 1)), "the upper half of a diagonal tile is rejected");
+  ENSURE(IsFatalInversion(tiled_sym, Layout::SymmetricIndex(10, 10, 0)), "the padding of an edge tile is rejected");
+  
+  const ExposedIndexMatrix<TiledAsymmetricIndexMatrix<uint32_t, std::vector<uint32_t>, 8>::type> tiled_asym(10);
+  ENSURE(tiled_asym.UniIndex_To_BiIndex(Layout::AsymmetricIndex(10, 2, 9))==std::make_pair(2u, 9u));
+  ENSURE(IsFatalInversion(tiled_asym, Layout::AsymmetricIndex(10, 2, 10)), "the padding of an edge tile is rejected");
+  ENSURE(IsFatalInversion(tiled_asym, Layout::AsymmetricSize(10)), "the position past the storage is rejected");
+};
+
+///check a view against the element-wise access
+template <class Matrix>
+static void CheckLine(const Matrix& m, const BitLine& line, const unsigned fixed, const bool isRow) {
+  ENSURE_EQUAL(line.size(), m.GetBiSize());
+  std::vector<unsigned> expected;
+  for (unsigned index=0; index<m.GetBiSize(); index++) {
+    const bool value = isRow ? m.Get(fixed, index) : m.Get(index, fixed);
+    ENSURE_EQUAL(line.Test(index), value);
+    if (value)
+      expected.push_back(index);
+  }
+  const std::vector<unsigned> iterated(line.begin(), line.end());
+  ENSURE(iterated==expected, "iteration yields the true fields in order");
+  ENSURE_EQUAL(line.Count(), expected.size());
+  ENSURE_EQUAL(line.Any(), !expected.empty());
+  ENSURE_EQUAL(line.FindFirst(), expected.empty() ? BitLine::npos : size_t(expected.front()));
+  
+  boost::dynamic_bitset<uint64_t> bits;
+  line.GetBits(bits);
+  ENSURE_EQUAL(bits.size(), m.GetBiSize());
+  ENSURE_EQUAL(bits.count(), expected.size());
+  BOOST_FOREACH(const unsigned index, expected)
+    ENSURE(bits.test(index));
+};
+
+TEST (Bool_RowAndColumnViews) {
+  const HashPredicate hp;
+  const unsigned sizes[] = {1, 2, 63, 64, 65, 150};
+  BOOST_FOREACH(const unsigned size, sizes) {
+    const SymmetricIndexMatrix_Bool simb(size, hp);
+    const AsymmetricIndexMatrix_Bool aimb(size, hp);
+    for (unsigned fixed=0; fixed<size; fixed++) {
+      CheckLine(simb, simb.GetRow(fixed), fixed, true);
+      CheckLine(simb, simb.GetColumn(fixed), fixed, false);
+      CheckLine(aimb, aimb.GetRow(fixed), fixed, true);
+      CheckLine(aimb, aimb.GetColumn(fixed), fixed, false);
+    }
+  }
+  
+  //an asymmetric matrix, where rows and columns differ
+  AsymmetricIndexMatrix_Bool aimb(70);
+  aimb.Set(3, 0, true);
+  aimb.Set(3, 69, true);
+  aimb.Set(5, 3, true);
+  CheckLine(aimb, aimb.GetRow(3), 3, true);
+  CheckLine(aimb, aimb.GetColumn(3), 3, false);
+  ENSURE_EQUAL(aimb.GetRow(3).Count(), 2);
+  ENSURE_EQUAL(aimb.GetColumn(3).FindFirst(), 5);
+  ENSURE(!aimb.GetRow(4).Any());
+};
+
 TEST (SymmetricIndexMatrix_Double_SetAndGet) {
   SymmetricIndexMatrix_Double d(2);
   
@@ -126,6 +270,295 @@ TEST (AsymmetricIndexMatrix_Double_SetAndGet) {
 };
 
 
+///the true fields are a band of width 2*40 around the diagonal
+struct BandPredicate {
+  bool operator() (const uint64_t index_A, const uint64_t index_B) const 
+    {return (index_A>index_B ? index_A-index_B : index_B-index_A)<=40;};
+};
+
+///the layout functions are consistent: the inversion and the stepping reproduce the position of every field
+template <class Layout>
+static void CheckLayout(const unsigned biSize) {
+  unsigned indexA = 0, indexB = 0;
+  size_t n_fields = 0;
+  for (size_t index=0; index<Layout::SymmetricSize(biSize); index++) {
+    ENSURE(Layout::SymmetricBiIndex(biSize, index)==std::make_pair(indexA, indexB));
+    if (Layout::SymmetricIsField(biSize, indexA, indexB)) {
+      ENSURE_EQUAL(Layout::SymmetricIndex(biSize, indexA, indexB), index);
+      n_fields++;
+    }
+    Layout::SymmetricNext(biSize, indexA, indexB);
+  }
+  ENSURE_EQUAL(n_fields, size_t(biSize)*(biSize+1)/2, "every field of the triangle has a position");
+  
+  indexA = 0;
+  indexB = 0;
+  n_fields = 0;
+  for (size_t index=0; index<Layout::AsymmetricSize(biSize); index++) {
+    ENSURE(Layout::AsymmetricBiIndex(biSize, index)==std::make_pair(indexA, indexB));
+    if (Layout::AsymmetricIsField(biSize, indexA, indexB)) {
+      ENSURE_EQUAL(Layout::AsymmetricIndex(biSize, indexA, indexB), index);
+      n_fields++;
+    }
+    Layout::AsymmetricNext(biSize, indexA, indexB);
+  }
+  ENSURE_EQUAL(n_fields, size_t(biSize)*biSize, "every field of the square has a position");
+};
+
+TEST (Layouts) {
+  const unsigned sizes[] = {1, 7, 8, 9, 30};
+  BOOST_FOREACH(const unsigned biSize, sizes) {
+    CheckLayout<RowMajorLayout>(biSize);
+    CheckLayout<TiledLayout<8> >(biSize);
+  }
+  CheckLayout<TiledLayout<64> >(130);
+  
+  //the linear index of a Gen2-scale matrix exceeds 32 bits
+  const size_t gen2 = 100000;
+  ENSURE_EQUAL(RowMajorLayout::SymmetricIndex(gen2, gen2-1, gen2-1), 5000049999ULL);
+  ENSURE(RowMajorLayout::SymmetricBiIndex(gen2, 5000049999ULL)==std::make_pair(unsigned(gen2-1), unsigned(gen2-1)));
+  ENSURE_EQUAL(RowMajorLayout::AsymmetricIndex(gen2, gen2-1, gen2-1), gen2*gen2-1);
+};
+
+///collects the fields visited by ForEachField
+struct FieldCollector {
+  std::vector<boost::tuple<unsigned, unsigned, uint32_t> >* fields_;
+  void operator()(const unsigned indexA, const unsigned indexB, const uint32_t value) const
+    {fields_->push_back(boost::make_tuple(indexA, indexB, value));};
+};
+
+TEST (TiledLayout_SetAndGet) {
+  const unsigned sizes[] = {1, 63, 64, 65, 200};
+  BOOST_FOREACH(const unsigned biSize, sizes) {
+    SymmetricIndexMatrix<uint32_t, std::vector<uint32_t> > flat_sym(biSize);
+    TiledSymmetricIndexMatrix<uint32_t, std::vector<uint32_t> >::type tiled_sym(biSize);
+    AsymmetricIndexMatrix<uint32_t, std::vector<uint32_t> > flat_asym(biSize);
+    TiledAsymmetricIndexMatrix<uint32_t, std::vector<uint32_t> >::type tiled_asym(biSize);
+    
+    for (unsigned a=0; a<biSize; a++) {
+      for (unsigned b=0; b<biSize; b++) {
+        if (b<=a) {
+          flat_sym.Set(a, b, a*1000+b+1);
+          tiled_sym.Set(b, a, a*1000+b+1); //the symmetric matrix is indifferent to the order
+        }
+        flat_asym.Set(a, b, a*1000+b+1);
+        tiled_asym.Set(a, b, a*1000+b+1);
+      }
+    }
+    for (unsigned a=0; a<biSize; a++) {
+      for (unsigned b=0; b<biSize; b++) {
+        ENSURE_EQUAL(tiled_sym.Get(a, b), flat_sym.Get(a, b));
+        ENSURE_EQUAL(tiled_asym.Get(a, b), flat_asym.Get(a, b));
+      }
+    }
+    
+    //the tiled matrix visits the fields tile after tile, every field once, and none of the padding
+    std::vector<boost::tuple<unsigned, unsigned, uint32_t> > fields;
+    const FieldCollector collector = {&fields};
+    tiled_sym.ForEachField(collector);
+    ENSURE_EQUAL(fields.size(), size_t(biSize)*(biSize+1)/2);
+    for (size_t f=0; f<fields.size(); f++) {
+      const unsigned a = fields[f].get<0>(), b = fields[f].get<1>();
+      ENSURE(b<=a && a<biSize);
+      ENSURE_EQUAL(fields[f].get<2>(), a*1000+b+1);
+      if (f) {
+        const unsigned prevA = fields[f-1].get<0>(), prevB = fields[f-1].get<1>();
+        ENSURE(std::make_pair(prevA/64, prevB/64)<=std::make_pair(a/64, b/64), "tile order");
+      }
+    }
+    
+    fields.clear();
+    flat_asym.ForEachField(collector);
+    ENSURE_EQUAL(fields.size(), size_t(biSize)*biSize);
+    for (size_t f=0; f<fields.size(); f++)
+      ENSURE(fields[f].get<0>()==f/biSize && fields[f].get<1>()==f%biSize, "row-major order");
+    fields.clear();
+    tiled_asym.ForEachField(collector);
+    ENSURE_EQUAL(fields.size(), size_t(biSize)*biSize);
+  }
+};
+
+///a predicate which is true for a pseudo-random fraction of the pairs; symmetric in its arguments if requested
+struct SparsePredicate {
+  unsigned permille_;
+  bool symmetric_;
+  bool operator() (const uint64_t index_A, const uint64_t index_B) const {
+    const uint64_t first = symmetric_ ? std::min(index_A, index_B) : index_A;
+    const uint64_t second = symmetric_ ? std::max(index_A, index_B) : index_B;
+    return ((second*2654435761ULL) ^ (first*40503ULL) ^ (first*second*97ULL)) % 1000 < permille_;
+  };
+};
+
+template <class Lhs, class Rhs>
+static std::vector<std::vector<bool> > NaiveProduct(const Lhs& lhs, const Rhs& rhs, const unsigned size) {
+  std::vector<std::vector<bool> > product(size, std::vector<bool>(size, false));
+  for (unsigned index_A=0; index_A<size; index_A++) {
+    for (unsigned index_B=0; index_B<size; index_B++) {
+      for (unsigned index_C=0; index_C<size && !product[index_A][index_B]; index_C++)
+        product[index_A][index_B] = lhs.Get(index_A, index_C) && rhs.Get(index_C, index_B);
+    }
+  }
+  return product;
+};
+
+///the fields reachable by paths of 1 to nSteps steps, by extending the paths one step at a time
+template <class Matrix>
+static std::vector<std::vector<bool> > NaiveReachable(const Matrix& m, const unsigned size, const unsigned nSteps) {
+  std::vector<std::vector<bool> > reach(size, std::vector<bool>(size, false));
+  if (!nSteps)
+    return reach;
+  for (unsigned index_A=0; index_A<size; index_A++) {
+    for (unsigned index_B=0; index_B<size; index_B++)
+      reach[index_A][index_B] = m.Get(index_A, index_B);
+  }
+  for (unsigned step=1; step<nSteps; step++) {
+    std::vector<std::vector<bool> > extended(reach);
+    for (unsigned index_A=0; index_A<size; index_A++) {
+      for (unsigned index_C=0; index_C<size; index_C++) {
+        if (!reach[index_A][index_C])
+          continue;
+        for (unsigned index_B=0; index_B<size; index_B++)
+          extended[index_A][index_B] = extended[index_A][index_B] || m.Get(index_C, index_B);
+      }
+    }
+    if (extended==reach)
+      break;
+    reach.swap(extended);
+  }
+  return reach;
+};
+
+template <class Matrix>
+static void CheckEqual(const Matrix& m, const std::vector<std::vector<bool> >& reference) {
+  for (unsigned index_A=0; index_A<reference.size(); index_A++) {
+    for (unsigned index_B=0; index_B<reference.size(); index_B++)
+      ENSURE_EQUAL(m.Get(index_A, index_B), bool(reference[index_A][index_B]));
+  }
+};
+
+TEST (Bool_Product) {
+  const SparsePredicate symmetric = {100, true};
+  const SparsePredicate asymmetric = {100, false};
+  const SparsePredicate other = {30, false};
+  //sizes around the boundaries of the blocks of bits and of the tabulated bits
+  const unsigned sizes[] = {1, 8, 9, 63, 64, 65, 150};
+  BOOST_FOREACH(const unsigned size, sizes) {
+    const SymmetricIndexMatrix_Bool sa(size, symmetric);
+    const SymmetricIndexMatrix_Bool sb(size, BandPredicate());
+    const AsymmetricIndexMatrix_Bool aa(size, asymmetric);
+    const AsymmetricIndexMatrix_Bool ab(size, other);
+    for (unsigned nThreads=1; nThreads<=3; nThreads+=2) {
+      CheckEqual(sa.Multiply(sb, nThreads), NaiveProduct(sa, sb, size));
+      CheckEqual(aa.Multiply(ab, nThreads), NaiveProduct(aa, ab, size));
+    }
+  }
+};
+
+TEST (Bool_ReachableAndClosure) {
+  //sparse enough to leave several clusters and unlinked indices
+  const SparsePredicate symmetric = {8, true};
+  const SparsePredicate asymmetric = {8, false};
+  const unsigned sizes[] = {1, 63, 64, 65, 150};
+  BOOST_FOREACH(const unsigned size, sizes) {
+    const SymmetricIndexMatrix_Bool simb(size, symmetric);
+    const AsymmetricIndexMatrix_Bool aimb(size, asymmetric);
+    for (unsigned nSteps=0; nSteps<=5; nSteps++) {
+      CheckEqual(simb.ReachableWithin(nSteps, 2), NaiveReachable(simb, size, nSteps));
+      CheckEqual(aimb.ReachableWithin(nSteps, 2), NaiveReachable(aimb, size, nSteps));
+    }
+    CheckEqual(simb.TransitiveClosure(), NaiveReachable(simb, size, size));
+    CheckEqual(aimb.TransitiveClosure(2), NaiveReachable(aimb, size, size));
+  }
+  
+  //a chain is connected end to end only by the closure
+  SymmetricIndexMatrix_Bool chain(100);
+  for (unsigned index=1; index<100; index++)
+    chain.Set(index-1, index, true);
+  ENSURE(!chain.ReachableWithin(98).Get(0, 99));
+  ENSURE(chain.ReachableWithin(99).Get(0, 99));
+  ENSURE(chain.TransitiveClosure().Get(0, 99));
+  ENSURE(chain.TransitiveClosure().Get(42, 42), "linked indices reach themselves");
+};
+
+///compare a PackedIntVector against plain values, element-wise and in bulk
+template <unsigned Bits>
+static void CheckPacked(const size_t size) {
+  PackedIntVector<Bits> packed(size);
+  std::vector<uint32_t> plain(size);
+  TestRandom random(Bits);
+  for (size_t i=0; i<size; i++) {
+    const uint64_t state = random.Next();
+    plain[i] = uint32_t(state>>32) & PackedIntVector<Bits>::max_value;
+    packed[i] = uint32_t(state>>32); //truncated to the lowest bits
+  }
+  for (size_t i=0; i<size; i++)
+    ENSURE_EQUAL(packed[i], plain[i]);
+  
+  //bulk paths at unaligned offsets
+  std::vector<uint32_t> unpacked(size);
+  for (size_t first=0; first<std::min(size, size_t(70)); first+=13) {
+    packed.Unpack(first, size-first, &unpacked[0]);
+    ENSURE(std::equal(unpacked.begin(), unpacked.begin()+(size-first), plain.begin()+first));
+  }
+  PackedIntVector<Bits> repacked(size);
+  repacked.Pack(0, size/3, &plain[0]);
+  repacked.Pack(size/3, size-size/3, &plain[size/3]);
+  for (size_t i=0; i<size; i++)
+    ENSURE_EQUAL(repacked[i], plain[i]);
+  ENSURE(packed.GetNBytes()<=(size*Bits+63)/64*8+8, "no padding per field");
+};
+
+TEST (PackedIntVector) {
+  CheckPacked<2>(1000);
+  CheckPacked<3>(1000);
+  CheckPacked<7>(999);
+  CheckPacked<12>(1001);
+  CheckPacked<16>(1000);
+  CheckPacked<31>(1000);
+  CheckPacked<32>(1000);
+  
+  //as the storage of a matrix
+  const unsigned biSize = 300;
+  SymmetricIndexMatrix<uint32_t, PackedIntVector<12> > packed(biSize);
+  SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > plain(biSize);
+  for (unsigned a=0; a<biSize; a++) {
+    for (unsigned b=0; b<=a; b++) {
+      packed.Set(a, b, (a*7+b*13)%4096);
+      plain.Set(a, b, (a*7+b*13)%4096);
+    }
+  }
+  for (unsigned a=0; a<biSize; a++) {
+    for (unsigned b=0; b<biSize; b++)
+      ENSURE_EQUAL(packed.Get(a, b), uint32_t(plain.Get(a, b)));
+  }
+};
+
+TEST (FixedPointVector) {
+  //decimetres in 12 bits
+  typedef FixedPointVector<12, 10> Decimetres;
+  Decimetres fixed(5);
+  fixed[0] = 17.04;
+  fixed[1] = 17.06;
+  fixed[2] = 1000.;
+  fixed[3] = -1.;
+  fixed[4] = 0.25;
+  ENSURE_EQUAL(fixed[0], 17.);
+  ENSURE_EQUAL(fixed[1], 17.1);
+  ENSURE_EQUAL(fixed[2], 409.5, "saturates");
+  ENSURE_EQUAL(fixed[3], 0.);
+  ENSURE_DISTANCE(fixed[4], 0.25, 0.05);
+  ENSURE_EQUAL(Decimetres::GetMaxValue(), 409.5);
+  
+  std::vector<double> unpacked(5);
+  fixed.Unpack(0, 5, &unpacked[0]);
+  for (size_t i=0; i<5; i++)
+    ENSURE_EQUAL(unpacked[i], fixed[i]);
+  
+  SymmetricIndexMatrix<double, FixedPointVector<12, 10> > matrix(10);
+  matrix.Set(3, 7, 125.04);
+  ENSURE_EQUAL(matrix.Get(7, 3), 125.);
+};
+
 #if SERIALIZATION_ENABLED
 static size_t maxSize = 100;
 
@@ -186,10 +619,114 @@ TEST(AsymmetricIndexMatrix_Bool_Serialize_boost_shared_ptr){
   serialize_object(AIMB_save, AIMB_load);
 };
 
+TEST(PackedIntVector_Serialize){
+  SymmetricIndexMatrix<uint32_t, PackedIntVector<12> >* save = new SymmetricIndexMatrix<uint32_t, PackedIntVector<12> >(maxSize);
+  save->Set(42, 17, 4000);
+  SymmetricIndexMatrix<uint32_t, PackedIntVector<12> >* load = nullptr;
+  
+  serialize_object(save, load);
+  ENSURE_EQUAL(load->Get(17, 42), 4000u);
+  delete save;
+  delete load;
+};
+
+TEST(Layout_Serialize){
+  typedef TiledSymmetricIndexMatrix<uint32_t, std::vector<uint32_t>, 8>::type Tiled;
+  Tiled* save = new Tiled(maxSize);
+  save->Set(42, 17, 4000);
+  Tiled* load = nullptr;
+  serialize_object(save, load);
+  ENSURE_EQUAL(load->Get(17, 42), 4000u);
+  delete load;
+  
+  //the fields of one layout do not load into another layout
+  std::stringstream ss;
+  {
+    SERIALIZATION_NS_BASE::archive::portable_binary_oarchive oa(ss);
+    oa << save;
+  }
+  delete save;
+  SymmetricIndexMatrix<uint32_t, std::vector<uint32_t> >* other = nullptr;
+  bool fatal = false;
+  try {
+    SERIALIZATION_NS_BASE::archive::portable_binary_iarchive ia(ss);
+    ia >> other;
+  }
+  catch (const std::runtime_error&) { fatal = true; }
+  ENSURE(fatal, "the layout tag is checked on loading");
+};
+
 TEST(SymmetricIndexMatrix_Bool_Serialize_boost_shared_ptr){    
   SymmetricIndexMatrix_BoolPtr SIMB_save = boost::make_shared<SymmetricIndexMatrix_Bool>(maxSize);
   SymmetricIndexMatrix_BoolPtr SIMB_load;
   
   serialize_object(SIMB_save, SIMB_load);
 };
+
+///a bitset of n pseudo-random bits
+static boost::dynamic_bitset<> RandomBitset(const size_t n) {
+  std::vector<boost::dynamic_bitset<>::block_type> blocks((n+boost::dynamic_bitset<>::bits_per_block-1)/boost::dynamic_bitset<>::bits_per_block);
+  TestRandom random(n);
+  for (size_t b=0; b<blocks.size(); b++)
+    blocks[b] = random.Next();
+  boost::dynamic_bitset<> bits(blocks.begin(), blocks.end());
+  bits.resize(n);
+  return bits;
+};
+
+TEST(DynamicBitSet_Serialize){
+  //sizes, which fill the last block partially and completely, and which span several chunks
+  const size_t sizes[] = {0, 1, 63, 64, 65, 1000, 100000};
+  BOOST_FOREACH(const size_t n, sizes) {
+    const boost::dynamic_bitset<> save = RandomBitset(n);
+    boost::dynamic_bitset<> load(7, 1ul);
+    std::stringstream ss;
+    {
+      SERIALIZATION_NS_BASE::archive::portable_binary_oarchive oa(ss);
+      oa << save;
+    }
+    {
+      SERIALIZATION_NS_BASE::archive::portable_binary_iarchive ia(ss);
+      ia >> load;
+    }
+    ENSURE(load==save);
+    ENSURE_EQUAL(load.count(), save.count());
+  }
+  
+  SymmetricIndexMatrix_Bool* SIMB_save = new SymmetricIndexMatrix_Bool(maxSize);
+  SIMB_save->Set(60, 6, true);
+  SymmetricIndexMatrix_Bool* SIMB_load = nullptr;
+  serialize_object(SIMB_save, SIMB_load);
+  ENSURE(SIMB_load->Get(6, 60) && !SIMB_load->Get(6, 61));
+  delete SIMB_save;
+  delete SIMB_load;
+};
+
+///archive a bitset as in version 0: the number of bits, and the blocks as a vector
+template <class Archive>
+static void SaveVersion0(Archive& ar, const boost::dynamic_bitset<>& bits) {
+  size_t num_bits = bits.size();
+  std::vector<boost::dynamic_bitset<>::block_type> blocks(bits.num_blocks());
+  to_block_range(bits, blocks.begin());
+  ar << SERIALIZATION_NS::make_nvp("num_bits", num_bits);
+  ar << SERIALIZATION_NS::make_nvp("blocks", blocks);
+};
+
+TEST(DynamicBitSet_Serialize_version0){
+  const size_t sizes[] = {0, 65, 100000};
+  BOOST_FOREACH(const size_t n, sizes) {
+    const boost::dynamic_bitset<> save = RandomBitset(n);
+    boost::dynamic_bitset<> load(7, 1ul);
+    std::stringstream ss;
+    {
+      SERIALIZATION_NS_BASE::archive::portable_binary_oarchive oa(ss);
+      SaveVersion0(oa, save);
+    }
+    {
+      SERIALIZATION_NS_BASE::archive::portable_binary_iarchive ia(ss);
+      SERIALIZATION_NS::load(ia, load, 0);
+    }
+    ENSURE(load==save);
+  }
+};
 #endif //SERIALIZATION_ENABLED
@@ -0,0 +1,175 @@
+/**
+ * \file MappedIndexMatrixTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Test the read-only mapped matrices against the matrices they were written from
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/MappedIndexMatrix.h"
+#include "ToolZ/TiledLayout.h"
+#include "ToolZ/DistanceService.h"
+#include "ToolZ/IC86Topology.h"
+
+#include <boost/make_shared.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "TestHelpers.h"
+
+using namespace indexmatrix;
+
+TEST_GROUP(MappedIndexMatrix);
+
+///the file all tests write to
+static const std::string path = "MappedIndexMatrixTest.idx";
+
+///does the call of 'function' raise log_fatal
+template <class Function>
+bool IsFatal(Function function) {
+  try { function(); }
+  catch (const std::runtime_error&) { return true; }
+  return false;
+};
+
+static void OpenSymmetric_uint16(const uint64_t checksum)
+  {MappedSymmetricIndexMatrix<uint16_t>::Open(path, checksum);};
+
+static void OpenAsymmetric_uint16(const uint64_t checksum)
+  {MappedAsymmetricIndexMatrix<uint16_t>::Open(path, checksum);};
+
+static void OpenSymmetric_int32()
+  {MappedSymmetricIndexMatrix<int32_t>::Open(path, 42);};
+
+static void OpenTiled_uint16()
+  {MappedSymmetricIndexMatrix<uint16_t, TiledLayout<64> >::Open(path, 42);};
+
+TEST (SetAndGet) {
+  const unsigned size = 300;
+  SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > sym(size);
+  AsymmetricIndexMatrix<double, std::vector<double> > asym(size);
+  TiledSymmetricIndexMatrix<float, std::vector<float>, 64>::type tiled(size);
+  for (unsigned i=0; i<size; i++) {
+    for (unsigned j=0; j<size; j++) {
+      sym.Set(i, j, i*j%65536);
+      asym.Set(i, j, i-0.5*j);
+      tiled.Set(i, j, i+j+0.25f);
+    }
+  }
+
+  WriteMapped(path, sym, 42);
+  const MappedSymmetricIndexMatrix<uint16_t>::type mapped_sym = MappedSymmetricIndexMatrix<uint16_t>::Open(path, 42);
+  WriteMapped(path, asym, 42);
+  const MappedAsymmetricIndexMatrix<double>::type mapped_asym = MappedAsymmetricIndexMatrix<double>::Open(path, 42);
+  WriteMapped(path, tiled, 42);
+  typedef MappedSymmetricIndexMatrix<float, TiledLayout<64> > MappedTiled;
+  const MappedTiled::type mapped_tiled = MappedTiled::Open(path, 42);
+
+  //the file is replaced by renaming, so that the earlier mappings still hold their own versions
+  ENSURE_EQUAL(mapped_sym.GetBiSize(), size);
+  for (unsigned i=0; i<size; i++) {
+    for (unsigned j=0; j<size; j++) {
+      ENSURE_EQUAL(mapped_sym.Get(i, j), sym.Get(i, j));
+      ENSURE_EQUAL(mapped_asym.Get(i, j), asym.Get(i, j));
+      ENSURE_EQUAL(mapped_tiled.Get(i, j), tiled.Get(i, j));
+    }
+  }
+  std::remove(path.c_str());
+};
+
+TEST (Copies_share_mapping) {
+  SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > sym(10);
+  sym.Set(7, 3, 73);
+  WriteMapped(path, sym, 42);
+  MappedSymmetricIndexMatrix<uint16_t>::type* original = new MappedSymmetricIndexMatrix<uint16_t>::type(MappedSymmetricIndexMatrix<uint16_t>::Open(path, 42));
+  const MappedSymmetricIndexMatrix<uint16_t>::type copy(*original);
+  ENSURE(copy.GetInternal().data()==original->GetInternal().data(), "no copy of the fields");
+  delete original;
+  std::remove(path.c_str());
+  ENSURE_EQUAL(copy.Get(3, 7), 73, "mapping outlives the original and the file name");
+};
+
+TEST (Verification) {
+  SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > sym(100);
+  WriteMapped(path, sym, 42);
+  ENSURE(!IsFatal(boost::bind(OpenSymmetric_uint16, 42)));
+  ENSURE(IsFatal(boost::bind(OpenSymmetric_uint16, 43)), "other geometry");
+  ENSURE(IsFatal(boost::bind(OpenAsymmetric_uint16, 42)), "other symmetry");
+  ENSURE(IsFatal(OpenSymmetric_int32), "other type");
+  ENSURE(IsFatal(OpenTiled_uint16), "other layout");
+
+  //a file which is no mapped matrix
+  {
+    std::ofstream ofs(path.c_str());
+    ofs<<"no matrix";
+  }
+  ENSURE(IsFatal(boost::bind(OpenSymmetric_uint16, 42)), "too short");
+  {
+    std::ofstream ofs(path.c_str());
+    ofs<<std::string(8192, 'x');
+  }
+  ENSURE(IsFatal(boost::bind(OpenSymmetric_uint16, 42)), "no magic");
+  std::remove(path.c_str());
+  ENSURE(IsFatal(boost::bind(OpenSymmetric_uint16, 42)), "no file");
+};
+
+///the names of the files in the working directory, which start with 'prefix'
+static std::vector<std::string> FilesStartingWith(const std::string& prefix) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(".");
+  while (const dirent* entry = readdir(dir)) {
+    const std::string name(entry->d_name);
+    if (!name.compare(0, prefix.size(), prefix))
+      names.push_back(name);
+  }
+  closedir(dir);
+  return names;
+};
+
+static void WriteMapped_uint16(const std::string& target) {
+  SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > sym(100);
+  WriteMapped(target, sym, 42);
+};
+
+TEST (TemporaryFiles) {
+  WriteMapped_uint16(path);
+  ENSURE_EQUAL(FilesStartingWith(path).size(), 1u, "the temporary file is renamed into place");
+  std::remove(path.c_str());
+  
+  //the rename onto a directory fails after the fields are written
+  const std::string dirPath = "MappedIndexMatrixTest.dir";
+  mkdir(dirPath.c_str(), 0755);
+  ENSURE(IsFatal(boost::bind(WriteMapped_uint16, dirPath)));
+  ENSURE_EQUAL(FilesStartingWith(dirPath).size(), 1u, "the temporary file is removed on failure");
+  rmdir(dirPath.c_str());
+};
+
+TEST (DistanceService) {
+  const I3Geometry geo = IC86Topology::Build_IC86_Geometry();
+  const CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo.omgeo));
+  const PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo.omgeo, hasher);
+  const DistanceService distService(posService);
+  distService.WriteMapped(path);
+
+  const MappedSymmetricIndexMatrix<uint16_t>::type mapped = MappedSymmetricIndexMatrix<uint16_t>::Open(path, posService->GetChecksum());
+  for (CompactHash i=0; i<hasher->HashSize(); i+=13) {
+    for (CompactHash j=0; j<hasher->HashSize(); j+=7)
+      ENSURE_EQUAL(double(mapped.Get(i, j)), distService.GetDistance(i, j));
+  }
+
+  //a geometry with one DOM moved has a different checksum
+  I3OMGeoMap moved = geo.omgeo;
+  moved[OMKey(36,30)].position.SetZ(moved[OMKey(36,30)].position.GetZ()+1.);
+  const PositionService movedService(moved, hasher);
+  ENSURE(movedService.GetChecksum()!=posService->GetChecksum());
+  ENSURE_EQUAL(PositionService(geo.omgeo, hasher).GetChecksum(), posService->GetChecksum());
+  std::remove(path.c_str());
+};
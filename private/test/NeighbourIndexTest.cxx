@@ -0,0 +1,112 @@
+/**
+ * \file NeighbourIndexTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Unit test to test the neighbour lists against a scan of all distances
+ */
+#include <I3Test.h>
+
+#include "ToolZ/NeighbourIndex.h"
+#include "ToolZ/DistanceService.h"
+
+#include "ToolZ/IC86Topology.h"
+
+#include "TestHelpers.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(NeighbourIndex)
+
+//create some objects which are used in all the tests
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static HashedGeometryConstPtr hashedGeo = boost::make_shared<const HashedGeometry>(geo->omgeo);
+
+///the neighbours of this DOM found by scanning all distances
+static std::vector<CompactHash> ScanNeighbours(
+  const PositionServiceConstPtr& posService,
+  const CompactHash a,
+  const double radius)
+{
+  std::vector<CompactHash> neighbours;
+  for (CompactHash j=0; j<posService->GetHashService()->HashSize(); j++) {
+    if (j!=a && posService->GetDistance(a, j)<=radius)
+      neighbours.push_back(j);
+  }
+  return neighbours;
+};
+
+TEST(spherical) {
+  const PositionServiceConstPtr posService = hashedGeo->GetPosService();
+  const NeighbourIndex index(hashedGeo, 150.);
+  ENSURE_EQUAL(index.GetRadius(), 150.);
+  ENSURE_EQUAL(index.GetConstraint(), NeighbourIndex::Spherical);
+
+  size_t size = 0;
+  for (CompactHash i=0; i<hashedGeo->GetHashService()->HashSize(); i++) {
+    const NeighbourIndex::NeighbourRange neighbours = index.GetNeighbours(i);
+    const NeighbourIndex::DistanceRange distances = index.GetDistances(i);
+    ENSURE_EQUAL(index.GetNNeighbours(i), neighbours.size());
+    ENSURE_EQUAL(neighbours.size(), distances.size());
+    size += neighbours.size();
+
+    for (size_t k=0; k<neighbours.size(); k++) {
+      ENSURE_EQUAL(distances[k], posService->GetDistance(i, neighbours[k]));
+      if (k>0)
+        ENSURE(distances[k-1]<=distances[k], "ordered by distance");
+    }
+
+    std::vector<CompactHash> sorted(neighbours.begin(), neighbours.end());
+    std::sort(sorted.begin(), sorted.end());
+    ENSURE(sorted==ScanNeighbours(posService, i, 150.));
+  }
+  ENSURE_EQUAL(index.GetSize(), size);
+
+  //the closest neighbours of an inice DOM are its direct neighbours on the string
+  const CompactOMKeyHashServiceConstPtr hasher = hashedGeo->GetHashService();
+  const NeighbourIndex::NeighbourRange neighbours = index.GetNeighbours(hasher->HashFromOMKey(OMKey(36,30)));
+  ENSURE_EQUAL(hasher->OMKeyFromHash(neighbours[0]), OMKey(36,29));
+  ENSURE_EQUAL(hasher->OMKeyFromHash(neighbours[1]), OMKey(36,31));
+}
+
+TEST(neighbours_within) {
+  const PositionServiceConstPtr posService = hashedGeo->GetPosService();
+  const NeighbourIndex index(hashedGeo, 150.);
+  for (CompactHash i=0; i<hashedGeo->GetHashService()->HashSize(); i+=11) {
+    const NeighbourIndex::NeighbourRange within = index.GetNeighboursWithin(i, 60.);
+    std::vector<CompactHash> sorted(within.begin(), within.end());
+    std::sort(sorted.begin(), sorted.end());
+    ENSURE(sorted==ScanNeighbours(posService, i, 60.));
+    ENSURE(within.begin()==index.GetNeighbours(i).begin(), "leading part of all neighbours");
+  }
+}
+
+TEST(z_only) {
+  const PositionServiceConstPtr posService = hashedGeo->GetPosService();
+  const NeighbourIndex index(hashedGeo, 20., NeighbourIndex::ZOnly);
+  for (CompactHash i=0; i<hashedGeo->GetHashService()->HashSize(); i+=7) {
+    const NeighbourIndex::NeighbourRange neighbours = index.GetNeighbours(i);
+    const NeighbourIndex::DistanceRange distances = index.GetDistances(i);
+    size_t n_expected = 0;
+    for (CompactHash j=0; j<hashedGeo->GetHashService()->HashSize(); j++)
+      n_expected += (j!=i && std::fabs(posService->GetZ()[j]-posService->GetZ()[i])<=20.);
+    ENSURE_EQUAL(neighbours.size(), n_expected);
+    for (size_t k=0; k<neighbours.size(); k++)
+      ENSURE_EQUAL(distances[k], std::fabs(posService->GetZ()[neighbours[k]]-posService->GetZ()[i]));
+  }
+}
+
+TEST(string_only) {
+  const CompactOMKeyHashServiceConstPtr hasher = hashedGeo->GetHashService();
+  const NeighbourIndex index(hashedGeo, 40., NeighbourIndex::StringOnly);
+  for (CompactHash i=0; i<hasher->HashSize(); i++) {
+    const NeighbourIndex::NeighbourRange neighbours = index.GetNeighbours(i);
+    for (size_t k=0; k<neighbours.size(); k++)
+      ENSURE_EQUAL(hasher->OMKeyFromHash(neighbours[k]).GetString(), hasher->OMKeyFromHash(i).GetString());
+  }
+  //inice DOMs on a standard string are spaced 17m: two DOMs above and two below
+  ENSURE_EQUAL(index.GetNNeighbours(hasher->HashFromOMKey(OMKey(36,30))), 4);
+  ENSURE_EQUAL(index.GetNNeighbours(hasher->HashFromOMKey(OMKey(36,1))), 2);
+}
@@ -68,6 +68,77 @@ TEST(UsingVector) {
   hasher.HashFromOMKey(OMKey(55,55));
 };
 
+TEST(DenseLookup) {
+  CompactOMKeyHashService hasher(ExtractOMKeys(geo));
+  ENSURE(hasher.IsDense(), "IC86 is dense enough to be tabulated");
+  
+  ENSURE(!hasher.HoldsOMKey(OMKey(0,1)));
+  ENSURE(!hasher.HoldsOMKey(OMKey(-1,1)));
+  ENSURE(!hasher.HoldsOMKey(OMKey(1,0)));
+  ENSURE(!hasher.HoldsOMKey(OMKey(1,1,1)));
+  ENSURE(!hasher.HoldsOMKey(OMKey(82,61)), "holes in the keyspace are not hashed");
+  ENSURE(!hasher.HoldsOMKey(OMKey(87,1)));
+  
+  bool thrown = false;
+  try { hasher.HashFromOMKey(OMKey(82,61)); }
+  catch (const std::out_of_range&) { thrown = true; }
+  ENSURE(thrown, "not hashed OMKeys throw like the map did");
+  
+  //sparse keyspaces fall back to the map
+  std::set<OMKey> omkey_set;
+  for (unsigned i=0; i<100; i++)
+    omkey_set.insert(omkey_set.end(),OMKey(i*100,i*100));
+  CompactOMKeyHashService sparse_hasher(omkey_set);
+  ENSURE(!sparse_hasher.IsDense(), "sparse keyspace falls back to the map");
+  CompactHash currentHash= 0;
+  BOOST_FOREACH(const OMKey& omkey, omkey_set) {
+    ENSURE(sparse_hasher.HoldsOMKey(omkey));
+    ENSURE_EQUAL(sparse_hasher.HashFromOMKey(omkey), currentHash);
+    currentHash++;
+  }
+  ENSURE(!sparse_hasher.HoldsOMKey(OMKey(1,1)));
+};
+
+TEST(HashFromOMKeys) {
+  CompactOMKeyHashService dense_hasher(ExtractOMKeys(geo));
+  
+  std::set<OMKey> sparse_set;
+  for (unsigned i=0; i<100; i++)
+    sparse_set.insert(sparse_set.end(),OMKey(i*100,i*100));
+  CompactOMKeyHashService sparse_hasher(sparse_set);
+  
+  //every third DOM of the geometry, as it would be keyed in a pulse map
+  I3Map<OMKey, double> omkey_map;
+  unsigned count = 0;
+  BOOST_FOREACH(const I3OMGeoMap::value_type& omkey_omgeo, geo->omgeo) {
+    if (!(count++%3))
+      omkey_map[omkey_omgeo.first] = 0.;
+  }
+  
+  const std::vector<CompactHash> hashes = dense_hasher.HashFromOMKeys(omkey_map.begin(), omkey_map.end());
+  ENSURE_EQUAL(hashes.size(), omkey_map.size());
+  typedef I3Map<OMKey, double>::value_type OMKey_Double;
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  BOOST_FOREACH(const OMKey_Double& entry, omkey_map) {
+    ENSURE_EQUAL(*hash_iter, dense_hasher.HashFromOMKey(entry.first));
+    ++hash_iter;
+  }
+  
+  //fill a caller-provided buffer, from the sparse hasher which does the merge-walk
+  std::vector<OMKey> sparse_keys(sparse_set.begin(), sparse_set.end());
+  sparse_keys.erase(sparse_keys.begin()+50, sparse_keys.begin()+60);
+  std::vector<CompactHash> buffer(sparse_keys.size());
+  ENSURE(sparse_hasher.HashFromOMKeys(sparse_keys.begin(), sparse_keys.end(), buffer.begin()) == buffer.end());
+  for (size_t i=0; i<sparse_keys.size(); i++)
+    ENSURE_EQUAL(buffer[i], sparse_hasher.HashFromOMKey(sparse_keys[i]));
+  
+  //not hashed OMKeys are rejected
+  sparse_keys.push_back(OMKey(100000, 1));
+  bool thrown = false;
+  try { sparse_hasher.HashFromOMKeys(sparse_keys.begin(), sparse_keys.end()); }
+  catch (const std::out_of_range&) { thrown = true; }
+  ENSURE(thrown, "not hashed OMKeys throw");
+};
 
 #if SERIALIZATION_ENABLED
 TEST(Serialize_raw_ptr){
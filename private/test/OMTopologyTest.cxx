@@ -19,6 +19,7 @@
 #include "TestHelpers.h"
 
 #include <boost/make_shared.hpp>
+#include <boost/foreach.hpp>
 
 TEST_GROUP(OMTopology)
 
@@ -95,6 +96,46 @@ TEST (OMTopologyMap_Comparator) {
   ENSURE_EQUAL(all_in.size(), 3);
 }
 
+TEST (IC86_ClosedFormHashing) {
+  const I3Geometry geo = IC86Topology::Build_IC86_Geometry();
+  const CompactOMKeyHashService hasher(ExtractOMKeys(geo.omgeo));
+  ENSURE_EQUAL(hasher.HashSize(), IC86Topology::N_DOMS);
+  
+  //the closed-form hashes are identical to those of a hasher on the geometry
+  BOOST_FOREACH(const I3OMGeoMap::value_type& omkey_omgeo, geo.omgeo) {
+    const OMKey& omkey = omkey_omgeo.first;
+    ENSURE(IC86Topology::HoldsOMKey(omkey));
+    ENSURE_EQUAL(IC86Topology::HashFromOMKey(omkey), hasher.HashFromOMKey(omkey));
+    ENSURE_EQUAL(IC86Topology::OMKeyFromHash(hasher.HashFromOMKey(omkey)), omkey);
+  }
+  ENSURE(!IC86Topology::HoldsOMKey(OMKey(0,1)));
+  ENSURE(!IC86Topology::HoldsOMKey(OMKey(1,0)));
+  ENSURE(!IC86Topology::HoldsOMKey(OMKey(1,65)));
+  ENSURE(!IC86Topology::HoldsOMKey(OMKey(82,61)));
+  ENSURE(!IC86Topology::HoldsOMKey(OMKey(87,1)));
+  ENSURE(!IC86Topology::HoldsOMKey(OMKey(1,1,1)));
+  
+  //the static hasher is shared and congruent
+  ENSURE(IC86Topology::GetHashService()==IC86Topology::GetHashService());
+  ENSURE(IC86Topology::GetHashService()->VerifyAgainst(ExtractOMKeys(geo.omgeo)));
+  ENSURE_EQUAL(IC86Topology::GetHashService()->HashSize(), IC86Topology::N_DOMS);
+};
+
+TEST (IC86_ClosedFormPositions) {
+  const I3Geometry geo = IC86Topology::Build_IC86_Geometry();
+  BOOST_FOREACH(const I3OMGeoMap::value_type& omkey_omgeo, geo.omgeo)
+    ENSURE(IC86Topology::GetPosition(omkey_omgeo.first)==omkey_omgeo.second.position);
+  
+  ENSURE(IC86Topology::GetStringPosition(36)==I3Position(0.,0.,0.), "detector is centered at string 36");
+  ENSURE_EQUAL(IC86Topology::GetPosition(OMKey(36,30)).GetZ(), 0., "OM30 rests in the XY plane");
+  
+  //the static PositionService is shared and congruent
+  const PositionServiceConstPtr posService = IC86Topology::GetPositionService();
+  ENSURE(posService==IC86Topology::GetPositionService());
+  ENSURE(posService->GetHashService()==IC86Topology::GetHashService());
+  ENSURE(posService->VerifyAgainst(geo.omgeo));
+};
+
 #if SERIALIZATION_ENABLED
 TEST(OMTopology_Serialize_raw_ptr){
   OMTopology* omt_save = new OMTopology();
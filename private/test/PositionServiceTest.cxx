@@ -32,7 +32,7 @@ TEST(Verify_against) {
 }
 
 TEST(get_position) {
-  for (int i=0; i<hasher->HashSize(); i++) {
+  for (CompactHash i=0; i<hasher->HashSize(); i++) {
     const OMKey omkey = hasher->OMKeyFromHash(i); 
     
     ENSURE_EQUAL(posService->GetPosition(omkey), geo->omgeo.at(omkey).position);
@@ -40,13 +40,56 @@ TEST(get_position) {
 }
   
 TEST(get_distance) {
-  for (int i=0; i<hasher->HashSize(); i++) {
+  for (CompactHash i=0; i<hasher->HashSize(); i++) {
     const OMKey omkey_a = hasher->OMKeyFromHash(i); 
     I3Position pos_a = geo->omgeo.at(omkey_a).position;
     ENSURE_EQUAL(posService->GetPosition(omkey_a), pos_a);
   }
 }
 
+TEST(coordinate_arrays) {
+  ENSURE_EQUAL(posService->GetX().size(), hasher->HashSize());
+  ENSURE_EQUAL(size_t(posService->GetX().data())%32, 0, "aligned for vectorized access");
+  for (CompactHash i=0; i<hasher->HashSize(); i++) {
+    const I3Position& pos = geo->omgeo.at(hasher->OMKeyFromHash(i)).position;
+    ENSURE_EQUAL(posService->GetX()[i], pos.GetX());
+    ENSURE_EQUAL(posService->GetY()[i], pos.GetY());
+    ENSURE_EQUAL(posService->GetZ()[i], pos.GetZ());
+  }
+}
+
+TEST(gather_positions) {
+  std::vector<CompactHash> hashes;
+  for (CompactHash i=0; i<hasher->HashSize(); i+=7)
+    hashes.push_back(i);
+  std::vector<double> x(hashes.size()), y(hashes.size()), z(hashes.size());
+  posService->GatherPositions(hashes.begin(), hashes.end(), x.data(), y.data(), z.data());
+  for (size_t i=0; i<hashes.size(); i++)
+    ENSURE(I3Position(x[i], y[i], z[i])==posService->GetPosition(hashes[i]));
+}
+
+TEST(distances_from) {
+  const I3Position pos(12., -34., 56.);
+  
+  //to all DOMs
+  std::vector<double> dist(hasher->HashSize());
+  posService->DistancesFrom(pos, dist.data());
+  for (CompactHash i=0; i<hasher->HashSize(); i++)
+    ENSURE_DISTANCE(dist[i], (posService->GetPosition(i)-pos).Magnitude(), 1E-9);
+  
+  //to a range of DOMs, spanning several gather blocks
+  std::vector<CompactHash> hashes;
+  for (CompactHash i=0; i<hasher->HashSize(); i+=3)
+    hashes.push_back(i);
+  std::vector<double> range_dist(hashes.size());
+  posService->DistancesFrom(pos, hashes.begin(), hashes.end(), range_dist.data());
+  for (size_t i=0; i<hashes.size(); i++)
+    ENSURE_DISTANCE(range_dist[i], dist[hashes[i]], 1E-9);
+  
+  //distance between DOMs
+  ENSURE_DISTANCE(posService->GetDistance(0, 100), (posService->GetPosition(0)-posService->GetPosition(100)).Magnitude(), 1E-9);
+}
+
 #if SERIALIZATION_ENABLED
 TEST(Serialize_raw_ptr){
   PositionService* ps_save = new PositionService(geo->omgeo, hasher);
@@ -0,0 +1,177 @@
+/**
+ * \file SparseIndexMatrixTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Test the sparse matrices against the dense matrices
+ */
+
+#include <I3Test.h>
+
+#include "ToolZ/SparseIndexMatrix.h"
+#include "ToolZ/IndexMatrix.h"
+
+#include <boost/make_shared.hpp>
+
+#include "TestHelpers.h"
+
+using namespace indexmatrix;
+
+TEST_GROUP(SparseIndexMatrix);
+
+///a distance-like value within a band of width 2*40 around the diagonal, and 0 beyond
+struct BandFunction {
+  double operator() (const uint64_t index_A, const uint64_t index_B) const {
+    const uint64_t distance = index_A>index_B ? index_A-index_B : index_B-index_A;
+    return distance<=40 ? 1.+distance : 0.;
+  };
+};
+
+///counts the fields visited by ForEachField
+struct FieldCounter {
+  size_t* count_;
+  void operator()(const unsigned, const unsigned, const double) const
+    {(*count_)++;};
+};
+
+TEST (SetAndGet) {
+  const unsigned size = 150;
+  SparseSymmetricIndexMatrix_Double sparse_sym(size);
+  SparseAsymmetricIndexMatrix_Double sparse_asym(size);
+  SymmetricIndexMatrix<double, std::vector<double> > dense_sym(size);
+  AsymmetricIndexMatrix<double, std::vector<double> > dense_asym(size);
+
+  TestRandom random(1);
+  for (unsigned q=0; q<3000; q++) {
+    const uint64_t state = random.Next();
+    const unsigned index_A = (state>>33)%size;
+    const unsigned index_B = (state>>13)%size;
+    const double value = (q%5==0) ? 0. : double(q); //also reset fields to the default
+    sparse_sym.Set(index_A, index_B, value);
+    sparse_asym.Set(index_A, index_B, value);
+    dense_sym.Set(index_A, index_B, value);
+    dense_asym.Set(index_A, index_B, value);
+  }
+
+  uint64_t n_sym = 0, n_asym = 0;
+  for (unsigned index_A=0; index_A<size; index_A++) {
+    for (unsigned index_B=0; index_B<size; index_B++) {
+      ENSURE_EQUAL(sparse_sym.Get(index_A, index_B), dense_sym.Get(index_A, index_B));
+      ENSURE_EQUAL(sparse_asym.Get(index_A, index_B), dense_asym.Get(index_A, index_B));
+      n_sym += (dense_sym.Get(index_A, index_B)!=0.);
+      n_asym += (dense_asym.Get(index_A, index_B)!=0.);
+    }
+
+    //the rows hold exactly the non-default fields, in order
+    const SparseSymmetricIndexMatrix_Double::RowRange row = sparse_sym.GetRow(index_A);
+    for (SparseSymmetricIndexMatrix_Double::RowRange::const_iterator it=row.begin(); it!=row.end(); ++it) {
+      ENSURE(it->value!=0.);
+      ENSURE_EQUAL(it->value, dense_sym.Get(index_A, it->index));
+      if (it!=row.begin())
+        ENSURE((it-1)->index<it->index, "ordered by index");
+    }
+  }
+  ENSURE_EQUAL(sparse_sym.GetNEntries(), n_sym, "only non-default fields are stored");
+  ENSURE_EQUAL(sparse_asym.GetNEntries(), n_asym, "only non-default fields are stored");
+
+  size_t count = 0;
+  const FieldCounter counter = {&count};
+  sparse_asym.ForEachField(counter);
+  ENSURE_EQUAL(count, n_asym);
+  count = 0;
+  sparse_sym.ForEachField(counter);
+  ENSURE(2*count>=n_sym && count<=n_sym, "each symmetric field once");
+};
+
+TEST (FromFunction) {
+  const BandFunction band;
+  const unsigned sizes[] = {1, 40, 41, 200};
+  BOOST_FOREACH(const unsigned size, sizes) {
+    for (unsigned nThreads=1; nThreads<=3; nThreads++) {
+      const SparseSymmetricIndexMatrix_Double sparse_sym(size, band, nThreads);
+      const SparseAsymmetricIndexMatrix_Double sparse_asym(size, band, nThreads);
+      for (unsigned index_A=0; index_A<size; index_A++) {
+        for (unsigned index_B=0; index_B<size; index_B++) {
+          ENSURE_EQUAL(sparse_sym.Get(index_A, index_B), band(index_A, index_B));
+          ENSURE_EQUAL(sparse_asym.Get(index_A, index_B), band(index_A, index_B));
+        }
+        //the symmetric rows are complete
+        ENSURE_EQUAL(sparse_sym.GetRow(index_A).size(), sparse_asym.GetRow(index_A).size());
+        for (size_t e=0; e<sparse_sym.GetRow(index_A).size(); e++)
+          ENSURE_EQUAL(sparse_sym.GetRow(index_A)[e].index, sparse_asym.GetRow(index_A)[e].index);
+      }
+    }
+  }
+};
+
+TEST (SetRow) {
+  SparseSymmetricIndexMatrix_Bool sym(10);
+  std::vector<SparseSymmetricIndexMatrix_Bool::Entry> row;
+  row.push_back(SparseSymmetricIndexMatrix_Bool::Entry(7, true));
+  row.push_back(SparseSymmetricIndexMatrix_Bool::Entry(2, true));
+  row.push_back(SparseSymmetricIndexMatrix_Bool::Entry(3, true));
+  sym.SetRow(3, row.begin(), row.end());
+  ENSURE(sym.Get(3, 2) && sym.Get(7, 3) && sym.Get(3, 3));
+  ENSURE_EQUAL(sym.GetNEntries(), 5u);
+
+  //replacing the row removes the mirrors of its former fields
+  row.resize(1);
+  sym.SetRow(3, row.begin(), row.end());
+  ENSURE(sym.Get(3, 7) && !sym.Get(2, 3) && !sym.Get(3, 3));
+  ENSURE_EQUAL(sym.GetNEntries(), 2u);
+  ENSURE_EQUAL(sym.GetColumn(7).front().index, 3u);
+
+  SparseAsymmetricIndexMatrix_Bool asym(10);
+  row.push_back(SparseSymmetricIndexMatrix_Bool::Entry(2, true));
+  row.push_back(SparseSymmetricIndexMatrix_Bool::Entry(5, false));
+  asym.SetRow(3, row.begin(), row.end());
+  ENSURE(asym.Get(3, 7) && asym.Get(3, 2) && !asym.Get(2, 3));
+  ENSURE_EQUAL(asym.GetNEntries(), 2u, "default values are not stored");
+  ENSURE_EQUAL(asym.GetRow(3).front().index, 2u, "ordered by index");
+};
+
+TEST (Gen2Scale) {
+  //a range at which the dense triangle would hold 5E9 fields and overflow 32-bit indices
+  const unsigned size = 100000;
+  SparseSymmetricIndexMatrix_Double sparse(size);
+  std::vector<SparseSymmetricIndexMatrix_Double::Entry> row;
+  for (unsigned index_A=0; index_A<size; index_A+=997) {
+    row.clear();
+    row.push_back(SparseSymmetricIndexMatrix_Double::Entry(size-1, 1.));
+    sparse.SetRow(index_A, row.begin(), row.end());
+  }
+  ENSURE_EQUAL(sparse.GetBiSize(), size_t(size));
+  ENSURE_EQUAL(sparse.Get(size-1, 997*100), 1.);
+  ENSURE_EQUAL(sparse.Get(size-1, 997*100+1), 0.);
+  ENSURE_EQUAL(sparse.GetRow(size-1).size(), 101u);
+  ENSURE_EQUAL(sparse.GetNEntries(), uint64_t(2*101));
+};
+
+#if SERIALIZATION_ENABLED
+TEST(Serialize_raw_ptr){
+  SparseSymmetricIndexMatrix_Double* sym_save = new SparseSymmetricIndexMatrix_Double(100, BandFunction());
+  SparseSymmetricIndexMatrix_Double* sym_load = nullptr;
+  serialize_object(sym_save, sym_load);
+  ENSURE_EQUAL(sym_load->GetNEntries(), sym_save->GetNEntries());
+  ENSURE_EQUAL(sym_load->Get(60, 30), sym_save->Get(60, 30));
+  delete sym_save;
+  delete sym_load;
+
+  SparseAsymmetricIndexMatrix_Bool* asym_save = new SparseAsymmetricIndexMatrix_Bool(100);
+  asym_save->Set(3, 5, true);
+  SparseAsymmetricIndexMatrix_Bool* asym_load = nullptr;
+  serialize_object(asym_save, asym_load);
+  ENSURE(asym_load->Get(3, 5) && !asym_load->Get(5, 3));
+  delete asym_save;
+  delete asym_load;
+};
+
+TEST(Serialize_boost_shared_ptr){
+  SparseSymmetricIndexMatrix_DoublePtr sym_save = boost::make_shared<SparseSymmetricIndexMatrix_Double>(100, 7.);
+  SparseSymmetricIndexMatrix_DoublePtr sym_load;
+  serialize_object(sym_save, sym_load);
+  ENSURE_EQUAL(sym_load->GetDefault(), 7.);
+};
+#endif //SERIALIZATION_ENABLED
@@ -0,0 +1,109 @@
+/**
+ * \file StringDistanceServiceTest.cxx
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Unit test to test the string-factored distance computation against the plain positions
+ */
+#include <I3Test.h>
+
+#include "ToolZ/StringDistanceService.h"
+#include "ToolZ/DistanceService.h"
+
+#include "ToolZ/IC86Topology.h"
+
+#include "TestHelpers.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(StringDistanceService)
+
+//create some objects which are used in all the hashings
+static I3GeometryConstPtr geo = boost::make_shared<const I3Geometry>(IC86Topology::Build_IC86_Geometry());
+static CompactOMKeyHashServiceConstPtr hasher = boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(geo));
+static PositionServiceConstPtr posService = boost::make_shared<const PositionService>(geo->omgeo,hasher);
+
+static StringDistanceServiceConstPtr strDistService = boost::make_shared<const StringDistanceService>(posService);
+
+
+TEST(Verify_against) {
+  ENSURE(strDistService->VerifyAgainst(geo->omgeo));
+}
+
+TEST(columns) {
+  //every string is one column, IceTop tanks sit exactly on top of their strings
+  ENSURE_EQUAL(strDistService->GetNColumns(), 86);
+  ENSURE_EQUAL(strDistService->GetMaxOffset(), 0.);
+}
+
+TEST(get_distance) {
+  for (CompactHash i=0; i<hasher->HashSize(); i+=7) {
+    for (CompactHash j=0; j<hasher->HashSize(); j++)
+      ENSURE_DISTANCE(strDistService->GetDistance(i, j), posService->GetDistance(i, j), 1E-3); //exact up to float precision
+  }
+  ENSURE_EQUAL(strDistService->GetDistance(OMKey(1,1), OMKey(1,1)), 0.);
+  ENSURE_EQUAL(strDistService->GetDistance(OMKey(36,1), OMKey(36,2)), 17.);
+  ENSURE_DISTANCE(strDistService->GetDistance(OMKey(36,30), OMKey(37,30)), 125., 1E-3);
+}
+
+TEST(jittered_geometry) {
+  //every DOM displaced horizontally by up to 0.3m in x and y, as for a surveyed geometry of slightly inclined strings
+  I3OMGeoMap jittered_omgeo = geo->omgeo;
+  TestRandom random(1);
+  for (I3OMGeoMap::iterator it=jittered_omgeo.begin(); it!=jittered_omgeo.end(); ++it) {
+    const uint64_t state = random.Next();
+    const double jitter_x = 0.3*(double((state>>33)%2001)/1000.-1.);
+    const double jitter_y = 0.3*(double((state>>13)%2001)/1000.-1.);
+    it->second.position.SetX(it->second.position.GetX()+jitter_x);
+    it->second.position.SetY(it->second.position.GetY()+jitter_y);
+  }
+  const PositionServiceConstPtr jittered_posService = boost::make_shared<const PositionService>(jittered_omgeo, hasher);
+  const StringDistanceService jittered_strDistService(jittered_posService);
+
+  //still one column per string
+  ENSURE_EQUAL(jittered_strDistService.GetNColumns(), 86);
+  ENSURE(jittered_strDistService.GetMaxOffset()>0.);
+  ENSURE(jittered_strDistService.GetMaxOffset()<=0.6);
+  for (CompactHash i=0; i<hasher->HashSize(); i+=7) {
+    for (CompactHash j=0; j<hasher->HashSize(); j++)
+      ENSURE_DISTANCE(jittered_strDistService.GetDistance(i, j), jittered_posService->GetDistance(i, j), 2.*jittered_strDistService.GetMaxOffset()+1E-3);
+  }
+
+  //a DOM displaced beyond the tolerance, like a second IceTop tank, starts its own column
+  jittered_omgeo[OMKey(1,61)].position.SetX(jittered_omgeo[OMKey(1,61)].position.GetX()+10.);
+  const PositionServiceConstPtr tank_posService = boost::make_shared<const PositionService>(jittered_omgeo, hasher);
+  const StringDistanceService tank_strDistService(tank_posService);
+  ENSURE_EQUAL(tank_strDistService.GetNColumns(), 87);
+  ENSURE_DISTANCE(tank_strDistService.GetDistance(OMKey(1,61), OMKey(1,62)), (tank_posService->GetPosition(OMKey(1,61))-tank_posService->GetPosition(OMKey(1,62))).Magnitude(), 2.*tank_strDistService.GetMaxOffset()+1E-3);
+}
+
+TEST(distances_from) {
+  std::vector<double> dist(hasher->HashSize());
+  for (CompactHash i=0; i<hasher->HashSize(); i+=101) {
+    strDistService->DistancesFrom(i, &dist[0]);
+    for (CompactHash j=0; j<hasher->HashSize(); j++)
+      ENSURE_EQUAL(dist[j], strDistService->GetDistance(i, j));
+  }
+}
+
+#if SERIALIZATION_ENABLED
+TEST(Serialize_raw_ptr){
+  StringDistanceService* ds_save = new StringDistanceService(posService);
+  StringDistanceService* ds_load = nullptr;
+
+  serialize_object(ds_save, ds_load);
+  ENSURE_EQUAL(ds_load->GetDistance(0, 100), ds_save->GetDistance(0, 100));
+  ENSURE_EQUAL(ds_load->GetTolerance(), ds_save->GetTolerance());
+  delete ds_save;
+  delete ds_load;
+};
+
+TEST(Serialize_boost_shared_ptr){
+  StringDistanceServicePtr ds_save = boost::make_shared<StringDistanceService>(posService);
+  StringDistanceServicePtr ds_load;
+
+  serialize_object(ds_save, ds_load);
+};
+#endif //SERIALIZATION_ENABLED
@@ -37,6 +37,21 @@ I3DOMLaunchSeriesMap GenerateTestDOMLaunches();
 //make a test geometry
 I3Geometry CreateGeometry();
 
+///a seeded linear congruential generator, which reproduces the same pseudo-random sequence on every platform
+class TestRandom {
+  ///the state, advanced with each draw
+  uint64_t state_;
+public:
+  ///constructor
+  explicit TestRandom(const uint64_t seed) : state_(seed) {};
+  ///advance the state and return it; its higher bits are the more random ones
+  uint64_t Next()
+    {return state_ = state_*6364136223846793005ULL + 1442695040888963407ULL;};
+  ///a pseudo-random number in [0, range)
+  uint64_t Uniform(const uint64_t range)
+    {return (Next()>>33)%range;};
+};
+
 
 #if SERIALIZATION_ENABLED
 template <class T>
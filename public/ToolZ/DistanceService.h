@@ -21,7 +21,14 @@
 #include <boost/foreach.hpp>
 
 #include "ToolZ/__SERIALIZATION.h"
-static const unsigned distanceservice_version_ = 0;
+///version 1: the distance cache can be persisted
+static const unsigned distanceservice_version_ = 1;
+
+#if SERIALIZATION_SUPPORT == 1
+  #include <boost/serialization/binary_object.hpp>
+#elif SERIALIZATION_SUPPORT == 2
+  #include "serialization/binary_object.hpp"
+#endif
 
 //============ CLASS DistanceService ==========
 
@@ -44,6 +51,7 @@ namespace SERIALIZATION_NS_BASE { namespace serialization {
 /**
   * Hashes the position and the distances between DOMs in a dynamic way.
   * iternal storing is as a uint in meters, so there will be an error of about 0.1m
+  * NOTE all methods are thread-safe, so a single instance can be shared between threads
   */
 class DistanceService {
 #if SERIALIZATION_ENABLED
@@ -65,23 +73,49 @@ private: //parameters
   const CompactOMKeyHashServiceConstPtr hasher_;
   /// a position service 
   const PositionServiceConstPtr posService_;
+  /// serialize the filled distances along, so that they need not be computed again after loading
+  const bool persistCache_;
   
 private: //property  
-  /// holds the precashed distances
-  mutable indexmatrix::SymmetricIndexMatrix<uint16_t, std::vector<uint16_t> > hashedDist_;
+  /// holds the precashed distances; 0 for not yet computed; atomic fields, so that the cache can be filled concurrently
+  mutable indexmatrix::SymmetricIndexMatrix<uint16_t, indexmatrix::RelaxedAtomicVector<uint16_t> > hashedDist_;
   
 private: 
   ///for the construction of the hashedPositions
   std::vector<I3Position> ConstructHashedPositions (  
     const I3GeometryConstPtr& geo) const ;
   
+  ///number of consecutive rows a thread computes in HashAllDistances before moving on
+  static const unsigned hashall_block_rows_ = 64;
+  
+  ///hash the distances of all row-blocks [firstBlock, firstBlock+blockStride, ...]
+  void HashDistanceRowBlocks(
+    const unsigned firstBlock,
+    const unsigned blockStride) const;
+  
+  /** @brief the filled fields of the cache in storage order, run-length encoded
+   * @param runs the alternating lengths of runs of empty and filled fields, starting with empty fields
+   * @param values the filled fields as little-endian bytes
+   */
+  void EncodeCache(std::vector<uint64_t>& runs,
+                   std::vector<uint8_t>& values) const;
+  ///fill the cache from the encoding of EncodeCache
+  void DecodeCache(const std::vector<uint64_t>& runs,
+                   const std::vector<uint8_t>& values) const;
+  
 public:
   /// constructor
+  /// \param posService the positions of the DOMs
+  /// \param persistCache serialize the filled distances along; makes the archive about 2 bytes per filled distance larger
   DistanceService(
-    const PositionServiceConstPtr& posService);
+    const PositionServiceConstPtr& posService,
+    const bool persistCache = false);
   
-  /// Hash all the Distances at once
-  void HashAllDistances() const;
+  /** @brief Hash all the Distances at once;
+   * rows are computed vectorized from the coordinate arrays of the PositionService and distributed over threads
+   * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+   */
+  void HashAllDistances(const unsigned nThreads = 0) const;
   
   /// Get the distance between these two DOMs by hashed index, compute if neccessary
   /// \param a hashed DOMindex
@@ -98,10 +132,31 @@ public:
   CompactOMKeyHashServiceConstPtr GetHashService() const;
   /// Get the internal PositionService
   PositionServiceConstPtr GetPosService() const;
+  /// are the filled distances serialized along
+  bool GetPersistCache() const;
+  /// the number of distances between distinct DOMs, which are computed and cached;
+  /// distances which round to 0m are indistinguishable from empty fields, and are never counted
+  uint64_t GetNCached() const;
+  
+#if SERIALIZATION_ENABLED
+  ///write the filled distances to an archive; for owners of a DistanceService, which serialize it in their own way
+  template<class Archive>
+  void SaveCache(Archive & ar) const;
+  ///restore the filled distances written by SaveCache
+  template<class Archive>
+  void LoadCache(Archive & ar) const;
+#endif //SERIALIZATION_ENABLED
   
   ///Verify the DistService against this geometry
   /// checks if all hashed Positions are the same
   bool VerifyAgainst(const I3OMGeoMap& omgeo) const;
+  
+  /** @brief hash all distances and write them to a file, which many processes can map read-only and share:
+   * open it with indexmatrix::MappedSymmetricIndexMatrix<uint16_t>::Open(path, GetPosService()->GetChecksum());
+   * the fields are the distances in meters, rounded
+   * @param path the file
+   */
+  void WriteMapped(const std::string& path) const;
 };
 
 typedef boost::shared_ptr<DistanceService> DistanceServicePtr;
@@ -117,6 +172,33 @@ template<class Archive>
 void DistanceService::serialize(Archive & ar, const unsigned int version)
 {};
 
+template<class Archive>
+void DistanceService::SaveCache(Archive & ar) const
+{
+  std::vector<uint64_t> runs;
+  std::vector<uint8_t> values;
+  EncodeCache(runs, values);
+  //the values are written as one binary block, instead of one archive item per field
+  uint64_t nBytes = values.size();
+  ar << SERIALIZATION_NS::make_nvp("runs", runs);
+  ar << SERIALIZATION_NS::make_nvp("nBytes", nBytes);
+  if (nBytes)
+    ar << SERIALIZATION_NS::make_nvp("values", SERIALIZATION_NS::make_binary_object(&values[0], nBytes));
+};
+
+template<class Archive>
+void DistanceService::LoadCache(Archive & ar) const
+{
+  std::vector<uint64_t> runs;
+  uint64_t nBytes;
+  ar >> SERIALIZATION_NS::make_nvp("runs", runs);
+  ar >> SERIALIZATION_NS::make_nvp("nBytes", nBytes);
+  std::vector<uint8_t> values(nBytes);
+  if (nBytes)
+    ar >> SERIALIZATION_NS::make_nvp("values", SERIALIZATION_NS::make_binary_object(&values[0], nBytes));
+  DecodeCache(runs, values);
+};
+
 // //NOTE (de)serialization overrides
 namespace SERIALIZATION_NS_BASE { namespace serialization {
 template<class Archive>
@@ -124,6 +206,10 @@ inline void save_construct_data(
   Archive & ar, const DistanceService * t, const unsigned int file_version)
 {
   ar << SERIALIZATION_NS::make_nvp("posService", t->posService_);
+  bool persistCache = t->persistCache_;
+  ar << SERIALIZATION_NS::make_nvp("persistCache", persistCache);
+  if (persistCache)
+    t->SaveCache(ar);
 };
 
 template<class Archive>
@@ -133,10 +219,18 @@ inline void load_construct_data(
   // retrieve data from archive required to construct new instance
   PositionServiceConstPtr posService;
   ar >> SERIALIZATION_NS::make_nvp("posService", posService);
+  //version 0 holds no cache
+  bool persistCache = false;
+  if (file_version>=1)
+    ar >> SERIALIZATION_NS::make_nvp("persistCache", persistCache);
   // invoke inplace constructor to initialize instance of my_class
-  ::new(t)DistanceService(posService);
+  ::new(t)DistanceService(posService, persistCache);
+  if (persistCache)
+    t->LoadCache(ar);
 };
 }} // namespace ...
+
+SERIALIZATION_CLASS_VERSION(DistanceService, distanceservice_version_);
 #endif //SERIALIZATION_ENABLED
 
 inline
@@ -157,4 +251,9 @@ PositionServiceConstPtr
 DistanceService::GetPosService() const
   { return posService_; };
 
+inline
+bool
+DistanceService::GetPersistCache() const
+  { return persistCache_; };
+
 #endif // DISTANCESERVICE_H
@@ -0,0 +1,50 @@
+/**
+ * \file FNV1a.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * The 64-bit FNV-1a hash, used to fingerprint geometries
+ */
+
+#ifndef FNV1A_H
+#define FNV1A_H
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "icetray/OMKey.h"
+#include "dataclasses/I3Position.h"
+
+///the 64-bit FNV-1a hash; fold values in one after the other, starting from offset_basis
+namespace fnv1a {
+  const uint64_t offset_basis = 14695981039346656037ULL;
+  const uint64_t prime = 1099511628211ULL;
+
+  ///fold the bytes of a value into the hash; NOTE use only with types without padding
+  template <typename T>
+  inline void FoldIn(uint64_t& hash, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i=0; i<sizeof(T); i++) {
+      hash ^= bytes[i];
+      hash *= prime;
+    }
+  };
+
+  ///fold the string, OM and PMT number into the hash
+  inline void FoldIn(uint64_t& hash, const OMKey& omkey) {
+    FoldIn(hash, int32_t(omkey.GetString()));
+    FoldIn(hash, uint32_t(omkey.GetOM()));
+    FoldIn(hash, uint8_t(omkey.GetPMT()));
+  };
+
+  ///fold the coordinates into the hash
+  inline void FoldIn(uint64_t& hash, const I3Position& pos) {
+    FoldIn(hash, pos.GetX());
+    FoldIn(hash, pos.GetY());
+    FoldIn(hash, pos.GetZ());
+  };
+}
+
+#endif //FNV1A_H
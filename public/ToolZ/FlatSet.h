@@ -0,0 +1,352 @@
+/**
+ * \file FlatSet.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * An ordered set stored as a sorted vector; a drop-in for std::set in the hit containers
+ */
+
+#ifndef FLATSET_H
+#define FLATSET_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+
+/**
+ * @brief an ordered set of unique elements stored contiguously in a sorted std::vector;
+ * it fulfills the interface of std::set as far as the hit containers and set-algorithms use it.
+ * Lookup is by binary search, iteration is over contiguous memory, and inserting at the end,
+ * like filling from a sorted sequence by insert(end(), value), is amortized constant.
+ * Inserting and erasing elsewhere is linear, as is building by insert(value) from unsorted input;
+ * construct from a range instead, which sorts once.
+ * NOTE like std::vector, and unlike std::set, any insertion and erasure invalidates all iterators.
+ * Elements need to be copy-constructible and assignable, as those of std::vector
+ * @template T the element type
+ * @template Compare the order principle; elements are unique under equivalence
+ */
+template <class T, class Compare = std::less<T> >
+class FlatSet {
+private:
+  typedef std::vector<T> Storage;
+
+public:
+  typedef T key_type;
+  typedef T value_type;
+  typedef Compare key_compare;
+  typedef Compare value_compare;
+  typedef typename Storage::size_type size_type;
+  typedef typename Storage::difference_type difference_type;
+  typedef const T& reference;
+  typedef const T& const_reference;
+  typedef const T* pointer;
+  typedef const T* const_pointer;
+  typedef typename Storage::const_iterator iterator;
+  typedef typename Storage::const_iterator const_iterator;
+  typedef typename Storage::const_reverse_iterator reverse_iterator;
+  typedef typename Storage::const_reverse_iterator const_reverse_iterator;
+
+private:
+  ///the elements, sorted and unique
+  Storage data_;
+  ///the order principle
+  Compare comp_;
+
+  ///sort the elements and remove all but the first of equivalent elements
+  void SortUnique();
+  ///are the elements sorted and unique
+  bool IsSortedUnique() const;
+
+public:
+  ///constructor: an empty set
+  explicit FlatSet(const Compare& comp = Compare());
+  ///constructor: from a range of elements in any order; of equivalent elements the first is kept
+  template <class InputIterator>
+  FlatSet(InputIterator first, InputIterator last, const Compare& comp = Compare());
+  ///copy constructor
+  FlatSet(const FlatSet& rhs);
+  ///assignment by copy and swap
+  FlatSet& operator=(FlatSet rhs);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_reverse_iterator rbegin() const;
+  const_reverse_iterator rend() const;
+
+  bool empty() const;
+  size_type size() const;
+  ///the number of elements the storage holds without reallocation
+  size_type capacity() const;
+  ///reserve storage for at least 'n' elements
+  void reserve(const size_type n);
+  void clear();
+  void swap(FlatSet& rhs);
+
+  ///insert an element, if no equivalent element is held;
+  /// @return the position of the held element and whether it was inserted
+  std::pair<iterator, bool> insert(const value_type& value);
+  ///insert an element, which is expected right before 'hint';
+  /// constant if the hint is correct and 'hint' is end(), logarithmic search otherwise
+  iterator insert(const_iterator hint, const value_type& value);
+  ///insert a range of elements; sorted once and merged
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last);
+
+  ///erase the element at 'pos'; @return the position after it
+  iterator erase(const_iterator pos);
+  ///erase the element equivalent to 'key'; @return the number of erased elements
+  size_type erase(const key_type& key);
+  ///erase the elements in [first, last); @return the position after them
+  iterator erase(const_iterator first, const_iterator last);
+
+  const_iterator find(const key_type& key) const;
+  size_type count(const key_type& key) const;
+  const_iterator lower_bound(const key_type& key) const;
+  const_iterator upper_bound(const key_type& key) const;
+  std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const;
+
+  key_compare key_comp() const;
+  value_compare value_comp() const;
+
+  ///the contiguous, sorted elements
+  const T* data() const;
+};
+
+///comparison of the elements, like for std::set
+template <class T, class Compare>
+bool operator==(const FlatSet<T, Compare>& lhs, const FlatSet<T, Compare>& rhs);
+template <class T, class Compare>
+bool operator!=(const FlatSet<T, Compare>& lhs, const FlatSet<T, Compare>& rhs);
+///lexicographical comparison of the elements, like for std::set
+template <class T, class Compare>
+bool operator<(const FlatSet<T, Compare>& lhs, const FlatSet<T, Compare>& rhs);
+
+
+//==============================================================================
+//========================== IMPLEMENTATIONS ===================================
+//==============================================================================
+
+template <class T, class Compare>
+FlatSet<T, Compare>::FlatSet(const Compare& comp) :
+  comp_(comp)
+{};
+
+template <class T, class Compare> template <class InputIterator>
+FlatSet<T, Compare>::FlatSet(InputIterator first, InputIterator last, const Compare& comp) :
+  data_(first, last),
+  comp_(comp)
+{
+  if (!IsSortedUnique())
+    SortUnique();
+};
+
+template <class T, class Compare>
+FlatSet<T, Compare>::FlatSet(const FlatSet& rhs) :
+  data_(rhs.data_),
+  comp_(rhs.comp_)
+{};
+
+template <class T, class Compare>
+FlatSet<T, Compare>& FlatSet<T, Compare>::operator=(FlatSet rhs) {
+  swap(rhs);
+  return *this;
+};
+
+template <class T, class Compare>
+bool FlatSet<T, Compare>::IsSortedUnique() const {
+  for (size_type i=1; i<data_.size(); i++) {
+    if (!comp_(data_[i-1], data_[i]))
+      return false;
+  }
+  return true;
+};
+
+template <class T, class Compare>
+void FlatSet<T, Compare>::SortUnique() {
+  std::stable_sort(data_.begin(), data_.end(), comp_);
+  typename Storage::iterator write = data_.begin();
+  for (typename Storage::iterator read = data_.begin(); read!=data_.end(); ++read) {
+    if (write==data_.begin() || comp_(*(write-1), *read))
+      *(write++) = *read;
+  }
+  data_.erase(write, data_.end());
+};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::const_iterator FlatSet<T, Compare>::begin() const
+  {return data_.begin();};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::const_iterator FlatSet<T, Compare>::end() const
+  {return data_.end();};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::const_reverse_iterator FlatSet<T, Compare>::rbegin() const
+  {return data_.rbegin();};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::const_reverse_iterator FlatSet<T, Compare>::rend() const
+  {return data_.rend();};
+
+template <class T, class Compare>
+inline bool FlatSet<T, Compare>::empty() const
+  {return data_.empty();};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::size_type FlatSet<T, Compare>::size() const
+  {return data_.size();};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::size_type FlatSet<T, Compare>::capacity() const
+  {return data_.capacity();};
+
+template <class T, class Compare>
+void FlatSet<T, Compare>::reserve(const size_type n)
+  {data_.reserve(n);};
+
+template <class T, class Compare>
+void FlatSet<T, Compare>::clear()
+  {data_.clear();};
+
+template <class T, class Compare>
+void FlatSet<T, Compare>::swap(FlatSet& rhs) {
+  data_.swap(rhs.data_);
+  std::swap(comp_, rhs.comp_);
+};
+
+template <class T, class Compare>
+std::pair<typename FlatSet<T, Compare>::iterator, bool>
+FlatSet<T, Compare>::insert(const value_type& value) {
+  const_iterator pos = lower_bound(value);
+  if (pos!=end() && !comp_(value, *pos))
+    return std::make_pair(pos, false);
+  const size_type index = pos-begin();
+  data_.insert(data_.begin()+index, value);
+  return std::make_pair(begin()+index, true);
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::iterator
+FlatSet<T, Compare>::insert(const_iterator hint, const value_type& value) {
+  //is the hint correct: value fits between the previous element and the hint
+  if ((hint==begin() || comp_(*(hint-1), value)) && (hint==end() || comp_(value, *hint))) {
+    const size_type index = hint-begin();
+    data_.insert(data_.begin()+index, value);
+    return begin()+index;
+  }
+  return insert(value).first;
+};
+
+template <class T, class Compare> template <class InputIterator>
+void FlatSet<T, Compare>::insert(InputIterator first, InputIterator last) {
+  const FlatSet other(first, last, comp_);
+  if (other.empty())
+    return;
+  //everything behind the held elements: append
+  if (empty() || comp_(data_.back(), other.data_.front())) {
+    data_.insert(data_.end(), other.begin(), other.end());
+    return;
+  }
+  //merge, keeping the held element of equivalent ones
+  Storage merged;
+  merged.reserve(data_.size()+other.size());
+  const_iterator iter1 = begin(), iter2 = other.begin();
+  while (iter1!=end() && iter2!=other.end()) {
+    if (comp_(*iter2, *iter1))
+      merged.push_back(*(iter2++));
+    else {
+      if (!comp_(*iter1, *iter2))
+        ++iter2;
+      merged.push_back(*(iter1++));
+    }
+  }
+  merged.insert(merged.end(), iter1, end());
+  merged.insert(merged.end(), iter2, other.end());
+  data_.swap(merged);
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::iterator
+FlatSet<T, Compare>::erase(const_iterator pos) {
+  const size_type index = pos-begin();
+  data_.erase(data_.begin()+index);
+  return begin()+index;
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::size_type
+FlatSet<T, Compare>::erase(const key_type& key) {
+  const const_iterator pos = find(key);
+  if (pos==end())
+    return 0;
+  erase(pos);
+  return 1;
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::iterator
+FlatSet<T, Compare>::erase(const_iterator first, const_iterator last) {
+  const size_type index = first-begin();
+  data_.erase(data_.begin()+index, data_.begin()+(last-begin()));
+  return begin()+index;
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::const_iterator
+FlatSet<T, Compare>::find(const key_type& key) const {
+  const const_iterator pos = lower_bound(key);
+  return (pos!=end() && !comp_(key, *pos)) ? pos : end();
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::size_type
+FlatSet<T, Compare>::count(const key_type& key) const
+  {return find(key)!=end();};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::const_iterator
+FlatSet<T, Compare>::lower_bound(const key_type& key) const
+  {return std::lower_bound(data_.begin(), data_.end(), key, comp_);};
+
+template <class T, class Compare>
+inline typename FlatSet<T, Compare>::const_iterator
+FlatSet<T, Compare>::upper_bound(const key_type& key) const
+  {return std::upper_bound(data_.begin(), data_.end(), key, comp_);};
+
+template <class T, class Compare>
+std::pair<typename FlatSet<T, Compare>::const_iterator, typename FlatSet<T, Compare>::const_iterator>
+FlatSet<T, Compare>::equal_range(const key_type& key) const {
+  const const_iterator pos = lower_bound(key);
+  return std::make_pair(pos, (pos!=end() && !comp_(key, *pos)) ? pos+1 : pos);
+};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::key_compare FlatSet<T, Compare>::key_comp() const
+  {return comp_;};
+
+template <class T, class Compare>
+typename FlatSet<T, Compare>::value_compare FlatSet<T, Compare>::value_comp() const
+  {return comp_;};
+
+template <class T, class Compare>
+inline const T* FlatSet<T, Compare>::data() const
+  {return data_.empty() ? NULL : &data_[0];};
+
+template <class T, class Compare>
+bool operator==(const FlatSet<T, Compare>& lhs, const FlatSet<T, Compare>& rhs)
+  {return lhs.size()==rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());};
+
+template <class T, class Compare>
+bool operator!=(const FlatSet<T, Compare>& lhs, const FlatSet<T, Compare>& rhs)
+  {return !(lhs==rhs);};
+
+template <class T, class Compare>
+bool operator<(const FlatSet<T, Compare>& lhs, const FlatSet<T, Compare>& rhs)
+  {return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());};
+
+#endif //FLATSET_H
@@ -22,7 +22,8 @@
 #include "ToolZ/PositionService.h"
 #include "ToolZ/DistanceService.h"
 
-static const unsigned hashedgeometry_version_ = 0;
+///version 1: the distance cache can be persisted
+static const unsigned hashedgeometry_version_ = 1;
 
 class HashedGeometry {
 #if SERIALIZATION_ENABLED
@@ -45,7 +46,8 @@ private:
   void serialize(Archive & ar, const unsigned int version);
   
   ///reconstruct from sparse information
-  HashedGeometry (const PositionServiceConstPtr& posService);
+  HashedGeometry (const PositionServiceConstPtr& posService,
+                  const bool persistDistances);
 #endif //SERIALIZATION_ENABLED
 private: //properties
   const CompactOMKeyHashServiceConstPtr hashService_;
@@ -53,12 +55,16 @@ private: //properties
   const DistanceServiceConstPtr distService_;
 public: //constructor
   /// constructor: hash this omgeo
-  HashedGeometry(const I3OMGeoMap& omgeo);
+  /// \param persistDistances serialize the distances, which the DistanceService has filled, along
+  HashedGeometry(const I3OMGeoMap& omgeo,
+                 const bool persistDistances = false);
   
   /// constructor: hash this omgeo, but only the specified OMKeys
+  /// \param persistDistances serialize the distances, which the DistanceService has filled, along
   HashedGeometry(
     const I3OMGeoMap& omgeo,
-    const std::set<OMKey> omkeys);
+    const std::set<OMKey> omkeys,
+    const bool persistDistances = false);
 public: //getters
   CompactOMKeyHashServiceConstPtr GetHashService() const;
   PositionServiceConstPtr GetPosService() const;
@@ -83,6 +89,10 @@ inline void SERIALIZATION_NS::save_construct_data(
 {
   const PositionService* p = (t->posService_).get();
   ar << SERIALIZATION_NS::make_nvp("posService", p);
+  bool persistDistances = t->distService_->GetPersistCache();
+  ar << SERIALIZATION_NS::make_nvp("persistDistances", persistDistances);
+  if (persistDistances)
+    t->distService_->SaveCache(ar);
 };
 
 template<class Archive>
@@ -93,8 +103,16 @@ inline void SERIALIZATION_NS::load_construct_data(
 {
   PositionService* posService;
   ar >> SERIALIZATION_NS::make_nvp("posService", posService);
-  ::new(t)HashedGeometry(boost::make_shared<const PositionService>(*posService));
+  //version 0 holds no distances
+  bool persistDistances = false;
+  if (version>=1)
+    ar >> SERIALIZATION_NS::make_nvp("persistDistances", persistDistances);
+  ::new(t)HashedGeometry(boost::make_shared<const PositionService>(*posService), persistDistances);
+  if (persistDistances)
+    t->distService_->LoadCache(ar);
 };
+
+SERIALIZATION_CLASS_VERSION(HashedGeometry, hashedgeometry_version_);
 #endif //SERIALIZATION_ENABLED
 
 inline
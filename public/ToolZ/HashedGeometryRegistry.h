@@ -0,0 +1,101 @@
+/**
+ * \file HashedGeometryRegistry.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A process-wide registry of hashers and HashedGeometries, so that identical geometries are only hashed once
+ */
+
+#ifndef HASHEDGEOMETRYREGISTRY_H
+#define HASHEDGEOMETRYREGISTRY_H
+
+#include <map>
+#include <set>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "dataclasses/geometry/I3Geometry.h"
+
+#include "ToolZ/OMKeyHash.h"
+#include "ToolZ/HashedGeometry.h"
+
+/**
+ * Hands out shared, immutable CompactOMKeyHashServices and HashedGeometries, keyed by a 64-bit fingerprint
+ * of the sorted OMKeys (and positions) they are built from.
+ * Entries are held weakly: an instance is reused as long as anyone in the process still holds it.
+ * A registered instance is only handed out after it is checked to encode exactly the requested OMKeys (and positions),
+ * so that fingerprint collisions can not mix up geometries.
+ * NOTE all methods are thread-safe
+ */
+struct HashedGeometryRegistry {
+private:
+  typedef std::map<uint64_t, boost::weak_ptr<const CompactOMKeyHashService> > HasherRegister;
+  typedef std::map<uint64_t, boost::weak_ptr<const HashedGeometry> > GeometryRegister;
+
+  ///the process-wide state of the registry
+  struct Registers {
+    ///guards all registers and counters
+    boost::mutex mutex_;
+    ///the registered hashers by fingerprint of their OMKeys
+    HasherRegister hashers_;
+    ///the registered HashedGeometries by fingerprint of their OMKeys and positions
+    GeometryRegister geometries_;
+    ///number of requests which could be served from the registers
+    uint64_t hits_;
+    ///number of requests which required a new object to be built
+    uint64_t misses_;
+    ///size of the registers at which expired entries are purged next
+    size_t purgeSize_;
+    ///constructor
+    Registers();
+  };
+
+  ///access the process-wide state; constructed on first use, so it is safe to use during static initialization
+  static Registers& GetRegisters();
+
+  ///remove all expired entries; NOTE call only with the mutex_ locked
+  static void Purge(Registers& regs);
+
+  ///remove all expired entries if the registers have doubled in size since the last purge; NOTE call only with the mutex_ locked
+  static void PurgeIfGrown(Registers& regs);
+
+public:
+  /// fingerprint a set of OMKeys
+  static uint64_t Fingerprint(const std::set<OMKey>& omkeys);
+
+  /// fingerprint all OMKeys and their positions in this omgeo
+  static uint64_t Fingerprint(const I3OMGeoMap& omgeo);
+
+  /// fingerprint the selected OMKeys and their positions in this omgeo
+  static uint64_t Fingerprint(
+    const I3OMGeoMap& omgeo,
+    const std::set<OMKey>& omkeys);
+
+  /// get a hasher for these OMKeys; built if not already registered
+  static CompactOMKeyHashServiceConstPtr GetHashService(const std::set<OMKey>& omkeys);
+
+  /// get a HashedGeometry for this omgeo; built if not already registered
+  static HashedGeometryConstPtr GetHashedGeometry(const I3OMGeoMap& omgeo);
+
+  /// get a HashedGeometry for this omgeo, hashing only the specified OMKeys; built if not already registered
+  static HashedGeometryConstPtr GetHashedGeometry(
+    const I3OMGeoMap& omgeo,
+    const std::set<OMKey>& omkeys);
+
+  /// number of requests served by an already registered object
+  static uint64_t GetCacheHits();
+
+  /// number of requests which required building a new object
+  static uint64_t GetCacheMisses();
+
+  /// number of currently alive registered objects (hashers and HashedGeometries)
+  static size_t GetSize();
+
+  /// forget all registered objects and reset the counters; objects still held elsewhere stay alive
+  static void Clear();
+};
+
+#endif //HASHEDGEOMETRYREGISTRY_H
@@ -0,0 +1,258 @@
+/**
+ * \file HashedOMKeySet.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A set of OMKeys represented by a bitset over their compact hashes
+ */
+
+#ifndef HASHEDOMKEYSET_H
+#define HASHEDOMKEYSET_H
+
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/cstdint.hpp>
+
+#include "ToolZ/OMKeyHash.h"
+
+/**
+ * A set of OMKeys, which are all hashed by the same CompactOMKeyHashService;
+ * membership is stored as one bit per hash, so that set-algebra is performed a (64-bit) word at a time.
+ * NOTE binary operations are only defined between sets over the same hasher
+ */
+class HashedOMKeySet {
+public:
+  ///the underlying bitset; one bit per hash
+  typedef boost::dynamic_bitset<uint64_t> BitSet;
+
+  /// iterates the hashes of all OMKeys in the set in ascending order
+  class const_iterator : public std::iterator<std::forward_iterator_tag, CompactHash> {
+    friend class HashedOMKeySet;
+  private:
+    ///the bitset iterated over
+    const BitSet* bits_;
+    ///current position; BitSet::npos for end
+    BitSet::size_type pos_;
+    ///constructor
+    const_iterator(const BitSet* bits, const BitSet::size_type pos);
+  public:
+    ///blank constructor
+    const_iterator();
+    ///get the hash at this position
+    CompactHash operator*() const;
+    ///advance to the next contained hash
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    bool operator==(const const_iterator& rhs) const;
+    bool operator!=(const const_iterator& rhs) const;
+  };
+
+private:
+  ///the hasher which defines the meaning of each bit
+  CompactOMKeyHashServiceConstPtr hasher_;
+  ///the bit at each hash is set if that OMKey is contained
+  BitSet bits_;
+
+  ///ensure that the other set is defined over the same hasher; log_fatal otherwise
+  void AssertCompatible(const HashedOMKeySet& rhs) const;
+  ///ensure that this hash is held by the hasher; throws std::out_of_range otherwise
+  void AssertInRange(const CompactHash hash) const;
+
+public:
+  ///blank constructor, NOTE avoid if possible
+  HashedOMKeySet();
+  /// constructor: empty set over this hasher
+  explicit HashedOMKeySet(const CompactOMKeyHashServiceConstPtr& hasher);
+  /// constructor: holding these omkeys; throws if any of these is not hashed by the hasher
+  HashedOMKeySet(
+    const CompactOMKeyHashServiceConstPtr& hasher,
+    const std::set<OMKey>& omkeys);
+  /// constructor: holding these hashes; throws std::out_of_range if any of these is not held by the hasher
+  HashedOMKeySet(
+    const CompactOMKeyHashServiceConstPtr& hasher,
+    const std::vector<CompactHash>& hashes);
+  /// get the set holding every OMKey hashed by the hasher
+  static HashedOMKeySet Full(const CompactOMKeyHashServiceConstPtr& hasher);
+
+public: //element access
+  ///insert this OMKey; return true if it was not contained before
+  bool Insert(const OMKey& omkey);
+  ///insert this hash; return true if it was not contained before; throws std::out_of_range if not held by the hasher
+  bool Insert(const CompactHash hash);
+  ///erase this OMKey; return true if it was contained before
+  bool Erase(const OMKey& omkey);
+  ///erase this hash; return true if it was contained before; throws std::out_of_range if not held by the hasher
+  bool Erase(const CompactHash hash);
+  ///is this OMKey contained; false also for OMKeys not hashed
+  bool Contains(const OMKey& omkey) const;
+  ///is this hash contained; false also for hashes not held by the hasher
+  bool Contains(const CompactHash hash) const;
+  ///remove all OMKeys
+  void Clear();
+
+public: //properties
+  ///number of contained OMKeys (popcount)
+  size_t Count() const;
+  ///is no OMKey contained
+  bool Empty() const;
+  ///get the hasher the set is defined over
+  CompactOMKeyHashServiceConstPtr GetHasher() const;
+  ///get the underlying bitset
+  const BitSet& GetBits() const;
+
+public: //iteration
+  const_iterator begin() const;
+  const_iterator end() const;
+
+public: //set algebra
+  ///union
+  HashedOMKeySet& operator|=(const HashedOMKeySet& rhs);
+  ///intersection
+  HashedOMKeySet& operator&=(const HashedOMKeySet& rhs);
+  ///difference
+  HashedOMKeySet& operator-=(const HashedOMKeySet& rhs);
+  ///symmetric difference
+  HashedOMKeySet& operator^=(const HashedOMKeySet& rhs);
+  ///all OMKeys of the hasher which are not contained
+  HashedOMKeySet operator~() const;
+  ///are all OMKeys also contained in rhs
+  bool IsSubsetOf(const HashedOMKeySet& rhs) const;
+  ///is at least one OMKey also contained in rhs
+  bool Intersects(const HashedOMKeySet& rhs) const;
+  ///number of OMKeys also contained in rhs
+  size_t IntersectionCount(const HashedOMKeySet& rhs) const;
+  ///same hasher and same OMKeys
+  bool operator==(const HashedOMKeySet& rhs) const;
+  bool operator!=(const HashedOMKeySet& rhs) const;
+
+public: //conversion
+  ///get the contained OMKeys
+  std::set<OMKey> GetOMKeys() const;
+  ///get the hashes of all contained OMKeys in ascending order
+  std::vector<CompactHash> GetHashes() const;
+};
+
+HashedOMKeySet operator|(HashedOMKeySet lhs, const HashedOMKeySet& rhs);
+HashedOMKeySet operator&(HashedOMKeySet lhs, const HashedOMKeySet& rhs);
+HashedOMKeySet operator-(HashedOMKeySet lhs, const HashedOMKeySet& rhs);
+HashedOMKeySet operator^(HashedOMKeySet lhs, const HashedOMKeySet& rhs);
+
+typedef boost::shared_ptr<HashedOMKeySet> HashedOMKeySetPtr;
+typedef boost::shared_ptr<const HashedOMKeySet> HashedOMKeySetConstPtr;
+
+
+//=====================================================
+//=================== IMPLEMENTATIONS =================
+//=====================================================
+
+inline
+HashedOMKeySet::const_iterator::const_iterator()
+: bits_(0), pos_(BitSet::npos)
+{};
+
+inline
+HashedOMKeySet::const_iterator::const_iterator(const BitSet* bits, const BitSet::size_type pos)
+: bits_(bits), pos_(pos)
+{};
+
+inline
+CompactHash HashedOMKeySet::const_iterator::operator*() const
+  {return CompactHash(pos_);};
+
+inline
+HashedOMKeySet::const_iterator& HashedOMKeySet::const_iterator::operator++() {
+  pos_ = bits_->find_next(pos_);
+  return *this;
+};
+
+inline
+HashedOMKeySet::const_iterator HashedOMKeySet::const_iterator::operator++(int) {
+  const const_iterator tmp(*this);
+  ++(*this);
+  return tmp;
+};
+
+inline
+bool HashedOMKeySet::const_iterator::operator==(const const_iterator& rhs) const
+  {return pos_==rhs.pos_;};
+
+inline
+bool HashedOMKeySet::const_iterator::operator!=(const const_iterator& rhs) const
+  {return pos_!=rhs.pos_;};
+
+inline
+void HashedOMKeySet::AssertInRange(const CompactHash hash) const {
+  if (hash>=bits_.size())
+    throw std::out_of_range("hash is not held by the hasher"); //NOTE same behaviour as the hasher
+};
+
+inline
+bool HashedOMKeySet::Insert(const OMKey& omkey)
+  {return Insert(hasher_->HashFromOMKey(omkey));};
+
+inline
+bool HashedOMKeySet::Insert(const CompactHash hash) {
+  AssertInRange(hash);
+  const bool contained = bits_.test(hash);
+  bits_.set(hash);
+  return !contained;
+};
+
+inline
+bool HashedOMKeySet::Erase(const OMKey& omkey) {
+  if (!hasher_->HoldsOMKey(omkey))
+    return false;
+  return Erase(hasher_->HashFromOMKey(omkey));
+};
+
+inline
+bool HashedOMKeySet::Erase(const CompactHash hash) {
+  AssertInRange(hash);
+  const bool contained = bits_.test(hash);
+  bits_.reset(hash);
+  return contained;
+};
+
+inline
+bool HashedOMKeySet::Contains(const OMKey& omkey) const
+  {return hasher_->HoldsOMKey(omkey) && bits_.test(hasher_->HashFromOMKey(omkey));};
+
+inline
+bool HashedOMKeySet::Contains(const CompactHash hash) const
+  {return hash<bits_.size() && bits_.test(hash);};
+
+inline
+void HashedOMKeySet::Clear()
+  {bits_.reset();};
+
+inline
+size_t HashedOMKeySet::Count() const
+  {return bits_.count();};
+
+inline
+bool HashedOMKeySet::Empty() const
+  {return bits_.none();};
+
+inline
+CompactOMKeyHashServiceConstPtr HashedOMKeySet::GetHasher() const
+  {return hasher_;};
+
+inline
+const HashedOMKeySet::BitSet& HashedOMKeySet::GetBits() const
+  {return bits_;};
+
+inline
+HashedOMKeySet::const_iterator HashedOMKeySet::begin() const
+  {return const_iterator(&bits_, bits_.find_first());};
+
+inline
+HashedOMKeySet::const_iterator HashedOMKeySet::end() const
+  {return const_iterator(&bits_, BitSet::npos);};
+
+#endif //HASHEDOMKEYSET_H
@@ -0,0 +1,255 @@
+/**
+ * \file HitBatch.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A time-ordered batch of hits stored as structure-of-arrays,
+ * so that kernels iterating over many hits touch only the columns they need
+ */
+
+#ifndef HITBATCH_H
+#define HITBATCH_H
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include <boost/foreach.hpp>
+
+#include "ToolZ/Hitclasses.h"
+
+//============ CLASS HitSpan ===========
+
+/**
+ * @brief a view on a contiguous, time-ordered range of hits in a HitBatch;
+ * the columns are plain arrays of length 'size', so that kernels can operate on them directly.
+ * NOTE the span does not own the columns; it must not outlive the HitBatch it was taken from
+ */
+struct HitSpan {
+  ///the DOM indices
+  const CompactHash* domIndex;
+  ///the times in ns, ascending
+  const double* time;
+  ///the charges; NULL if the batch holds none
+  const double* charge;
+  ///the origins; NULL if the batch holds none
+  const uint32_t* origin;
+  ///the number of hits
+  size_t size;
+
+  ///the sub-range of 'count' hits starting at 'first'
+  HitSpan SubSpan(const size_t first, const size_t count) const;
+  ///the position of the first hit not earlier than 'time'
+  size_t LowerBound(const double time) const;
+  ///the sub-range of hits with begin<=time<end
+  HitSpan TimeWindow(const double begin, const double end) const;
+};
+
+//============ CLASS HitBatch ===========
+
+/**
+ * @brief a time-ordered batch of hits stored as columns of DOM index, time,
+ * and optionally charge and origin;
+ * hits are ordered by time, with the DOM index and then the origin as tie-breakers, like AbsHitSet.
+ * The origin is the position of the hit's response object in the flattened response map it was extracted from,
+ * by which the batch can be converted back to a response map, see OMKeyMap_HitFacility::MapFromHitBatch
+ */
+class HitBatch {
+private:
+  ///column of DOM indices
+  std::vector<CompactHash> domIndex_;
+  ///column of times
+  std::vector<double> time_;
+  ///column of charges; empty if the batch holds none
+  std::vector<double> charge_;
+  ///column of origins; empty if the batch holds none
+  std::vector<uint32_t> origin_;
+
+  ///establish the time-order of the columns
+  void Sort();
+  ///the time of a hit
+  static double TimeOf(const AbsHit& h);
+  ///the time of a hit
+  static double TimeOf(const AbsDAQHit& h);
+
+public:
+  ///constructor: an empty batch
+  HitBatch();
+  /** @brief constructor: take over the columns of hits in any order and sort them;
+   * the passed vectors are left empty
+   * @param domIndex the DOM indices
+   * @param time the times
+   * @param charge the charges; empty or of the same length as 'time'
+   * @param origin the origins; empty or of the same length as 'time'
+   */
+  HitBatch(std::vector<CompactHash>& domIndex,
+           std::vector<double>& time,
+           std::vector<double>& charge,
+           std::vector<uint32_t>& origin);
+  /// constructor: from a container of AbsHits, Hits or AbsDAQHits; without charges and origins
+  template <class HitContainer>
+  explicit HitBatch(const HitContainer& hits);
+
+  ///the number of hits
+  size_t size() const;
+  ///holds the batch no hits
+  bool empty() const;
+  ///does the batch hold charges
+  bool HasCharge() const;
+  ///does the batch hold origins
+  bool HasOrigin() const;
+
+  ///the DOM index of the hit at 'index'
+  CompactHash GetDOMIndex(const size_t index) const;
+  ///the time of the hit at 'index'
+  double GetTime(const size_t index) const;
+  ///the charge of the hit at 'index'
+  double GetCharge(const size_t index) const;
+  ///the origin of the hit at 'index'
+  uint32_t GetOrigin(const size_t index) const;
+  ///the hit at 'index' as an AbsHit
+  AbsHit GetAbsHit(const size_t index) const;
+
+  ///the column of DOM indices
+  const std::vector<CompactHash>& GetDOMIndices() const;
+  ///the column of times
+  const std::vector<double>& GetTimes() const;
+  ///the column of charges; empty if the batch holds none
+  const std::vector<double>& GetCharges() const;
+  ///the column of origins; empty if the batch holds none
+  const std::vector<uint32_t>& GetOrigins() const;
+
+  ///a view on all hits
+  HitSpan GetSpan() const;
+  ///put all hits as AbsHits into a container
+  template <class AbsHitContainer>
+  AbsHitContainer GetAbsHits() const;
+};
+
+///dump the object to a (string)stream
+std::ostream& operator<<(std::ostream& oss, const HitBatch& b);
+
+
+//==============================================================================
+//========================== IMPLEMENTATIONS ===================================
+//==============================================================================
+
+//================ CLASS HitSpan =======================
+
+inline
+HitSpan HitSpan::SubSpan(const size_t first, const size_t count) const {
+  const HitSpan sub = {
+    domIndex+first,
+    time+first,
+    charge ? charge+first : NULL,
+    origin ? origin+first : NULL,
+    count };
+  return sub;
+};
+
+inline
+size_t HitSpan::LowerBound(const double t) const
+  {return std::lower_bound(time, time+size, t)-time;};
+
+inline
+HitSpan HitSpan::TimeWindow(const double begin, const double end) const {
+  const size_t first = LowerBound(begin);
+  return SubSpan(first, std::max(LowerBound(end), first)-first);
+};
+
+//================ CLASS HitBatch =======================
+
+inline
+double HitBatch::TimeOf(const AbsHit& h)
+  {return h.GetTime();};
+
+inline
+double HitBatch::TimeOf(const AbsDAQHit& h)
+  {return h.GetDAQTicks()/10.;};
+
+template <class HitContainer>
+HitBatch::HitBatch(const HitContainer& hits) {
+  domIndex_.reserve(hits.size());
+  time_.reserve(hits.size());
+  typedef typename HitContainer::value_type Hitclass;
+  BOOST_FOREACH(const Hitclass& h, hits) {
+    domIndex_.push_back(h.GetDOMIndex());
+    time_.push_back(TimeOf(h));
+  }
+  Sort();
+};
+
+inline
+size_t HitBatch::size() const
+  {return time_.size();};
+
+inline
+bool HitBatch::empty() const
+  {return time_.empty();};
+
+inline
+bool HitBatch::HasCharge() const
+  {return !charge_.empty();};
+
+inline
+bool HitBatch::HasOrigin() const
+  {return !origin_.empty();};
+
+inline
+CompactHash HitBatch::GetDOMIndex(const size_t index) const
+  {return domIndex_[index];};
+
+inline
+double HitBatch::GetTime(const size_t index) const
+  {return time_[index];};
+
+inline
+double HitBatch::GetCharge(const size_t index) const
+  {return charge_[index];};
+
+inline
+uint32_t HitBatch::GetOrigin(const size_t index) const
+  {return origin_[index];};
+
+inline
+AbsHit HitBatch::GetAbsHit(const size_t index) const
+  {return AbsHit(domIndex_[index], time_[index]);};
+
+inline
+const std::vector<CompactHash>& HitBatch::GetDOMIndices() const
+  {return domIndex_;};
+
+inline
+const std::vector<double>& HitBatch::GetTimes() const
+  {return time_;};
+
+inline
+const std::vector<double>& HitBatch::GetCharges() const
+  {return charge_;};
+
+inline
+const std::vector<uint32_t>& HitBatch::GetOrigins() const
+  {return origin_;};
+
+inline
+HitSpan HitBatch::GetSpan() const {
+  const HitSpan span = {
+    domIndex_.empty() ? NULL : &domIndex_[0],
+    time_.empty() ? NULL : &time_[0],
+    charge_.empty() ? NULL : &charge_[0],
+    origin_.empty() ? NULL : &origin_[0],
+    time_.size() };
+  return span;
+};
+
+template <class AbsHitContainer>
+AbsHitContainer HitBatch::GetAbsHits() const {
+  AbsHitContainer hits;
+  for (size_t i=0; i<time_.size(); i++)
+    hits.insert(hits.end(), AbsHit(domIndex_[i], time_[i]));
+  return hits;
+};
+
+#endif //HITBATCH_H
@@ -18,8 +18,11 @@ static const unsigned hitfacility_version_ = 0;
 
 #include <numeric>
 #include <queue>
+#include <algorithm>
 
 #include "ToolZ/HitSorting.h"
+#include "ToolZ/HitBatch.h"
+#include "ToolZ/HashedGeometryRegistry.h"
 
 #include "dataclasses/physics/I3RecoPulse.h"
 #include "dataclasses/I3MapOMKeyMask.h" //one of the bitmasks that is explicitly supported
@@ -47,6 +50,7 @@ protected:
   typedef HitObject<Response> ResponseHitObject;
   typedef std::set<ResponseHitObject, typename ResponseHitObject::RetrievalOrdered> ResponseHitObjectSetRO;
   typedef std::list<ResponseHitObject> ResponseHitObjectList; 
+  typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
   
 protected://properties/parameters
   ///PARAM: the frame this might have been extracted from
@@ -61,6 +65,8 @@ protected://properties/internal
   const CompactOMKeyHashServiceConstPtr hasher_;
   /// here are the extracted objects
   mutable boost::shared_ptr<ResponseHitObjectList> hitObjects_;
+  /// the entries of the map indexed by the hash of their DOM; NULL for DOMs not in the map
+  mutable std::vector<const OMKey_RespVec*> domTable_;
   
 public://methods
   /** constructor
@@ -85,6 +91,16 @@ public://methods
   /// Extract AbsDAQHit-objects from the ResponseMap and put/insert them into the container 
   template <class AbsDAQHitContainer>
   AbsDAQHitContainer GetAbsDAQHits() const;
+  /// Extract all hits from the ResponseMap into a time-ordered HitBatch, which holds their origins
+  /// \param withCharge also fill the charges of the hits, see GetInferredCharge
+  HitBatch GetHitBatch(const bool withCharge=false) const;
+  /// Get the time of the earliest hit in the ResponseMap, which is a suitable time base for CompactHits; 0 if empty
+  double GetTimeBase() const;
+  /// Extract CompactHit-objects from the ResponseMap and put/insert them into the container;
+  /// log_fatal if a hit is beyond the lossless range around the time base
+  /// \param timeBase the time base the times of the CompactHits are relative to, see GetTimeBase
+  template <class CompactHitContainer>
+  CompactHitContainer GetCompactHits(const double timeBase) const;
   
   /// Revert once extracted Hits back to a subMap of the original ResonseMap
   /// \param hits a container with the hits to revert
@@ -98,6 +114,11 @@ public://methods
   I3ResponseSeriesMap
   MapFromAbsHits (const AbsHitContainer &abshits) const;
   
+  /// Revert a HitBatch, or any part of it, back to a subMap of the original ResonseMap by the origins of its hits
+  /// \param batch a HitBatch extracted by GetHitBatch of this facility
+  I3ResponseSeriesMap
+  MapFromHitBatch (const HitBatch &batch) const;
+  
   /// Get the internally held hasher
   CompactOMKeyHashServiceConstPtr GetHasher() const;
   
@@ -105,38 +126,65 @@ public://methods
   /// \param h the hit //FIXME static
   const HitObject<Response>& GetHitObject(const Hit &h) const;
   
+  /// Extract handles to all response objects of the ResponseMap, in the order of the map
+  template <class HitHandleContainer>
+  HitHandleContainer GetHitHandles() const;
+  
+  /// Get the handle to the response object a Hit of this facility is associated to; in constant time
+  /// \param h a hit extracted by GetHits of this facility
+  HitHandle GetHandle(const Hit &h) const;
+  
+  /// Resolve a handle to the response object it refers to; in constant time
+  /// \param h a handle to a response object of this map
+  const Response& GetResponse(const HitHandle &h) const;
+  
+  /// Resolve a handle to a HitObject referring into the ResponseMap; in constant time
+  /// \param h a handle to a response object of this map
+  HitObject<Response> GetHitObject(const HitHandle &h) const;
+  
+  /// Revert handles back to a subMap of the original ResonseMap
+  /// \param handles a container with the handles to revert
+  template<class HitHandleContainer>
+  I3ResponseSeriesMap
+  MapFromHandles (const HitHandleContainer &handles) const;
+  
   //NOTE FUTURE here could be a general implementation of "MaskFromHits()", however the OMKeyMapMasks are not templated
   
 protected:
+  /// Get the entry of the map a handle refers to, checking that the handle is valid
+  const OMKey_RespVec& GetMapEntry(const HitHandle &h) const;
+  
   /// a callable stuct which can internally used for example with the Masking of I3RecoPulseSeriesMapMask
-  struct predicate {
+  struct predicate_handle {
     ///keep a pointer to the outer facility
     const OMKeyMap_HitFacility* outer_;
-    ///hold the hits which need to be backconverted
-    const HitSetRO hits_;
-    ///stepping iterator
-    HitSetRO::const_iterator it_;
-    ///marking the static end for the stepping operator
-    const HitSetRO::const_iterator it_end_;
+    ///hold the handles which need to be backconverted, in the order of the map
+    std::vector<HitHandle> handles_;
+    ///stepping position in handles_; an index rather than an iterator, so that the object can be copied
+    size_t pos_;
+    ///the DOM of the previous call
+    OMKey omkey_;
+    ///the hash of the DOM of the previous call
+    CompactHash hash_;
+    ///has the object been called before
+    bool started_;
     
     ///constructor
-    template <class HitContainer>
-    predicate(const OMKeyMap_HitFacility* outer, const HitContainer &hits);
+    template <class HitHandleContainer>
+    predicate_handle(const OMKeyMap_HitFacility* outer, const HitHandleContainer &handles);
     
     ///call operator to this object
-    bool operator() (const OMKey& o, size_t, const Response& r);
+    bool operator() (const OMKey& o, size_t index, const Response& r);
   };
   
   /// a callable stuct which can internally used for example with the Masking of I3RecoPulseSeriesMapMask
   struct predicate_abs {
     ///keep a pointer to the outer facility
     const OMKeyMap_HitFacility* outer_;
-    ///hold the hits which need to be backconverted
-    const AbsHitSetRO hits_;
-    ///stepping iterator
-    AbsHitSetRO::const_iterator it_;
-    ///marking the static end for the stepping operator
-    const AbsHitSetRO::const_iterator it_end_;
+    ///hold the hits which need to be backconverted, sorted into retrieval order
+    std::vector<AbsHit> hits_;
+    ///stepping position in hits_; an index rather than an iterator, so that the object can be copied
+    size_t pos_;
     
     ///constructor
     template <class HitContainer>
@@ -211,6 +259,10 @@ public://methods
   /// \param hits a container with the hits to revert
   template<class AbsHitContainer>
   I3RecoPulseSeriesMapMask MaskFromAbsHits (const AbsHitContainer &abshits) const;
+  /// Revert handles back to a final ResponseMask of the original ResonseMap
+  /// \param handles a container with the handles to revert
+  template<class HitHandleContainer>
+  I3RecoPulseSeriesMapMask MaskFromHandles (const HitHandleContainer &handles) const;
 };
 
 typedef boost::shared_ptr<I3RecoPulseSeriesMap_HitFacility> I3RecoPulseSeriesMap_HitFacilityPtr;
@@ -233,7 +285,7 @@ OMKeyMap_HitFacility<Response>::OMKeyMap_HitFacility(
 : frame_(frame),
   key_(key),
   map_(frame_->Get<boost::shared_ptr<const I3ResponseSeriesMap> >(key_)),
-  hasher_(hasher ? hasher : boost::make_shared<const CompactOMKeyHashService>(ExtractOMKeys(*map_)))
+  hasher_(hasher ? hasher : HashedGeometryRegistry::GetHashService(ExtractOMKeys(*map_)))
   //hitObjects_(boost::make_shared<std::list<HitObject<Response> >(OMKeyMap_To_HitObjects<Response, std::list<HitObject<Response> > > (*map_))) //only created on demand
 {
   if (!map_)
@@ -262,62 +314,134 @@ OMKeyMap_HitFacility<Response>::GetHits() const {
   if (!hitObjects_) //if the pointer is not yet pointing to a valid object 
     hitObjects_ = boost::make_shared<ResponseHitObjectList>(HitSorting::OMKeyMap_To_HitObjects<Response, ResponseHitObjectList> (*map_));
   
-  //make the according hits and link them
-//   HitList hits;
-//   BOOST_FOREACH(const ResponseHitObject &ho, hitObjects_)
-//     hits.insert(hits.end(), Hit(hasher_->HashFromOMKey(ho.GetOMKey()), ho.GetTime(), ho));
-//   return HitContainer(hits.begin(), hits.end());
-  
-  HitContainer hits;
-  BOOST_FOREACH(const ResponseHitObject &ho, *hitObjects_)
-    hits.insert(hits.end(), Hit(hasher_->HashFromOMKey(ho.GetOMKey()), ho.GetTime(), ho));
-  return hits;
+  //hash the keys of the non-empty series in one pass; the hitObjects_ are in the same order as the map
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  typename I3ResponseSeriesMap::const_iterator map_iter = map_->begin();
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  
+  //collect in map order, and let the container establish its order at once, which sorted vectors need to be efficient
+  HitSeries hits;
+  hits.reserve(hitObjects_->size());
+  BOOST_FOREACH(const ResponseHitObject &ho, *hitObjects_) {
+    while (map_iter->first != ho.GetOMKey()) { //skip over to the next DOM; only non-empty series have a hash
+      if (!map_iter->second.empty())
+        ++hash_iter;
+      ++map_iter;
+    }
+    hits.push_back(Hit(*hash_iter, ho.GetTime(), ho));
+  }
+  return HitContainer(hits.begin(), hits.end());
 }
 
 template <class Response> template <class AbsHitContainer>
 AbsHitContainer
 OMKeyMap_HitFacility<Response>::GetAbsHits() const {
-//   if (!hitObjects_) //if the pointer is not yet pointing to a valid object 
-//     hitObjects_ = boost::make_shared<ResponseHitObjectList>(HitSorting::OMKeyMap_To_HitObjects<Response, ResponseHitObjectList> (*map_));
-//   
-//   AbsHitContainer hits;
-//   BOOST_FOREACH(const ResponseHitObject &ho, *hitObjects_)
-//     hits.insert(hits.end(), AbsHit(hasher_->HashFromOMKey(ho.GetOMKey()), ho.GetTime()));
-//   return hits;
-  
-  AbsHitContainer hits;
-  typedef std::pair<OMKey, std::vector<Response> > OMKey_RespVec;
+  //collect in map order, and let the container establish its order at once, which sorted vectors need to be efficient
+  AbsHitSeries hits;
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
   BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (o_rvec.second.empty())
+      continue;
+    const CompactHash hash = *(hash_iter++);
     BOOST_FOREACH(const Response& r, o_rvec.second) {
-      hits.insert(hits.end(), AbsHit(hasher_->HashFromOMKey(o_rvec.first), GetInferredTime(r)));
+      hits.push_back(AbsHit(hash, GetInferredTime(r)));
     }
   }
-  return hits;
+  return AbsHitContainer(hits.begin(), hits.end());
 }
 
 template <class Response> template <class AbsDAQHitContainer>
 AbsDAQHitContainer
 OMKeyMap_HitFacility<Response>::GetAbsDAQHits() const {
-//   if (!hitObjects_) //if the pointer is not yet pointing to a valid object 
-//     hitObjects_ = boost::make_shared<ResponseHitObjectList>(HitSorting::OMKeyMap_To_HitObjects<Response, ResponseHitObjectList> (*map_));
-//   
-//   AbsDAQHitContainer hits;
-//   BOOST_FOREACH(const ResponseHitObject &ho, *hitObjects_)
-//     hits.insert(hits.end(), AbsDAQHit(hasher_->HashFromOMKey(ho.GetOMKey()), ho.GetDAQTicks()));
-//   return hits;
-
-  //do NOT go through HitObjects and do things directly
-  AbsDAQHitContainer hits;
-  typedef std::pair<OMKey, std::vector<Response> > OMKey_RespVec;
+  AbsDAQHitSeries hits;
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
   BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (o_rvec.second.empty())
+      continue;
+    const CompactHash hash = *(hash_iter++);
     BOOST_FOREACH(const Response& r, o_rvec.second) {
-      hits.insert(hits.end(), AbsDAQHit(hasher_->HashFromOMKey(o_rvec.first), GetInferredDAQTicks(r)));
+      hits.push_back(AbsDAQHit(hash, GetInferredDAQTicks(r)));
     }
   }
-  return hits;
+  return AbsDAQHitContainer(hits.begin(), hits.end());
 };
 
 
+template <class Response>
+HitBatch
+OMKeyMap_HitFacility<Response>::GetHitBatch(const bool withCharge) const {
+  typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
+  size_t nHits = 0;
+  BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_)
+    nHits += o_rvec.second.size();
+  
+  //fill the columns in the order of the map, so that the origin is the running index; HitBatch sorts them
+  std::vector<CompactHash> domIndex;
+  std::vector<double> time;
+  std::vector<double> charge;
+  std::vector<uint32_t> origin;
+  domIndex.reserve(nHits);
+  time.reserve(nHits);
+  if (withCharge)
+    charge.reserve(nHits);
+  origin.reserve(nHits);
+  
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (o_rvec.second.empty())
+      continue;
+    const CompactHash hash = *(hash_iter++);
+    BOOST_FOREACH(const Response& r, o_rvec.second) {
+      origin.push_back(time.size());
+      domIndex.push_back(hash);
+      time.push_back(GetInferredTime(r));
+      if (withCharge)
+        charge.push_back(GetInferredCharge(r));
+    }
+  }
+  return HitBatch(domIndex, time, charge, origin);
+};
+
+template <class Response>
+double
+OMKeyMap_HitFacility<Response>::GetTimeBase() const {
+  double timeBase = 0.;
+  bool found = false;
+  BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    BOOST_FOREACH(const Response& r, o_rvec.second) {
+      const double time = GetInferredTime(r);
+      if (!found || time<timeBase) {
+        timeBase = time;
+        found = true;
+      }
+    }
+  }
+  return timeBase;
+};
+
+template <class Response> template <class CompactHitContainer>
+CompactHitContainer
+OMKeyMap_HitFacility<Response>::GetCompactHits(const double timeBase) const {
+  //collect in map order, and let the container establish its order at once, which sorted vectors need to be efficient
+  CompactHitSeries hits;
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (o_rvec.second.empty())
+      continue;
+    const CompactHash hash = *(hash_iter++);
+    BOOST_FOREACH(const Response& r, o_rvec.second) {
+      hits.push_back(CompactHit(hash, GetInferredTime(r), timeBase));
+    }
+  }
+  return CompactHitContainer(hits.begin(), hits.end());
+};
+
 template <class Response> template<class HitContainer>
 typename OMKeyMap_HitFacility<Response>::I3ResponseSeriesMap
 OMKeyMap_HitFacility<Response>::MapFromHits (const HitContainer &hits) const {
@@ -325,15 +449,11 @@ OMKeyMap_HitFacility<Response>::MapFromHits (const HitContainer &hits) const {
   if (!hitObjects_)
     log_fatal("hits were not correctly extracted");
   
-  I3ResponseSeriesMap responseMap;
-
-  const HitSetRO ro_hits(hits.begin(), hits.end());
-  for (HitSetRO::const_iterator hit_iter=ro_hits.begin(); hit_iter!=ro_hits.end(); ++hit_iter) {
-    const ResponseHitObject& resp = hit_iter->GetAssociatedHitObject<Response>();
-    responseMap[resp.GetOMKey()].push_back(resp.GetResponseObj());
-  }
-  
-  return responseMap;
+  HitHandleSeries handles;
+  handles.reserve(hits.size());
+  BOOST_FOREACH(const Hit& h, hits)
+    handles.push_back(GetHandle(h));
+  return MapFromHandles(handles);
 };
 
 template <class Response> template<class AbsHitContainer>
@@ -374,53 +494,159 @@ OMKeyMap_HitFacility<Response>::MapFromAbsHits (const AbsHitContainer &abshits)
 };
 
 
+template <class Response>
+typename OMKeyMap_HitFacility<Response>::I3ResponseSeriesMap
+OMKeyMap_HitFacility<Response>::MapFromHitBatch (const HitBatch &batch) const {
+  if (!batch.empty() && !batch.HasOrigin())
+    log_fatal("the HitBatch holds no origins; extract it with GetHitBatch");
+  
+  //the origins in map order, so that the map is walked once
+  std::vector<uint32_t> origins(batch.GetOrigins());
+  std::sort(origins.begin(), origins.end());
+  
+  I3ResponseSeriesMap responseMap;
+  std::vector<uint32_t>::const_iterator origin_iter = origins.begin();
+  size_t offset = 0;
+  typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
+  BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (origin_iter==origins.end())
+      break;
+    const size_t end = offset+o_rvec.second.size();
+    if (*origin_iter<end) {
+      ResponseSeries& responses = responseMap[o_rvec.first];
+      for (; origin_iter!=origins.end() && *origin_iter<end; ++origin_iter)
+        responses.push_back(o_rvec.second[*origin_iter-offset]);
+    }
+    offset = end;
+  }
+  if (origin_iter!=origins.end())
+    log_fatal("the HitBatch was not extracted from this map");
+  
+  return responseMap;
+};
+
 template <class Response>
 const HitObject<Response>&
 OMKeyMap_HitFacility<Response>::GetHitObject(const Hit &h) const {
   return (h.GetAssociatedHitObject<Response>());
 }
 
-template <class Response> template <class HitContainer>
-OMKeyMap_HitFacility<Response>::predicate::predicate
-  (const OMKeyMap_HitFacility* outer,
-   const HitContainer &hits) :
-  outer_(outer),
-  hits_(hits.begin(),hits.end()),
-  it_(hits_.begin()),
-  it_end_(hits_.end())
-{};
+template <class Response> template <class HitHandleContainer>
+HitHandleContainer
+OMKeyMap_HitFacility<Response>::GetHitHandles() const {
+  //collect in map order, which is the order of the handles
+  HitHandleSeries handles;
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (o_rvec.second.empty())
+      continue;
+    const CompactHash hash = *(hash_iter++);
+    for (uint32_t i=0; i<o_rvec.second.size(); i++)
+      handles.push_back(HitHandle(hash, i));
+  }
+  return HitHandleContainer(handles.begin(), handles.end());
+};
 
 template <class Response>
-bool OMKeyMap_HitFacility<Response>::predicate::operator() 
-  (const OMKey& o, size_t, const Response& r)
-{
-  //DANGER potential memory leak;
-  //function is using stepping iterators it_ and it_end_ initiatized at construction time
-  //however in the function call the memory range of the between iterators seem to be different
-  //than what they have been initialized as: a.k.a. it==hits_.begin() & it==hits_.end() is not true
-  // at first call
-  if (it_==it_end_)
-    return false;
+const typename OMKeyMap_HitFacility<Response>::OMKey_RespVec&
+OMKeyMap_HitFacility<Response>::GetMapEntry(const HitHandle &h) const {
+  if (domTable_.empty()) { //only created on demand
+    domTable_.assign(hasher_->HashSize(), NULL);
+    const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+    std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+    BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+      if (!o_rvec.second.empty())
+        domTable_[*(hash_iter++)] = &o_rvec;
+    }
+  }
   
-  const CompactHash ohash = outer_->hasher_->HashFromOMKey(o);
-  const double time = GetInferredTime(r);
+  if (h.GetDOMIndex()>=domTable_.size()
+    || !domTable_[h.GetDOMIndex()]
+    || h.GetResponseIndex()>=domTable_[h.GetDOMIndex()]->second.size())
+    log_fatal_stream(h<<" does not refer to an object in map '"<<key_<<"'");
+  return *domTable_[h.GetDOMIndex()];
+};
+
+template <class Response>
+HitHandle
+OMKeyMap_HitFacility<Response>::GetHandle(const Hit &h) const {
+  const OMKey_RespVec& o_rvec = GetMapEntry(HitHandle(h.GetDOMIndex(), 0));
+  //the HitObject refers into the map; the position of the response object within its series is the index
+  const Response* resp = &(h.GetAssociatedHitObject<Response>().GetResponseObj());
+  const Response* first = &(o_rvec.second[0]);
+  if (resp<first || resp>=first+o_rvec.second.size())
+    log_fatal_stream(h<<" was not extracted from map '"<<key_<<"'");
+  return HitHandle(h.GetDOMIndex(), resp-first);
+};
+
+template <class Response>
+const Response&
+OMKeyMap_HitFacility<Response>::GetResponse(const HitHandle &h) const
+  {return GetMapEntry(h).second[h.GetResponseIndex()];};
+
+template <class Response>
+HitObject<Response>
+OMKeyMap_HitFacility<Response>::GetHitObject(const HitHandle &h) const {
+  const OMKey_RespVec& o_rvec = GetMapEntry(h);
+  return HitObject<Response>(o_rvec.first, o_rvec.second[h.GetResponseIndex()]);
+};
+
+template <class Response> template<class HitHandleContainer>
+typename OMKeyMap_HitFacility<Response>::I3ResponseSeriesMap
+OMKeyMap_HitFacility<Response>::MapFromHandles (const HitHandleContainer &handles) const {
+  //bring the handles into map order, unless they are already
+  HitHandleSeries ordered(handles.begin(), handles.end());
+  if (!std::is_sorted(ordered.begin(), ordered.end()))
+    std::sort(ordered.begin(), ordered.end());
+  ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
   
-  while (it_!=it_end_) {
-    if (it_->GetDOMIndex() > ohash) {
-      return false;
-    }
-    if (it_->GetDOMIndex() == ohash) {
-      if (it_->GetTime() == time) {
-        assert(it_->GetAssociatedHitObject<Response>().GetResponseObj()==r); //make sure these object are the same
-        return true;
-      }
-      else if (it_->GetTime() > time) {
-        return false;
-      }
+  I3ResponseSeriesMap responseMap;
+  const OMKey_RespVec* entry = NULL;
+  ResponseSeries* responses = NULL;
+  BOOST_FOREACH(const HitHandle& h, ordered) {
+    const OMKey_RespVec& o_rvec = GetMapEntry(h);
+    if (&o_rvec!=entry) { //entered the next DOM
+      entry = &o_rvec;
+      responses = &responseMap[o_rvec.first];
     }
-    it_++;
+    responses->push_back(o_rvec.second[h.GetResponseIndex()]);
   }
-  return false;
+  return responseMap;
+};
+
+template <class Response> template <class HitHandleContainer>
+OMKeyMap_HitFacility<Response>::predicate_handle::predicate_handle
+  (const OMKeyMap_HitFacility* outer,
+   const HitHandleContainer &handles) :
+  outer_(outer),
+  handles_(handles.begin(), handles.end()),
+  pos_(0),
+  omkey_(),
+  hash_(0),
+  started_(false)
+{
+  if (!std::is_sorted(handles_.begin(), handles_.end()))
+    std::sort(handles_.begin(), handles_.end());
+};
+
+template <class Response>
+bool OMKeyMap_HitFacility<Response>::predicate_handle::operator() 
+  (const OMKey& o, size_t index, const Response&)
+{
+  if (!started_ || o!=omkey_) { //entered the series of the next DOM: seek to its first handle
+    started_ = true;
+    omkey_ = o;
+    hash_ = outer_->hasher_->HashFromOMKey(o);
+    pos_ = std::lower_bound(handles_.begin(), handles_.end(), HitHandle(hash_, 0))-handles_.begin();
+  }
+  
+  //the objects of a series are called in order of their index, so is the position stepped
+  while (pos_<handles_.size()
+    && handles_[pos_].GetDOMIndex()==hash_
+    && handles_[pos_].GetResponseIndex()<index)
+    ++pos_;
+  return (pos_<handles_.size() && handles_[pos_]==HitHandle(hash_, index));
 };
 
 
@@ -430,36 +656,31 @@ OMKeyMap_HitFacility<Response>::predicate_abs::predicate_abs
    const AbsHitContainer &hits) :
   outer_(outer),
   hits_(hits.begin(),hits.end()),
-  it_(hits_.begin()),
-  it_end_(hits_.end())
-{};
+  pos_(0)
+{
+  std::sort(hits_.begin(), hits_.end(), AbsHit::RetrievalOrdered());
+};
 
 template <class Response>
 bool OMKeyMap_HitFacility<Response>::predicate_abs::operator() 
   (const OMKey& o, size_t, const Response& r)
 {
-  //DANGER potential memory leak;
-  //function is using stepping iterators it_ and it_end_ initiatized at construction time
-  //however in the function call the memory range of the between iterators seem to be different
-  //than what they have been initialized as: a.k.a. it==hits_.begin() & it==hits_.end() is not true
-  // at first call
-  
-  if (it_==it_end_)
+  if (pos_==hits_.size())
     return false;
   
   const CompactHash ohash = outer_->hasher_->HashFromOMKey(o);
   const double time = GetInferredTime(r);
-  while (it_!=it_end_) {
-    if (it_->GetDOMIndex() > ohash) {
+  while (pos_<hits_.size()) {
+    if (hits_[pos_].GetDOMIndex() > ohash) {
       return false;
     }
-    if (it_->GetDOMIndex() == ohash) {
-      if (it_->GetTime() == time) {
+    if (hits_[pos_].GetDOMIndex() == ohash) {
+      if (hits_[pos_].GetTime() == time) {
         return true;}
-      else if (it_->GetTime() > time) {
+      else if (hits_[pos_].GetTime() > time) {
         return false;}
     }
-    it_++;
+    pos_++;
   }
   return false;
 };
@@ -475,7 +696,14 @@ CompactOMKeyHashServiceConstPtr OMKeyMap_HitFacility<Response>::GetHasher() cons
 template<class HitContainer>
 I3RecoPulseSeriesMapMask
 I3RecoPulseSeriesMap_HitFacility::MaskFromHits (const HitContainer &hits) const {
-  return I3RecoPulseSeriesMapMask(*frame_, key_, predicate(this, hits));
+  if (!hitObjects_)
+    log_fatal("hits were not correctly extracted");
+  
+  HitHandleSeries handles;
+  handles.reserve(hits.size());
+  BOOST_FOREACH(const Hit& h, hits)
+    handles.push_back(GetHandle(h));
+  return MaskFromHandles(handles);
 };
 
 template<class AbsHitContainer>
@@ -484,6 +712,12 @@ I3RecoPulseSeriesMap_HitFacility::MaskFromAbsHits (const AbsHitContainer &hits)
   return I3RecoPulseSeriesMapMask(*frame_, key_, predicate_abs(this, hits));
 };
 
+template<class HitHandleContainer>
+I3RecoPulseSeriesMapMask
+I3RecoPulseSeriesMap_HitFacility::MaskFromHandles (const HitHandleContainer &handles) const {
+  return I3RecoPulseSeriesMapMask(*frame_, key_, predicate_handle(this, handles));
+};
+
 
 template <class HitContainer>
 HitContainer
@@ -558,28 +792,19 @@ I3RecoPulseSeriesMap_HitFacility::GetAbsHits (const std::string &key) const {
   //just reextract the hitobjects
   ResponseHitObjectList hitObjects_derived = HitSorting::OMKeyMap_To_HitObjects<I3RecoPulse, ResponseHitObjectList >(*derived_mask->Apply(*frame_));//as an alternative choose a priporityque
 
-  //make the hits by finding the correct hitobject
-//   AbsHitContainer hits;
-//   
-//   ResponseHitObjectList::const_iterator iter=hitObjects_->begin();
-//   BOOST_FOREACH(const I3RecoPulse_HitObject &ho, hitObjects_derived) {
-//     while (iter != hitObjects_->end()) {
-//       if (iter->GetOMKey() == ho.GetOMKey() && iter->GetResponseObj() == ho.GetResponseObj()) {
-//         hits.insert(hits.end(), AbsHit(hasher_->HashFromOMKey(iter->GetOMKey()), iter->GetTime()));
-//         break;
-//       }
-//       iter++;
-//     }
-//   }
-  
-  AbsHitContainer hits;
-  typedef std::pair<OMKey, std::vector<I3RecoPulse> > OMKey_RespVec;
+  AbsHitSeries hits;
+  const std::vector<CompactHash> hashes = hasher_->HashFromOMKeysOfNonEmpty(map_->begin(), map_->end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
+  typedef I3ResponseSeriesMap::value_type OMKey_RespVec;
   BOOST_FOREACH(const OMKey_RespVec& o_rvec, *map_) {
+    if (o_rvec.second.empty())
+      continue;
+    const CompactHash hash = *(hash_iter++);
     BOOST_FOREACH(const I3RecoPulse& r, o_rvec.second) {
-      hits.insert(hits.end(), AbsHit(hasher_->HashFromOMKey(o_rvec.first), GetInferredTime(r)));
+      hits.push_back(AbsHit(hash, GetInferredTime(r)));
     }
   }
-  return hits;
+  return AbsHitContainer(hits.begin(), hits.end());
 };
 
 
@@ -107,12 +107,10 @@ protected:
   struct predicate {
     ///keep a pointer to the outer facility
     const OMKeyMap_HitFacility_FirstHit* outer_;
-    ///hold the hits which need to be backconverted
-    const HitSetRO hits_;
-    ///stepping iterator
-    HitSetRO::const_iterator it_;
-    ///marking the static end for the stepping operator
-    const HitSetRO::const_iterator it_end_;
+    ///hold the hits which need to be backconverted, sorted into retrieval order
+    std::vector<Hit> hits_;
+    ///stepping position in hits_; an index rather than an iterator, so that the object can be copied
+    size_t pos_;
     
     ///constructor
     template <class HitContainer>
@@ -126,12 +124,10 @@ protected:
   struct predicate_abs {
     ///keep a pointer to the outer facility
     const OMKeyMap_HitFacility_FirstHit* outer_;
-    ///hold the hits which need to be backconverted
-    const AbsHitSetRO hits_;
-    ///stepping iterator
-    AbsHitSetRO::const_iterator it_;
-    ///marking the static end for the stepping operator
-    const AbsHitSetRO::const_iterator it_end_;
+    ///hold the hits which need to be backconverted, sorted into retrieval order
+    std::vector<AbsHit> hits_;
+    ///stepping position in hits_; an index rather than an iterator, so that the object can be copied
+    size_t pos_;
     
     ///constructor
     template <class HitContainer>
@@ -319,39 +315,35 @@ OMKeyMap_HitFacility_FirstHit<Response>::predicate::predicate
    const HitContainer &hits) :
   outer_(outer),
   hits_(hits.begin(),hits.end()),
-  it_(hits_.begin()),
-  it_end_(hits_.end())
-{};
+  pos_(0)
+{
+  std::sort(hits_.begin(), hits_.end(), Hit::RetrievalOrdered());
+};
 
 template <class Response>
 bool OMKeyMap_HitFacility_FirstHit<Response>::predicate::operator() 
   (const OMKey& o, size_t, const Response& r)
 {
-  //DANGER potential memory leak;
-  //function is using stepping iterators it_ and it_end_ initiatized at construction time
-  //however in the function call the memory range of the between iterators seem to be different
-  //than what they have been initialized as: a.k.a. it==hits_.begin() & it==hits_.end() is not true
-  // at first call
-  if (it_==it_end_)
+  if (pos_==hits_.size())
     return false;
   
   const CompactHash ohash = outer_->hasher_->HashFromOMKey(o);
   const double time = GetInferredTime(r);
   
-  while (it_!=it_end_) {
-    if (it_->GetDOMIndex() > ohash) {
+  while (pos_<hits_.size()) {
+    if (hits_[pos_].GetDOMIndex() > ohash) {
       return false;
     }
-    if (it_->GetDOMIndex() == ohash) {
-      if (it_->GetTime() == time) {
-        assert(it_->GetAssociatedHitObject<Response>().GetResponseObj()==r); //make sure these object are the same
+    if (hits_[pos_].GetDOMIndex() == ohash) {
+      if (hits_[pos_].GetTime() == time) {
+        assert(hits_[pos_].GetAssociatedHitObject<Response>().GetResponseObj()==r); //make sure these object are the same
         return true;
       }
-      else if (it_->GetTime() > time) {
+      else if (hits_[pos_].GetTime() > time) {
         return false;
       }
     }
-    it_++;
+    pos_++;
   }
   return false;
 };
@@ -363,36 +355,31 @@ OMKeyMap_HitFacility_FirstHit<Response>::predicate_abs::predicate_abs
    const AbsHitContainer &hits) :
   outer_(outer),
   hits_(hits.begin(),hits.end()),
-  it_(hits_.begin()),
-  it_end_(hits_.end())
-{};
+  pos_(0)
+{
+  std::sort(hits_.begin(), hits_.end(), AbsHit::RetrievalOrdered());
+};
 
 template <class Response>
 bool OMKeyMap_HitFacility_FirstHit<Response>::predicate_abs::operator() 
   (const OMKey& o, size_t, const Response& r)
 {
-  //DANGER potential memory leak;
-  //function is using stepping iterators it_ and it_end_ initiatized at construction time
-  //however in the function call the memory range of the between iterators seem to be different
-  //than what they have been initialized as: a.k.a. it==hits_.begin() & it==hits_.end() is not true
-  // at first call
-  
-  if (it_==it_end_)
+  if (pos_==hits_.size())
     return false;
   
   const CompactHash ohash = outer_->hasher_->HashFromOMKey(o);
   const double time = GetInferredTime(r);
-  while (it_!=it_end_) {
-    if (it_->GetDOMIndex() > ohash) {
+  while (pos_<hits_.size()) {
+    if (hits_[pos_].GetDOMIndex() > ohash) {
       return false;
     }
-    if (it_->GetDOMIndex() == ohash) {
-      if (it_->GetTime() == time) {
+    if (hits_[pos_].GetDOMIndex() == ohash) {
+      if (hits_[pos_].GetTime() == time) {
         return true;}
-      else if (it_->GetTime() > time) {
+      else if (hits_[pos_].GetTime() > time) {
         return false;}
     }
-    it_++;
+    pos_++;
   }
   return false;
 };
@@ -18,6 +18,7 @@ static const unsigned hitsorting_version_ = 0;
 
 #include <numeric>
 #include <queue>
+#include <algorithm>
 
 #include "OMKeyHash.h"
 
@@ -143,9 +144,13 @@ HitSorting::HitObjects_To_OMKeyMap (const HitObjectContainer &hitObjs)
 {
   I3Map<OMKey, std::vector<Response> > responseMap;
   
-  typedef std::set<HitObject<Response>, typename HitObject<Response>::RetrievalOrdered> HitObjectsRO;
-  HitObjectsRO ro_ho(hitObjs.begin(), hitObjs.end());
-  for (typename HitObjectsRO::const_iterator ho_iter=ro_ho.begin(); ho_iter!=ro_ho.end(); ++ho_iter) {
+  //sort the (trivially copyable) HitObjects in place into retrieval order; equivalent ones are taken once, like by a set
+  typedef typename HitObject<Response>::RetrievalOrdered RetrievalOrdered;
+  std::vector<HitObject<Response> > ro_ho(hitObjs.begin(), hitObjs.end());
+  std::stable_sort(ro_ho.begin(), ro_ho.end(), RetrievalOrdered());
+  for (typename std::vector<HitObject<Response> >::const_iterator ho_iter=ro_ho.begin(); ho_iter!=ro_ho.end(); ++ho_iter) {
+    if (ho_iter!=ro_ho.begin() && !RetrievalOrdered()(*(ho_iter-1), *ho_iter))
+      continue;
     responseMap[ho_iter->GetOMKey()].push_back(ho_iter->GetResponseObj());
   }
   
@@ -199,9 +204,12 @@ HitSorting::Hits_To_OMKeyMap (
 {
   I3Map<OMKey, std::vector<Response> > responseMap;
   
-  typedef std::set<Hit, Hit::RetrievalOrdered> RO_Hits;
-  RO_Hits ro_hits(hits.begin(), hits.end());
-  for (RO_Hits::const_iterator h_iter=ro_hits.begin(); h_iter!=ro_hits.end(); ++h_iter) {
+  //sort the (trivially copyable) Hits in place into retrieval order; equivalent ones are taken once, like by a set
+  HitSeries ro_hits(hits.begin(), hits.end());
+  std::stable_sort(ro_hits.begin(), ro_hits.end(), Hit::RetrievalOrdered());
+  for (HitSeries::const_iterator h_iter=ro_hits.begin(); h_iter!=ro_hits.end(); ++h_iter) {
+    if (h_iter!=ro_hits.begin() && !Hit::RetrievalOrdered()(*(h_iter-1), *h_iter))
+      continue;
     const HitObject<Response>& ho = h_iter->GetAssociatedHitObject<Response>();
     responseMap[ho.GetOMKey()].push_back(ho.GetResponseObj());
   }
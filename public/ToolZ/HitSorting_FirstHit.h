@@ -93,12 +93,15 @@ HitSorting::OMKeyMap_FirstHits_To_AbsHits(
   
   typedef I3Map<OMKey, std::vector<I3RecoPulse> > I3ResponseSeriesMap;
   typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
+  const std::vector<CompactHash> hashes = hasher->HashFromOMKeysOfNonEmpty(map.begin(), map.end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
   BOOST_FOREACH(const OMKey_RespVec& o_rvec, map) {
     if (o_rvec.second.empty())
       continue;
-    
+    const CompactHash hash = *(hash_iter++);
+
     const Response& r = o_rvec.second.front();
-    hits.insert(AbsHit(hasher->HashFromOMKey(o_rvec.first), GetInferredTime(r)));
+    hits.insert(AbsHit(hash, GetInferredTime(r)));
   }
   return hits;
 };
@@ -112,12 +115,15 @@ HitSorting::OMKeyMap_FirstHits_To_AbsDAQHits(
   AbsDAQHitContainer hits;
   typedef I3Map<OMKey, std::vector<I3RecoPulse> > I3ResponseSeriesMap;
   typedef typename I3ResponseSeriesMap::value_type OMKey_RespVec;
+  const std::vector<CompactHash> hashes = hasher->HashFromOMKeysOfNonEmpty(map.begin(), map.end());
+  std::vector<CompactHash>::const_iterator hash_iter = hashes.begin();
   BOOST_FOREACH(const OMKey_RespVec& o_rvec, map) {
     if (o_rvec.second.empty())
       continue;
-    
+    const CompactHash hash = *(hash_iter++);
+
     const Response& r = o_rvec.second.front();
-    hits.insert(AbsDAQHit(hasher->HashFromOMKey(o_rvec.first), GetInferredDAQTicks(r)));
+    hits.insert(AbsDAQHit(hash, GetInferredDAQTicks(r)));
   }
   return hits;
 };
@@ -18,8 +18,17 @@ static const unsigned hitclasses_version_ = 0;
 
 #include <numeric>
 #include <queue>
+#include <cmath>
+#include <stdint.h>
 
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/type_traits/has_trivial_assign.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+
+#include "ToolZ/__SERIALIZATION.h"
 #include "ToolZ/SetHelpers.h"
+#include "ToolZ/FlatSet.h"
 #include "ToolZ/OMKeyHash.h"
 
 
@@ -34,14 +43,15 @@ static const unsigned hitclasses_version_ = 0;
 
 /**
   *  A abstract description of a hit
-  * This type needs to be as small as possible so that copies are cheap.
+  * This type needs to be as small as possible so that copies are cheap;
+  * it is a trivially copyable value type, so that it can be sorted in place and copied as memory
   */
 class AbsHit{
 private:
   ///The index of the DOM on which this hit occurred, within the set of hit DOMs of the current event
-  const CompactHash domIndex_;
+  CompactHash domIndex_;
   ///The actual time of the hit
-  const double time_;
+  double time_;
   
 public:
   /** Constructor
@@ -75,6 +85,11 @@ public:
   };
 };
 
+BOOST_STATIC_ASSERT_MSG(sizeof(AbsHit)==16, "AbsHit is expected to be packed into 16 bytes");
+BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<AbsHit>::value
+  && boost::has_trivial_assign<AbsHit>::value
+  && boost::has_trivial_destructor<AbsHit>::value, "AbsHit is expected to be trivially copyable");
+
 ///dump object to (string)stream
 std::ostream& operator<< (std::ostream& oss, const AbsHit& h);
 
@@ -87,11 +102,15 @@ typedef std::deque<AbsHit> AbsHitDeque;
 
 typedef std::set<AbsHit, AbsHit::RetrievalOrdered> AbsHitSetRO;
 
+//the same as sorted vectors
+typedef FlatSet<AbsHit> AbsHitFlatSet;
+typedef FlatSet<AbsHit, AbsHit::RetrievalOrdered> AbsHitFlatSetRO;
+
 ///wrapper around HitSets to establish time order in the set of SubEvents
 struct HitSetTimeOrder {
-  /// implement the order principle
-  template <class Hitclass>
-  bool operator()(const std::set<Hitclass> &lhs, const std::set<Hitclass> &rhs) const;
+  /// implement the order principle; for std::set and FlatSet
+  template <class HitSetclass>
+  bool operator()(const HitSetclass &lhs, const HitSetclass &rhs) const;
 };
 
 //a time-ordered sequence of time-ordered HitSets
@@ -111,9 +130,9 @@ typedef std::list<AbsHitSet> AbsHitSetList;
 class AbsDAQHit{
 private:
   ///The index of the DOM on which this hit occurred, within the set of hit DOMs of the current event
-  const CompactHash domIndex_;
+  CompactHash domIndex_;
   ///The actual time of the hit
-  const int64_t daqTicks_;
+  int64_t daqTicks_;
 
 public:
   /** Constructor
@@ -145,6 +164,11 @@ public:
   };
 };
 
+BOOST_STATIC_ASSERT_MSG(sizeof(AbsDAQHit)==16, "AbsDAQHit is expected to be packed into 16 bytes");
+BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<AbsDAQHit>::value
+  && boost::has_trivial_assign<AbsDAQHit>::value
+  && boost::has_trivial_destructor<AbsDAQHit>::value, "AbsDAQHit is expected to be trivially copyable");
+
 ///dump object to (string)stream
 std::ostream& operator<< (std::ostream& oss, const AbsDAQHit& h);
 
@@ -157,6 +181,10 @@ typedef std::deque<AbsDAQHit> AbsDAQHitDeque;
 
 typedef std::set<AbsDAQHit, AbsDAQHit::RetrievalOrdered> AbsDAQHitSetRO;
 
+//the same as sorted vectors
+typedef FlatSet<AbsDAQHit> AbsDAQHitFlatSet;
+typedef FlatSet<AbsDAQHit, AbsDAQHit::RetrievalOrdered> AbsDAQHitFlatSetRO;
+
 //a time-ordered sequence of time-ordered HitSets
 typedef std::set<AbsDAQHitSet, HitSetTimeOrder> AbsDAQHitSetSequence;
 
@@ -165,6 +193,96 @@ typedef std::deque<AbsDAQHitSet> AbsDAQHitSetDeque;
 typedef std::list<AbsDAQHitSet> AbsDAQHitSetList;
 
 
+//============ CLASS CompactHit =========================
+
+/**
+  * A compact description of a hit for events with very many hits:
+  * the index of the DOM and the time as a float relative to the time base of the event, in 8 bytes instead of 16.
+  * Within the lossless range the float resolves the DAQ tick of 0.1ns,
+  * so that AbsDAQHits are converted back exactly and AbsHits to the precision of a DAQ tick;
+  * the converting constructors log_fatal outside of it.
+  * Choose the time base close to the earliest hit, like OMKeyMap_HitFacility::GetTimeBase()
+  */
+class CompactHit{
+private:
+  ///The index of the DOM on which this hit occurred, within the set of hit DOMs of the current event
+  CompactHash domIndex_;
+  ///The time of the hit relative to the time base
+  float relTime_;
+
+public:
+  ///The largest magnitude of a relative time that is resolved to 0.1ns: 2^20 ns
+  static const double losslessRange;
+  
+  /** Constructor
+    * @param domIndex The index of the DOM where the hit occurred
+    * @param relTime The time of the hit relative to the time base
+    */
+  CompactHit(const CompactHash domIndex, const float relTime);
+  /** Constructor: convert an absolute time; log_fatal if it lies outside of the lossless range around the time base
+    * @param domIndex The index of the DOM where the hit occurred
+    * @param time The time of the hit
+    * @param timeBase The time base
+    */
+  CompactHit(const CompactHash domIndex, const double time, const double timeBase);
+  ///Constructor: convert an AbsHit; log_fatal if it lies outside of the lossless range around the time base
+  CompactHit(const AbsHit& h, const double timeBase);
+  ///Constructor: convert an AbsDAQHit; log_fatal if it lies outside of the lossless range around the time base
+  CompactHit(const AbsDAQHit& h, const double timeBase);
+
+public:
+  //access properties: Getters
+  ///simply return the DOMindex of this hit
+  const CompactHash& GetDOMIndex() const;
+  ///simply return the time of this hit relative to the time base
+  const float& GetRelativeTime() const;
+  ///the absolute time of this hit
+  double GetTime(const double timeBase) const;
+  ///the absolute time of this hit in DAQticks, rounded to the nearest tick
+  int64_t GetDAQTicks(const double timeBase) const;
+  
+  //conversions
+  ///convert to an AbsHit
+  AbsHit ToAbsHit(const double timeBase) const;
+  ///convert to an AbsDAQHit
+  AbsDAQHit ToAbsDAQHit(const double timeBase) const;
+  ///is a time relative to the time base within the lossless range
+  static bool InLosslessRange(const double relTime);
+  
+  //operators
+  ///Comparison Operator for CompactHits;
+  bool operator==(const CompactHit& rhs) const;
+  ///for sorting CompactHits we're mostly interested in their time, and only use their indices as tie-breakers
+  bool operator<(const CompactHit& rhs) const;
+  
+  ///struct that provides order principle for retrieval sorting
+  struct RetrievalOrdered {
+    ///internal call operator
+    bool operator() (const CompactHit& lhs, const CompactHit& rhs) const;
+  };
+};
+
+BOOST_STATIC_ASSERT_MSG(sizeof(CompactHit)==8, "CompactHit is expected to be packed into 8 bytes");
+BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<CompactHit>::value
+  && boost::has_trivial_assign<CompactHit>::value
+  && boost::has_trivial_destructor<CompactHit>::value, "CompactHit is expected to be trivially copyable");
+
+///dump object to (string)stream
+std::ostream& operator<< (std::ostream& oss, const CompactHit& h);
+
+//shorthands
+typedef std::set<CompactHit> CompactHitSet;
+typedef std::vector<CompactHit> CompactHitSeries;
+typedef std::list<CompactHit> CompactHitList;
+typedef std::deque<CompactHit> CompactHitDeque;
+
+typedef std::set<CompactHit, CompactHit::RetrievalOrdered> CompactHitSetRO;
+
+//the same as sorted vectors
+typedef FlatSet<CompactHit> CompactHitFlatSet;
+typedef FlatSet<CompactHit, CompactHit::RetrievalOrdered> CompactHitFlatSetRO;
+
+
 //=========== Helpers to get arbitrary time info from objects =============
 
 ///Get a sensible time-information of an object: this might be exact time, start-time,
@@ -180,6 +298,19 @@ template<> double GetInferredTime(const I3DOMLaunch &r);
 template<> double GetInferredTime(const I3MCHit &r);
 template<> double GetInferredTime(const I3MCPulse &r);
 
+///Get a sensible charge-information of an object: the charge or the number of photo-electrons it represents;
+/// log_fatal for objects which carry no charge, like I3DOMLaunch
+/// @param r the respones object interesed in
+template <class Response>
+double
+GetInferredCharge(const Response &r);
+
+//some specializations for explicitly supported types
+template<> double GetInferredCharge(const I3RecoPulse &r);
+template<> double GetInferredCharge(const I3DOMLaunch &r);
+template<> double GetInferredCharge(const I3MCHit &r);
+template<> double GetInferredCharge(const I3MCPulse &r);
+
 ///Get a sensible time-information of an object: this might be exact time, start-time,
 /// or whatever makes sense to order objects in time; here DAQtick precision == 1/10ns
 /// @param r the respones object interesed in
@@ -196,15 +327,15 @@ time_sort (const Response &i, const Response &j);
   
 /** @brief the representation of a Hit as a pair of a OMKey and a (detector-)response-object like a pulse/lunch/hit/whatever
   * this class is templated and needs explicitly the specialization of the GetTime()-routine
-  * NOTE this class holds references, so objects it is constructed from must not move in memory
+  * NOTE this class points to the objects it is constructed from, so these must not move in memory
   */
 template <class Response>
 class HitObject {
 protected: //properties
-  /// holds the OMKey
-  const OMKey& omkey_;
-  /// holds the pulse/lunch/hit/whatever
-  const Response& response_obj_;
+  /// points to the OMKey
+  const OMKey* omkey_;
+  /// points to the pulse/lunch/hit/whatever
+  const Response* response_obj_;
   
 public:
   /// constructor
@@ -239,6 +370,11 @@ typedef HitObject<I3DOMLaunch> I3DOMLaunch_HitObject;
 typedef HitObject<I3MCHit> I3MCHit_HitObject;
 typedef HitObject<I3MCPulse> I3MCPulse_HitObject;
 
+BOOST_STATIC_ASSERT_MSG(sizeof(I3RecoPulse_HitObject)==2*sizeof(void*), "HitObject is expected to hold two pointers");
+BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<I3RecoPulse_HitObject>::value
+  && boost::has_trivial_assign<I3RecoPulse_HitObject>::value
+  && boost::has_trivial_destructor<I3RecoPulse_HitObject>::value, "HitObject is expected to be trivially copyable");
+
 ///dump the object to a (string)stream
 template <class Response>
 std::ostream& operator<<(std::ostream& oss, const HitObject<Response>& h);
@@ -247,14 +383,16 @@ std::ostream& operator<<(std::ostream& oss, const HitObject<Response>& h);
   * Evil expansion of the HitObject class, holding its own copies of objects.
   * most engeniously can be downcasted to HitObject, but must *NEVER* be downcasted and copied
   * from temporary objects, e.g. the case when inserting elements into std::containers,
-  * as you will loose coherence between refernces held by Base-object and copies of 
-  * those in the temporary and possibly destroyed object on the stack
+  * as you will loose coherence between the pointers held by Base-object and copies of 
+  * those in the temporary and possibly destroyed object on the stack.
+  * NOTE as the base object points into this object, it is not trivially copyable;
+  * copy and assignment keep the base object pointing to the own copies
   */
 template <class Response>
 class HitObjectOriginal : public HitObject<Response> {
 private: //properties
-  const OMKey omkey_; //NOTE shadows the variable of the baseclass
-  const Response response_obj_; //NOTE shadows the variable of the baseclass
+  OMKey omkey_; //NOTE shadows the variable of the baseclass
+  Response response_obj_; //NOTE shadows the variable of the baseclass
 public:
   ///constructor
   HitObjectOriginal(
@@ -272,6 +410,15 @@ public:
     omkey_(hoo.omkey_),
     response_obj_(hoo.response_obj_)
   {};
+  
+  /// assignment (the implicit one is not enough): copy the objects, but keep pointing to the own ones
+  HitObjectOriginal& operator=(
+    const HitObjectOriginal& hoo)
+  {
+    omkey_ = hoo.omkey_;
+    response_obj_ = hoo.response_obj_;
+    return *this;
+  };
 };
 
 //shorthands
@@ -280,6 +427,60 @@ typedef HitObjectOriginal<I3DOMLaunch> I3DOMLaunch_HitObjectOriginal;
 typedef HitObjectOriginal<I3MCHit> I3MCHit_HitObjectOriginal;
 typedef HitObjectOriginal<I3MCPulse> I3MCPulse_HitObjectOriginal;
 
+//============ CLASS HitHandle ===========
+
+/**
+  * A relocatable reference to a response object within a response map:
+  * the hash of the DOM and the index of the object within the response series of that DOM.
+  * As it holds no pointers, containers of handles can be copied, stored and serialized
+  * without the objects they refer to; resolve them with the OMKeyMap_HitFacility they were taken from
+  */
+class HitHandle {
+private:
+  ///The index of the DOM on which the response object was registered
+  CompactHash domIndex_;
+  ///The index of the response object within the response series of that DOM
+  uint32_t responseIndex_;
+
+public:
+  ///constructor: an empty handle
+  HitHandle();
+  /** Constructor
+    * @param domIndex The index of the DOM the response object was registered on
+    * @param responseIndex The index of the response object within the response series of that DOM
+    */
+  HitHandle(const CompactHash domIndex, const uint32_t responseIndex);
+
+  ///the index of the DOM
+  CompactHash GetDOMIndex() const;
+  ///the index of the response object within the response series of the DOM
+  uint32_t GetResponseIndex() const;
+
+  ///equal if referring to the same response object
+  bool operator== (const HitHandle& rhs) const;
+  ///unequal if referring to different response objects
+  bool operator!= (const HitHandle& rhs) const;
+  ///handles are ordered like the response objects in the map: by DOM, then by index
+  bool operator< (const HitHandle& rhs) const;
+
+#if SERIALIZATION_ENABLED
+  template<class Archive>
+  void serialize(Archive & ar, const unsigned version);
+#endif //SERIALIZATION_ENABLED
+};
+
+BOOST_STATIC_ASSERT_MSG(sizeof(HitHandle)==8, "HitHandle is expected to be packed into 8 bytes");
+BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<HitHandle>::value
+  && boost::has_trivial_assign<HitHandle>::value
+  && boost::has_trivial_destructor<HitHandle>::value, "HitHandle is expected to be trivially copyable");
+
+///Dump the object into a string-stream
+std::ostream& operator<<(std::ostream& oss, const HitHandle& h);
+
+//some more definitions for frequent use, objects
+typedef std::vector<HitHandle> HitHandleSeries;
+typedef std::set<HitHandle> HitHandleSet;
+
 //============ CLASS Hit ===========
 
 /**
@@ -311,6 +512,11 @@ public:
   };
 };
 
+BOOST_STATIC_ASSERT_MSG(sizeof(Hit)==sizeof(AbsHit)+sizeof(void*), "Hit is expected to hold an AbsHit and a pointer");
+BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<Hit>::value
+  && boost::has_trivial_assign<Hit>::value
+  && boost::has_trivial_destructor<Hit>::value, "Hit is expected to be trivially copyable");
+
 ///Dump the object into a string-stream (this is bound to python as string-cast)
 std::ostream& operator<<(std::ostream& oss, const Hit& h);  
 
@@ -323,6 +529,10 @@ typedef std::deque<Hit> HitDeque;
 
 typedef std::set<Hit, Hit::RetrievalOrdered> HitSetRO;
 
+//the same as sorted vectors
+typedef FlatSet<Hit> HitFlatSet;
+typedef FlatSet<Hit, Hit::RetrievalOrdered> HitFlatSetRO;
+
 //a time-ordered sequence of time-ordered HitSets
 typedef std::set<HitSet, HitSetTimeOrder> HitSetSequence;
 
@@ -364,15 +574,15 @@ bool AbsHit::RetrievalOrdered::operator() (const AbsHit& lhs, const AbsHit& rhs)
   return lhs.GetDOMIndex() < rhs.GetDOMIndex();
 };
 
-template <class Hitclass>
+template <class HitSetclass>
 bool HitSetTimeOrder::operator() (
-  const std::set<Hitclass> &lhs, 
-  const std::set<Hitclass> &rhs) const 
+  const HitSetclass &lhs, 
+  const HitSetclass &rhs) const 
 {
-  typename std::set<Hitclass>::const_iterator lhs_iter= lhs.begin();
-  typename std::set<Hitclass>::const_iterator rhs_iter= rhs.begin();
-  const typename std::set<Hitclass>::const_iterator lhs_end= lhs.end();
-  const typename std::set<Hitclass>::const_iterator rhs_end= rhs.end();
+  typename HitSetclass::const_iterator lhs_iter= lhs.begin();
+  typename HitSetclass::const_iterator rhs_iter= rhs.begin();
+  const typename HitSetclass::const_iterator lhs_end= lhs.end();
+  const typename HitSetclass::const_iterator rhs_end= rhs.end();
   // until any of the hits is decisive      
   while (lhs_iter!=lhs_end && rhs_iter!=rhs_end) {
     if (*lhs_iter == *rhs_iter) {
@@ -417,31 +627,83 @@ bool AbsDAQHit::RetrievalOrdered::operator() (const AbsDAQHit& lhs, const AbsDAQ
 };
 
 
+//================ CLASS CompactHit =======================
+
+inline
+CompactHit::CompactHit(const CompactHash domIndex, const float relTime) :
+  domIndex_(domIndex),
+  relTime_(relTime)
+{};
+
+inline
+const CompactHash& CompactHit::GetDOMIndex() const {return domIndex_;};
+
+inline
+const float& CompactHit::GetRelativeTime() const {return relTime_;};
+
+inline
+double CompactHit::GetTime(const double timeBase) const {return timeBase+relTime_;};
+
+inline
+int64_t CompactHit::GetDAQTicks(const double timeBase) const
+  {return (int64_t)std::floor((timeBase+relTime_)*10.+0.5);};
+
+inline
+AbsHit CompactHit::ToAbsHit(const double timeBase) const
+  {return AbsHit(domIndex_, GetTime(timeBase));};
+
+inline
+AbsDAQHit CompactHit::ToAbsDAQHit(const double timeBase) const
+  {return AbsDAQHit(domIndex_, GetDAQTicks(timeBase));};
+
+inline
+bool CompactHit::InLosslessRange(const double relTime)
+  {return std::abs(relTime)<losslessRange;};
+
+inline
+bool CompactHit::operator== (const CompactHit& rhs) const
+  {return(domIndex_==rhs.domIndex_ && relTime_==rhs.relTime_);};
+
+inline
+bool CompactHit::operator< (const CompactHit& rhs) const {
+  if (relTime_==rhs.relTime_)
+    return (domIndex_<rhs.domIndex_);
+  return (relTime_<rhs.relTime_);
+};
+
+inline
+bool CompactHit::RetrievalOrdered::operator() (const CompactHit& lhs, const CompactHit& rhs) const {
+  if (lhs.GetDOMIndex() == rhs.GetDOMIndex())
+    return lhs.GetRelativeTime() < rhs.GetRelativeTime();
+  return lhs.GetDOMIndex() < rhs.GetDOMIndex();
+};
+
+
 //================ CLASS HitObject ====================
 
 template <class Response>
 HitObject<Response>::HitObject (
   const OMKey& omkey,
   const Response& response_obj)
-: omkey_(omkey),
-  response_obj_(response_obj)
+: omkey_(&omkey),
+  response_obj_(&response_obj)
 {};
 
 template <class Response>
 double HitObject<Response>::GetTime() const
-  {return GetInferredTime(response_obj_);};
+  {return GetInferredTime(*response_obj_);};
 
 template <class Response>
 uint64_t HitObject<Response>::GetDAQTicks() const
-  {return GetInferredDAQTicks(response_obj_);}; 
+  {return GetInferredDAQTicks(*response_obj_);}; 
 
 template <class Response>
 const OMKey& HitObject<Response>::GetOMKey() const
-  {return omkey_;};
+  {return *omkey_;};
 
 template <class Response>
 const Response& HitObject<Response>::GetResponseObj() const
-  {return response_obj_;};
+  {return *response_obj_;};
 
 template <class Response>
 bool HitObject<Response>::operator<(const HitObject& rhs) const
@@ -466,6 +728,49 @@ std::ostream& operator<<(std::ostream& oss, const HitObject<Response>& h) {
 };
 
 
+//============= CLASS HitHandle ====================
+
+inline
+HitHandle::HitHandle() :
+  domIndex_(0),
+  responseIndex_(0)
+{};
+
+inline
+HitHandle::HitHandle(const CompactHash domIndex, const uint32_t responseIndex) :
+  domIndex_(domIndex),
+  responseIndex_(responseIndex)
+{};
+
+inline
+CompactHash HitHandle::GetDOMIndex() const {return domIndex_;};
+
+inline
+uint32_t HitHandle::GetResponseIndex() const {return responseIndex_;};
+
+inline
+bool HitHandle::operator== (const HitHandle& rhs) const
+  {return (domIndex_==rhs.domIndex_ && responseIndex_==rhs.responseIndex_);};
+
+inline
+bool HitHandle::operator!= (const HitHandle& rhs) const
+  {return !(*this==rhs);};
+
+inline
+bool HitHandle::operator< (const HitHandle& rhs) const {
+  if (domIndex_==rhs.domIndex_)
+    return (responseIndex_<rhs.responseIndex_);
+  return (domIndex_<rhs.domIndex_);
+};
+
+#if SERIALIZATION_ENABLED
+template <class Archive>
+void HitHandle::serialize(Archive & ar, const unsigned version) {
+  ar & SERIALIZATION_NS::make_nvp("DOMIndex", domIndex_);
+  ar & SERIALIZATION_NS::make_nvp("ResponseIndex", responseIndex_);
+};
+#endif //SERIALIZATION_ENABLED
+
 //============= CLASS Hit ====================
 
 inline
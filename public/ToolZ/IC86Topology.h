@@ -21,6 +21,8 @@ static const unsigned ic86topology_version_ = 0;
 #include "dataclasses/geometry/I3Geometry.h"
 
 #include "ToolZ/OMTopology.h"
+#include "ToolZ/OMKeyHash.h"
+#include "ToolZ/PositionService.h"
 
 ///Some topological functions useful for the IC86 detector configuration
 struct IC86Topology{
@@ -77,6 +79,83 @@ struct IC86Topology{
   /// Build a OMTopology for IC86
   static
   OMTopologyMap Build_IC86_OMKeyTopologyMap();
+  
+  //=== closed-form hashing and positions of the ideal IC86 geometry
+  
+  /// number of strings carrying IceTop tanks
+  static const unsigned int N_ICETOP_STRINGS = 81;
+  /// number of DOMs on each string, which also carries IceTop tanks (60 InIce + 4 IceTop)
+  static const unsigned int N_DOMS_ICETOP_STRING = 64;
+  /// number of DOMs on the remaining (DeepCore) strings
+  static const unsigned int N_DOMS_INICE_STRING = 60;
+  /// number of DOMs in the IC86 geometry (InIce and IceTop)
+  static const unsigned int N_DOMS = 5484;
+  
+  /// Is this OMKey part of the IC86 geometry
+  static
+  bool HoldsOMKey(const OMKey& omkey);
+  
+  /** @brief closed-form hash of this OMKey;
+   * identical to the hash a CompactOMKeyHashService on the IC86 geometry would give
+   * NOTE the OMKey must be held (see HoldsOMKey), this is not checked
+   */
+  static
+  CompactHash HashFromOMKey(const OMKey& omkey);
+  
+  /// closed-form inverse of HashFromOMKey; NOTE the hash must be smaller than N_DOMS, this is not checked
+  static
+  OMKey OMKeyFromHash(const CompactHash hash);
+  
+  /// the position of this string in the XY plane (Z=0)
+  static
+  I3Position GetStringPosition(const unsigned int str);
+  
+  /// the position of this DOM, identical to the one in Build_IC86_Geometry; NOTE the OMKey must be held
+  static
+  I3Position GetPosition(const OMKey& omkey);
+  
+  /// a process-wide hasher of all OMKeys in the IC86 geometry, built once from the closed-form hashes
+  static
+  CompactOMKeyHashServiceConstPtr GetHashService();
+  
+  /// a process-wide PositionService on the IC86 geometry, built once from the closed-form positions
+  static
+  PositionServiceConstPtr GetPositionService();
+};
+
+
+//=====================================================
+//=================== IMPLEMENTATIONS =================
+//=====================================================
+
+inline
+bool IC86Topology::HoldsOMKey(const OMKey& omkey) {
+  const int str = omkey.GetString();
+  const unsigned int om = omkey.GetOM();
+  if (omkey.GetPMT()!=0 || str<1 || om<1)
+    return false;
+  if (str<=int(N_ICETOP_STRINGS))
+    return om<=N_DOMS_ICETOP_STRING;
+  return (str<=86 && om<=N_DOMS_INICE_STRING);
+};
+
+inline
+CompactHash IC86Topology::HashFromOMKey(const OMKey& omkey) {
+  //OMKeys are ordered by string then om; strings 1-81 hold 64 DOMs each, strings 82-86 60 DOMs each
+  const unsigned int str = omkey.GetString();
+  const unsigned int om = omkey.GetOM();
+  if (str<=N_ICETOP_STRINGS)
+    return (str-1)*N_DOMS_ICETOP_STRING + (om-1);
+  return N_ICETOP_STRINGS*N_DOMS_ICETOP_STRING + (str-N_ICETOP_STRINGS-1)*N_DOMS_INICE_STRING + (om-1);
+};
+
+inline
+OMKey IC86Topology::OMKeyFromHash(const CompactHash hash) {
+  const CompactHash icetop_strings_hashes = N_ICETOP_STRINGS*N_DOMS_ICETOP_STRING;
+  if (hash<icetop_strings_hashes)
+    return OMKey(hash/N_DOMS_ICETOP_STRING+1, hash%N_DOMS_ICETOP_STRING+1);
+  const CompactHash rest = hash-icetop_strings_hashes;
+  return OMKey(N_ICETOP_STRINGS+1+rest/N_DOMS_INICE_STRING, rest%N_DOMS_INICE_STRING+1);
 };
 
 #endif //IC86TOPOLOGY_H
@@ -15,6 +15,7 @@
 #define INDEXMATRIX_H
 
 
+#include "icetray/I3Logging.h"
 #include "icetray/OMKey.h"
 #include "dataclasses/I3Map.h"
 #include "dataclasses/I3TimeWindow.h"
@@ -22,51 +23,186 @@
 #include "dataclasses/geometry/I3Geometry.h"
 //#include "ToolZ/OMKeyHash.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <boost/foreach.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/function.hpp>
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/version.hpp>
+
+///is the in-place access to the blocks of a boost::dynamic_bitset<> available; see indexmatrix::BitsetBlocks
+#ifndef INDEXMATRIX_BITSET_BLOCKS
+  #if BOOST_VERSION >= 103500 && BOOST_VERSION < 108700
+    #define INDEXMATRIX_BITSET_BLOCKS 1
+  #else
+    #define INDEXMATRIX_BITSET_BLOCKS 0
+  #endif
+#endif
+
+namespace indexmatrix {
+  /**
+   * @brief the blocks of a bitset, to be read and written in place; valid as long as the bitset is not resized.
+   * dynamic_bitset exposes its blocks only to its friend boost::to_block_range, which copies them out;
+   * this is the one place to reach past that, by a specialization of to_block_range in IndexMatrix.cxx,
+   * which relies on the internal storage of dynamic_bitset<>, and is therefore enabled by INDEXMATRIX_BITSET_BLOCKS
+   * only for the boost versions, which are known to have it.
+   * @return NULL, if the access is not available, or for an empty bitset; users fall back to the public interface then
+   */
+  template <typename Block, typename Allocator>
+  const Block* BitsetBlocks(const boost::dynamic_bitset<Block, Allocator>& bits);
+  template <typename Block, typename Allocator>
+  Block* BitsetBlocks(boost::dynamic_bitset<Block, Allocator>& bits);
+#if INDEXMATRIX_BITSET_BLOCKS
+  const boost::dynamic_bitset<>::block_type* BitsetBlocks(const boost::dynamic_bitset<>& bits);
+  boost::dynamic_bitset<>::block_type* BitsetBlocks(boost::dynamic_bitset<>& bits);
+#endif
+}; //namespace indexmatrix
 
 //serialization
 #include "ToolZ/__SERIALIZATION.h"
 static const unsigned indexmatrix_version_ = 0;
+///version of the SymmetricIndexMatrix and AsymmetricIndexMatrix templates, which archive the tag of their layout since version 1
+static const unsigned indexmatrix_layout_version_ = 1;
+///version of the serialization of boost::dynamic_bitset, which streams the blocks since version 1
+static const unsigned dynamic_bitset_version_ = 1;
 
 #if SERIALIZATION_ENABLED
   #if FUTURE
     #include <boost/dynamic_bitset/serialization.hpp> //FUTURE
     #include <boost/serialization/dynamic_bitset.hpp> //FUTURE
   #else
-//NOTE Include serialization for boost::dynamic_bitset
+//NOTE Include serialization for boost::dynamic_bitset; the blocks are streamed without a copy of the bitset:
+//in place where indexmatrix::BitsetBlocks is available, otherwise a chunk at a time through the public block-range interface
+  namespace indexmatrix {
+    ///the number of blocks, which are buffered at a time, if a bitset is streamed in chunks
+    static const size_t bitset_chunk_blocks_ = 1024;
+    
+    /**
+     * @brief a buffer of blocks, which passes each full chunk on to an archive; Flush() passes on the last one
+     * @template Archive the output archive
+     * @template Block the block type of the bitset
+     */
+    template <class Archive, typename Block>
+    class BlockChunkSaver {
+    private:
+      Archive& ar_;
+      Block chunk_[bitset_chunk_blocks_];
+      size_t fill_;
+    public:
+      ///output iterator, which appends the blocks to the chunk; see std::back_insert_iterator
+      class inserter : public std::iterator<std::output_iterator_tag, void, void, void, void> {
+        BlockChunkSaver* saver_;
+      public:
+        inserter(BlockChunkSaver& saver) : saver_(&saver) {};
+        inserter& operator=(const Block block) {saver_->Put(block); return *this;};
+        inserter& operator*() {return *this;};
+        inserter& operator++() {return *this;};
+        inserter& operator++(int) {return *this;};
+      };
+      
+      BlockChunkSaver(Archive& ar) : ar_(ar), fill_(0) {};
+      ///append a block to the chunk, and pass the chunk on if it is full
+      void Put(const Block block) {
+        chunk_[fill_++] = block;
+        if (fill_==bitset_chunk_blocks_)
+          Flush();
+      };
+      ///pass the blocks in the chunk on to the archive
+      void Flush() {
+        if (fill_)
+          ar_ & SERIALIZATION_NS::make_array(chunk_, fill_);
+        fill_ = 0;
+      };
+    };
+  }; //namespace indexmatrix
+  
   namespace SERIALIZATION_NS_BASE { namespace serialization {
   template <typename Ar, typename Block, typename Alloc>
-      void save(Ar& ar, ::boost::dynamic_bitset<Block, Alloc> const& bs, unsigned version) {
+      void save(Ar& ar, ::boost::dynamic_bitset<Block, Alloc> const& bs, unsigned) {
           size_t num_bits = bs.size();
-          std::vector<Block> blocks(bs.num_blocks());
-          to_block_range(bs, blocks.begin());
+          size_t num_blocks = bs.num_blocks();
+          ar & SERIALIZATION_NS::make_nvp("num_bits", num_bits);
+          ar & SERIALIZATION_NS::make_nvp("num_blocks", num_blocks);
           
-          ar & SERIALIZATION_NS::make_nvp("num_bits", num_bits); 
-          ar & SERIALIZATION_NS::make_nvp("blocks", blocks);
+          if (const Block* blocks = indexmatrix::BitsetBlocks(bs))
+            ar & SERIALIZATION_NS::make_array(blocks, num_blocks);
+          else {
+            indexmatrix::BlockChunkSaver<Ar, Block> saver(ar);
+            to_block_range(bs, typename indexmatrix::BlockChunkSaver<Ar, Block>::inserter(saver));
+            saver.Flush();
+          }
       };
 
   template <typename Ar, typename Block, typename Alloc>
       void load(Ar& ar, ::boost::dynamic_bitset<Block, Alloc>& bs, unsigned version) {
+          const size_t bits_per_block = ::boost::dynamic_bitset<Block, Alloc>::bits_per_block;
           size_t num_bits;
-          std::vector<Block> blocks;
           ar & SERIALIZATION_NS::make_nvp("num_bits", num_bits);
-          ar & SERIALIZATION_NS::make_nvp("blocks", blocks);
-
-          bs.resize(num_bits);
-          from_block_range(blocks.begin(), blocks.end(), bs);
+          
+          if (version==0) {
+            //the blocks were archived as a vector
+            std::vector<Block> blocks;
+            ar & SERIALIZATION_NS::make_nvp("blocks", blocks);
+            if (blocks.size()!=(num_bits+bits_per_block-1)/bits_per_block)
+              log_fatal("archived bitset holds %zu blocks for %zu bits", blocks.size(), num_bits);
+            bs.clear();
+            bs.append(blocks.begin(), blocks.end());
+            bs.resize(num_bits);
+            return;
+          }
+          
+          size_t num_blocks;
+          ar & SERIALIZATION_NS::make_nvp("num_blocks", num_blocks);
+          if (num_blocks!=(num_bits+bits_per_block-1)/bits_per_block)
+            log_fatal("archived bitset holds %zu blocks for %zu bits", num_blocks, num_bits);
+          
+          bs.clear();
           bs.resize(num_bits);
+          if (Block* blocks = indexmatrix::BitsetBlocks(bs)) {
+            ar & SERIALIZATION_NS::make_array(blocks, num_blocks);
+            //the bits beyond num_bits need to be clear, as dynamic_bitset relies on that
+            if (num_bits%bits_per_block)
+              blocks[num_blocks-1] &= ~(~Block(0) << (num_bits%bits_per_block));
+          }
+          else if (num_blocks) {
+            //append the blocks a chunk at a time to the reserved storage; shrinking to num_bits clears the unused bits of the last block
+            bs.clear();
+            bs.reserve(num_bits);
+            Block chunk[indexmatrix::bitset_chunk_blocks_];
+            for (size_t done=0; done<num_blocks; ) {
+              const size_t fill = std::min(num_blocks-done, indexmatrix::bitset_chunk_blocks_);
+              ar & SERIALIZATION_NS::make_array(chunk, fill);
+              bs.append(chunk, chunk+fill);
+              done += fill;
+            }
+            bs.resize(num_bits);
+          }
       };
 
   template <typename Ar, typename Block, typename Alloc>
       void serialize(Ar& ar, ::boost::dynamic_bitset<Block, Alloc>& bs, unsigned version) {
           split_free(ar, bs, version);
       };
+  
+  //NOTE SERIALIZATION_CLASS_VERSION takes no templates; this is what it expands to for all block types
+  template <typename Block, typename Alloc>
+      struct version< ::boost::dynamic_bitset<Block, Alloc> > {
+        typedef ::boost::mpl::int_<dynamic_bitset_version_> type;
+        typedef ::boost::mpl::integral_c_tag tag;
+        BOOST_STATIC_CONSTANT(int, value = type::value);
+      };
   }; }; //namespace
   
   typedef boost::dynamic_bitset<> DynamicBitSet;
-  SERIALIZATION_CLASS_VERSION(DynamicBitSet, indexmatrix_version_);
   #endif //FUTURE
 #endif //SERIALIZATION_ENABLED
 
@@ -75,10 +211,216 @@ static const unsigned indexmatrix_version_ = 0;
  * two-dimentional maps
  */
 namespace indexmatrix{
+  /**
+   * @brief a fixed-size array of atomic fields, for use as 'Internal' of an IndexMatrix that is shared between threads
+   * all accesses are relaxed: each field is read and written indivisibly, but no ordering to other memory is implied;
+   * this suits caches, where concurrent writers would store identical values
+   * @template T an integral type, for which boost::atomic is lock-free
+   */
+  template <typename T>
+  class RelaxedAtomicVector {
+  private:
+    ///the number of fields
+    size_t size_;
+    ///the fields
+    boost::scoped_array<boost::atomic<T> > fields_;
+    
+  public:
+    ///proxy to a single field
+    class reference {
+      friend class RelaxedAtomicVector;
+    private:
+      boost::atomic<T>& field_;
+      reference(boost::atomic<T>& field);
+    public:
+      ///relaxed store
+      reference& operator=(const T value);
+      ///relaxed load
+      operator T() const;
+    };
+    
+    /// constructor; all fields are zero-initialized
+    RelaxedAtomicVector(const size_t size);
+    ///relaxed load of a field
+    T operator[](const size_t index) const;
+    ///proxy to a field for relaxed stores
+    reference operator[](const size_t index);
+    ///the number of fields
+    size_t size() const;
+  };
+  
+  /**
+   * @brief the fields [Field, NFields) of a group of packed fields, which start at a word boundary;
+   * unrolled at compile time, so that the position of each field is a constant
+   */
+  template <unsigned Bits, unsigned Field, unsigned NFields>
+  struct PackedGroup {
+    static const unsigned word = Field*Bits/64;
+    static const unsigned shift = Field*Bits%64;
+    static const uint64_t mask = (uint64_t(1)<<Bits)-1;
+    
+    template <typename T>
+    static void Unpack(const uint64_t* words, T* dest) {
+      dest[Field] = ((words[word]>>shift) | (shift+Bits>64 ? words[word+1]<<((64-shift)%64) : 0)) & mask;
+      PackedGroup<Bits, Field+1, NFields>::Unpack(words, dest);
+    };
+    ///or the fields into zero-initialized words
+    template <typename T>
+    static void Pack(const T* src, uint64_t* words) {
+      const uint64_t field = uint64_t(src[Field]) & mask;
+      words[word] |= field<<shift;
+      if (shift+Bits>64)
+        words[word+1] |= field>>((64-shift)%64);
+      PackedGroup<Bits, Field+1, NFields>::Pack(src, words);
+    };
+  };
+  
+  template <unsigned Bits, unsigned NFields>
+  struct PackedGroup<Bits, NFields, NFields> {
+    template <typename T>
+    static void Unpack(const uint64_t*, T*) {};
+    template <typename T>
+    static void Pack(const T*, uint64_t*) {};
+  };
+  
+  /**
+   * @brief a fixed-size array of unsigned integers of 'Bits' bits each, packed without padding, for use as 'Internal' of an IndexMatrix;
+   * e.g. a matrix of 12-bit fields needs 3/8 of the memory of uint32_t fields. Values are truncated to their lowest 'Bits' bits.
+   * Fields may straddle two words; a field is read branch-free from both.
+   * NOTE writing a field rewrites the word it shares with its neighbours, so concurrent writes are not safe
+   * @template Bits the width of a field in [2, 32]
+   */
+  template <unsigned Bits>
+  class PackedIntVector {
+    BOOST_STATIC_ASSERT_MSG(Bits>=2 && Bits<=32, "PackedIntVector holds fields of 2 to 32 bits");
+  #if SERIALIZATION_ENABLED
+    friend class SERIALIZATION_NS::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned version);
+  #endif //SERIALIZATION_ENABLED
+  public:
+    typedef uint32_t value_type;
+    ///the largest value a field can hold
+    static const uint32_t max_value = uint32_t((uint64_t(1)<<Bits)-1);
+    
+  private:
+    ///the number of fields
+    size_t size_;
+    ///the packed fields, followed by one word of padding, so that the word following a field can always be read
+    std::vector<uint64_t> words_;
+    ///the number of fields, which exactly fill group_words_ words: 64 over the greatest common divisor with Bits
+    static const unsigned group_fields_ = 64/(Bits&(~Bits+1));
+    static const unsigned group_words_ = Bits/(Bits&(~Bits+1));
+    
+  public:
+    ///proxy to a single field
+    class reference {
+      friend class PackedIntVector;
+    private:
+      PackedIntVector& vector_;
+      const size_t index_;
+      reference(PackedIntVector& vector, const size_t index);
+    public:
+      ///store a value
+      reference& operator=(const uint32_t value);
+      ///load the value
+      operator uint32_t() const;
+    };
+    
+    /// constructor; all fields are zero-initialized
+    PackedIntVector(const size_t size);
+    ///load a field
+    uint32_t operator[](const size_t index) const;
+    ///proxy to a field for stores
+    reference operator[](const size_t index);
+    ///store a field
+    void Set(const size_t index, const uint32_t value);
+    ///the number of fields
+    size_t size() const;
+    ///the number of bytes taken by the fields
+    size_t GetNBytes() const;
+    
+    /** @brief load the fields [first, first+count) at once; whole groups of fields, which exactly fill a number of words,
+     * are unpacked by a PackedGroup with constant shifts
+     * @param first the first field
+     * @param count the number of fields
+     * @param dest array of count values to fill
+     */
+    template <typename T>
+    void Unpack(const size_t first, const size_t count, T* dest) const;
+    /** @brief store the fields [first, first+count) at once; whole groups of fields are composed word by word
+     * @param first the first field
+     * @param count the number of fields
+     * @param src array of count values to store
+     */
+    template <typename T>
+    void Pack(const size_t first, const size_t count, const T* src);
+  };
+  
+  /**
+   * @brief fixed-point storage of non-negative real values in a PackedIntVector, for use as 'Internal' of an IndexMatrix:
+   * a value is stored as the nearest multiple of 1/StepsPerUnit and saturates at the largest representable value;
+   * e.g. FixedPointVector<12, 10> holds decimetres up to 409.5 units in 12 bits
+   * @template Bits the width of a field in [2, 32]
+   * @template StepsPerUnit the number of steps per unit of the stored values
+   */
+  template <unsigned Bits, unsigned StepsPerUnit>
+  class FixedPointVector {
+  #if SERIALIZATION_ENABLED
+    friend class SERIALIZATION_NS::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned version);
+  #endif //SERIALIZATION_ENABLED
+  public:
+    typedef double value_type;
+    
+  private:
+    ///the quantized fields
+    PackedIntVector<Bits> packed_;
+    
+  public:
+    ///proxy to a single field
+    class reference {
+      friend class FixedPointVector;
+    private:
+      PackedIntVector<Bits>& packed_;
+      const size_t index_;
+      reference(PackedIntVector<Bits>& packed, const size_t index);
+    public:
+      ///store a value, quantized
+      reference& operator=(const double value);
+      ///load the value
+      operator double() const;
+    };
+    
+    /// constructor; all fields are zero-initialized
+    FixedPointVector(const size_t size);
+    ///load a field
+    double operator[](const size_t index) const;
+    ///proxy to a field for stores
+    reference operator[](const size_t index);
+    ///the number of fields
+    size_t size() const;
+    ///the number of bytes taken by the fields
+    size_t GetNBytes() const;
+    ///the largest value a field can hold
+    static double GetMaxValue();
+    ///the quantized representation of a value
+    static uint32_t Quantize(const double value);
+    
+    /** @brief load the fields [first, first+count) at once
+     * @param first the first field
+     * @param count the number of fields
+     * @param dest array of count values to fill
+     */
+    void Unpack(const size_t first, const size_t count, double* dest) const;
+  };
+
   /**
    * @brief a two-dimentional map holding entries of type 'Base'
    * 'internal' representation is a linear array of some sort,
-   * which can be evaluated in any field and typecast to 'Base'
+   * which can be evaluated in any field and typecast to 'Base';
+   * this is the storage, which is shared by all layouts and serialized; element access is provided by IndexMatrixAccess
    * @template Base a basic, or complex datatype
    * @template internal a vectorized array, which supports operator[]
    */
@@ -109,24 +451,67 @@ namespace indexmatrix{
     /// \param biSize of the matrix in one dimention
     /// \param mapSize size of the internal container that needs to be hold
     IndexMatrix (const unsigned biSize,
-                 const unsigned mapSize);
+                 const size_t mapSize);
+    /// hidden constructor: adopt an existing storage
+    /// \param biSize of the matrix in one dimention
+    /// \param internal the storage; is copied, so that a storage which shares its fields (like MappedVector) is shared
+    IndexMatrix (const unsigned biSize,
+                 const Internal& internal);
     /// copy constructor
 //     IndexMatrix (const IndexMatrix& other);
-    /// destructor
-    virtual
+    /// destructor; not virtual, as matrices are never deleted through their storage
     ~IndexMatrix();
-    
-  private: //internal methods
-    //forward declaration
-    virtual
-    unsigned BiIndex_To_UniIndex(
-      const unsigned indexA,
-      const unsigned indexB) const = 0;
-      
-    virtual
-    std::pair<unsigned, unsigned> UniIndex_To_BiIndex(
-      const unsigned index) const = 0;
 
+  public: //methods
+    /// get the size of the indexable range, which is [0, bisize-1]
+    size_t GetBiSize() const;
+    /// get the internal storage; the fields are in the storage order of the layout
+    const Internal& GetInternal() const;
+  };
+
+  /**
+   * @brief element access to an IndexMatrix, where the index layout is provided by the derived class (CRTP):
+   * 'Layout' implements BiIndex_To_UniIndex and UniIndex_To_BiIndex, so that Get and Set resolve statically
+   * and inline to the index arithmetic, instead of a virtual call per access
+   * @template Base a basic, or complex datatype
+   * @template internal a vectorized array, which supports operator[]
+   * @template Layout the derived class
+   */
+  template <typename Base, class Internal, class Layout>
+  class IndexMatrixAccess : public IndexMatrix<Base, Internal> {
+  protected: //constructors
+    /// hidden constructor
+    /// \param biSize of the matrix in one dimention
+    /// \param mapSize size of the internal container that needs to be hold
+    IndexMatrixAccess (const unsigned biSize,
+                       const size_t mapSize);
+    /// hidden constructor: adopt an existing storage
+    /// \param biSize of the matrix in one dimention
+    /// \param internal the storage; needs to hold exactly the fields of the layout
+    IndexMatrixAccess (const unsigned biSize,
+                       const Internal& internal);
+    
+    /** @brief evaluate a predicate for all fields; requires 'Internal' to be a boost::dynamic_bitset
+     * the pairs (indexA, indexB) are generated in the order of the internal storage, so that whole blocks of bits are
+     * composed at once; the blocks are distributed over threads
+     * @param predicate a functor bool(indexA, indexB), which needs to be safe to call concurrently
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    template <class Predicate>
+    void SetFromPredicate(const Predicate& predicate,
+                          const unsigned nThreads);
+    
+  private:
+    ///number of consecutive blocks of bits a thread composes in SetFromPredicate before moving on
+    static const size_t predicate_chunk_blocks_ = 256;
+    
+    ///compose the blocks of the chunks [firstChunk, firstChunk+chunkStride, ...] of the internal storage
+    template <class Predicate, class Block>
+    void ComposePredicateChunks(const Predicate& predicate,
+                                std::vector<Block>& blocks,
+                                const size_t firstChunk,
+                                const size_t chunkStride) const;
+    
   public: //methods
     /** @brief get the value for field
      * @param indexA this one
@@ -142,17 +527,64 @@ namespace indexmatrix{
     void Set (const unsigned indexA,
               const unsigned indexB,
               const Base value);
-    /// get the size of the indexable range, which is [0, bisize-1]
-    size_t GetBiSize() const;
+    
+    /** @brief visit all fields in the order of the internal storage, which is the cache-friendly order to sweep the matrix:
+     * row after row for the RowMajorLayout
+     * @param function a functor void(indexA, indexB, value); the symmetric matrix visits each field once with indexA>=indexB
+     */
+    template <class Function>
+    void ForEachField(Function function) const;
   };
 
 
+  //===================== Layouts =========================
+  
+  ///the largest integer root with (root*root+root)/2<=index, which is the row of index in a packed triangle
+  size_t TriangularRoot(const size_t index);
+  
+  /**
+   * @brief the storage order of the fields row after row; the symmetric matrix packs the lower triangle row after row.
+   * This is the default, and the layout of all matrices archived before layouts were tagged.
+   * A layout provides the storage size, the position of a field, the inverse, and the field at the following position
+   * for either symmetry; indexA>=indexB is guaranteed by the caller for the symmetric functions.
+   * A layout also provides a tag, which is archived along with the fields and needs to be unique among the layouts
+   */
+  struct RowMajorLayout {
+    ///the tag of this layout in archives and mapped files
+    static const uint32_t tag = 0;
+    
+    static size_t SymmetricSize(const size_t biSize);
+    static size_t SymmetricIndex(const size_t biSize, const size_t indexA, const size_t indexB);
+    static std::pair<unsigned, unsigned> SymmetricBiIndex(const size_t biSize, const size_t index);
+    static void SymmetricNext(const size_t biSize, unsigned& indexA, unsigned& indexB);
+    ///every storage position holds a field
+    static bool SymmetricIsField(const size_t biSize, const unsigned indexA, const unsigned indexB);
+    
+    static size_t AsymmetricSize(const size_t biSize);
+    static size_t AsymmetricIndex(const size_t biSize, const size_t indexA, const size_t indexB);
+    static std::pair<unsigned, unsigned> AsymmetricBiIndex(const size_t biSize, const size_t index);
+    static void AsymmetricNext(const size_t biSize, unsigned& indexA, unsigned& indexB);
+    ///every storage position holds a field
+    static bool AsymmetricIsField(const size_t biSize, const unsigned indexA, const unsigned indexB);
+  };
+  
+#if SERIALIZATION_ENABLED
+  /** @brief archive the tag of a layout, and verify it when loading; log_fatal if the archive holds another layout.
+   * Archives of version 0 predate the tags and hold the fields in the RowMajorLayout
+   */
+  template <class Layout, class Archive>
+  void ArchiveLayoutTag(Archive& ar, const unsigned version);
+#endif //SERIALIZATION_ENABLED
+  
+  
   //===================== CLASS SymmetricIndexMatrix =========================
   
   ///dynamic symmetric BiIndexed -map; input is anything [0..x][0..x]; only upper half and diagonal is filled
   ///NOTE beware, there is no explicit check if you leave the indexable range, that is your responsibility
-  template <typename Base, class Internal>
-  class SymmetricIndexMatrix : public IndexMatrix<Base, Internal> {
+  /// @template Layout the storage order of the fields; RowMajorLayout, or TiledLayout of ToolZ/TiledLayout.h
+  template <typename Base, class Internal, class Layout = RowMajorLayout>
+  class SymmetricIndexMatrix : public IndexMatrixAccess<Base, Internal, SymmetricIndexMatrix<Base, Internal, Layout> > {
+    friend class IndexMatrixAccess<Base, Internal, SymmetricIndexMatrix>;
   #if SERIALIZATION_ENABLED
     friend class SERIALIZATION_NS::access;
     
@@ -169,16 +601,37 @@ namespace indexmatrix{
   #endif //SERIALIZATION_ENABLED
   protected: // hidden methods
     ///convert from Bi-indexed representation to a linear index
-    unsigned BiIndex_To_UniIndex(
+    size_t BiIndex_To_UniIndex(
       const unsigned indexA,
       const unsigned indexB) const;
-    ///convert from linear index to Bi-indexed representation
-    /// @return a pair of indexA and indexB, where indexA<=indexB
-    std::pair<unsigned, unsigned> UniIndex_To_BiIndex(const unsigned index) const;
+    ///convert from linear index to Bi-indexed representation; computed in closed form; log_fatal if the index holds no field
+    /// @return a pair of indexA and indexB, where indexA>=indexB
+    std::pair<unsigned, unsigned> UniIndex_To_BiIndex(const size_t index) const;
+    ///the Bi-indexed representation of any storage position, also of padding, which is not checked
+    std::pair<unsigned, unsigned> Position_To_BiIndex(const size_t index) const;
+    ///advance the Bi-indexed representation to the following linear index
+    void NextBiIndex(unsigned& indexA,
+                     unsigned& indexB) const;
+    ///does the linear index of this Bi-indexed representation hold a field, or is it padding of the layout
+    bool IsField(const unsigned indexA,
+                 const unsigned indexB) const;
   public:
     /// constructor
     /// @param biSize that is the range of the biIndex
-    SymmetricIndexMatrix<Base, Internal> (const unsigned biSize);
+    SymmetricIndexMatrix (const unsigned biSize);
+    /// constructor: adopt an existing storage, for example a read-only MappedVector
+    /// @param biSize that is the range of the biIndex
+    /// @param internal the storage, holding the fields in the storage order of the Layout
+    SymmetricIndexMatrix (const unsigned biSize,
+                          const Internal& internal);
+    
+    /** @brief set the fields (indexA, 0) to (indexA, indexA) at once, which are contiguous in the RowMajorLayout
+     * @param indexA the row
+     * @param first iterator to the indexA+1 values
+     */
+    template <class InputIterator>
+    void SetRow (const unsigned indexA,
+                 InputIterator first);
     
 //     SymmetricIndexMatrix<Base, Internal> (const SymmetricIndexMatrix<Base, Internal>& other) :
 //       IndexMatrix<Base, Internal>(other)
@@ -190,8 +643,10 @@ namespace indexmatrix{
   
   ///dynamic asymmetric BiIndexed map; input is anything [0..x][0..x]; all fields are filled
   ///NOTE beware, there is no explicit check if you leave the indexable range, that is your responsibile
-  template <typename Base, class Internal>
-  class AsymmetricIndexMatrix : public IndexMatrix<Base, Internal> {
+  /// @template Layout the storage order of the fields; RowMajorLayout, or TiledLayout of ToolZ/TiledLayout.h
+  template <typename Base, class Internal, class Layout = RowMajorLayout>
+  class AsymmetricIndexMatrix : public IndexMatrixAccess<Base, Internal, AsymmetricIndexMatrix<Base, Internal, Layout> > {
+    friend class IndexMatrixAccess<Base, Internal, AsymmetricIndexMatrix>;
   #if SERIALIZATION_ENABLED
     friend class SERIALIZATION_NS::access;
     
@@ -208,24 +663,37 @@ namespace indexmatrix{
   #endif //SERIALIZATION_ENABLED
   protected: // hidden methods
     ///convert from Bi-indexed representation to a linear index
-    unsigned BiIndex_To_UniIndex(
+    size_t BiIndex_To_UniIndex(
       const unsigned indexA,
       const unsigned indexB) const;
-    ///convert from linear index to Bi-indexed representation
+    ///convert from linear index to Bi-indexed representation; log_fatal if the index holds no field
     /// @return a pair of indexA and indexB
-    std::pair<unsigned, unsigned> UniIndex_To_BiIndex(const unsigned index) const;  
+    std::pair<unsigned, unsigned> UniIndex_To_BiIndex(const size_t index) const;  
+    ///the Bi-indexed representation of any storage position, also of padding, which is not checked
+    std::pair<unsigned, unsigned> Position_To_BiIndex(const size_t index) const;
+    ///advance the Bi-indexed representation to the following linear index
+    void NextBiIndex(unsigned& indexA,
+                     unsigned& indexB) const;
+    ///does the linear index of this Bi-indexed representation hold a field, or is it padding of the layout
+    bool IsField(const unsigned indexA,
+                 const unsigned indexB) const;
       
   public:
     /// constructor
     /// @param biSize that is the range of the biIndex
-    AsymmetricIndexMatrix<Base, Internal>(const unsigned biSize);
+    AsymmetricIndexMatrix(const unsigned biSize);
+    /// constructor: adopt an existing storage, for example a read-only MappedVector
+    /// @param biSize that is the range of the biIndex
+    /// @param internal the storage, holding the fields in the storage order of the Layout
+    AsymmetricIndexMatrix(const unsigned biSize,
+                          const Internal& internal);
     
 //     AsymmetricIndexMatrix<Base, Internal>(const AsymmetricIndexMatrix<Base, Internal>& other) :
 //       IndexMatrix<Base, Internal>(other)
 //       {};
       
     ///construct from a asymetric matrix from a symmetric matrix
-    AsymmetricIndexMatrix<Base, Internal>(const SymmetricIndexMatrix<Base, Internal>& other);
+    AsymmetricIndexMatrix(const SymmetricIndexMatrix<Base, Internal, Layout>& other);
   };
   
 
@@ -274,7 +742,105 @@ namespace indexmatrix{
   };
   
   
+  //================== CLASS  BitLine ==================
+  
+  /**
+   * @brief a read-only view of one row or column of a bool matrix: the fields of one fixed index,
+   * indexed by the other index in [0, biSize-1].
+   * The line is composed of a contiguous segment of the bitset, which is scanned a block at a time,
+   * followed by a strided segment, which is tested field by field:
+   * a row of the AsymmetricIndexMatrix is all contiguous, a column all strided;
+   * a row of the SymmetricIndexMatrix is contiguous up to the diagonal and continues down the column.
+   * NOTE the view refers to the matrix, which needs to outlive it
+   */
+  class BitLine {
+  public:
+    typedef boost::dynamic_bitset<> BitSet;
+    ///returned by the Find-methods if there is no further true field
+    static const size_t npos = BitSet::npos;
+    
+    /// iterates the indices of all true fields of the line in ascending order
+    class const_iterator : public std::iterator<std::forward_iterator_tag, unsigned> {
+      friend class BitLine;
+    private:
+      ///the line iterated over
+      const BitLine* line_;
+      ///current index; npos for end
+      size_t index_;
+      ///constructor
+      const_iterator(const BitLine* line, const size_t index);
+    public:
+      ///blank constructor
+      const_iterator();
+      ///get the index at this position
+      unsigned operator*() const;
+      ///advance to the next true field
+      const_iterator& operator++();
+      const_iterator operator++(int);
+      bool operator==(const const_iterator& rhs) const;
+      bool operator!=(const const_iterator& rhs) const;
+    };
+    
+  private:
+    ///the bits of the matrix
+    const BitSet* bits_;
+    ///the length of the line
+    size_t biSize_;
+    ///position of the field with index 0 in the bitset
+    size_t offset_;
+    ///the fields [0, contiguous_) are contiguous in the bitset
+    size_t contiguous_;
+    ///the fixed index of the strided fields
+    size_t fixed_;
+    ///the strided fields are in the symmetric (triangular) layout, otherwise in the asymmetric layout
+    bool triangular_;
+    
+    ///position in the bitset of a field in the strided segment
+    size_t StridedPosition(const size_t index) const;
+    
+  public:
+    /** @brief constructor
+     * @param bits the bits of the matrix
+     * @param biSize the length of the line
+     * @param offset position of the field with index 0 in the bitset
+     * @param contiguous the number of leading fields, which are contiguous in the bitset
+     * @param fixed the fixed index of the strided fields
+     * @param triangular the strided fields are in the symmetric layout, otherwise in the asymmetric layout
+     */
+    BitLine(const BitSet& bits,
+            const size_t biSize,
+            const size_t offset,
+            const size_t contiguous,
+            const size_t fixed,
+            const bool triangular);
+    
+    ///the length of the line
+    size_t size() const;
+    ///get the value of the field at this index
+    bool Test(const size_t index) const;
+    ///the index of the first true field; npos if there is none
+    size_t FindFirst() const;
+    ///the index of the first true field after this index; npos if there is none
+    size_t FindNext(const size_t index) const;
+    ///the number of true fields
+    size_t Count() const;
+    ///are there any true fields
+    bool Any() const;
+    
+    /** @brief copy the line into a bitset of length size(), e.g. for bitwise combination with other lines or sets
+     * @param bits the bitset to fill; is resized
+     */
+    template <typename Block, class Allocator>
+    void GetBits(boost::dynamic_bitset<Block, Allocator>& bits) const;
+    
+    const_iterator begin() const;
+    const_iterator end() const;
+  };
+  
+  
   //================== CLASS  (A)SymmetricIndexMatrix_Bool ==================
+  
+  class AsymmetricIndexMatrix_Bool;
 
   /// specializzed class SymmetricIndexMatrix for Bool
   class SymmetricIndexMatrix_Bool : public SymmetricIndexMatrix<bool, boost::dynamic_bitset<> > {
@@ -295,16 +861,52 @@ namespace indexmatrix{
   public:
     //constructor explicit
     SymmetricIndexMatrix_Bool (const unsigned biSize, const bool setall = false);
-    //constructor predicate
-    SymmetricIndexMatrix_Bool (const unsigned biSize, const boost::function<bool (const uint64_t, const uint64_t)> predicate);
+    /** @brief constructor predicate: evaluate predicate(indexA, indexB) for all fields
+     * @param biSize that is the range of the biIndex
+     * @param predicate a functor bool(indexA, indexB); is called concurrently if nThreads!=1
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    template <class Predicate>
+    SymmetricIndexMatrix_Bool (const unsigned biSize,
+                               const Predicate& predicate,
+                               const unsigned nThreads = 1,
+                               typename boost::disable_if<boost::is_arithmetic<Predicate> >::type* = 0);
     ///emplace with bitwise or
     SymmetricIndexMatrix_Bool& operator|=(const SymmetricIndexMatrix_Bool& rhs);
     ///emplace with bitwise and
     SymmetricIndexMatrix_Bool& operator&=(const SymmetricIndexMatrix_Bool& rhs);
+    
+    ///view the fields (indexA, 0..biSize-1), which are stitched from the stored row and the stored column of indexA
+    BitLine GetRow(const unsigned indexA) const;
+    ///view the fields (0..biSize-1, indexB); identical to the row, as the matrix is symmetric
+    BitLine GetColumn(const unsigned indexB) const;
+    
+    /** @brief the boolean matrix product: field (indexA, indexB) is true if there is any indexC,
+     * so that (indexA, indexC) of this and (indexC, indexB) of rhs are true.
+     * The product of two different symmetric matrices is asymmetric in general
+     * @param rhs the right hand side; needs to be of the same size
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    AsymmetricIndexMatrix_Bool Multiply(const SymmetricIndexMatrix_Bool& rhs,
+                                        const unsigned nThreads = 1) const;
+    /** @brief the connectivity within a number of steps: field (indexA, indexB) is true if there is a path
+     * of 1 to nSteps true fields from indexA to indexB
+     * @param nSteps maximal length of the path
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    SymmetricIndexMatrix_Bool ReachableWithin(const unsigned nSteps,
+                                              const unsigned nThreads = 1) const;
+    /** @brief the transitive closure: field (indexA, indexB) is true if there is a path of any length
+     * from indexA to indexB; so all fields among the members of a connected cluster are true.
+     * The clusters are found by union-find on the true fields, so this is linear in their number
+     */
+    SymmetricIndexMatrix_Bool TransitiveClosure() const;
   };
     
   /// specializzed class AsymmetricIndexMatrix for Bool
   class AsymmetricIndexMatrix_Bool : public AsymmetricIndexMatrix<bool, boost::dynamic_bitset<> > {
+    ///composes its products
+    friend class SymmetricIndexMatrix_Bool;
   #if SERIALIZATION_ENABLED
     friend class SERIALIZATION_NS::access;
     
@@ -322,12 +924,45 @@ namespace indexmatrix{
   public:
     //constructor explicit
     AsymmetricIndexMatrix_Bool (const unsigned biSize, const bool setall = false);
-    //constructor predicate
-    AsymmetricIndexMatrix_Bool (const unsigned biSize, const boost::function<bool (const uint64_t, const uint64_t)> predicate);
+    /** @brief constructor predicate: evaluate predicate(indexA, indexB) for all fields
+     * @param biSize that is the range of the biIndex
+     * @param predicate a functor bool(indexA, indexB); is called concurrently if nThreads!=1
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    template <class Predicate>
+    AsymmetricIndexMatrix_Bool (const unsigned biSize,
+                                const Predicate& predicate,
+                                const unsigned nThreads = 1,
+                                typename boost::disable_if<boost::is_arithmetic<Predicate> >::type* = 0);
     ///emplace with bitwise or
     AsymmetricIndexMatrix_Bool& operator|=(const AsymmetricIndexMatrix_Bool& rhs);
     ///emplace with bitwise and
     AsymmetricIndexMatrix_Bool& operator&=(const AsymmetricIndexMatrix_Bool& rhs);    
+    
+    ///view the fields (indexA, 0..biSize-1), which are contiguous
+    BitLine GetRow(const unsigned indexA) const;
+    ///view the fields (0..biSize-1, indexB), which are strided by biSize
+    BitLine GetColumn(const unsigned indexB) const;
+    
+    /** @brief the boolean matrix product: field (indexA, indexB) is true if there is any indexC,
+     * so that (indexA, indexC) of this and (indexC, indexB) of rhs are true
+     * @param rhs the right hand side; needs to be of the same size
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    AsymmetricIndexMatrix_Bool Multiply(const AsymmetricIndexMatrix_Bool& rhs,
+                                        const unsigned nThreads = 1) const;
+    /** @brief the connectivity within a number of steps: field (indexA, indexB) is true if there is a directed path
+     * of 1 to nSteps true fields from indexA to indexB
+     * @param nSteps maximal length of the path
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    AsymmetricIndexMatrix_Bool ReachableWithin(const unsigned nSteps,
+                                               const unsigned nThreads = 1) const;
+    /** @brief the transitive closure: field (indexA, indexB) is true if there is a directed path of any length
+     * from indexA to indexB. Computed by repeated squaring, so that the number of products is logarithmic in the longest path
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     */
+    AsymmetricIndexMatrix_Bool TransitiveClosure(const unsigned nThreads = 1) const;
   };
   
   typedef boost::shared_ptr<AsymmetricIndexMatrix_Double> AsymmetricIndexMatrix_DoublePtr;
@@ -346,6 +981,23 @@ namespace indexmatrix{
   SERIALIZATION_CLASS_VERSION(indexmatrix::SymmetricIndexMatrix_Double, indexmatrix_version_);
   SERIALIZATION_CLASS_VERSION(indexmatrix::AsymmetricIndexMatrix_Bool, indexmatrix_version_);
   SERIALIZATION_CLASS_VERSION(indexmatrix::SymmetricIndexMatrix_Bool, indexmatrix_version_);
+  
+  //NOTE SERIALIZATION_CLASS_VERSION takes no templates; this is what it expands to for a single class
+  namespace SERIALIZATION_NS_BASE { namespace serialization {
+    template <typename Base, class Internal, class Layout>
+    struct version<indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout> > {
+      typedef ::boost::mpl::int_<indexmatrix_layout_version_> type;
+      typedef ::boost::mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = type::value);
+    };
+    
+    template <typename Base, class Internal, class Layout>
+    struct version<indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout> > {
+      typedef ::boost::mpl::int_<indexmatrix_layout_version_> type;
+      typedef ::boost::mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = type::value);
+    };
+  }}; // namespace ...
 #endif //SERIALIZATION_ENABLED
 
   
@@ -363,7 +1015,10 @@ namespace SERIALIZATION_NS_BASE { namespace serialization {
   template<class Archive, typename Base, class Internal>
   inline void save_construct_data(
     Archive & ar, const indexmatrix::IndexMatrix<Base,Internal> * t, const unsigned int file_version)
-  { ar << SERIALIZATION_NS::make_nvp("biSize", t->biSize_); };
+  {
+    const size_t biSize = t->GetBiSize();
+    ar << SERIALIZATION_NS::make_nvp("biSize", biSize);
+  };
 
   template<class Archive, typename Base, class Internal>
   inline void load_construct_data(
@@ -377,11 +1032,17 @@ namespace SERIALIZATION_NS_BASE { namespace serialization {
 #endif //SERIALIZATION_ENABLED
 
 template <typename Base, class Internal>
-indexmatrix::IndexMatrix<Base, Internal>::IndexMatrix (const unsigned biSize, const unsigned mapSize) :
+indexmatrix::IndexMatrix<Base, Internal>::IndexMatrix (const unsigned biSize, const size_t mapSize) :
   biSize_(biSize),
   internal_(mapSize) 
 {};
 
+template <typename Base, class Internal>
+indexmatrix::IndexMatrix<Base, Internal>::IndexMatrix (const unsigned biSize, const Internal& internal) :
+  biSize_(biSize),
+  internal_(internal) 
+{};
+
 // template <typename Base, class Internal>
 // indexmatrix::IndexMatrix<Base, Internal>::IndexMatrix (const indexmatrix::IndexMatrix<Base, Internal>& other):
 //   biSize_(other.biSize_),
@@ -392,53 +1053,543 @@ template <typename Base, class Internal>
 indexmatrix::IndexMatrix<Base, Internal>::~IndexMatrix ()
 {};
 
-template <typename Base, class Internal>
-Base 
-indexmatrix::IndexMatrix<Base, Internal>::Get (const unsigned indexA, const unsigned indexB) const
-  {return internal_[BiIndex_To_UniIndex(indexA, indexB)];};
-
-template <typename Base, class Internal>
-void 
-indexmatrix::IndexMatrix<Base, Internal>::Set (const unsigned indexA, const unsigned indexB, const Base value)
-  {internal_[BiIndex_To_UniIndex(indexA, indexB)]=value;};
-  
 template <typename Base, class Internal>
 size_t
 indexmatrix::IndexMatrix<Base, Internal>::GetBiSize () const
   {return biSize_;};
+
+template <typename Base, class Internal>
+const Internal&
+indexmatrix::IndexMatrix<Base, Internal>::GetInternal () const
+  {return internal_;};
+
+
+//===================== CLASS IndexMatrixAccess =========================
+
+template <typename Base, class Internal, class Layout>
+indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::IndexMatrixAccess (const unsigned biSize, const size_t mapSize) :
+  IndexMatrix<Base, Internal>(biSize, mapSize)
+{};
+
+template <typename Base, class Internal, class Layout>
+indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::IndexMatrixAccess (const unsigned biSize, const Internal& internal) :
+  IndexMatrix<Base, Internal>(biSize, internal)
+{};
+
+template <typename Base, class Internal, class Layout>
+template <class Predicate>
+void indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::SetFromPredicate(
+  const Predicate& predicate,
+  const unsigned nThreads)
+{
+  typedef typename Internal::block_type Block;
+  std::vector<Block> blocks(this->internal_.num_blocks(), Block(0));
+  
+  const size_t nChunks = (blocks.size()+predicate_chunk_blocks_-1)/predicate_chunk_blocks_;
+  size_t nWorkers = nThreads ? nThreads : boost::thread::hardware_concurrency();
+  nWorkers = std::max(size_t(1), std::min(nWorkers, nChunks));
   
+  if (nWorkers==1)
+    ComposePredicateChunks(predicate, blocks, 0, 1);
+  else {
+    //each thread writes whole blocks, so that no two threads touch the same block
+    boost::thread_group workers;
+    for (size_t t=0; t<nWorkers; t++)
+      workers.create_thread(boost::bind(&IndexMatrixAccess::template ComposePredicateChunks<Predicate, Block>,
+        this, boost::cref(predicate), boost::ref(blocks), t, nWorkers));
+    workers.join_all();
+  }
+  
+  const size_t mapSize = this->internal_.size();
+  this->internal_.clear();
+  this->internal_.append(blocks.begin(), blocks.end());
+  this->internal_.resize(mapSize);
+};
+
+template <typename Base, class Internal, class Layout>
+template <class Predicate, class Block>
+void indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::ComposePredicateChunks(
+  const Predicate& predicate,
+  std::vector<Block>& blocks,
+  const size_t firstChunk,
+  const size_t chunkStride) const
+{
+  const size_t bitsPerBlock = Internal::bits_per_block;
+  const size_t mapSize = this->internal_.size();
+  const Layout& layout = *static_cast<const Layout*>(this);
+  
+  for (size_t chunk=firstChunk; chunk*predicate_chunk_blocks_<blocks.size(); chunk+=chunkStride) {
+    const size_t firstBlock = chunk*predicate_chunk_blocks_;
+    const size_t lastBlock = std::min(firstBlock+predicate_chunk_blocks_, blocks.size());
+    
+    //locate the first position of the chunk once, then step through the positions in storage order
+    size_t index = firstBlock*bitsPerBlock;
+    const std::pair<unsigned, unsigned> first = layout.Position_To_BiIndex(index);
+    unsigned indexA = first.first;
+    unsigned indexB = first.second;
+    for (size_t block=firstBlock; block<lastBlock; block++) {
+      Block bits(0);
+      for (size_t bit=0; bit<bitsPerBlock && index<mapSize; bit++, index++) {
+        if (layout.IsField(indexA, indexB) && predicate(indexA, indexB))
+          bits |= Block(1) << bit;
+        layout.NextBiIndex(indexA, indexB);
+      }
+      blocks[block] = bits;
+    }
+  }
+};
+
+template <typename Base, class Internal, class Layout>
+template <class Function>
+void indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::ForEachField(Function function) const {
+  const Layout& layout = *static_cast<const Layout*>(this);
+  unsigned indexA = 0;
+  unsigned indexB = 0;
+  for (size_t index=0; index<this->internal_.size(); index++) {
+    if (layout.IsField(indexA, indexB))
+      function(indexA, indexB, Base(this->internal_[index]));
+    layout.NextBiIndex(indexA, indexB);
+  }
+};
+
+template <typename Base, class Internal, class Layout>
+inline Base 
+indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::Get (const unsigned indexA, const unsigned indexB) const
+  {return this->internal_[static_cast<const Layout*>(this)->BiIndex_To_UniIndex(indexA, indexB)];};
+
+template <typename Base, class Internal, class Layout>
+inline void 
+indexmatrix::IndexMatrixAccess<Base, Internal, Layout>::Set (const unsigned indexA, const unsigned indexB, const Base value)
+  {this->internal_[static_cast<const Layout*>(this)->BiIndex_To_UniIndex(indexA, indexB)]=value;};
+  
+
+//===================== block access =========================
+
+template <typename Block, typename Allocator>
+inline const Block* indexmatrix::BitsetBlocks(const boost::dynamic_bitset<Block, Allocator>&)
+  {return 0;};
+
+template <typename Block, typename Allocator>
+inline Block* indexmatrix::BitsetBlocks(boost::dynamic_bitset<Block, Allocator>&)
+  {return 0;};
+
+//===================== CLASS BitLine =========================
+
+inline
+indexmatrix::BitLine::const_iterator::const_iterator(const BitLine* line, const size_t index) :
+  line_(line),
+  index_(index)
+{};
+
+inline
+indexmatrix::BitLine::const_iterator::const_iterator() :
+  line_(NULL),
+  index_(npos)
+{};
+
+inline
+unsigned indexmatrix::BitLine::const_iterator::operator*() const
+  {return index_;};
+
+inline
+indexmatrix::BitLine::const_iterator& indexmatrix::BitLine::const_iterator::operator++() {
+  index_ = line_->FindNext(index_);
+  return *this;
+};
+
+inline
+indexmatrix::BitLine::const_iterator indexmatrix::BitLine::const_iterator::operator++(int) {
+  const const_iterator old(*this);
+  ++(*this);
+  return old;
+};
+
+inline
+bool indexmatrix::BitLine::const_iterator::operator==(const const_iterator& rhs) const
+  {return index_==rhs.index_;};
+
+inline
+bool indexmatrix::BitLine::const_iterator::operator!=(const const_iterator& rhs) const
+  {return index_!=rhs.index_;};
+
+inline
+size_t indexmatrix::BitLine::StridedPosition(const size_t index) const
+  {return triangular_ ? (index*index+index)/2+fixed_ : index*biSize_+fixed_;};
+
+inline
+size_t indexmatrix::BitLine::size() const
+  {return biSize_;};
+
+inline
+bool indexmatrix::BitLine::Test(const size_t index) const
+  {return (*bits_)[index<contiguous_ ? offset_+index : StridedPosition(index)];};
+
+inline
+size_t indexmatrix::BitLine::FindFirst() const
+  {return (biSize_ && Test(0)) ? 0 : FindNext(0);};
+
+inline
+indexmatrix::BitLine::const_iterator indexmatrix::BitLine::begin() const
+  {return const_iterator(this, FindFirst());};
+
+inline
+indexmatrix::BitLine::const_iterator indexmatrix::BitLine::end() const
+  {return const_iterator(this, npos);};
+
+template <typename Block, class Allocator>
+void indexmatrix::BitLine::GetBits(boost::dynamic_bitset<Block, Allocator>& bits) const {
+  bits.clear();
+  bits.resize(biSize_);
+  for (size_t index=FindFirst(); index!=npos; index=FindNext(index))
+    bits.set(index);
+};
+
+
+//===================== CLASS RelaxedAtomicVector =========================
+
+template <typename T>
+indexmatrix::RelaxedAtomicVector<T>::reference::reference(boost::atomic<T>& field) :
+  field_(field)
+{};
+
+template <typename T>
+typename indexmatrix::RelaxedAtomicVector<T>::reference&
+indexmatrix::RelaxedAtomicVector<T>::reference::operator=(const T value) {
+  field_.store(value, boost::memory_order_relaxed);
+  return *this;
+};
+
+template <typename T>
+indexmatrix::RelaxedAtomicVector<T>::reference::operator T() const
+  {return field_.load(boost::memory_order_relaxed);};
+
+template <typename T>
+indexmatrix::RelaxedAtomicVector<T>::RelaxedAtomicVector(const size_t size) :
+  size_(size),
+  fields_(new boost::atomic<T>[size])
+{
+  for (size_t i=0; i<size_; i++)
+    fields_[i].store(T(), boost::memory_order_relaxed);
+};
+
+template <typename T>
+T indexmatrix::RelaxedAtomicVector<T>::operator[](const size_t index) const
+  {return fields_[index].load(boost::memory_order_relaxed);};
+
+template <typename T>
+typename indexmatrix::RelaxedAtomicVector<T>::reference
+indexmatrix::RelaxedAtomicVector<T>::operator[](const size_t index)
+  {return reference(fields_[index]);};
+
+template <typename T>
+size_t indexmatrix::RelaxedAtomicVector<T>::size() const
+  {return size_;};
+
+
+//===================== CLASS PackedIntVector =========================
+
+template <unsigned Bits>
+const uint32_t indexmatrix::PackedIntVector<Bits>::max_value;
+template <unsigned Bits>
+const unsigned indexmatrix::PackedIntVector<Bits>::group_fields_;
+template <unsigned Bits>
+const unsigned indexmatrix::PackedIntVector<Bits>::group_words_;
+
+#if SERIALIZATION_ENABLED
+template <unsigned Bits>
+template <class Archive>
+void indexmatrix::PackedIntVector<Bits>::serialize(Archive & ar, const unsigned version) {
+  ar & SERIALIZATION_NS::make_nvp("size", size_);
+  ar & SERIALIZATION_NS::make_nvp("words", words_);
+};
+#endif //SERIALIZATION_ENABLED
+
+template <unsigned Bits>
+indexmatrix::PackedIntVector<Bits>::reference::reference(PackedIntVector& vector, const size_t index) :
+  vector_(vector),
+  index_(index)
+{};
+
+template <unsigned Bits>
+inline typename indexmatrix::PackedIntVector<Bits>::reference&
+indexmatrix::PackedIntVector<Bits>::reference::operator=(const uint32_t value) {
+  vector_.Set(index_, value);
+  return *this;
+};
+
+template <unsigned Bits>
+inline indexmatrix::PackedIntVector<Bits>::reference::operator uint32_t() const
+  {return static_cast<const PackedIntVector&>(vector_)[index_];};
+
+template <unsigned Bits>
+indexmatrix::PackedIntVector<Bits>::PackedIntVector(const size_t size) :
+  size_(size),
+  words_((uint64_t(size)*Bits+63)/64+1, 0)
+{};
+
+template <unsigned Bits>
+inline uint32_t indexmatrix::PackedIntVector<Bits>::operator[](const size_t index) const {
+  const uint64_t bit = uint64_t(index)*Bits;
+  const size_t word = bit/64;
+  const unsigned shift = bit%64;
+  //the second word contributes nothing if shift==0; the shift is split, as shifting by 64 is undefined
+  return ((words_[word]>>shift) | ((words_[word+1]<<1)<<(63-shift))) & max_value;
+};
+
+template <unsigned Bits>
+inline typename indexmatrix::PackedIntVector<Bits>::reference
+indexmatrix::PackedIntVector<Bits>::operator[](const size_t index)
+  {return reference(*this, index);};
+
+template <unsigned Bits>
+inline void indexmatrix::PackedIntVector<Bits>::Set(const size_t index, const uint32_t value) {
+  const uint64_t bit = uint64_t(index)*Bits;
+  const size_t word = bit/64;
+  const unsigned shift = bit%64;
+  const uint64_t field = value & max_value;
+  words_[word] = (words_[word] & ~(uint64_t(max_value)<<shift)) | (field<<shift);
+  if (shift+Bits>64) {
+    const unsigned spill = shift+Bits-64;
+    words_[word+1] = (words_[word+1] & ~(uint64_t(max_value)>>(Bits-spill))) | (field>>(64-shift));
+  }
+};
+
+template <unsigned Bits>
+inline size_t indexmatrix::PackedIntVector<Bits>::size() const
+  {return size_;};
+
+template <unsigned Bits>
+size_t indexmatrix::PackedIntVector<Bits>::GetNBytes() const
+  {return words_.size()*sizeof(uint64_t);};
+
+template <unsigned Bits>
+template <typename T>
+void indexmatrix::PackedIntVector<Bits>::Unpack(const size_t first, const size_t count, T* dest) const {
+  size_t index = first;
+  const size_t last = first+count;
+  for (; index<last && index%group_fields_; index++)
+    *dest++ = (*this)[index];
+  //whole groups, in which the position of every field is a constant
+  for (; index+group_fields_<=last; index+=group_fields_) {
+    const uint64_t* words = &words_[index/group_fields_*group_words_];
+    PackedGroup<Bits, 0, group_fields_>::Unpack(words, dest);
+    dest += group_fields_;
+  }
+  for (; index<last; index++)
+    *dest++ = (*this)[index];
+};
+
+template <unsigned Bits>
+template <typename T>
+void indexmatrix::PackedIntVector<Bits>::Pack(const size_t first, const size_t count, const T* src) {
+  size_t index = first;
+  const size_t last = first+count;
+  for (; index<last && index%group_fields_; index++)
+    Set(index, *src++);
+  //whole groups are composed word by word
+  for (; index+group_fields_<=last; index+=group_fields_) {
+    uint64_t* words = &words_[index/group_fields_*group_words_];
+    std::fill(words, words+group_words_, uint64_t(0));
+    PackedGroup<Bits, 0, group_fields_>::Pack(src, words);
+    src += group_fields_;
+  }
+  for (; index<last; index++)
+    Set(index, *src++);
+};
+
+
+//===================== CLASS FixedPointVector =========================
+
+#if SERIALIZATION_ENABLED
+template <unsigned Bits, unsigned StepsPerUnit>
+template <class Archive>
+void indexmatrix::FixedPointVector<Bits, StepsPerUnit>::serialize(Archive & ar, const unsigned version)
+  {ar & SERIALIZATION_NS::make_nvp("packed", packed_);};
+#endif //SERIALIZATION_ENABLED
+
+template <unsigned Bits, unsigned StepsPerUnit>
+indexmatrix::FixedPointVector<Bits, StepsPerUnit>::reference::reference(PackedIntVector<Bits>& packed, const size_t index) :
+  packed_(packed),
+  index_(index)
+{};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+inline typename indexmatrix::FixedPointVector<Bits, StepsPerUnit>::reference&
+indexmatrix::FixedPointVector<Bits, StepsPerUnit>::reference::operator=(const double value) {
+  packed_.Set(index_, Quantize(value));
+  return *this;
+};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+inline indexmatrix::FixedPointVector<Bits, StepsPerUnit>::reference::operator double() const
+  {return static_cast<const PackedIntVector<Bits>&>(packed_)[index_]/double(StepsPerUnit);};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+indexmatrix::FixedPointVector<Bits, StepsPerUnit>::FixedPointVector(const size_t size) :
+  packed_(size)
+{};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+inline double indexmatrix::FixedPointVector<Bits, StepsPerUnit>::operator[](const size_t index) const
+  {return packed_[index]/double(StepsPerUnit);};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+inline typename indexmatrix::FixedPointVector<Bits, StepsPerUnit>::reference
+indexmatrix::FixedPointVector<Bits, StepsPerUnit>::operator[](const size_t index)
+  {return reference(packed_, index);};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+inline size_t indexmatrix::FixedPointVector<Bits, StepsPerUnit>::size() const
+  {return packed_.size();};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+size_t indexmatrix::FixedPointVector<Bits, StepsPerUnit>::GetNBytes() const
+  {return packed_.GetNBytes();};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+double indexmatrix::FixedPointVector<Bits, StepsPerUnit>::GetMaxValue()
+  {return PackedIntVector<Bits>::max_value/double(StepsPerUnit);};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+inline uint32_t indexmatrix::FixedPointVector<Bits, StepsPerUnit>::Quantize(const double value) {
+  const double steps = value*StepsPerUnit+0.5;
+  if (!(steps>=1.)) //also NAN
+    return 0;
+  if (steps>=PackedIntVector<Bits>::max_value)
+    return PackedIntVector<Bits>::max_value;
+  return uint32_t(steps);
+};
+
+template <unsigned Bits, unsigned StepsPerUnit>
+void indexmatrix::FixedPointVector<Bits, StepsPerUnit>::Unpack(const size_t first, const size_t count, double* dest) const {
+  packed_.Unpack(first, count, dest);
+  //divide rather than multiply by the step, so that the values are identical to those of operator[]
+  for (size_t i=0; i<count; i++)
+    dest[i] /= StepsPerUnit;
+};
+
+
+//===================== Layouts =========================
+
+inline
+size_t indexmatrix::TriangularRoot(const size_t index) {
+  //invert index=(root*root+root)/2+rest with rest<=root: root is the integer root of 8*index+1
+  uint64_t root = uint64_t((std::sqrt(8.*index+1.)-1.)/2.);
+  //correct for the rounding of the floating point root
+  while ((root*root+root)/2 > index)
+    root--;
+  while (((root+1)*(root+1)+(root+1))/2 <= index)
+    root++;
+  return root;
+};
+
+inline
+size_t indexmatrix::RowMajorLayout::SymmetricSize(const size_t biSize)
+  {return (biSize*biSize+biSize)/2;};
+
+inline
+size_t indexmatrix::RowMajorLayout::SymmetricIndex(const size_t, const size_t indexA, const size_t indexB)
+  {return (indexA*indexA+indexA)/2+indexB;};
+
+inline
+std::pair<unsigned, unsigned> indexmatrix::RowMajorLayout::SymmetricBiIndex(const size_t, const size_t index) {
+  const size_t indexA = TriangularRoot(index);
+  return std::make_pair(indexA, index-(indexA*indexA+indexA)/2);
+};
+
+inline
+void indexmatrix::RowMajorLayout::SymmetricNext(const size_t, unsigned& indexA, unsigned& indexB) {
+  if (++indexB>indexA) {
+    indexA++;
+    indexB=0;
+  }
+};
+
+inline
+bool indexmatrix::RowMajorLayout::SymmetricIsField(const size_t, const unsigned, const unsigned)
+  {return true;};
+
+inline
+size_t indexmatrix::RowMajorLayout::AsymmetricSize(const size_t biSize)
+  {return biSize*biSize;};
+
+inline
+size_t indexmatrix::RowMajorLayout::AsymmetricIndex(const size_t biSize, const size_t indexA, const size_t indexB)
+  {return indexA*biSize+indexB;};
+
+inline
+std::pair<unsigned, unsigned> indexmatrix::RowMajorLayout::AsymmetricBiIndex(const size_t biSize, const size_t index) {
+  const size_t indexA = index / biSize;
+  return std::make_pair(indexA, index-biSize*indexA);
+};
+
+inline
+void indexmatrix::RowMajorLayout::AsymmetricNext(const size_t biSize, unsigned& indexA, unsigned& indexB) {
+  if (++indexB==biSize) {
+    indexA++;
+    indexB=0;
+  }
+};
+
+inline
+bool indexmatrix::RowMajorLayout::AsymmetricIsField(const size_t, const unsigned, const unsigned)
+  {return true;};
+
+#if SERIALIZATION_ENABLED
+template <class Layout, class Archive>
+void indexmatrix::ArchiveLayoutTag(Archive& ar, const unsigned version) {
+  uint32_t tag = version ? Layout::tag : RowMajorLayout::tag;
+  if (version)
+    ar & SERIALIZATION_NS::make_nvp("LayoutTag", tag);
+  if (tag!=Layout::tag)
+    log_fatal("archive holds the fields in layout %u instead of layout %u", unsigned(tag), unsigned(Layout::tag));
+};
+#endif //SERIALIZATION_ENABLED
+
 
 //===================== CLASS AsymmetricIndexMatrix =========================
   
 #if SERIALIZATION_ENABLED 
-template <typename Base, class Internal>
+template <typename Base, class Internal, class Layout>
 template <class Archive>
-void indexmatrix::AsymmetricIndexMatrix<Base, Internal>::serialize(Archive & ar, const unsigned version) {
+void indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::serialize(Archive & ar, const unsigned version) {
+  ArchiveLayoutTag<Layout>(ar, version);
   typedef IndexMatrix<Base, Internal> IM;
   ar & SERIALIZATION_BASE_OBJECT_NVP( IM );
 };
 
 namespace SERIALIZATION_NS_BASE { namespace serialization {
-  template<class Archive, typename Base, class Internal>
+  template<class Archive, typename Base, class Internal, class Layout>
   inline void save_construct_data(
-    Archive & ar, const indexmatrix::AsymmetricIndexMatrix<Base,Internal> * t, const unsigned int file_version)
-  { ar << SERIALIZATION_NS::make_nvp("biSize", t->biSize_); };
+    Archive & ar, const indexmatrix::AsymmetricIndexMatrix<Base,Internal,Layout> * t, const unsigned int file_version)
+  {
+    const size_t biSize = t->GetBiSize();
+    ar << SERIALIZATION_NS::make_nvp("biSize", biSize);
+  };
 
-  template<class Archive, typename Base, class Internal>
+  template<class Archive, typename Base, class Internal, class Layout>
   inline void load_construct_data(
-    Archive & ar, indexmatrix::AsymmetricIndexMatrix<Base,Internal> * t, const unsigned int file_version)
+    Archive & ar, indexmatrix::AsymmetricIndexMatrix<Base,Internal,Layout> * t, const unsigned int file_version)
   {
     size_t biSize;
     ar >> SERIALIZATION_NS::make_nvp("biSize", biSize);
-    ::new(t)indexmatrix::AsymmetricIndexMatrix<Base, Internal>(biSize);
+    ::new(t)indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>(biSize);
   };
 }}; // namespace ...
 #endif
 
-template <typename Base, class Internal>
-indexmatrix::AsymmetricIndexMatrix<Base, Internal>::AsymmetricIndexMatrix(const unsigned biSize) :
-  IndexMatrix<Base, Internal>(biSize, biSize*biSize)
+template <typename Base, class Internal, class Layout>
+indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::AsymmetricIndexMatrix(const unsigned biSize) :
+  IndexMatrixAccess<Base, Internal, AsymmetricIndexMatrix>(biSize, Layout::AsymmetricSize(biSize))
 {};  
+
+template <typename Base, class Internal, class Layout>
+indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::AsymmetricIndexMatrix(const unsigned biSize, const Internal& internal) :
+  IndexMatrixAccess<Base, Internal, AsymmetricIndexMatrix>(biSize, internal)
+{
+  if (internal.size()!=Layout::AsymmetricSize(biSize))
+    log_fatal("storage does not hold the fields of this matrix");
+};  
   
 // template <typename Base, class Internal>
 // indexmatrix::AsymmetricIndexMatrix<Base, Internal>::AsymmetricIndexMatrix(const SymmetricIndexMatrix<Base, Internal>& other) :
@@ -452,80 +1603,132 @@ indexmatrix::AsymmetricIndexMatrix<Base, Internal>::AsymmetricIndexMatrix(const
 //   }
 // };
 
-template <typename Base, class Internal>
-unsigned indexmatrix::AsymmetricIndexMatrix<Base, Internal>::BiIndex_To_UniIndex(const unsigned indexA, const unsigned indexB) const
-  {return (indexA*IndexMatrix<Base, Internal>::biSize_)+indexB;};  
+template <typename Base, class Internal, class Layout>
+inline size_t indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::BiIndex_To_UniIndex(const unsigned indexA, const unsigned indexB) const
+  {return Layout::AsymmetricIndex(this->biSize_, indexA, indexB);};  
 
-template <typename Base, class Internal>
+template <typename Base, class Internal, class Layout>
 std::pair<unsigned, unsigned> 
-indexmatrix::AsymmetricIndexMatrix<Base, Internal>::UniIndex_To_BiIndex(const unsigned index) const 
+indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::UniIndex_To_BiIndex(const size_t index) const 
 {
-  const unsigned indexA = index / IndexMatrix<Base, Internal>::biSize_;
-  const unsigned indexB = index - IndexMatrix<Base, Internal>::biSize_*indexA;
-  return std::make_pair(indexA, indexB);
+  if (index >= this->internal_.size())
+    log_fatal("out of indexable range");
+  const std::pair<unsigned, unsigned> biIndex = Layout::AsymmetricBiIndex(this->biSize_, index);
+  if (!Layout::AsymmetricIsField(this->biSize_, biIndex.first, biIndex.second))
+    log_fatal("index %zu is padding of the layout", index);
+  return biIndex;
 };
+
+template <typename Base, class Internal, class Layout>
+inline std::pair<unsigned, unsigned> 
+indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::Position_To_BiIndex(const size_t index) const 
+  {return Layout::AsymmetricBiIndex(this->biSize_, index);};
+
+template <typename Base, class Internal, class Layout>
+inline void indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::NextBiIndex(
+  unsigned& indexA,
+  unsigned& indexB) const
+  {Layout::AsymmetricNext(this->biSize_, indexA, indexB);};
+
+template <typename Base, class Internal, class Layout>
+inline bool indexmatrix::AsymmetricIndexMatrix<Base, Internal, Layout>::IsField(
+  const unsigned indexA,
+  const unsigned indexB) const
+  {return Layout::AsymmetricIsField(this->biSize_, indexA, indexB);};
   
 
 //===================== CLASS SymmetricIndexMatrix =========================
 
 #if SERIALIZATION_ENABLED
 namespace SERIALIZATION_NS_BASE { namespace serialization {
-  template<class Archive, typename Base, class Internal>
+  template<class Archive, typename Base, class Internal, class Layout>
   inline void save_construct_data(
-      Archive & ar, const indexmatrix::SymmetricIndexMatrix<Base,Internal> * t, const unsigned int file_version)
-  { ar << SERIALIZATION_NS::make_nvp("biSize", t->biSize_); };
+      Archive & ar, const indexmatrix::SymmetricIndexMatrix<Base,Internal,Layout> * t, const unsigned int file_version)
+  {
+    const size_t biSize = t->GetBiSize();
+    ar << SERIALIZATION_NS::make_nvp("biSize", biSize);
+  };
 
-  template<class Archive, typename Base, class Internal>
+  template<class Archive, typename Base, class Internal, class Layout>
   inline void load_construct_data(
-    Archive & ar, indexmatrix::SymmetricIndexMatrix<Base,Internal> * t, const unsigned int file_version)
+    Archive & ar, indexmatrix::SymmetricIndexMatrix<Base,Internal,Layout> * t, const unsigned int file_version)
   {
     size_t biSize;
     ar >> SERIALIZATION_NS::make_nvp("biSize", biSize);
-    ::new(t)indexmatrix::SymmetricIndexMatrix<Base, Internal>(biSize);
+    ::new(t)indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>(biSize);
   };
 }}; // namespace ...
 
-template <typename Base, class Internal>
+template <typename Base, class Internal, class Layout>
 template <class Archive>
-void indexmatrix::SymmetricIndexMatrix<Base, Internal>::serialize(Archive & ar, const unsigned version) {
+void indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::serialize(Archive & ar, const unsigned version) {
+  ArchiveLayoutTag<Layout>(ar, version);
   typedef IndexMatrix<Base, Internal> IM;
   ar & SERIALIZATION_BASE_OBJECT_NVP( IM );
 };
 #endif //SERIALIZATION_ENABLED
 
-template <typename Base, class Internal>
-indexmatrix::SymmetricIndexMatrix<Base, Internal>::SymmetricIndexMatrix (const unsigned biSize) :
-  IndexMatrix<Base, Internal>(biSize, (biSize*biSize+biSize)/2) 
+template <typename Base, class Internal, class Layout>
+indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::SymmetricIndexMatrix (const unsigned biSize) :
+  IndexMatrixAccess<Base, Internal, SymmetricIndexMatrix>(biSize, Layout::SymmetricSize(biSize)) 
 {};
+
+template <typename Base, class Internal, class Layout>
+indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::SymmetricIndexMatrix (const unsigned biSize, const Internal& internal) :
+  IndexMatrixAccess<Base, Internal, SymmetricIndexMatrix>(biSize, internal) 
+{
+  if (internal.size()!=Layout::SymmetricSize(biSize))
+    log_fatal("storage does not hold the fields of this matrix");
+};
   
-template <typename Base, class Internal>
-unsigned indexmatrix::SymmetricIndexMatrix<Base, Internal>::BiIndex_To_UniIndex(
+template <typename Base, class Internal, class Layout>
+template <class InputIterator>
+void indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::SetRow(
+  const unsigned indexA,
+  InputIterator first)
+{
+  for (size_t indexB=0; indexB<=indexA; indexB++, ++first)
+    this->internal_[Layout::SymmetricIndex(this->biSize_, indexA, indexB)] = *first;
+};
+  
+template <typename Base, class Internal, class Layout>
+inline size_t indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::BiIndex_To_UniIndex(
   const unsigned indexA,
   const unsigned indexB) const
 {
-  if (indexB > indexA)
-    return BiIndex_To_UniIndex(indexB, indexA);
-  return (indexA*indexA+indexA)/2+indexB; 
+  //order the pair by min/max instead of recursing, which compiles to conditional moves
+  return Layout::SymmetricIndex(this->biSize_, std::max(indexA, indexB), std::min(indexA, indexB));
 };
 
-template <typename Base, class Internal>
+template <typename Base, class Internal, class Layout>
 std::pair<unsigned, unsigned> 
-indexmatrix::SymmetricIndexMatrix<Base, Internal>::UniIndex_To_BiIndex(const unsigned index) const 
+indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::UniIndex_To_BiIndex(const size_t index) const 
 {
-  if (index > (IndexMatrix<Base, Internal>::biSize_*IndexMatrix<Base, Internal>::biSize_+IndexMatrix<Base, Internal>::biSize_)/2 + IndexMatrix<Base, Internal>::biSize_)
+  if (index >= this->internal_.size())
     log_fatal("out of indexable range");
-  
-  uint64_t indexA=0;
-  uint64_t offset = (indexA*indexA+indexA)/2;
-  while (offset <= index) {
-    indexA++;
-    offset = (indexA*indexA+indexA)/2;
-  }
-  indexA--;
-  const uint64_t indexB = index - (indexA*indexA+indexA)/2;
-  return std::make_pair(indexA, indexB);
+  const std::pair<unsigned, unsigned> biIndex = Layout::SymmetricBiIndex(this->biSize_, index);
+  if (!Layout::SymmetricIsField(this->biSize_, biIndex.first, biIndex.second))
+    log_fatal("index %zu is padding of the layout", index);
+  return biIndex;
 };
 
+template <typename Base, class Internal, class Layout>
+inline std::pair<unsigned, unsigned> 
+indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::Position_To_BiIndex(const size_t index) const 
+  {return Layout::SymmetricBiIndex(this->biSize_, index);};
+
+template <typename Base, class Internal, class Layout>
+inline void indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::NextBiIndex(
+  unsigned& indexA,
+  unsigned& indexB) const
+  {Layout::SymmetricNext(this->biSize_, indexA, indexB);};
+
+template <typename Base, class Internal, class Layout>
+inline bool indexmatrix::SymmetricIndexMatrix<Base, Internal, Layout>::IsField(
+  const unsigned indexA,
+  const unsigned indexB) const
+  {return Layout::SymmetricIsField(this->biSize_, indexA, indexB);};
+
 //===================== CLASS SymmetricIndexMatrix_Double =========================
 
 #if SERIALIZATION_ENABLED
@@ -586,6 +1789,17 @@ void indexmatrix::AsymmetricIndexMatrix_Double::serialize(Archive & ar, const un
 
 //===================== CLASS SymmetricIndexMatrix_Bool =========================
 
+template <class Predicate>
+indexmatrix::SymmetricIndexMatrix_Bool::SymmetricIndexMatrix_Bool (
+  const unsigned biSize,
+  const Predicate& predicate,
+  const unsigned nThreads,
+  typename boost::disable_if<boost::is_arithmetic<Predicate> >::type*)
+: SymmetricIndexMatrix<bool, boost::dynamic_bitset<> >(biSize)
+{
+  SetFromPredicate(predicate, nThreads);
+};
+
 #if SERIALIZATION_ENABLED
 namespace SERIALIZATION_NS_BASE { namespace serialization {
   template<class Archive>
@@ -615,6 +1829,17 @@ void indexmatrix::SymmetricIndexMatrix_Bool::serialize(Archive & ar, const unsig
 
 //===================== CLASS AsymmetricIndexMatrix_Bool =========================
 
+template <class Predicate>
+indexmatrix::AsymmetricIndexMatrix_Bool::AsymmetricIndexMatrix_Bool (
+  const unsigned biSize,
+  const Predicate& predicate,
+  const unsigned nThreads,
+  typename boost::disable_if<boost::is_arithmetic<Predicate> >::type*)
+: AsymmetricIndexMatrix<bool, boost::dynamic_bitset<> >(biSize)
+{
+  SetFromPredicate(predicate, nThreads);
+};
+
 #if SERIALIZATION_ENABLED
 namespace SERIALIZATION_NS_BASE { namespace serialization {
   template<class Archive>
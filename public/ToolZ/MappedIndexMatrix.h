@@ -0,0 +1,339 @@
+/**
+ * \file MappedIndexMatrix.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Read-only IndexMatrix storage backed by a memory-mapped file;
+ * all processes mapping the same file share a single copy in the page cache
+ */
+
+#ifndef MAPPEDINDEXMATRIX_H
+#define MAPPEDINDEXMATRIX_H
+
+#include "ToolZ/IndexMatrix.h"
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+///version of the binary layout of mapped matrix files
+static const unsigned mappedindexmatrix_version_ = 0;
+
+namespace indexmatrix {
+  /**
+   * @brief the header at the start of a mapped matrix file; the fields follow at 'dataOffset',
+   * which is page-aligned, as a plain array in the storage order of the layout and in the byte-order of the writer
+   */
+  struct MappedFileHeader {
+    ///identifies the file as a mapped matrix: "TZIDXMAP"
+    char magic[8];
+    ///the version of the file layout; mappedindexmatrix_version_
+    uint32_t version;
+    ///marker written in the byte-order of the writer
+    uint32_t byteOrder;
+    ///sizeof of a field
+    uint32_t fieldSize;
+    ///the kind of a field: 0 unsigned integer, 1 signed integer, 2 floating point
+    uint32_t fieldKind;
+    ///1 for a symmetric, 0 for an asymmetric matrix
+    uint32_t symmetric;
+    ///the tag of the layout of the fields; see RowMajorLayout::tag
+    uint32_t layout;
+    ///the size of the indexable range
+    uint64_t biSize;
+    ///the number of stored fields
+    uint64_t nFields;
+    ///checksum of the geometry the matrix was built from; see PositionService::GetChecksum
+    uint64_t checksum;
+    ///offset of the fields from the start of the file
+    uint64_t dataOffset;
+
+    ///the header for a matrix of fields of type T
+    template <typename T>
+    static MappedFileHeader Create(const bool symmetric,
+                                   const unsigned layout,
+                                   const uint64_t biSize,
+                                   const uint64_t nFields,
+                                   const uint64_t checksum);
+    ///the code of fieldKind for type T
+    template <typename T>
+    static uint32_t FieldKind();
+  };
+
+  /**
+   * @brief a whole file mapped read-only into memory; the header is verified on opening
+   * NOTE the file must not be modified while it is mapped; WriteMapped replaces files atomically
+   */
+  class MappedFile {
+  private:
+    ///start of the mapping
+    void* address_;
+    ///length of the mapping
+    size_t length_;
+
+    ///no copies; share through MappedFileConstPtr instead
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+  public:
+    /// constructor: map the file; log_fatal if it can not be mapped, or is no mapped matrix of this version
+    /// @param path the file
+    MappedFile(const std::string& path);
+    /// destructor: unmap the file
+    ~MappedFile();
+    ///the verified header
+    const MappedFileHeader& GetHeader() const;
+    ///the start of the fields
+    const void* GetFields() const;
+  };
+
+  typedef boost::shared_ptr<const MappedFile> MappedFileConstPtr;
+
+  /**
+   * @brief a file written aside, to a temporary file of a unique name in the same directory, and renamed into place by Commit;
+   * the temporary file is removed again if the writer is destroyed before Commit, also when a write raised log_fatal
+   */
+  class MappedFileWriter {
+  private:
+    ///the file to replace
+    std::string path_;
+    ///the temporary file, which is written
+    std::string tmpPath_;
+    ///descriptor of the temporary file; -1 once it is closed
+    int fd_;
+
+    ///no copies
+    MappedFileWriter(const MappedFileWriter&);
+    MappedFileWriter& operator=(const MappedFileWriter&);
+
+  public:
+    /// constructor: create the temporary file; log_fatal if it can not be created
+    /// @param path the file to replace
+    MappedFileWriter(const std::string& path);
+    /// destructor: remove the temporary file, unless it was committed
+    ~MappedFileWriter();
+    ///append bytes to the temporary file; log_fatal on failure
+    void Write(const void* data, const size_t size);
+    ///close the temporary file and rename it to the path; log_fatal on failure
+    void Commit();
+  };
+
+  /**
+   * @brief a read-only array of fields in a MappedFile, for use as 'Internal' of an IndexMatrix;
+   * copies share the mapping, which lives as long as any of them.
+   * As there is no writable operator[], Set and SetRow do not compile for matrices over this storage
+   * @template T an arithmetic type, as it was written to the file
+   */
+  template <typename T>
+  class MappedVector {
+    BOOST_STATIC_ASSERT_MSG(boost::is_arithmetic<T>::value && !(boost::is_same<T, bool>::value),
+      "MappedVector holds arithmetic fields; bool is not supported");
+  private:
+    ///the mapping
+    MappedFileConstPtr file_;
+    ///the fields in the mapping
+    const T* fields_;
+    ///the number of fields
+    size_t size_;
+
+  public:
+    /// constructor; log_fatal if the file does not hold fields of type T
+    MappedVector(const MappedFileConstPtr& file);
+    ///read a field
+    T operator[](const size_t index) const;
+    ///the number of fields
+    size_t size() const;
+    ///the fields
+    const T* data() const;
+  };
+
+  ///@{
+  /** @brief write the fields of a matrix to a file, which can be opened with MappedSymmetricIndexMatrix::Open
+   * or MappedAsymmetricIndexMatrix::Open; the file is written aside and then renamed into place,
+   * so that processes which already map an older version keep a consistent view
+   * @param path the file
+   * @param matrix the matrix; its fields are written as type Base
+   * @param checksum of the geometry the matrix was built from
+   */
+  template <typename Base, class Internal, class Layout>
+  void WriteMapped(const std::string& path,
+                   const SymmetricIndexMatrix<Base, Internal, Layout>& matrix,
+                   const uint64_t checksum);
+  template <typename Base, class Internal, class Layout>
+  void WriteMapped(const std::string& path,
+                   const AsymmetricIndexMatrix<Base, Internal, Layout>& matrix,
+                   const uint64_t checksum);
+  ///@}
+
+  ///write a header and the fields in 'internal' as type Base; log_fatal on failure
+  template <typename Base, class Internal>
+  void WriteMappedFields(const std::string& path,
+                         const MappedFileHeader& header,
+                         const Internal& internal);
+
+  ///verify that a mapped file holds a matrix of this shape, built from this geometry; log_fatal if not
+  void VerifyMappedFile(const std::string& path,
+                        const MappedFileHeader& found,
+                        const MappedFileHeader& expected);
+
+  template <typename Base, class Layout = RowMajorLayout>
+  struct MappedSymmetricIndexMatrix {
+    ///shorthand for the read-only SymmetricIndexMatrix over a mapped file
+    typedef SymmetricIndexMatrix<Base, MappedVector<Base>, Layout> type;
+    /** @brief map a file written by WriteMapped; log_fatal if it holds another kind of matrix,
+     * or was built from another geometry
+     * @param path the file
+     * @param checksum of the geometry, which the matrix is expected to be built from
+     */
+    static type Open(const std::string& path,
+                     const uint64_t checksum);
+  };
+
+  template <typename Base, class Layout = RowMajorLayout>
+  struct MappedAsymmetricIndexMatrix {
+    ///shorthand for the read-only AsymmetricIndexMatrix over a mapped file
+    typedef AsymmetricIndexMatrix<Base, MappedVector<Base>, Layout> type;
+    /** @brief map a file written by WriteMapped; log_fatal if it holds another kind of matrix,
+     * or was built from another geometry
+     * @param path the file
+     * @param checksum of the geometry, which the matrix is expected to be built from
+     */
+    static type Open(const std::string& path,
+                     const uint64_t checksum);
+  };
+}; //namespace indexmatrix
+
+
+//========================================================
+//==================== IMPLEMENTATIONS ===================
+//========================================================
+
+template <typename T>
+uint32_t indexmatrix::MappedFileHeader::FieldKind()
+  {return !std::numeric_limits<T>::is_integer ? 2 : (std::numeric_limits<T>::is_signed ? 1 : 0);};
+
+template <typename T>
+indexmatrix::MappedFileHeader indexmatrix::MappedFileHeader::Create(
+  const bool symmetric,
+  const unsigned layout,
+  const uint64_t biSize,
+  const uint64_t nFields,
+  const uint64_t checksum)
+{
+  const MappedFileHeader header = {
+    {'T','Z','I','D','X','M','A','P'},
+    mappedindexmatrix_version_,
+    0x01020304,
+    sizeof(T),
+    FieldKind<T>(),
+    symmetric,
+    layout,
+    biSize,
+    nFields,
+    checksum,
+    4096 };
+  return header;
+};
+
+template <typename T>
+indexmatrix::MappedVector<T>::MappedVector(const MappedFileConstPtr& file) :
+  file_(file),
+  fields_(static_cast<const T*>(file->GetFields())),
+  size_(file->GetHeader().nFields)
+{
+  if (file->GetHeader().fieldSize!=sizeof(T) || file->GetHeader().fieldKind!=MappedFileHeader::FieldKind<T>())
+    log_fatal("mapped file does not hold fields of this type");
+};
+
+template <typename T>
+inline T indexmatrix::MappedVector<T>::operator[](const size_t index) const
+  {return fields_[index];};
+
+template <typename T>
+inline size_t indexmatrix::MappedVector<T>::size() const
+  {return size_;};
+
+template <typename T>
+inline const T* indexmatrix::MappedVector<T>::data() const
+  {return fields_;};
+
+template <typename Base, class Internal>
+void indexmatrix::WriteMappedFields(
+  const std::string& path,
+  const MappedFileHeader& header,
+  const Internal& internal)
+{
+  MappedFileWriter writer(path);
+  writer.Write(&header, sizeof(header));
+  const std::vector<char> padding(header.dataOffset-sizeof(header), 0);
+  writer.Write(&padding[0], padding.size());
+
+  //convert and write the fields in chunks, as 'Internal' may be any storage
+  std::vector<Base> chunk(4096);
+  for (size_t first=0; first<internal.size(); first+=chunk.size()) {
+    const size_t n = std::min(chunk.size(), internal.size()-first);
+    for (size_t i=0; i<n; i++)
+      chunk[i] = internal[first+i];
+    writer.Write(&chunk[0], n*sizeof(Base));
+  }
+  writer.Commit();
+};
+
+template <typename Base, class Internal, class Layout>
+void indexmatrix::WriteMapped(
+  const std::string& path,
+  const SymmetricIndexMatrix<Base, Internal, Layout>& matrix,
+  const uint64_t checksum)
+{
+  WriteMappedFields<Base>(path,
+    MappedFileHeader::Create<Base>(true, Layout::tag, matrix.GetBiSize(), matrix.GetInternal().size(), checksum),
+    matrix.GetInternal());
+};
+
+template <typename Base, class Internal, class Layout>
+void indexmatrix::WriteMapped(
+  const std::string& path,
+  const AsymmetricIndexMatrix<Base, Internal, Layout>& matrix,
+  const uint64_t checksum)
+{
+  WriteMappedFields<Base>(path,
+    MappedFileHeader::Create<Base>(false, Layout::tag, matrix.GetBiSize(), matrix.GetInternal().size(), checksum),
+    matrix.GetInternal());
+};
+
+template <typename Base, class Layout>
+typename indexmatrix::MappedSymmetricIndexMatrix<Base, Layout>::type
+indexmatrix::MappedSymmetricIndexMatrix<Base, Layout>::Open(
+  const std::string& path,
+  const uint64_t checksum)
+{
+  const MappedFileConstPtr file = boost::make_shared<const MappedFile>(path);
+  const uint64_t biSize = file->GetHeader().biSize;
+  VerifyMappedFile(path, file->GetHeader(),
+    MappedFileHeader::Create<Base>(true, Layout::tag, biSize, Layout::SymmetricSize(biSize), checksum));
+  return type(biSize, MappedVector<Base>(file));
+};
+
+template <typename Base, class Layout>
+typename indexmatrix::MappedAsymmetricIndexMatrix<Base, Layout>::type
+indexmatrix::MappedAsymmetricIndexMatrix<Base, Layout>::Open(
+  const std::string& path,
+  const uint64_t checksum)
+{
+  const MappedFileConstPtr file = boost::make_shared<const MappedFile>(path);
+  const uint64_t biSize = file->GetHeader().biSize;
+  VerifyMappedFile(path, file->GetHeader(),
+    MappedFileHeader::Create<Base>(false, Layout::tag, biSize, Layout::AsymmetricSize(biSize), checksum));
+  return type(biSize, MappedVector<Base>(file));
+};
+
+#endif //MAPPEDINDEXMATRIX_H
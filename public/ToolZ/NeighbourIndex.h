@@ -0,0 +1,158 @@
+/**
+ * \file NeighbourIndex.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Lists for each hashed DOM all DOMs within a fixed radius, ordered by distance
+ */
+
+#ifndef NEIGHBOURINDEX_H
+#define NEIGHBOURINDEX_H
+
+#include "ToolZ/OMKeyHash.h"
+#include "ToolZ/PositionService.h"
+#include "ToolZ/HashedGeometry.h"
+
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+//============ CLASS NeighbourIndex ==========
+
+/**
+  * An adjacency list of all DOMs within a radius R of each DOM, so that range queries do not need
+  * to scan a whole row of the DistanceService.
+  * The neighbours are stored in compressed sparse row layout: one contiguous block per DOM,
+  * ordered by increasing distance (ties by hash); the DOM itself is not listed as its own neighbour.
+  * Distances are exact, as computed from the PositionService
+  * NOTE the index is immutable after construction, so all methods are thread-safe
+  */
+class NeighbourIndex {
+public:
+  /// which DOMs are considered as neighbours
+  enum Constraint {
+    /// all DOMs within a sphere of radius R
+    Spherical = 0,
+    /// all DOMs within a slab of half-height R; the distance is the vertical distance only
+    ZOnly = 1,
+    /// only DOMs on the same string within a sphere of radius R
+    StringOnly = 2
+  };
+
+  typedef boost::iterator_range<const CompactHash*> NeighbourRange;
+  typedef boost::iterator_range<const double*> DistanceRange;
+
+private: //parameters
+  /// a hasher for translation of OMKeys to indeces (hashes)
+  const CompactOMKeyHashServiceConstPtr hasher_;
+  /// the radius within which DOMs are neighbours
+  const double radius_;
+  /// the applied constraint
+  const Constraint constraint_;
+
+private: //properties
+  /// the neighbours of DOM i are at [offsets_[i], offsets_[i+1]); HashSize()+1 entries
+  std::vector<size_t> offsets_;
+  /// the neighbours of all DOMs in hash order, each block ordered by distance
+  std::vector<CompactHash> neighbours_;
+  /// the distances to the neighbours, in the same layout as neighbours_
+  std::vector<double> distances_;
+
+private:
+  ///fill the adjacency from the positions
+  void Build(const PositionService& posService);
+
+public:
+  /** @brief constructor
+   * @param hashedGeo the hashed geometry to index
+   * @param radius the radius within which DOMs are neighbours
+   * @param constraint which DOMs are considered as neighbours
+   */
+  NeighbourIndex(
+    const HashedGeometryConstPtr& hashedGeo,
+    const double radius,
+    const Constraint constraint = Spherical);
+
+  /** @brief constructor
+   * @param posService the hashed positions to index
+   * @param radius the radius within which DOMs are neighbours
+   * @param constraint which DOMs are considered as neighbours
+   */
+  NeighbourIndex(
+    const PositionServiceConstPtr& posService,
+    const double radius,
+    const Constraint constraint = Spherical);
+
+  /// the number of neighbours of this DOM
+  size_t GetNNeighbours(const CompactHash a) const;
+
+  /// the neighbours of this DOM, ordered by increasing distance
+  NeighbourRange GetNeighbours(const CompactHash a) const;
+  /// the distances to the neighbours of this DOM, in the order of GetNeighbours()
+  DistanceRange GetDistances(const CompactHash a) const;
+
+  /** @brief the neighbours of this DOM which are closer than a smaller radius; the leading part of GetNeighbours()
+   * @param a hashed DOMindex
+   * @param radius the radius; needs to be smaller or equal the radius of the index
+   */
+  NeighbourRange GetNeighboursWithin(
+    const CompactHash a,
+    const double radius) const;
+
+  /// the number of neighbour-pairs stored, counting each direction
+  size_t GetSize() const;
+
+  /// Get the radius within which DOMs are neighbours
+  double GetRadius() const;
+  /// Get the applied constraint
+  Constraint GetConstraint() const;
+  /// Get the internal Hasher
+  CompactOMKeyHashServiceConstPtr GetHashService() const;
+};
+
+typedef boost::shared_ptr<NeighbourIndex> NeighbourIndexPtr;
+typedef boost::shared_ptr<const NeighbourIndex> NeighbourIndexConstPtr;
+
+
+//========================================================
+//==================== IMPLERMENTATIONS ==================
+//========================================================
+
+inline
+size_t NeighbourIndex::GetNNeighbours(const CompactHash a) const
+  { return offsets_.at(a+1)-offsets_[a]; };
+
+inline
+NeighbourIndex::NeighbourRange
+NeighbourIndex::GetNeighbours(const CompactHash a) const {
+  const CompactHash* base = neighbours_.data();
+  return NeighbourRange(base+offsets_.at(a), base+offsets_.at(a+1));
+};
+
+inline
+NeighbourIndex::DistanceRange
+NeighbourIndex::GetDistances(const CompactHash a) const {
+  const double* base = distances_.data();
+  return DistanceRange(base+offsets_.at(a), base+offsets_.at(a+1));
+};
+
+inline
+size_t NeighbourIndex::GetSize() const
+  { return neighbours_.size(); };
+
+inline
+double NeighbourIndex::GetRadius() const
+  { return radius_; };
+
+inline
+NeighbourIndex::Constraint NeighbourIndex::GetConstraint() const
+  { return constraint_; };
+
+inline
+CompactOMKeyHashServiceConstPtr
+NeighbourIndex::GetHashService() const
+  { return hasher_; };
+
+#endif // NEIGHBOURINDEX_H
@@ -14,9 +14,15 @@
 #ifndef OMKEYHASH_H
 #define OMKEYHASH_H
 
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
 #include "icetray/OMKey.h"
 #include "dataclasses/geometry/I3Geometry.h"
 
+#include <boost/iterator/filter_iterator.hpp>
+
 //serialization
 #include "ToolZ/__SERIALIZATION.h"
 static const unsigned omkeyhash_version_ = 0;
@@ -24,6 +30,9 @@ static const unsigned omkeyhash_version_ = 0;
 /// the new Hash object for OMKeys
 typedef unsigned int CompactHash;
 
+/// sentinel value for OMKeys, which are not hashed
+static const CompactHash INVALID_HASH = std::numeric_limits<CompactHash>::max();
+
 /// failitate extraction from a general I3Map(OMkey, value)
 template <class mapped>
 std::set<OMKey> 
@@ -36,6 +45,9 @@ std::set<OMKey> ExtractOMKeys(
   const I3GeometryConstPtr& geo);
 
 
+/// forward declaration, see HashedOMKeySet.h
+class HashedOMKeySet;
+
 //forward declarations for serialization
 #if SERIALIZATION_ENABLED
 class CompactOMKeyHashService;
@@ -81,16 +93,67 @@ private:
   void serialize(Archive & ar, const unsigned int version);
 #endif //SERIALIZATION_ENABLED
 
+private:
+  /**
+   * A dense table spanning the bounding box (string, om, pmt) of all hashed OMKeys;
+   * each field holds the hash of that OMKey or INVALID_HASH if the OMKey is not hashed
+   */
+  struct LookupTable {
+    ///lower corner of the bounding box
+    int minString_;
+    unsigned int minOM_;
+    unsigned int minPMT_;
+    ///extent of the bounding box
+    unsigned int nStrings_;
+    unsigned int nOMs_;
+    unsigned int nPMTs_;
+    ///the table itself; empty if the keyspace was too sparse to be tabulated
+    std::vector<CompactHash> table_;
+    
+    ///constructor: empty table
+    LookupTable();
+    ///does this table hold any entries
+    bool Empty() const;
+    ///look up the hash of this OMKey; INVALID_HASH if not hashed
+    CompactHash Lookup(const OMKey& omkey) const;
+  };
+  
+  ///maximal number of table fields per hashed OMKey before falling back to the hashmap_
+  static const unsigned int lookup_max_sparsity_ = 8;
+  
 private:
   ///each hash value can be translated to an OMKey; this vector is ordered and fixed on construction
   const std::vector<OMKey> omkeyvec_; //should be const but cannot be for practible reasons
-  ///each OMKey has a consecutive hash value
+  ///each OMKey has a consecutive hash value; dense table for direct access
+  const LookupTable lookup_;
+  ///each OMKey has a consecutive hash value; only filled if the lookup_ is empty (very sparse keyspaces)
   const std::map<OMKey, CompactHash> hashmap_; //NOTE should be const, but the overhead is just too much (serialization::load_constuct_data)
 
 private: //internal methods (for constructors)
-///create the hashmap from an omkey-vec
+///get the OMKey from an entry in a range of OMKeys
+static
+const OMKey& KeyOf(const OMKey& omkey);
+
+///get the OMKey from an entry in a range of OMKey-keyed pairs, like the entries of an I3Map
+template <class mapped>
+static
+const OMKey& KeyOf(const std::pair<const OMKey, mapped>& entry);
+
+///selects the entries of an OMKey-keyed map, which hold a non-empty series
+struct NonEmptyEntry {
+  template <class Entry>
+  bool operator()(const Entry& entry) const {return !entry.second.empty();};
+};
+
+///create the dense lookup table from an omkey-vec; stays empty if the keys are too sparse
 static
-std::map<OMKey, CompactHash> HashMap_From_OMKeyVec(const std::vector<OMKey>& omkeyvec);
+LookupTable LookupTable_From_OMKeyVec(const std::vector<OMKey>& omkeyvec);
+
+///create the hashmap from an omkey-vec, if the lookup table could not be used
+static
+std::map<OMKey, CompactHash> HashMap_From_OMKeyVec(
+  const std::vector<OMKey>& omkeyvec,
+  const LookupTable& lookup);
 
 // private:
 public:
@@ -108,12 +171,52 @@ public: //methods
   /// verify that all these omkeys are hashable
   bool VerifyAgainst(const std::set<OMKey>& omkeys) const;
   
+  /// verify that all these omkeys are hashable; a single bitset subset test
+  bool VerifyAgainst(const HashedOMKeySet& omkeys) const;
+  
   ///Get the OMKey to that hash
   OMKey OMKeyFromHash(const CompactHash hash) const;
   
   ///Get The Hash for this OMKey
   CompactHash HashFromOMKey(const OMKey omkey) const;
   
+  /** @brief Get the Hashes for a sorted range of OMKeys in one single pass
+   * works on ranges of OMKeys (std::set<OMKey>) as well as OMKey-keyed pairs (I3Map<OMKey, ...>)
+   * NOTE the range must be sorted; throws if any OMKey is not hashed
+   * @param first begin of the range
+   * @param last end of the range
+   * @return the hashes in the order of the range
+   */
+  template <class ForwardIterator>
+  std::vector<CompactHash> HashFromOMKeys(
+    ForwardIterator first,
+    ForwardIterator last) const;
+  
+  /** @brief Get the Hashes for a sorted range of OMKeys in one single pass, writing into a caller-provided buffer
+   * NOTE the range must be sorted; throws if any OMKey is not hashed
+   * @param first begin of the range
+   * @param last end of the range
+   * @param out output iterator to the buffer, which needs to hold as many elements as the range
+   * @return the output iterator past the last written hash
+   */
+  template <class InputIterator, class OutputIterator>
+  OutputIterator HashFromOMKeys(
+    InputIterator first,
+    InputIterator last,
+    OutputIterator out) const;
+  
+  /** @brief Get the Hashes for the OMKeys of the non-empty entries of a sorted OMKey-keyed map in one single pass;
+   * the OMKeys of empty entries are skipped, and so need not be hashed
+   * NOTE the range must be sorted; throws if the OMKey of any non-empty entry is not hashed
+   * @param first begin of the range
+   * @param last end of the range
+   * @return the hashes in the order of the non-empty entries
+   */
+  template <class ForwardIterator>
+  std::vector<CompactHash> HashFromOMKeysOfNonEmpty(
+    ForwardIterator first,
+    ForwardIterator last) const;
+  
   ///hasher holds this OMKey
   bool HoldsOMKey(const OMKey omkey) const;
   
@@ -123,6 +226,9 @@ public: //methods
   ///size of the table
   unsigned int HashSize() const;
   
+  ///is the dense lookup table in use (or the fallback hashmap)
+  bool IsDense() const;
+  
   ///returns all cached OMKeys
   std::set<OMKey> GetOMKeys() const;
 };
@@ -200,9 +306,26 @@ CompactOMKeyHashService::CompactOMKeyHashService (
   InputIterator first,
   InputIterator last) :
   omkeyvec_(first, last),
-  hashmap_(HashMap_From_OMKeyVec(omkeyvec_))
+  lookup_(LookupTable_From_OMKeyVec(omkeyvec_)),
+  hashmap_(HashMap_From_OMKeyVec(omkeyvec_, lookup_))
 {};
 
+inline
+bool CompactOMKeyHashService::LookupTable::Empty() const {
+  return table_.empty();
+};
+
+inline
+CompactHash CompactOMKeyHashService::LookupTable::Lookup(const OMKey& omkey) const {
+  //NOTE unsigned arithmetic: keys below the lower corner wrap around and fail the range check
+  const unsigned int s = unsigned(omkey.GetString()-minString_);
+  const unsigned int o = omkey.GetOM()-minOM_;
+  const unsigned int p = omkey.GetPMT()-minPMT_;
+  if (s>=nStrings_ || o>=nOMs_ || p>=nPMTs_)
+    return INVALID_HASH;
+  return table_[(s*nOMs_+o)*nPMTs_+p];
+};
+
 inline
 OMKey CompactOMKeyHashService::OMKeyFromHash(const CompactHash hash) const {
   return omkeyvec_.at(hash); //NOTE this throws exception if hash is greater than the number of hashed DOMs
@@ -210,12 +333,74 @@ OMKey CompactOMKeyHashService::OMKeyFromHash(const CompactHash hash) const {
   
 inline
 CompactHash CompactOMKeyHashService::HashFromOMKey(const OMKey omkey) const {
-  return hashmap_.at(omkey); //NOTE this throws exception if omkey does not exist in map
+  if (lookup_.Empty())
+    return hashmap_.at(omkey); //NOTE this throws exception if omkey does not exist in map
+  const CompactHash hash = lookup_.Lookup(omkey);
+  if (hash==INVALID_HASH)
+    throw std::out_of_range("OMKey is not hashed"); //NOTE same behaviour as the map
+  return hash;
+};
+
+inline
+const OMKey& CompactOMKeyHashService::KeyOf(const OMKey& omkey) {
+  return omkey;
+};
+
+template <class mapped>
+const OMKey& CompactOMKeyHashService::KeyOf(const std::pair<const OMKey, mapped>& entry) {
+  return entry.first;
+};
+
+template <class ForwardIterator>
+std::vector<CompactHash> CompactOMKeyHashService::HashFromOMKeys(
+  ForwardIterator first,
+  ForwardIterator last) const
+{
+  std::vector<CompactHash> hashes(std::distance(first, last));
+  HashFromOMKeys(first, last, hashes.begin());
+  return hashes;
+};
+
+template <class ForwardIterator>
+std::vector<CompactHash> CompactOMKeyHashService::HashFromOMKeysOfNonEmpty(
+  ForwardIterator first,
+  ForwardIterator last) const
+{
+  typedef boost::filter_iterator<NonEmptyEntry, ForwardIterator> NonEmptyIterator;
+  return HashFromOMKeys(NonEmptyIterator(first, last), NonEmptyIterator(last, last));
+};
+
+template <class InputIterator, class OutputIterator>
+OutputIterator CompactOMKeyHashService::HashFromOMKeys(
+  InputIterator first,
+  InputIterator last,
+  OutputIterator out) const
+{
+  if (!lookup_.Empty()) { //every single lookup is a direct table access anyways
+    for (; first!=last; ++first, ++out)
+      *out = HashFromOMKey(KeyOf(*first));
+    return out;
+  }
+  
+  //merge-walk the sorted range along the (equally sorted) omkeyvec_, so the hash is the position therein
+  std::vector<OMKey>::const_iterator vec_iter = omkeyvec_.begin();
+  const std::vector<OMKey>::const_iterator vec_end = omkeyvec_.end();
+  for (; first!=last; ++first, ++out) {
+    const OMKey& omkey = KeyOf(*first);
+    while (vec_iter!=vec_end && *vec_iter<omkey)
+      ++vec_iter;
+    if (vec_iter==vec_end || omkey<*vec_iter)
+      throw std::out_of_range("OMKey is not hashed or range is not sorted");
+    *out = CompactHash(vec_iter-omkeyvec_.begin());
+  }
+  return out;
 };
 
 inline
 bool CompactOMKeyHashService::HoldsOMKey(const OMKey omkey) const {
-  return (hashmap_.find(omkey) != hashmap_.end());
+  if (lookup_.Empty())
+    return (hashmap_.find(omkey) != hashmap_.end());
+  return (lookup_.Lookup(omkey) != INVALID_HASH);
 };
   
 inline
@@ -228,6 +413,11 @@ unsigned int CompactOMKeyHashService::HashSize() const {
   return omkeyvec_.size();
 };
 
+inline
+bool CompactOMKeyHashService::IsDense() const {
+  return !lookup_.Empty();
+};
+
 inline
 std::set<OMKey> CompactOMKeyHashService::GetOMKeys() const {
   return std::set<OMKey>(omkeyvec_.begin(),omkeyvec_.end());
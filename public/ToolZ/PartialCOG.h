@@ -26,11 +26,12 @@
 
 #include "ToolZ/OMKeyHash.h"
 #include "ToolZ/Hitclasses.h"
+#include "ToolZ/HitBatch.h"
 #include "ToolZ/PositionService.h"
 #include "dataclasses/physics/I3RecoPulse.h"
 
 /** compute the fraction of hits using quartiles of their hit-time order
-  * @param hits a set of hits
+  * @param tset an ordered set of hits, like std::set or FlatSet
   * @param nFrac number of fractions
   * @param startFrac start counting from this fraction 
   * @param endFrac end counting after this fraction (included)
@@ -38,9 +39,9 @@
   * @param min_inc include at least that many entries from the start of counting, default is 0
   * @param max_inc include no more than that many entries from the start of counting, default is INF
   */
-template<class T>
-std::set<T> Fraction_count (
-  const std::set<T>& tset,
+template<class ordered_set>
+ordered_set Fraction_count (
+  const ordered_set& tset,
   const size_t nFrac,
   const size_t startFrac, //natural counting
   const size_t endFrac, //natural counting
@@ -49,7 +50,7 @@ std::set<T> Fraction_count (
   const size_t max_inc=std::numeric_limits<size_t>::max());
 
 /** compute the fraction of hits using quartiles of their accumulated charge
-  * @param hits a set of hits
+  * @param tset an ordered set of hits, like std::set or FlatSet
   * @param nFrac number of fractions that should be used
   * @param getweight a function to retrieve a specific weight for every entry in tset
   * @param useFrac use that fraction (always absolute counting from the front)
@@ -57,9 +58,9 @@ std::set<T> Fraction_count (
   * @param min_inc include at least that many doms in the COG
   * @param max_inc include no more than that many doms in the COG
   */
-template <class T>
-std::set<T> Fraction_weight (
-  const std::set<T> tset,
+template <class T, class ordered_set>
+ordered_set Fraction_weight (
+  const ordered_set& tset,
   const boost::function<double (const T&)>& getweight,
   const size_t nFrac,
   const size_t startFrac, //natural counting
@@ -76,35 +77,45 @@ typedef std::pair<I3Position,double> I3PosTime;
 
 /**
  * Compute the COG of this part of Hits
- * @param hits a set of hits
- * @param useCharge weight each hit by its charge
+ * @param hits a time-ordered container of hits, like std::set or FlatSet
  * @return a pair of COG position and time (as average of the configured pulses)
  */
-template <class Hitclass>
-I3PosTime ComputeCOG_count(
+template <class HitContainer>
+I3PosTime ComputeCOG(
   const PositionServiceConstPtr& posService,
-  const std::set<Hitclass>& hits);
+  const HitContainer& hits);
 
 /**
  * Compute the COG of this part of Hits
- * @param hits a set of hits
+ * @param hits a time-ordered container of hits, like std::set or FlatSet
  * @param getweight a function to retrieve a specific weight for every entry in tset
  * @return a pair of COG position and time (as average of the configured pulses)
  */
-template <class Hitclass>
+template <class Hitclass, class HitContainer>
 I3PosTime ComputeCOG_weight(
   const PositionServiceConstPtr& posService,
-  const std::set<Hitclass>& hits,
+  const HitContainer& hits,
   const boost::function<double (const Hitclass&)>& getweight);
 
+/**
+ * Compute the COG of a span of hits in a HitBatch, reading the coordinates column-wise from the PositionService
+ * @param hits a span of hits
+ * @param useCharge weight each hit by its charge; the span needs to hold charges
+ * @return a pair of COG position and time (as average of the configured pulses)
+ */
+I3PosTime ComputeCOG(
+  const PositionServiceConstPtr& posService,
+  const HitSpan& hits,
+  const bool useCharge=false);
+
 //=========================================================================
 //======================= IMPLEMENTATIONS =================================
 //=========================================================================
 
 //_____________________________________________________________________________
-template<class T>
-std::set<T> Fraction_count (
-  const std::set<T>& tset,
+template<class ordered_set>
+ordered_set Fraction_count (
+  const ordered_set& tset,
   const size_t nFrac,
   const size_t startFrac, //natural counting
   const size_t endFrac, //natural counting
@@ -133,14 +144,14 @@ std::set<T> Fraction_count (
   
   const double n_per_frac = tset.size()/nFrac;
 
-  std::set<T> outtset;
+  ordered_set outtset(tset.key_comp());
   
   if (!reverseOrder) { //counting forward
     const size_t start_index = (unsigned long)std::ceil((startFrac-1)*n_per_frac);
     const size_t end_index = std::min((unsigned long)std::floor(endFrac*n_per_frac)-1, tset.size()-1);
     const size_t n_many = end_index-start_index +1;
     
-    typename std::set<T>::const_iterator tset_iter = tset.begin();
+    typename ordered_set::const_iterator tset_iter = tset.begin();
     for (size_t i=0; i<start_index; i++)
       tset_iter++;
     
@@ -158,18 +169,22 @@ std::set<T> Fraction_count (
     const size_t end_index = (unsigned long)std::ceil((endFrac-1)*n_per_frac);
     const size_t n_many = start_index-end_index +1;
 
-    typename std::set<T>::const_reverse_iterator tset_riter = tset.rbegin();
+    typename ordered_set::const_reverse_iterator tset_riter = tset.rbegin();
     for (size_t i=tset.size()-1; i>start_index; i--)
       ++tset_riter;
     
+    const typename ordered_set::const_reverse_iterator first_riter = tset_riter;
     size_t n_added = 0;
     while(tset_riter!=tset.rend()) {
-      outtset.insert(outtset.begin(), *tset_riter);
       ++n_added;
       if ((n_added>=min_inc && n_added>=n_many) || n_added >=max_inc)
         break;
       ++tset_riter;
     }
+    //the counted entries are contiguous; build them in forward order, which is linear also for sorted vectors
+    if (tset_riter!=tset.rend())
+      ++tset_riter;
+    outtset = ordered_set(tset_riter.base(), first_riter.base(), tset.key_comp());
   }
 
   log_debug("Leaving HitFraction_countHits");
@@ -178,9 +193,9 @@ std::set<T> Fraction_count (
 
 
 //_____________________________________________________________________________
-template <class T>
-std::set<T> Fraction_weight (
-  const std::set<T> tset,
+template <class T, class ordered_set>
+ordered_set Fraction_weight (
+  const ordered_set& tset,
   const boost::function<double (const T&)>& getweight,
   const size_t nFrac,
   const size_t startFrac, //natural counting
@@ -215,13 +230,13 @@ std::set<T> Fraction_weight (
   
   const double weight_per_frac = tot_weight/nFrac;
   
-  HitSet outtset;
+  ordered_set outtset(tset.key_comp());
   
   if (!reverseOrder) { //counting forward
     double start_weight = (startFrac-1)*weight_per_frac;
     double end_weight = endFrac*weight_per_frac;
     
-    HitSet::const_iterator tset_iter = tset.begin();
+    typename ordered_set::const_iterator tset_iter = tset.begin();
     double c=0; //collected weight
     double c_add=0;
     while (tset_iter != tset.end()) {
@@ -248,7 +263,7 @@ std::set<T> Fraction_weight (
     double start_weight = (startFrac)*weight_per_frac;
     double end_weight = (endFrac-1)*weight_per_frac;
     
-    HitSet::const_reverse_iterator tset_riter = tset.rbegin();
+    typename ordered_set::const_reverse_iterator tset_riter = tset.rbegin();
     double c=0; //collected weight
     double c_add=0;
     while (tset_riter != tset.rend()) {
@@ -259,9 +274,9 @@ std::set<T> Fraction_weight (
       tset_riter++;
     }
     //have found the start position
+    const typename ordered_set::const_reverse_iterator first_riter = tset_riter;
     size_t n_added=0;
     while (tset_riter != tset.rend()) {
-      outtset.insert(outtset.begin(), *tset_riter);
       double c_add = getweight(*tset_riter);
       c += c_add;
       ++n_added;
@@ -270,6 +285,10 @@ std::set<T> Fraction_weight (
         break;
       ++tset_riter;
     }
+    //the collected entries are contiguous; build them in forward order, which is linear also for sorted vectors
+    if (tset_riter!=tset.rend())
+      ++tset_riter;
+    outtset = ordered_set(tset_riter.base(), first_riter.base(), tset.key_comp());
   }
   
   log_debug("Leaving HitFraction_countCharge");
@@ -278,11 +297,12 @@ std::set<T> Fraction_weight (
 
 
 //_____________________________________________________________________________
-template <class Hitclass>
+template <class HitContainer>
 I3PosTime ComputeCOG(
   const PositionServiceConstPtr& posService,
-  const std::set<Hitclass>& hits)
+  const HitContainer& hits)
 {
+  typedef typename HitContainer::value_type Hitclass;
   log_debug("Entering CompputeCOG()");
   
   double cog_time(0.);
@@ -310,10 +330,10 @@ I3PosTime ComputeCOG(
 
 
 //_____________________________________________________________________________
-template <class Hitclass> 
+template <class Hitclass, class HitContainer> 
 I3PosTime ComputeCOG_weight(
   const PositionServiceConstPtr& posService,
-  const std::set<Hitclass>& hits,
+  const HitContainer& hits,
   const boost::function<double (const Hitclass&)>& getweight)
 {
   log_debug("Entering CompputeCOG_weight()");
@@ -323,7 +343,7 @@ I3PosTime ComputeCOG_weight(
   
   double coll_weight(0.); 
 
-  BOOST_FOREACH(const Hit& hit, hits) {
+  BOOST_FOREACH(const Hitclass& hit, hits) {
     const double weight = getweight(hit);
     const I3Position domPos = posService->GetPosition(hit.GetDOMIndex());
     coll_weight+=weight;
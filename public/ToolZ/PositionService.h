@@ -16,6 +16,11 @@
 
 #include "ToolZ/OMKeyHash.h"
 
+#include <cmath>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
 #include "dataclasses/geometry/I3Geometry.h"
 
 #include "ToolZ/__SERIALIZATION.h"
@@ -55,26 +60,31 @@ private:
 
   template<class Archive>
   void serialize(Archive & ar, const unsigned int file_version);
-  
-  //construct from sparse information only in the serialization
-  PositionService(
-    const CompactOMKeyHashServiceConstPtr& hasher,
-    const std::vector<I3Position>& hashedPosition);
 #endif //SERIALIZATION_ENABLED
   
 private: //parameters
   /// a hasher for translation of OMKeys to indeces (hashes)
   const CompactOMKeyHashServiceConstPtr hasher_;
   
+public:
+  /// a contiguous array of one coordinate for all DOMs; aligned for vectorized access
+  typedef std::vector<double, boost::alignment::aligned_allocator<double, 32> > CoordinateVector;
+  
 private: //property  
-  /// holds precashed positions
-  const std::vector<I3Position> hashedPosition_;
+  /// holds precashed positions as structure-of-arrays: the coordinates of the DOM at each hash
+  CoordinateVector x_, y_, z_;
   
 private: 
   ///for the construction of the hashedPositions
   std::vector<I3Position> ConstructHashedPositions (  
     const I3OMGeoMap& omgeo) const;
   
+  ///fill the coordinate arrays from these hashed positions
+  void SetHashedPositions(const std::vector<I3Position>& hashedPosition);
+  
+  ///get the hashed positions as array-of-structures
+  std::vector<I3Position> GetHashedPositions() const;
+  
 public:
   /// constructor
   /// \param geo pointer to an I3Geometry used for Position retrieval
@@ -88,13 +98,83 @@ public:
     const I3OMGeoMap& omgeo,
     const CompactOMKeyHashServiceConstPtr& hasher);
   
+  /// constructor: from already hashed positions (used by serialization and static geometries)
+  /// \param hasher pointer to the hashing service
+  /// \param hashedPosition the position of each DOM in the order of its hash
+  PositionService(
+    const CompactOMKeyHashServiceConstPtr& hasher,
+    const std::vector<I3Position>& hashedPosition);
+  
 public:
   /// Get the Position of the DOM hased under index a; hash if neccessary
   /// \param a the simple index of that DOM
-  const I3Position& GetPosition(const CompactHash a) const;
+  I3Position GetPosition(const CompactHash a) const;
   /// Get the Position of the DOM at this omkey
   /// \param a the simple index of that DOM
-  const I3Position& GetPosition(const OMKey& a) const;
+  I3Position GetPosition(const OMKey& a) const;
+  
+  /// Get the distance between the DOMs hashed under index a and b
+  double GetDistance(const CompactHash a, const CompactHash b) const;
+  
+  /// the x-coordinates of all DOMs in the order of their hashes
+  const CoordinateVector& GetX() const;
+  /// the y-coordinates of all DOMs in the order of their hashes
+  const CoordinateVector& GetY() const;
+  /// the z-coordinates of all DOMs in the order of their hashes
+  const CoordinateVector& GetZ() const;
+  
+  /** @brief gather the coordinates of the DOMs of a range of hashes into contiguous caller-provided buffers
+   * @param first begin of the range of hashes
+   * @param last end of the range of hashes
+   * @param x buffer for the x-coordinates; needs to hold as many elements as the range
+   * @param y buffer for the y-coordinates
+   * @param z buffer for the z-coordinates
+   */
+  template <class InputIterator>
+  void GatherPositions(
+    InputIterator first,
+    InputIterator last,
+    double* x,
+    double* y,
+    double* z) const;
+  
+  /** @brief compute the distances from a point to all DOMs at once (vectorized)
+   * @param pos the point
+   * @param dist buffer for the distances in the order of the hashes; needs to hold HashSize() elements
+   */
+  void DistancesFrom(
+    const I3Position& pos,
+    double* dist) const;
+  
+  /** @brief compute the distances from a point to the DOMs of a range of hashes
+   * @param pos the point
+   * @param first begin of the range of hashes
+   * @param last end of the range of hashes
+   * @param dist buffer for the distances in the order of the range; needs to hold as many elements as the range
+   */
+  template <class InputIterator>
+  void DistancesFrom(
+    const I3Position& pos,
+    InputIterator first,
+    InputIterator last,
+    double* dist) const;
+  
+  /** @brief compute the distances from a point to a number of points given in structure-of-arrays layout (vectorized)
+   * @param pos the point
+   * @param x x-coordinates of the points
+   * @param y y-coordinates of the points
+   * @param z z-coordinates of the points
+   * @param n number of points
+   * @param dist buffer for the distances; needs to hold n elements
+   */
+  static
+  void DistancesFrom(
+    const I3Position& pos,
+    const double* x,
+    const double* y,
+    const double* z,
+    const size_t n,
+    double* dist);
   
   /// Get the internal Hasher
   CompactOMKeyHashServiceConstPtr GetHashService() const;
@@ -102,6 +182,10 @@ public:
   ///Verify the DistService against this geometry
   /// checks if all hashed Positions are the same
   bool VerifyAgainst(const I3OMGeoMap& omgeo) const;
+  
+  /// a checksum (FNV-1a) of the hashed OMKeys and their positions;
+  /// identifies the geometry that derived products, like mapped matrix files, were built from
+  uint64_t GetChecksum() const;
 };
 
 typedef boost::shared_ptr<PositionService> PositionServicePtr;
@@ -124,7 +208,8 @@ void SERIALIZATION_NS::save_construct_data(
   Archive & ar, const PositionService * t, const unsigned int file_version)
 {
   ar << SERIALIZATION_NS::make_nvp("hasher", t->hasher_);
-  ar << SERIALIZATION_NS::make_nvp("hashedPosition", t->hashedPosition_); 
+  const std::vector<I3Position> hashedPosition = t->GetHashedPositions();
+  ar << SERIALIZATION_NS::make_nvp("hashedPosition", hashedPosition); 
 };
 
 template<class Archive>
@@ -143,13 +228,72 @@ void SERIALIZATION_NS::load_construct_data(
 #endif //SERIALIZATION_ENABLED
 
 inline
-const I3Position& PositionService::GetPosition(const CompactHash a) const {
-  return hashedPosition_[a];
+I3Position PositionService::GetPosition(const CompactHash a) const {
+  return I3Position(x_[a], y_[a], z_[a]);
 };
 
 inline
-const I3Position& PositionService::GetPosition(const OMKey& a) const
+I3Position PositionService::GetPosition(const OMKey& a) const
    {return GetPosition(hasher_->HashFromOMKey(a));};
+
+inline
+double PositionService::GetDistance(const CompactHash a, const CompactHash b) const {
+  const double dx = x_[a]-x_[b];
+  const double dy = y_[a]-y_[b];
+  const double dz = z_[a]-z_[b];
+  return std::sqrt(dx*dx+dy*dy+dz*dz);
+};
+
+inline
+const PositionService::CoordinateVector& PositionService::GetX() const
+  {return x_;};
+
+inline
+const PositionService::CoordinateVector& PositionService::GetY() const
+  {return y_;};
+
+inline
+const PositionService::CoordinateVector& PositionService::GetZ() const
+  {return z_;};
+
+template <class InputIterator>
+void PositionService::GatherPositions(
+  InputIterator first,
+  InputIterator last,
+  double* x,
+  double* y,
+  double* z) const
+{
+  for (; first!=last; ++first, ++x, ++y, ++z) {
+    const CompactHash hash = *first;
+    *x = x_[hash];
+    *y = y_[hash];
+    *z = z_[hash];
+  }
+};
+
+template <class InputIterator>
+void PositionService::DistancesFrom(
+  const I3Position& pos,
+  InputIterator first,
+  InputIterator last,
+  double* dist) const
+{
+  //gather into contiguous blocks, which are then processed vectorized
+  const size_t block_size = 256;
+  double x[block_size], y[block_size], z[block_size];
+  while (first!=last) {
+    size_t n = 0;
+    for (; first!=last && n<block_size; ++first, ++n) {
+      const CompactHash hash = *first;
+      x[n] = x_[hash];
+      y[n] = y_[hash];
+      z[n] = z_[hash];
+    }
+    DistancesFrom(pos, x, y, z, n, dist);
+    dist += n;
+  }
+};
  
 inline
 CompactOMKeyHashServiceConstPtr 
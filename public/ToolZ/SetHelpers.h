@@ -17,11 +17,16 @@
 static const unsigned sethelpers_version_ = 0;
 
 #include <set>
+#include <algorithm>
+#include <iterator>
 
 //=================== Now some Helper functions for ordered sets ==================
+// All helpers order the elements by the key_comp() of the containers, like std::set and FlatSet do.
+// Sets with contiguous storage, like FlatSet, are intersected by galloping through the larger set
+// if their sizes differ much, and by a linear merge otherwise
 
 /**Test whether any item in a sorted container is also found in another container
-* NOTE: requirements: iterator and operator< (order!) defined
+* NOTE: requirements: iterator and key_comp() (order!) defined
 * @param lhs the one container
 * @param rhs the other container having the same sorting as lhs_iter
 * @return (true) if lhs and rhs intersect by at least one element
@@ -30,7 +35,7 @@ template <class ordered_set>
 bool SetsIntersect(const ordered_set &lhs, const ordered_set &rhs);
 
 /** returns the number of intersecting items in two sets
-* NOTE: requirements: iterator and operator< (order!) defined
+* NOTE: requirements: iterator and key_comp() (order!) defined
 * @param lhs the one container
 * @param rhs the other container having the same sorting as lhs_iter
 * @return return the number of intersecting items
@@ -39,7 +44,7 @@ template <class ordered_set>
 unsigned SetsIntersectionCount(const ordered_set &lhs, const ordered_set &rhs);
 
 /** returns the intersecting items in two sets
-* NOTE: requirements: iterator and operator< (order!) defined
+* NOTE: requirements: iterator and key_comp() (order!) defined
 * @param lhs the one container
 * @param rhs the other container having the same sorting as lhs_iter
 * @return return the set of insecting elements
@@ -48,7 +53,7 @@ template <class ordered_set>
 ordered_set SetsIntersection(const ordered_set &lhs, const ordered_set &rhs);
 
 /** @brief a helper function that compares two sets and evaluates the identity by evaluating the identity of every element
-* NOTE: requirements: iterator and operator< (order!) defined
+* NOTE: requirements: iterator and key_comp() (order!) defined
 * @param lhs the one container
 * @param rhs the other container having the same sorting as lhs_iter
 * @return (true) if sets are identical in every element
@@ -69,22 +74,122 @@ ordered_set UniteSets(const ordered_set &lhs, const ordered_set &rhs);
 //========================== IMPLEMENTATIONS ===================================
 //==============================================================================
 
+namespace sethelpers {
+  ///if one set is this many times larger than the other, the smaller set gallops through the larger
+  static const size_t gallop_ratio = 16;
+
+  /** @brief find the first element in [first, last) not ordered before 'value',
+   * by probing at exponentially growing distances from 'first' and a binary search in the last step;
+   * logarithmic in the distance to the result instead of in the size of the range
+   */
+  template <class RandomAccessIterator, class T, class Compare>
+  RandomAccessIterator Gallop(RandomAccessIterator first,
+                              const RandomAccessIterator last,
+                              const T& value,
+                              const Compare& comp)
+  {
+    typename std::iterator_traits<RandomAccessIterator>::difference_type step = 1;
+    while (step<last-first && comp(first[step], value)) {
+      first += step;
+      step *= 2;
+    }
+    return std::lower_bound(first, first+std::min(step, last-first), value, comp);
+  };
+
+  /** @brief call visit(l, r) for each pair of equivalent elements of the sorted ranges,
+   * until visit returns false; by linear merge
+   */
+  template <class Iterator, class Compare, class Visitor>
+  void ForEachCommon(Iterator first1, const Iterator last1,
+                     Iterator first2, const Iterator last2,
+                     const Compare& comp,
+                     Visitor& visit,
+                     std::bidirectional_iterator_tag)
+  {
+    while (first1!=last1 && first2!=last2) {
+      if (comp(*first1, *first2))
+        ++first1;
+      else if (comp(*first2, *first1))
+        ++first2;
+      else if (!visit(*(first1++), *(first2++)))
+        return;
+    }
+  };
+
+  /** @brief call visit(l, r) for each pair of equivalent elements of the sorted ranges,
+   * until visit returns false; gallops if one range is much smaller than the other
+   */
+  template <class Iterator, class Compare, class Visitor>
+  void ForEachCommon(Iterator first1, const Iterator last1,
+                     Iterator first2, const Iterator last2,
+                     const Compare& comp,
+                     Visitor& visit,
+                     std::random_access_iterator_tag)
+  {
+    const size_t size1 = last1-first1, size2 = last2-first2;
+    if (size2>gallop_ratio*size1) {
+      for (; first1!=last1; ++first1) {
+        first2 = Gallop(first2, last2, *first1, comp);
+        if (first2==last2)
+          return;
+        if (!comp(*first1, *first2) && !visit(*first1, *(first2++)))
+          return;
+      }
+    }
+    else if (size1>gallop_ratio*size2) {
+      for (; first2!=last2; ++first2) {
+        first1 = Gallop(first1, last1, *first2, comp);
+        if (first1==last1)
+          return;
+        if (!comp(*first2, *first1) && !visit(*(first1++), *first2))
+          return;
+      }
+    }
+    else
+      ForEachCommon(first1, last1, first2, last2, comp, visit, std::bidirectional_iterator_tag());
+  };
+
+  ///call visit(l, r) for each pair of equivalent elements of the two sets, until visit returns false
+  template <class ordered_set, class Visitor>
+  void ForEachCommon(const ordered_set &lhs, const ordered_set &rhs, Visitor& visit) {
+    typedef typename std::iterator_traits<typename ordered_set::const_iterator>::iterator_category Category;
+    ForEachCommon(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), lhs.key_comp(), visit, Category());
+  };
+
+  ///visitor which stops at the first common element
+  struct FoundVisitor {
+    bool found_;
+    FoundVisitor() : found_(false) {};
+    template <class T>
+    bool operator()(const T&, const T&) {found_ = true; return false;};
+  };
+
+  ///visitor which counts the common elements
+  struct CountVisitor {
+    unsigned count_;
+    CountVisitor() : count_(0) {};
+    template <class T>
+    bool operator()(const T&, const T&) {++count_; return true;};
+  };
+
+  ///visitor which collects the common elements of the left-hand set
+  template <class ordered_set>
+  struct CollectVisitor {
+    ordered_set& outset_;
+    CollectVisitor(ordered_set& outset) : outset_(outset) {};
+    bool operator()(const typename ordered_set::value_type& l, const typename ordered_set::value_type&)
+      {outset_.insert(outset_.end(), l); return true;};
+  };
+}; //namespace sethelpers
+
 template <class ordered_set>
 bool 
 SetsIntersect(const ordered_set &lhs,
                           const ordered_set &rhs)
 {
-  typename ordered_set::const_iterator iter1 = lhs.begin();
-  typename ordered_set::const_iterator iter2 = rhs.begin();
-  while (iter1!=lhs.end() && iter2!=rhs.end()) {
-    if (*iter1<*iter2)
-      ++iter1;
-    else if (*iter2<*iter1)
-      ++iter2;
-    else
-      return(true);
-  }
-  return(false);
+  sethelpers::FoundVisitor visit;
+  sethelpers::ForEachCommon(lhs, rhs, visit);
+  return visit.found_;
 };
 
 
@@ -93,20 +198,9 @@ ordered_set
 SetsIntersection(const ordered_set &lhs,
                  const ordered_set &rhs)
 { 
-  ordered_set outset;
-  typename ordered_set::const_iterator iter1 = lhs.begin();
-  typename ordered_set::const_iterator iter2 = rhs.begin();
-  while (iter1!=lhs.end() && iter2!=rhs.end()) {
-    if (*iter1<*iter2)
-      ++iter1;
-    else if (*iter2<*iter1)
-      ++iter2;
-    else {
-      outset.insert(outset.end(), *iter1);
-      ++iter1;
-      ++iter2;
-    }
-  }
+  ordered_set outset(lhs.key_comp());
+  sethelpers::CollectVisitor<ordered_set> visit(outset);
+  sethelpers::ForEachCommon(lhs, rhs, visit);
   return outset;
 };
 
@@ -115,21 +209,9 @@ unsigned
 SetsIntersectionCount(const ordered_set &lhs,
                           const ordered_set &rhs)
 {
-  unsigned overlap=0;
-  typename ordered_set::const_iterator iter1 = lhs.begin();
-  typename ordered_set::const_iterator iter2 = rhs.begin();
-  while (iter1!=lhs.end() && iter2!=rhs.end()) {
-    if (*iter1<*iter2)
-      ++iter1;
-    else if (*iter2<*iter1)
-      ++iter2;
-    else {
-      overlap++;
-      ++iter1;
-      ++iter2;
-    }
-  }
-  return overlap;
+  sethelpers::CountVisitor visit;
+  sethelpers::ForEachCommon(lhs, rhs, visit);
+  return visit.count_;
 };
 
 
@@ -150,14 +232,24 @@ ordered_set
 UniteSets(const ordered_set &lhs,
                       const ordered_set &rhs)
 {
-  ordered_set unite;
-
-  for (typename ordered_set::const_iterator lhs_iter = lhs.begin(); lhs_iter!=lhs.end(); ++lhs_iter){
-    unite.insert(*lhs_iter);
-  }
-  for (typename ordered_set::const_iterator rhs_iter = rhs.begin(); rhs_iter!=rhs.end(); ++rhs_iter){
-    unite.insert(*rhs_iter);
+  //merge, always inserting at the end, which is constant for std::set and FlatSet alike
+  const typename ordered_set::key_compare comp = lhs.key_comp();
+  ordered_set unite(comp);
+  typename ordered_set::const_iterator lhs_iter = lhs.begin();
+  typename ordered_set::const_iterator rhs_iter = rhs.begin();
+  while (lhs_iter!=lhs.end() && rhs_iter!=rhs.end()) {
+    if (comp(*rhs_iter, *lhs_iter))
+      unite.insert(unite.end(), *(rhs_iter++));
+    else {
+      if (!comp(*lhs_iter, *rhs_iter))
+        ++rhs_iter;
+      unite.insert(unite.end(), *(lhs_iter++));
+    }
   }
+  for (; lhs_iter!=lhs.end(); ++lhs_iter)
+    unite.insert(unite.end(), *lhs_iter);
+  for (; rhs_iter!=rhs.end(); ++rhs_iter)
+    unite.insert(unite.end(), *rhs_iter);
   return unite;
 };
 
@@ -0,0 +1,628 @@
+/**
+ * \file SparseIndexMatrix.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Two dimensional matrices, which store only the fields differing from a default value
+ */
+
+#ifndef SPARSEINDEXMATRIX_H
+#define SPARSEINDEXMATRIX_H
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+
+//serialization
+#include "ToolZ/__SERIALIZATION.h"
+static const unsigned sparseindexmatrix_version_ = 0;
+
+namespace indexmatrix {
+  template <typename Base> class SparseSymmetricIndexMatrix;
+  template <typename Base> class SparseAsymmetricIndexMatrix;
+}
+
+#if SERIALIZATION_ENABLED
+namespace SERIALIZATION_NS_BASE { namespace serialization {
+  template<class Archive, typename Base>
+  void save_construct_data(
+    Archive & ar, const indexmatrix::SparseSymmetricIndexMatrix<Base> * t, const unsigned int file_version);
+  template<class Archive, typename Base>
+  void load_construct_data(
+    Archive & ar, indexmatrix::SparseSymmetricIndexMatrix<Base> * t, const unsigned int file_version);
+  template<class Archive, typename Base>
+  void save_construct_data(
+    Archive & ar, const indexmatrix::SparseAsymmetricIndexMatrix<Base> * t, const unsigned int file_version);
+  template<class Archive, typename Base>
+  void load_construct_data(
+    Archive & ar, indexmatrix::SparseAsymmetricIndexMatrix<Base> * t, const unsigned int file_version);
+}};
+#endif //SERIALIZATION_ENABLED
+
+namespace indexmatrix {
+  ///a stored field in a row of a sparse matrix
+  template <typename Base>
+  struct SparseEntry {
+    ///the index of the field within the row
+    unsigned index;
+    ///the value of the field
+    Base value;
+
+    SparseEntry();
+    SparseEntry(const unsigned index, const Base value);
+    ///order by index
+    bool operator<(const SparseEntry& rhs) const;
+  #if SERIALIZATION_ENABLED
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned version);
+  #endif //SERIALIZATION_ENABLED
+  };
+
+  /**
+   * @brief a two-dimensional map holding entries of type 'Base', which stores only the fields differing from a default value;
+   * the memory scales with the number of stored fields instead of the square of the indexable range.
+   * Every row holds its stored fields as entries sorted by index: Get is a binary search in the row,
+   * Set an insertion into the row, and the stored fields of a row are iterated directly.
+   * This is the storage shared by both symmetries; all counts are 64-bit, so that Gen2-scale ranges can be indexed
+   * @template Base a basic, or complex datatype, which is equality comparable
+   * NOTE the default value needs to compare equal to itself, so NAN can not be the default
+   */
+  template <typename Base>
+  class SparseIndexMatrix {
+  #if SERIALIZATION_ENABLED
+    friend class SERIALIZATION_NS::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned version);
+  #endif //SERIALIZATION_ENABLED
+  public:
+    typedef SparseEntry<Base> Entry;
+    typedef std::vector<Entry> Row;
+    typedef boost::iterator_range<typename Row::const_iterator> RowRange;
+
+  protected: //properties
+    ///the size of the indexable range
+    size_t biSize_;
+    ///the value of all fields which are not stored
+    Base default_;
+    ///the stored fields of each row, sorted by index
+    std::vector<Row> rows_;
+
+  protected: //constructors
+    /// hidden constructor
+    /// \param biSize of the matrix in one dimention
+    /// \param defaultValue the value of all fields which are not stored
+    SparseIndexMatrix (const unsigned biSize,
+                       const Base defaultValue);
+    /// destructor; not virtual, as matrices are never deleted through their storage
+    ~SparseIndexMatrix();
+
+    ///set the field in the row indexA only; a default value removes it
+    void SetEntry (const unsigned indexA,
+                   const unsigned indexB,
+                   const Base value);
+
+    /** @brief evaluate a function for all fields (indexA, indexB) with indexB<=indexA if lowerOnly, or else for all fields;
+     * each row is composed by one thread, the rows are dealt round-robin to the threads
+     * @param function a functor Base(indexA, indexB), which needs to be safe to call concurrently
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     * @param lowerOnly evaluate only the lower triangle
+     */
+    template <class Function>
+    void SetFromFunction (const Function& function,
+                          const unsigned nThreads,
+                          const bool lowerOnly);
+
+  private:
+    ///compose the rows [firstRow, firstRow+rowStride, ...]
+    template <class Function>
+    void ComposeRows (const Function& function,
+                      const size_t firstRow,
+                      const size_t rowStride,
+                      const bool lowerOnly);
+
+  public: //methods
+    /** @brief get the value for field
+     * @param indexA this one
+     * @param indexB and this one
+     */
+    Base Get (const unsigned indexA,
+              const unsigned indexB) const;
+    /// get the size of the indexable range, which is [0, bisize-1]
+    size_t GetBiSize() const;
+    /// get the value of all fields which are not stored
+    Base GetDefault() const;
+    /// get the number of stored entries
+    uint64_t GetNEntries() const;
+    /// the stored fields (indexA, *), sorted by index
+    RowRange GetRow(const unsigned indexA) const;
+  };
+
+
+  //===================== CLASS SparseSymmetricIndexMatrix =========================
+
+  /// sparse symmetric BiIndexed map; the fields (indexA, indexB) and (indexB, indexA) are both stored, so that full rows can be iterated
+  template <typename Base>
+  class SparseSymmetricIndexMatrix : public SparseIndexMatrix<Base> {
+  #if SERIALIZATION_ENABLED
+    friend class SERIALIZATION_NS::access;
+
+    template<class Archive, typename B>
+    friend void SERIALIZATION_NS::save_construct_data(
+      Archive & ar, const SparseSymmetricIndexMatrix<B> * t, const unsigned int file_version);
+
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned version);
+  #endif //SERIALIZATION_ENABLED
+  public:
+    typedef typename SparseIndexMatrix<Base>::Entry Entry;
+    typedef typename SparseIndexMatrix<Base>::RowRange RowRange;
+
+    /** @brief constructor
+     * @param biSize that is the range of the biIndex
+     * @param defaultValue the value of all fields which are not stored
+     */
+    SparseSymmetricIndexMatrix (const unsigned biSize,
+                                const Base defaultValue = Base());
+    /** @brief constructor from function: evaluate function(indexA, indexB) for all fields and store those differing from the default
+     * @param biSize that is the range of the biIndex
+     * @param function a functor Base(indexA, indexB); is called concurrently if nThreads!=1
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     * @param defaultValue the value of all fields which are not stored
+     */
+    template <class Function>
+    SparseSymmetricIndexMatrix (const unsigned biSize,
+                                const Function& function,
+                                const unsigned nThreads = 1,
+                                const Base defaultValue = Base(),
+                                typename boost::disable_if<boost::is_arithmetic<Function> >::type* = 0);
+
+    /** @brief set the value for field
+     * @param indexA this one
+     * @param indexB and this one
+     * @param value to this value; the default value removes the field from the storage
+     */
+    void Set (const unsigned indexA,
+              const unsigned indexB,
+              const Base value);
+    /** @brief set the fields (indexA, *) at once, e.g. from a list of neighbours; all other fields of the row become default
+     * @param indexA the row
+     * @param first iterator to the first Entry of the row; the entries need to have distinct indices
+     * @param last iterator past the last Entry
+     */
+    template <class InputIterator>
+    void SetRow (const unsigned indexA,
+                 InputIterator first,
+                 InputIterator last);
+    /// the stored fields (0..biSize-1, indexB); identical to the row, as the matrix is symmetric
+    RowRange GetColumn(const unsigned indexB) const;
+
+    /** @brief visit all stored fields row after row
+     * @param function a functor void(indexA, indexB, value); each field is visited once with indexA>=indexB
+     */
+    template <class Function>
+    void ForEachField(Function function) const;
+  };
+
+
+  //===================== CLASS SparseAsymmetricIndexMatrix =========================
+
+  /// sparse asymmetric BiIndexed map
+  template <typename Base>
+  class SparseAsymmetricIndexMatrix : public SparseIndexMatrix<Base> {
+  #if SERIALIZATION_ENABLED
+    friend class SERIALIZATION_NS::access;
+
+    template<class Archive, typename B>
+    friend void SERIALIZATION_NS::save_construct_data(
+      Archive & ar, const SparseAsymmetricIndexMatrix<B> * t, const unsigned int file_version);
+
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned version);
+  #endif //SERIALIZATION_ENABLED
+  public:
+    typedef typename SparseIndexMatrix<Base>::Entry Entry;
+    typedef typename SparseIndexMatrix<Base>::RowRange RowRange;
+
+    /** @brief constructor
+     * @param biSize that is the range of the biIndex
+     * @param defaultValue the value of all fields which are not stored
+     */
+    SparseAsymmetricIndexMatrix (const unsigned biSize,
+                                 const Base defaultValue = Base());
+    /** @brief constructor from function: evaluate function(indexA, indexB) for all fields and store those differing from the default
+     * @param biSize that is the range of the biIndex
+     * @param function a functor Base(indexA, indexB); is called concurrently if nThreads!=1
+     * @param nThreads number of threads to use; 0 for as many as there are hardware threads
+     * @param defaultValue the value of all fields which are not stored
+     */
+    template <class Function>
+    SparseAsymmetricIndexMatrix (const unsigned biSize,
+                                 const Function& function,
+                                 const unsigned nThreads = 1,
+                                 const Base defaultValue = Base(),
+                                 typename boost::disable_if<boost::is_arithmetic<Function> >::type* = 0);
+
+    /** @brief set the value for field
+     * @param indexA this one
+     * @param indexB and this one
+     * @param value to this value; the default value removes the field from the storage
+     */
+    void Set (const unsigned indexA,
+              const unsigned indexB,
+              const Base value);
+    /** @brief set the fields (indexA, *) at once, e.g. from a list of neighbours; all other fields of the row become default
+     * @param indexA the row
+     * @param first iterator to the first Entry of the row; the entries need to have distinct indices
+     * @param last iterator past the last Entry
+     */
+    template <class InputIterator>
+    void SetRow (const unsigned indexA,
+                 InputIterator first,
+                 InputIterator last);
+
+    /** @brief visit all stored fields row after row
+     * @param function a functor void(indexA, indexB, value)
+     */
+    template <class Function>
+    void ForEachField(Function function) const;
+  };
+
+  typedef SparseSymmetricIndexMatrix<double> SparseSymmetricIndexMatrix_Double;
+  typedef SparseAsymmetricIndexMatrix<double> SparseAsymmetricIndexMatrix_Double;
+  typedef SparseSymmetricIndexMatrix<bool> SparseSymmetricIndexMatrix_Bool;
+  typedef SparseAsymmetricIndexMatrix<bool> SparseAsymmetricIndexMatrix_Bool;
+
+  typedef boost::shared_ptr<SparseSymmetricIndexMatrix_Double> SparseSymmetricIndexMatrix_DoublePtr;
+  typedef boost::shared_ptr<const SparseSymmetricIndexMatrix_Double> SparseSymmetricIndexMatrix_DoubleConstPtr;
+  typedef boost::shared_ptr<SparseAsymmetricIndexMatrix_Double> SparseAsymmetricIndexMatrix_DoublePtr;
+  typedef boost::shared_ptr<const SparseAsymmetricIndexMatrix_Double> SparseAsymmetricIndexMatrix_DoubleConstPtr;
+  typedef boost::shared_ptr<SparseSymmetricIndexMatrix_Bool> SparseSymmetricIndexMatrix_BoolPtr;
+  typedef boost::shared_ptr<const SparseSymmetricIndexMatrix_Bool> SparseSymmetricIndexMatrix_BoolConstPtr;
+  typedef boost::shared_ptr<SparseAsymmetricIndexMatrix_Bool> SparseAsymmetricIndexMatrix_BoolPtr;
+  typedef boost::shared_ptr<const SparseAsymmetricIndexMatrix_Bool> SparseAsymmetricIndexMatrix_BoolConstPtr;
+}; //namespace indexmatrix
+
+#if SERIALIZATION_ENABLED
+  SERIALIZATION_CLASS_VERSION(indexmatrix::SparseSymmetricIndexMatrix_Double, sparseindexmatrix_version_);
+  SERIALIZATION_CLASS_VERSION(indexmatrix::SparseAsymmetricIndexMatrix_Double, sparseindexmatrix_version_);
+  SERIALIZATION_CLASS_VERSION(indexmatrix::SparseSymmetricIndexMatrix_Bool, sparseindexmatrix_version_);
+  SERIALIZATION_CLASS_VERSION(indexmatrix::SparseAsymmetricIndexMatrix_Bool, sparseindexmatrix_version_);
+#endif //SERIALIZATION_ENABLED
+
+
+//==============================================================================
+//========================== IMPLEMENTATION ====================================
+//==============================================================================
+
+//===================== CLASS SparseEntry =========================
+
+template <typename Base>
+indexmatrix::SparseEntry<Base>::SparseEntry() :
+  index(0),
+  value()
+{};
+
+template <typename Base>
+indexmatrix::SparseEntry<Base>::SparseEntry(const unsigned index, const Base value) :
+  index(index),
+  value(value)
+{};
+
+template <typename Base>
+inline bool indexmatrix::SparseEntry<Base>::operator<(const SparseEntry& rhs) const
+  {return index<rhs.index;};
+
+#if SERIALIZATION_ENABLED
+template <typename Base>
+template <class Archive>
+void indexmatrix::SparseEntry<Base>::serialize(Archive & ar, const unsigned version) {
+  ar & SERIALIZATION_NS::make_nvp("index", index);
+  ar & SERIALIZATION_NS::make_nvp("value", value);
+};
+#endif //SERIALIZATION_ENABLED
+
+
+//===================== CLASS SparseIndexMatrix =========================
+
+#if SERIALIZATION_ENABLED
+template <typename Base>
+template <class Archive>
+void indexmatrix::SparseIndexMatrix<Base>::serialize(Archive & ar, const unsigned version)
+{ ar & SERIALIZATION_NS::make_nvp("Rows", rows_); };
+#endif //SERIALIZATION_ENABLED
+
+template <typename Base>
+indexmatrix::SparseIndexMatrix<Base>::SparseIndexMatrix (const unsigned biSize, const Base defaultValue) :
+  biSize_(biSize),
+  default_(defaultValue),
+  rows_(biSize)
+{};
+
+template <typename Base>
+indexmatrix::SparseIndexMatrix<Base>::~SparseIndexMatrix ()
+{};
+
+template <typename Base>
+Base indexmatrix::SparseIndexMatrix<Base>::Get (const unsigned indexA, const unsigned indexB) const {
+  const Row& row = rows_[indexA];
+  const typename Row::const_iterator it = std::lower_bound(row.begin(), row.end(), Entry(indexB, default_));
+  return (it!=row.end() && it->index==indexB) ? it->value : default_;
+};
+
+template <typename Base>
+void indexmatrix::SparseIndexMatrix<Base>::SetEntry (const unsigned indexA, const unsigned indexB, const Base value) {
+  Row& row = rows_[indexA];
+  const typename Row::iterator it = std::lower_bound(row.begin(), row.end(), Entry(indexB, default_));
+  if (it!=row.end() && it->index==indexB) {
+    if (value==default_)
+      row.erase(it);
+    else
+      it->value = value;
+  }
+  else if (value!=default_)
+    row.insert(it, Entry(indexB, value));
+};
+
+template <typename Base>
+template <class Function>
+void indexmatrix::SparseIndexMatrix<Base>::SetFromFunction(
+  const Function& function,
+  const unsigned nThreads,
+  const bool lowerOnly)
+{
+  size_t nWorkers = nThreads ? nThreads : boost::thread::hardware_concurrency();
+  nWorkers = std::max(size_t(1), std::min(nWorkers, biSize_));
+
+  if (nWorkers==1)
+    ComposeRows(function, 0, 1, lowerOnly);
+  else {
+    //each thread writes whole rows, so that no two threads touch the same row
+    boost::thread_group workers;
+    for (size_t t=0; t<nWorkers; t++)
+      workers.create_thread(boost::bind(&SparseIndexMatrix::template ComposeRows<Function>,
+        this, boost::cref(function), t, nWorkers, lowerOnly));
+    workers.join_all();
+  }
+};
+
+template <typename Base>
+template <class Function>
+void indexmatrix::SparseIndexMatrix<Base>::ComposeRows(
+  const Function& function,
+  const size_t firstRow,
+  const size_t rowStride,
+  const bool lowerOnly)
+{
+  for (size_t indexA=firstRow; indexA<biSize_; indexA+=rowStride) {
+    Row& row = rows_[indexA];
+    row.clear();
+    const size_t lastB = lowerOnly ? indexA+1 : biSize_;
+    for (size_t indexB=0; indexB<lastB; indexB++) {
+      const Base value = function(indexA, indexB);
+      if (value!=default_)
+        row.push_back(Entry(indexB, value));
+    }
+  }
+};
+
+template <typename Base>
+inline size_t indexmatrix::SparseIndexMatrix<Base>::GetBiSize () const
+  {return biSize_;};
+
+template <typename Base>
+inline Base indexmatrix::SparseIndexMatrix<Base>::GetDefault () const
+  {return default_;};
+
+template <typename Base>
+uint64_t indexmatrix::SparseIndexMatrix<Base>::GetNEntries () const {
+  uint64_t nEntries = 0;
+  for (size_t indexA=0; indexA<biSize_; indexA++)
+    nEntries += rows_[indexA].size();
+  return nEntries;
+};
+
+template <typename Base>
+inline typename indexmatrix::SparseIndexMatrix<Base>::RowRange
+indexmatrix::SparseIndexMatrix<Base>::GetRow (const unsigned indexA) const
+  {return RowRange(rows_[indexA].begin(), rows_[indexA].end());};
+
+
+//===================== CLASS SparseSymmetricIndexMatrix =========================
+
+#if SERIALIZATION_ENABLED
+namespace SERIALIZATION_NS_BASE { namespace serialization {
+  template<class Archive, typename Base>
+  inline void save_construct_data(
+    Archive & ar, const indexmatrix::SparseSymmetricIndexMatrix<Base> * t, const unsigned int file_version)
+  {
+    ar << SERIALIZATION_NS::make_nvp("biSize", t->biSize_);
+    ar << SERIALIZATION_NS::make_nvp("default", t->default_);
+  };
+
+  template<class Archive, typename Base>
+  inline void load_construct_data(
+    Archive & ar, indexmatrix::SparseSymmetricIndexMatrix<Base> * t, const unsigned int file_version)
+  {
+    size_t biSize;
+    Base defaultValue;
+    ar >> SERIALIZATION_NS::make_nvp("biSize", biSize);
+    ar >> SERIALIZATION_NS::make_nvp("default", defaultValue);
+    ::new(t)indexmatrix::SparseSymmetricIndexMatrix<Base>(biSize, defaultValue);
+  };
+}}; // namespace ...
+
+template <typename Base>
+template <class Archive>
+void indexmatrix::SparseSymmetricIndexMatrix<Base>::serialize(Archive & ar, const unsigned version) {
+  typedef SparseIndexMatrix<Base> SIM;
+  ar & SERIALIZATION_BASE_OBJECT_NVP( SIM );
+};
+#endif //SERIALIZATION_ENABLED
+
+template <typename Base>
+indexmatrix::SparseSymmetricIndexMatrix<Base>::SparseSymmetricIndexMatrix (
+  const unsigned biSize,
+  const Base defaultValue)
+: SparseIndexMatrix<Base>(biSize, defaultValue)
+{};
+
+template <typename Base>
+template <class Function>
+indexmatrix::SparseSymmetricIndexMatrix<Base>::SparseSymmetricIndexMatrix (
+  const unsigned biSize,
+  const Function& function,
+  const unsigned nThreads,
+  const Base defaultValue,
+  typename boost::disable_if<boost::is_arithmetic<Function> >::type*)
+: SparseIndexMatrix<Base>(biSize, defaultValue)
+{
+  this->SetFromFunction(function, nThreads, true);
+  //mirror the lower triangle; the rows are visited in ascending order, so that the mirrored entries append in order
+  for (size_t indexA=0; indexA<this->biSize_; indexA++) {
+    const typename SparseIndexMatrix<Base>::Row& row = this->rows_[indexA];
+    for (size_t e=0; e<row.size() && row[e].index<indexA; e++)
+      this->rows_[row[e].index].push_back(Entry(indexA, row[e].value));
+  }
+};
+
+template <typename Base>
+void indexmatrix::SparseSymmetricIndexMatrix<Base>::Set (
+  const unsigned indexA,
+  const unsigned indexB,
+  const Base value)
+{
+  this->SetEntry(indexA, indexB, value);
+  if (indexA!=indexB)
+    this->SetEntry(indexB, indexA, value);
+};
+
+template <typename Base>
+template <class InputIterator>
+void indexmatrix::SparseSymmetricIndexMatrix<Base>::SetRow (
+  const unsigned indexA,
+  InputIterator first,
+  InputIterator last)
+{
+  //clear the mirrors of the former fields, then set the new fields and their mirrors
+  typename SparseIndexMatrix<Base>::Row former;
+  former.swap(this->rows_[indexA]);
+  for (typename SparseIndexMatrix<Base>::Row::const_iterator it=former.begin(); it!=former.end(); ++it) {
+    if (it->index!=indexA)
+      this->SetEntry(it->index, indexA, this->default_);
+  }
+  for (; first!=last; ++first)
+    Set(indexA, first->index, first->value);
+};
+
+template <typename Base>
+inline typename indexmatrix::SparseSymmetricIndexMatrix<Base>::RowRange
+indexmatrix::SparseSymmetricIndexMatrix<Base>::GetColumn (const unsigned indexB) const
+  {return this->GetRow(indexB);};
+
+template <typename Base>
+template <class Function>
+void indexmatrix::SparseSymmetricIndexMatrix<Base>::ForEachField(Function function) const {
+  for (size_t indexA=0; indexA<this->biSize_; indexA++) {
+    const typename SparseIndexMatrix<Base>::Row& row = this->rows_[indexA];
+    for (size_t e=0; e<row.size() && row[e].index<=indexA; e++)
+      function(indexA, row[e].index, row[e].value);
+  }
+};
+
+
+//===================== CLASS SparseAsymmetricIndexMatrix =========================
+
+#if SERIALIZATION_ENABLED
+namespace SERIALIZATION_NS_BASE { namespace serialization {
+  template<class Archive, typename Base>
+  inline void save_construct_data(
+    Archive & ar, const indexmatrix::SparseAsymmetricIndexMatrix<Base> * t, const unsigned int file_version)
+  {
+    ar << SERIALIZATION_NS::make_nvp("biSize", t->biSize_);
+    ar << SERIALIZATION_NS::make_nvp("default", t->default_);
+  };
+
+  template<class Archive, typename Base>
+  inline void load_construct_data(
+    Archive & ar, indexmatrix::SparseAsymmetricIndexMatrix<Base> * t, const unsigned int file_version)
+  {
+    size_t biSize;
+    Base defaultValue;
+    ar >> SERIALIZATION_NS::make_nvp("biSize", biSize);
+    ar >> SERIALIZATION_NS::make_nvp("default", defaultValue);
+    ::new(t)indexmatrix::SparseAsymmetricIndexMatrix<Base>(biSize, defaultValue);
+  };
+}}; // namespace ...
+
+template <typename Base>
+template <class Archive>
+void indexmatrix::SparseAsymmetricIndexMatrix<Base>::serialize(Archive & ar, const unsigned version) {
+  typedef SparseIndexMatrix<Base> SIM;
+  ar & SERIALIZATION_BASE_OBJECT_NVP( SIM );
+};
+#endif //SERIALIZATION_ENABLED
+
+template <typename Base>
+indexmatrix::SparseAsymmetricIndexMatrix<Base>::SparseAsymmetricIndexMatrix (
+  const unsigned biSize,
+  const Base defaultValue)
+: SparseIndexMatrix<Base>(biSize, defaultValue)
+{};
+
+template <typename Base>
+template <class Function>
+indexmatrix::SparseAsymmetricIndexMatrix<Base>::SparseAsymmetricIndexMatrix (
+  const unsigned biSize,
+  const Function& function,
+  const unsigned nThreads,
+  const Base defaultValue,
+  typename boost::disable_if<boost::is_arithmetic<Function> >::type*)
+: SparseIndexMatrix<Base>(biSize, defaultValue)
+{
+  this->SetFromFunction(function, nThreads, false);
+};
+
+template <typename Base>
+inline void indexmatrix::SparseAsymmetricIndexMatrix<Base>::Set (
+  const unsigned indexA,
+  const unsigned indexB,
+  const Base value)
+  {this->SetEntry(indexA, indexB, value);};
+
+template <typename Base>
+template <class InputIterator>
+void indexmatrix::SparseAsymmetricIndexMatrix<Base>::SetRow (
+  const unsigned indexA,
+  InputIterator first,
+  InputIterator last)
+{
+  typename SparseIndexMatrix<Base>::Row& row = this->rows_[indexA];
+  row.clear();
+  for (; first!=last; ++first) {
+    if (first->value!=this->default_)
+      row.push_back(Entry(first->index, first->value));
+  }
+  std::sort(row.begin(), row.end());
+};
+
+template <typename Base>
+template <class Function>
+void indexmatrix::SparseAsymmetricIndexMatrix<Base>::ForEachField(Function function) const {
+  for (size_t indexA=0; indexA<this->biSize_; indexA++) {
+    const typename SparseIndexMatrix<Base>::Row& row = this->rows_[indexA];
+    for (size_t e=0; e<row.size(); e++)
+      function(indexA, row[e].index, row[e].value);
+  }
+};
+
+#endif //SPARSEINDEXMATRIX_H
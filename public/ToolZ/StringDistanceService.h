@@ -0,0 +1,219 @@
+/**
+ * \file StringDistanceService.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * Computes distances between hashed DOMs from a compact string-factored representation
+ */
+
+#ifndef STRINGDISTANCESERVICE_H
+#define STRINGDISTANCESERVICE_H
+
+#include "ToolZ/OMKeyHash.h"
+#include "ToolZ/PositionService.h"
+
+#include <cmath>
+#include <vector>
+#include <stdint.h>
+
+#include "icetray/I3Units.h"
+
+#include "ToolZ/__SERIALIZATION.h"
+///version 1: the column tolerance is stored
+static const unsigned stringdistanceservice_version_ = 1;
+
+//============ CLASS StringDistanceService ==========
+
+//forward declarations for Serialization
+#if SERIALIZATION_ENABLED
+class StringDistanceService;
+
+namespace SERIALIZATION_NS_BASE { namespace serialization {
+  template<class Archive>
+  void save_construct_data(
+    Archive & ar, const StringDistanceService * t, const unsigned int file_version);
+
+  template<class Archive>
+  void load_construct_data(
+    Archive & ar, StringDistanceService * t, const unsigned int file_version);
+}};
+#endif //SERIALIZATION_ENABLED
+
+
+/**
+  * An alternative to the DistanceService, which does not hold a matrix of all DOM-to-DOM distances:
+  * DOMs sit on vertical strings, so that the DOMs of a string, which lie within a tolerance of each other
+  * in the horizontal plane, are grouped into a column at their mean horizontal position;
+  * only the squared horizontal distances between all columns and the column of each DOM are stored,
+  * while the vertical part is computed on demand from the z-coordinates.
+  * Distances deviate from the true ones by at most twice GetMaxOffset(), the largest horizontal distance
+  * of any DOM to its column, which is zero for ideal vertical strings; they are not rounded to meters like in the DistanceService.
+  * The representation is small enough to stay in cache (about 40kB for IC86 instead of 30MB)
+  * NOTE all methods are thread-safe
+  */
+class StringDistanceService {
+#if SERIALIZATION_ENABLED
+  friend class SERIALIZATION_NS::access;
+
+  template<class Archive>
+  friend void SERIALIZATION_NS::save_construct_data(
+    Archive & ar, const StringDistanceService * t, const unsigned int file_version);
+
+  template<class Archive>
+  friend void SERIALIZATION_NS::load_construct_data(
+    Archive & ar, StringDistanceService * t, const unsigned int file_version);
+
+  template<class Archive>
+  void serialize(Archive & ar, const unsigned int file_version);
+#endif //SERIALIZATION_ENABLED
+private: //parameters
+  /// a hasher for translation of OMKeys to indeces (hashes)
+  const CompactOMKeyHashServiceConstPtr hasher_;
+  /// a position service
+  const PositionServiceConstPtr posService_;
+  /// DOMs of the same string within this horizontal distance to the first DOM of a column join that column
+  const double tolerance_;
+
+private: //properties
+  /// number of columns
+  unsigned nColumns_;
+  /// the largest horizontal distance of any DOM to the position of its column
+  double maxOffset_;
+  /// the column of each DOM in the order of the hashes
+  std::vector<uint16_t> column_;
+  /// squared horizontal distances between all columns; row-major nColumns x nColumns
+  std::vector<float> horizontalDist2_;
+
+public:
+  /// constructor
+  /// \param posService the positions of the hashed DOMs
+  /// \param tolerance DOMs of the same string within this horizontal distance to the first DOM of a column join that column;
+  ///   DOMs further out start a new column (e.g. the two IceTop tanks of a station)
+  StringDistanceService(
+    const PositionServiceConstPtr& posService,
+    const double tolerance = 1.*I3Units::m);
+
+  /// Get the distance between these two DOMs by hashed index
+  /// \param a hashed DOMindex
+  /// \param b hashed DOMindex
+  double GetDistance(const CompactHash a,
+                     const CompactHash b) const;
+  /// Get the distance between these two DOMs by omkey
+  /// \param a OMKey
+  /// \param b OMKey
+  double GetDistance(const OMKey& a,
+                     const OMKey& b) const;
+
+  /** @brief Get the distances from this DOM to all DOMs at once (vectorized)
+   * @param a hashed DOMindex
+   * @param dist buffer for the distances in the order of the hashes; needs to hold HashSize() elements
+   */
+  void DistancesFrom(const CompactHash a,
+                     double* dist) const;
+
+  /// number of columns, which the DOMs are grouped into
+  unsigned GetNColumns() const;
+
+  /// the tolerance within which DOMs of the same string are grouped into a column
+  double GetTolerance() const;
+
+  /// the largest horizontal distance of any DOM to the position of its column;
+  /// distances are accurate to twice this value
+  double GetMaxOffset() const;
+
+  /// Get the internal Hasher
+  CompactOMKeyHashServiceConstPtr GetHashService() const;
+  /// Get the internal PositionService
+  PositionServiceConstPtr GetPosService() const;
+
+  ///Verify the DistService against this geometry
+  /// checks if all hashed Positions are the same
+  bool VerifyAgainst(const I3OMGeoMap& omgeo) const;
+};
+
+typedef boost::shared_ptr<StringDistanceService> StringDistanceServicePtr;
+typedef boost::shared_ptr<const StringDistanceService> StringDistanceServiceConstPtr;
+
+
+//========================================================
+//==================== IMPLERMENTATIONS ==================
+//========================================================
+
+#if SERIALIZATION_ENABLED
+template<class Archive>
+void StringDistanceService::serialize(Archive & ar, const unsigned int version)
+{};
+
+// //NOTE (de)serialization overrides
+namespace SERIALIZATION_NS_BASE { namespace serialization {
+template<class Archive>
+inline void save_construct_data(
+  Archive & ar, const StringDistanceService * t, const unsigned int file_version)
+{
+  ar << SERIALIZATION_NS::make_nvp("posService", t->posService_);
+  double tolerance = t->tolerance_;
+  ar << SERIALIZATION_NS::make_nvp("tolerance", tolerance);
+};
+
+template<class Archive>
+inline void load_construct_data(
+  Archive & ar, StringDistanceService * t, const unsigned int file_version)
+{
+  PositionServiceConstPtr posService;
+  ar >> SERIALIZATION_NS::make_nvp("posService", posService);
+  //version 0 used no tolerance
+  double tolerance = 0.;
+  if (file_version>=1)
+    ar >> SERIALIZATION_NS::make_nvp("tolerance", tolerance);
+  ::new(t)StringDistanceService(posService, tolerance);
+};
+}} // namespace ...
+#endif //SERIALIZATION_ENABLED
+
+inline
+double StringDistanceService::GetDistance(
+  const CompactHash a,
+  const CompactHash b) const
+{
+  const double* z = posService_->GetZ().data();
+  const double dz = z[a]-z[b];
+  return std::sqrt(double(horizontalDist2_[column_[a]*nColumns_+column_[b]]) + dz*dz);
+};
+
+inline
+double StringDistanceService::GetDistance(
+  const OMKey& a,
+  const OMKey& b) const
+{
+  return GetDistance( hasher_->HashFromOMKey(a), hasher_->HashFromOMKey(b));
+};
+
+inline
+unsigned StringDistanceService::GetNColumns() const
+  { return nColumns_; };
+
+inline
+double StringDistanceService::GetTolerance() const
+  { return tolerance_; };
+
+inline
+double StringDistanceService::GetMaxOffset() const
+  { return maxOffset_; };
+
+inline
+CompactOMKeyHashServiceConstPtr
+StringDistanceService::GetHashService() const
+  { return hasher_; };
+
+inline
+PositionServiceConstPtr
+StringDistanceService::GetPosService() const
+  { return posService_; };
+
+#if SERIALIZATION_ENABLED
+  SERIALIZATION_CLASS_VERSION(StringDistanceService, stringdistanceservice_version_);
+#endif //SERIALIZATION_ENABLED
+
+#endif // STRINGDISTANCESERVICE_H
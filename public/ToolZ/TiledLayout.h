@@ -0,0 +1,167 @@
+/**
+ * \file TiledLayout.h
+ *
+ * (c) 2012 the IceCube Collaboration
+ *
+ * \author Marcel Zoll <marcel.zoll@fysik.su.se>
+ *
+ * A tiled storage order of the IndexMatrix, as an opt-in alternative to the default RowMajorLayout;
+ * it pays off only where the cache misses of the access pattern outweigh the cost of computing the tile index,
+ * which was not the case in any pattern of IndexMatrixBenchmark; measure before choosing it
+ */
+
+#ifndef TILEDLAYOUT_H
+#define TILEDLAYOUT_H
+
+#include "ToolZ/IndexMatrix.h"
+
+namespace indexmatrix {
+  /**
+   * @brief the storage order of the fields in square tiles of TileSize x TileSize fields, tile after tile in row-major order,
+   * and row-major within each tile; the symmetric matrix stores the lower triangle of tiles, where the diagonal tiles
+   * are stored whole. Pairs of indices which are close to each other share a tile, and so a few cache lines,
+   * also where they are far apart in a row-major layout.
+   * Tiles at the edges are padded, so that some storage positions do not hold a field;
+   * IndexMatrixAccess::ForEachField sweeps the fields tile by tile, and skips the padding
+   * @template TileSize the edge-length of the tiles; needs to be a power of 2
+   */
+  template <unsigned TileSize>
+  struct TiledLayout {
+    BOOST_STATIC_ASSERT_MSG(TileSize && !(TileSize&(TileSize-1)), "TileSize needs to be a power of 2");
+    ///the tag of this layout in archives and mapped files
+    static const uint32_t tag = TileSize;
+    ///the edge-length of the tiles
+    static const unsigned tile_size = TileSize;
+    ///number of tiles along one edge of the matrix
+    static size_t NTiles(const size_t biSize);
+    
+    static size_t SymmetricSize(const size_t biSize);
+    static size_t SymmetricIndex(const size_t biSize, const size_t indexA, const size_t indexB);
+    static std::pair<unsigned, unsigned> SymmetricBiIndex(const size_t biSize, const size_t index);
+    static void SymmetricNext(const size_t biSize, unsigned& indexA, unsigned& indexB);
+    ///the position holds a field, and not padding or the upper half of a diagonal tile
+    static bool SymmetricIsField(const size_t biSize, const unsigned indexA, const unsigned indexB);
+    
+    static size_t AsymmetricSize(const size_t biSize);
+    static size_t AsymmetricIndex(const size_t biSize, const size_t indexA, const size_t indexB);
+    static std::pair<unsigned, unsigned> AsymmetricBiIndex(const size_t biSize, const size_t index);
+    static void AsymmetricNext(const size_t biSize, unsigned& indexA, unsigned& indexB);
+    ///the position holds a field, and not padding
+    static bool AsymmetricIsField(const size_t biSize, const unsigned indexA, const unsigned indexB);
+  };
+  
+  template <typename Base, class Internal, unsigned TileSize = 64>
+  struct TiledSymmetricIndexMatrix {
+    ///shorthand for the SymmetricIndexMatrix in TiledLayout
+    typedef SymmetricIndexMatrix<Base, Internal, TiledLayout<TileSize> > type;
+  };
+  
+  template <typename Base, class Internal, unsigned TileSize = 64>
+  struct TiledAsymmetricIndexMatrix {
+    ///shorthand for the AsymmetricIndexMatrix in TiledLayout
+    typedef AsymmetricIndexMatrix<Base, Internal, TiledLayout<TileSize> > type;
+  };
+}; //namespace indexmatrix
+
+
+//========================================================
+//==================== IMPLEMENTATIONS ===================
+//========================================================
+
+template <unsigned TileSize>
+const uint32_t indexmatrix::TiledLayout<TileSize>::tag;
+
+template <unsigned TileSize>
+const unsigned indexmatrix::TiledLayout<TileSize>::tile_size;
+
+template <unsigned TileSize>
+inline size_t indexmatrix::TiledLayout<TileSize>::NTiles(const size_t biSize)
+  {return (biSize+TileSize-1)/TileSize;};
+
+template <unsigned TileSize>
+inline size_t indexmatrix::TiledLayout<TileSize>::SymmetricSize(const size_t biSize) {
+  const size_t nTiles = NTiles(biSize);
+  return (nTiles*nTiles+nTiles)/2*TileSize*TileSize;
+};
+
+template <unsigned TileSize>
+inline size_t indexmatrix::TiledLayout<TileSize>::SymmetricIndex(const size_t, const size_t indexA, const size_t indexB) {
+  const size_t tileA = indexA/TileSize;
+  const size_t tileB = indexB/TileSize;
+  const size_t tile = (tileA*tileA+tileA)/2+tileB;
+  return (tile*TileSize+indexA%TileSize)*TileSize+indexB%TileSize;
+};
+
+template <unsigned TileSize>
+std::pair<unsigned, unsigned> indexmatrix::TiledLayout<TileSize>::SymmetricBiIndex(const size_t, const size_t index) {
+  const size_t tile = index/(TileSize*TileSize);
+  const size_t tileA = TriangularRoot(tile);
+  const size_t tileB = tile-(tileA*tileA+tileA)/2;
+  const size_t inTile = index%(TileSize*TileSize);
+  return std::make_pair(tileA*TileSize+inTile/TileSize, tileB*TileSize+inTile%TileSize);
+};
+
+template <unsigned TileSize>
+inline void indexmatrix::TiledLayout<TileSize>::SymmetricNext(const size_t, unsigned& indexA, unsigned& indexB) {
+  if (++indexB%TileSize)
+    return;
+  //next row within the tile
+  indexB -= TileSize;
+  if (++indexA%TileSize)
+    return;
+  //next tile in the lower triangle of tiles
+  indexA -= TileSize;
+  if (indexB+TileSize>indexA) {
+    indexA += TileSize;
+    indexB = 0;
+  }
+  else
+    indexB += TileSize;
+};
+
+template <unsigned TileSize>
+inline bool indexmatrix::TiledLayout<TileSize>::SymmetricIsField(const size_t biSize, const unsigned indexA, const unsigned indexB)
+  {return indexA<biSize && indexB<=indexA;};
+
+template <unsigned TileSize>
+inline size_t indexmatrix::TiledLayout<TileSize>::AsymmetricSize(const size_t biSize) {
+  const size_t nTiles = NTiles(biSize);
+  return nTiles*nTiles*TileSize*TileSize;
+};
+
+template <unsigned TileSize>
+inline size_t indexmatrix::TiledLayout<TileSize>::AsymmetricIndex(const size_t biSize, const size_t indexA, const size_t indexB) {
+  const size_t tile = indexA/TileSize*NTiles(biSize)+indexB/TileSize;
+  return (tile*TileSize+indexA%TileSize)*TileSize+indexB%TileSize;
+};
+
+template <unsigned TileSize>
+std::pair<unsigned, unsigned> indexmatrix::TiledLayout<TileSize>::AsymmetricBiIndex(const size_t biSize, const size_t index) {
+  const size_t nTiles = NTiles(biSize);
+  const size_t tile = index/(TileSize*TileSize);
+  const size_t inTile = index%(TileSize*TileSize);
+  return std::make_pair(tile/nTiles*TileSize+inTile/TileSize, tile%nTiles*TileSize+inTile%TileSize);
+};
+
+template <unsigned TileSize>
+inline void indexmatrix::TiledLayout<TileSize>::AsymmetricNext(const size_t biSize, unsigned& indexA, unsigned& indexB) {
+  if (++indexB%TileSize)
+    return;
+  //next row within the tile
+  indexB -= TileSize;
+  if (++indexA%TileSize)
+    return;
+  //next tile in row-major order of tiles
+  indexA -= TileSize;
+  indexB += TileSize;
+  if (indexB>=NTiles(biSize)*TileSize) {
+    indexA += TileSize;
+    indexB = 0;
+  }
+};
+
+template <unsigned TileSize>
+inline bool indexmatrix::TiledLayout<TileSize>::AsymmetricIsField(const size_t biSize, const unsigned indexA, const unsigned indexB)
+  {return indexA<biSize && indexB<biSize;};
+
+#endif //TILEDLAYOUT_H